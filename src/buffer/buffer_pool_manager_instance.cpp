@@ -46,6 +46,14 @@ BufferPoolManagerInstance::BufferPoolManagerInstance(size_t pool_size, uint32_t
 }
 
 BufferPoolManagerInstance::~BufferPoolManagerInstance() {
+  {
+    std::lock_guard<std::mutex> guard(prefetch_latch_);
+    stop_prefetch_ = true;
+  }
+  prefetch_cv_.notify_one();
+  if (prefetch_thread_.joinable()) {
+    prefetch_thread_.join();
+  }
   delete[] pages_;
   delete replacer_;
 }
@@ -101,7 +109,6 @@ Page *BufferPoolManagerInstance::FetchPgImp(page_id_t page_id) {
   if (frame_id != -1) {
     replacer_->Pin(frame_id);
     pages_[frame_id].pin_count_++;
-    pages_[frame_id].is_dirty_ = true;
     return &pages_[frame_id];
   }
 
@@ -132,6 +139,8 @@ bool BufferPoolManagerInstance::DeletePgImp(page_id_t page_id) {
     if (pages_[frame_id].GetPinCount() != 0) {
       return false;
     }
+    // The frame was unpinned into the replacer, take it out so that it is not handed out twice.
+    replacer_->Pin(frame_id);
     page_table_.erase(page_id);
     pages_[frame_id].page_id_ = INVALID_PAGE_ID;
     pages_[frame_id].is_dirty_ = false;
@@ -147,14 +156,73 @@ bool BufferPoolManagerInstance::UnpinPgImp(page_id_t page_id, bool is_dirty) {
   if (frame_id == -1 || pages_[frame_id].pin_count_ == 0) {
     return false;
   }
-  pages_[frame_id].is_dirty_ = is_dirty;
+  // Another thread may have dirtied the page while it was pinned here, never clear its flag.
+  if (is_dirty) {
+    pages_[frame_id].is_dirty_ = true;
+  }
   if (--pages_[frame_id].pin_count_ == 0) {
     replacer_->Unpin(frame_id);
     FlushPg(page_id);
+    pages_[frame_id].is_dirty_ = false;
   }
   return true;
 }
 
+std::future<void> BufferPoolManagerInstance::PrefetchPgImp(page_id_t page_id) {
+  std::promise<void> done;
+  std::future<void> future = done.get_future();
+  {
+    std::lock_guard<std::mutex> guard(prefetch_latch_);
+    if (prefetch_queue_.size() >= MAX_PREFETCH_QUEUE_SIZE) {
+      done.set_value();
+      return future;
+    }
+    prefetch_queue_.emplace_back(page_id, std::move(done));
+    if (!prefetch_thread_.joinable()) {
+      prefetch_thread_ = std::thread(&BufferPoolManagerInstance::PrefetchLoop, this);
+    }
+  }
+  prefetch_cv_.notify_one();
+  return future;
+}
+
+void BufferPoolManagerInstance::PrefetchLoop() {
+  std::unique_lock<std::mutex> lock(prefetch_latch_);
+  while (true) {
+    prefetch_cv_.wait(lock, [this] { return stop_prefetch_ || !prefetch_queue_.empty(); });
+    if (prefetch_queue_.empty()) {
+      return;
+    }
+    auto request = std::move(prefetch_queue_.front());
+    prefetch_queue_.pop_front();
+    // Requests still queued at shutdown are only completed, the disk manager may be gone already.
+    bool stop = stop_prefetch_;
+    lock.unlock();
+    if (!stop) {
+      PrefetchPg(request.first);
+    }
+    request.second.set_value();
+    lock.lock();
+  }
+}
+
+void BufferPoolManagerInstance::PrefetchPg(page_id_t page_id) {
+  std::lock_guard<std::mutex> lock_guard(latch_);
+  if (FindPage(page_id) != -1) {
+    return;
+  }
+  auto frame_id = FindFreshPage();
+  if (frame_id == -1) {
+    return;
+  }
+  page_table_[page_id] = frame_id;
+  pages_[frame_id].page_id_ = page_id;
+  pages_[frame_id].pin_count_ = 0;
+  pages_[frame_id].is_dirty_ = false;
+  disk_manager_->ReadPage(page_id, pages_[frame_id].GetData());
+  replacer_->Unpin(frame_id);
+}
+
 page_id_t BufferPoolManagerInstance::AllocatePage() {
   const page_id_t next_page_id = next_page_id_;
   next_page_id_ += num_instances_;
@@ -46,6 +46,11 @@ Page *ParallelBufferPoolManager::FetchPgImp(page_id_t page_id) {
   return GetBufferPoolManager(page_id)->FetchPage(page_id);
 }
 
+std::future<void> ParallelBufferPoolManager::PrefetchPgImp(page_id_t page_id) {
+  // Prefetch page for page_id through responsible BufferPoolManagerInstance
+  return GetBufferPoolManager(page_id)->PrefetchPage(page_id);
+}
+
 bool ParallelBufferPoolManager::UnpinPgImp(page_id_t page_id, bool is_dirty) {
   // Unpin page_id from responsible BufferPoolManagerInstance
   return GetBufferPoolManager(page_id)->UnpinPage(page_id, is_dirty);
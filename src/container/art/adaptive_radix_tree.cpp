@@ -0,0 +1,879 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// adaptive_radix_tree.cpp
+//
+// Identification: src/container/art/adaptive_radix_tree.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "container/art/adaptive_radix_tree.h"
+
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <thread>  // NOLINT
+
+#if defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+#include "common/rid.h"
+#include "storage/index/generic_key.h"
+
+namespace bustub {
+
+/*****************************************************************************
+ * VERSION LOCKS
+ *****************************************************************************/
+template <typename KeyType, typename ValueType>
+bool ADAPTIVE_RADIX_TREE_TYPE::Node::ReadLock(uint64_t *version) const {
+  uint64_t current = version_.load();
+  while ((current & LOCKED) != 0) {
+    std::this_thread::yield();
+    current = version_.load();
+  }
+  *version = current;
+  return (current & OBSOLETE) == 0;
+}
+
+template <typename KeyType, typename ValueType>
+bool ADAPTIVE_RADIX_TREE_TYPE::Node::Validate(uint64_t version) const {
+  // the reads of the node must not move past the check
+  std::atomic_thread_fence(std::memory_order_acquire);
+  return version_.load() == version;
+}
+
+template <typename KeyType, typename ValueType>
+bool ADAPTIVE_RADIX_TREE_TYPE::Node::Upgrade(uint64_t version) {
+  return version_.compare_exchange_strong(version, version + LOCKED);
+}
+
+template <typename KeyType, typename ValueType>
+bool ADAPTIVE_RADIX_TREE_TYPE::Node::WriteLock() {
+  while (true) {
+    uint64_t version;
+    if (!ReadLock(&version)) {
+      return false;
+    }
+    if (Upgrade(version)) {
+      return true;
+    }
+  }
+}
+
+/*****************************************************************************
+ * NODES
+ *****************************************************************************/
+template <typename KeyType, typename ValueType>
+bool ADAPTIVE_RADIX_TREE_TYPE::ReadPrefixLength(const Node *node, uint32_t level, uint32_t *prefix_len) {
+  *prefix_len = node->prefix_len_;
+  // every inner node branches on at least one more byte of the key
+  return level + *prefix_len < KEY_SIZE;
+}
+
+template <typename KeyType, typename ValueType>
+uint32_t ADAPTIVE_RADIX_TREE_TYPE::MatchPrefix(const Node *node, const uint8_t *key, uint32_t level,
+                                               uint32_t prefix_len) {
+  uint32_t i = 0;
+  while (i < prefix_len && node->prefix_[i] == key[level + i]) {
+    i++;
+  }
+  return i;
+}
+
+template <typename KeyType, typename ValueType>
+typename ADAPTIVE_RADIX_TREE_TYPE::Node *ADAPTIVE_RADIX_TREE_TYPE::FindChild(const Node *node, uint8_t byte) {
+  // The node may be changed concurrently, so the number of children is clamped to the capacity and the caller
+  // validates the node before it follows the child.
+  switch (node->type_) {
+    case NodeType::NODE4: {
+      auto *n = static_cast<const Node4 *>(node);
+      uint32_t num_children = std::min<uint32_t>(n->num_children_, 4);
+      for (uint32_t i = 0; i < num_children; i++) {
+        if (n->keys_[i] == byte) {
+          return n->children_[i];
+        }
+      }
+      return nullptr;
+    }
+    case NodeType::NODE16: {
+      auto *n = static_cast<const Node16 *>(node);
+      uint32_t num_children = std::min<uint32_t>(n->num_children_, 16);
+#if defined(__SSE2__)
+      auto hits = _mm_cmpeq_epi8(_mm_set1_epi8(static_cast<char>(byte)),
+                                 _mm_loadu_si128(reinterpret_cast<const __m128i *>(n->keys_)));
+      uint32_t matches = static_cast<uint32_t>(_mm_movemask_epi8(hits)) & ((1U << num_children) - 1);
+      return matches == 0 ? nullptr : n->children_[__builtin_ctz(matches)];
+#else
+      for (uint32_t i = 0; i < num_children; i++) {
+        if (n->keys_[i] == byte) {
+          return n->children_[i];
+        }
+      }
+      return nullptr;
+#endif
+    }
+    case NodeType::NODE48: {
+      auto *n = static_cast<const Node48 *>(node);
+      uint8_t slot = n->child_index_[byte];
+      return slot == 0 || slot > 48 ? nullptr : n->children_[slot - 1];
+    }
+    case NodeType::NODE256:
+      return static_cast<const Node256 *>(node)->children_[byte];
+  }
+  return nullptr;
+}
+
+template <typename KeyType, typename ValueType>
+typename ADAPTIVE_RADIX_TREE_TYPE::Node *ADAPTIVE_RADIX_TREE_TYPE::NextChild(const Node *node, uint32_t from,
+                                                                             uint8_t *byte) {
+  switch (node->type_) {
+    case NodeType::NODE4:
+    case NodeType::NODE16: {
+      const uint8_t *keys;
+      Node *const *children;
+      uint32_t num_children;
+      if (node->type_ == NodeType::NODE4) {
+        auto *n = static_cast<const Node4 *>(node);
+        keys = n->keys_;
+        children = n->children_;
+        num_children = std::min<uint32_t>(n->num_children_, 4);
+      } else {
+        auto *n = static_cast<const Node16 *>(node);
+        keys = n->keys_;
+        children = n->children_;
+        num_children = std::min<uint32_t>(n->num_children_, 16);
+      }
+      for (uint32_t i = 0; i < num_children; i++) {
+        if (keys[i] >= from) {
+          *byte = keys[i];
+          return children[i];
+        }
+      }
+      return nullptr;
+    }
+    case NodeType::NODE48: {
+      auto *n = static_cast<const Node48 *>(node);
+      for (uint32_t b = from; b < 256; b++) {
+        uint8_t slot = n->child_index_[b];
+        if (slot != 0 && slot <= 48 && n->children_[slot - 1] != nullptr) {
+          *byte = static_cast<uint8_t>(b);
+          return n->children_[slot - 1];
+        }
+      }
+      return nullptr;
+    }
+    case NodeType::NODE256: {
+      auto *n = static_cast<const Node256 *>(node);
+      for (uint32_t b = from; b < 256; b++) {
+        if (n->children_[b] != nullptr) {
+          *byte = static_cast<uint8_t>(b);
+          return n->children_[b];
+        }
+      }
+      return nullptr;
+    }
+  }
+  return nullptr;
+}
+
+template <typename KeyType, typename ValueType>
+bool ADAPTIVE_RADIX_TREE_TYPE::IsFull(const Node *node) {
+  switch (node->type_) {
+    case NodeType::NODE4:
+      return node->num_children_ == 4;
+    case NodeType::NODE16:
+      return node->num_children_ == 16;
+    case NodeType::NODE48:
+      return node->num_children_ == 48;
+    case NodeType::NODE256:
+      return false;
+  }
+  return false;
+}
+
+template <typename KeyType, typename ValueType>
+bool ADAPTIVE_RADIX_TREE_TYPE::IsUnderfull(const Node *node) {
+  // A node shrinks once the smaller type is a few children short of full after the removal, so that a node
+  // does not flip between two types when children are added and removed at the boundary.
+  switch (node->type_) {
+    case NodeType::NODE4:
+      return false;
+    case NodeType::NODE16:
+      return node->num_children_ <= 4;
+    case NodeType::NODE48:
+      return node->num_children_ <= 13;
+    case NodeType::NODE256:
+      return node->num_children_ <= 38;
+  }
+  return false;
+}
+
+template <typename KeyType, typename ValueType>
+void ADAPTIVE_RADIX_TREE_TYPE::AddChild(Node *node, uint8_t byte, Node *child) {
+  switch (node->type_) {
+    case NodeType::NODE4:
+    case NodeType::NODE16: {
+      uint8_t *keys;
+      Node **children;
+      if (node->type_ == NodeType::NODE4) {
+        keys = static_cast<Node4 *>(node)->keys_;
+        children = static_cast<Node4 *>(node)->children_;
+      } else {
+        keys = static_cast<Node16 *>(node)->keys_;
+        children = static_cast<Node16 *>(node)->children_;
+      }
+      uint32_t pos = 0;
+      while (pos < node->num_children_ && keys[pos] < byte) {
+        pos++;
+      }
+      memmove(keys + pos + 1, keys + pos, node->num_children_ - pos);
+      memmove(children + pos + 1, children + pos, (node->num_children_ - pos) * sizeof(Node *));
+      keys[pos] = byte;
+      children[pos] = child;
+      break;
+    }
+    case NodeType::NODE48: {
+      auto *n = static_cast<Node48 *>(node);
+      uint8_t slot = 0;
+      while (n->children_[slot] != nullptr) {
+        slot++;
+      }
+      n->children_[slot] = child;
+      n->child_index_[byte] = slot + 1;
+      break;
+    }
+    case NodeType::NODE256:
+      static_cast<Node256 *>(node)->children_[byte] = child;
+      break;
+  }
+  node->num_children_++;
+}
+
+template <typename KeyType, typename ValueType>
+void ADAPTIVE_RADIX_TREE_TYPE::ChangeChild(Node *node, uint8_t byte, Node *child) {
+  switch (node->type_) {
+    case NodeType::NODE4:
+    case NodeType::NODE16: {
+      uint8_t *keys;
+      Node **children;
+      if (node->type_ == NodeType::NODE4) {
+        keys = static_cast<Node4 *>(node)->keys_;
+        children = static_cast<Node4 *>(node)->children_;
+      } else {
+        keys = static_cast<Node16 *>(node)->keys_;
+        children = static_cast<Node16 *>(node)->children_;
+      }
+      for (uint32_t i = 0; i < node->num_children_; i++) {
+        if (keys[i] == byte) {
+          children[i] = child;
+          return;
+        }
+      }
+      UNREACHABLE("the node has no child for the byte");
+    }
+    case NodeType::NODE48: {
+      auto *n = static_cast<Node48 *>(node);
+      n->children_[n->child_index_[byte] - 1] = child;
+      break;
+    }
+    case NodeType::NODE256:
+      static_cast<Node256 *>(node)->children_[byte] = child;
+      break;
+  }
+}
+
+template <typename KeyType, typename ValueType>
+void ADAPTIVE_RADIX_TREE_TYPE::RemoveChild(Node *node, uint8_t byte) {
+  switch (node->type_) {
+    case NodeType::NODE4:
+    case NodeType::NODE16: {
+      uint8_t *keys;
+      Node **children;
+      if (node->type_ == NodeType::NODE4) {
+        keys = static_cast<Node4 *>(node)->keys_;
+        children = static_cast<Node4 *>(node)->children_;
+      } else {
+        keys = static_cast<Node16 *>(node)->keys_;
+        children = static_cast<Node16 *>(node)->children_;
+      }
+      uint32_t pos = 0;
+      while (keys[pos] != byte) {
+        pos++;
+      }
+      memmove(keys + pos, keys + pos + 1, node->num_children_ - pos - 1);
+      memmove(children + pos, children + pos + 1, (node->num_children_ - pos - 1) * sizeof(Node *));
+      break;
+    }
+    case NodeType::NODE48: {
+      auto *n = static_cast<Node48 *>(node);
+      n->children_[n->child_index_[byte] - 1] = nullptr;
+      n->child_index_[byte] = 0;
+      break;
+    }
+    case NodeType::NODE256:
+      static_cast<Node256 *>(node)->children_[byte] = nullptr;
+      break;
+  }
+  node->num_children_--;
+}
+
+template <typename KeyType, typename ValueType>
+typename ADAPTIVE_RADIX_TREE_TYPE::Node *ADAPTIVE_RADIX_TREE_TYPE::NewNode(NodeType type) {
+  switch (type) {
+    case NodeType::NODE4:
+      return new Node4();
+    case NodeType::NODE16:
+      return new Node16();
+    case NodeType::NODE48:
+      return new Node48();
+    case NodeType::NODE256:
+      return new Node256();
+  }
+  return nullptr;
+}
+
+template <typename KeyType, typename ValueType>
+typename ADAPTIVE_RADIX_TREE_TYPE::Node *ADAPTIVE_RADIX_TREE_TYPE::Grow(const Node *node) {
+  Node *bigger = NewNode(static_cast<NodeType>(static_cast<uint8_t>(node->type_) + 1));
+  bigger->prefix_len_ = node->prefix_len_;
+  memcpy(bigger->prefix_, node->prefix_, node->prefix_len_);
+  uint8_t byte;
+  for (Node *child = NextChild(node, 0, &byte); child != nullptr; child = NextChild(node, byte + 1U, &byte)) {
+    AddChild(bigger, byte, child);
+  }
+  return bigger;
+}
+
+template <typename KeyType, typename ValueType>
+typename ADAPTIVE_RADIX_TREE_TYPE::Node *ADAPTIVE_RADIX_TREE_TYPE::Shrink(const Node *node, uint8_t removed_byte) {
+  Node *smaller = NewNode(static_cast<NodeType>(static_cast<uint8_t>(node->type_) - 1));
+  smaller->prefix_len_ = node->prefix_len_;
+  memcpy(smaller->prefix_, node->prefix_, node->prefix_len_);
+  uint8_t byte;
+  for (Node *child = NextChild(node, 0, &byte); child != nullptr; child = NextChild(node, byte + 1U, &byte)) {
+    if (byte != removed_byte) {
+      AddChild(smaller, byte, child);
+    }
+  }
+  return smaller;
+}
+
+template <typename KeyType, typename ValueType>
+void ADAPTIVE_RADIX_TREE_TYPE::FreeNode(Node *node) {
+  if (IsLeaf(node)) {
+    delete AsLeaf(node);
+    return;
+  }
+  switch (node->type_) {
+    case NodeType::NODE4:
+      delete static_cast<Node4 *>(node);
+      break;
+    case NodeType::NODE16:
+      delete static_cast<Node16 *>(node);
+      break;
+    case NodeType::NODE48:
+      delete static_cast<Node48 *>(node);
+      break;
+    case NodeType::NODE256:
+      delete static_cast<Node256 *>(node);
+      break;
+  }
+}
+
+template <typename KeyType, typename ValueType>
+void ADAPTIVE_RADIX_TREE_TYPE::FreeSubtree(Node *node) {
+  if (!IsLeaf(node)) {
+    uint8_t byte;
+    for (Node *child = NextChild(node, 0, &byte); child != nullptr; child = NextChild(node, byte + 1U, &byte)) {
+      FreeSubtree(child);
+    }
+  }
+  FreeNode(node);
+}
+
+/*****************************************************************************
+ * TREE
+ *****************************************************************************/
+template <typename KeyType, typename ValueType>
+ADAPTIVE_RADIX_TREE_TYPE::AdaptiveRadixTree() : root_(new Node256()) {}
+
+template <typename KeyType, typename ValueType>
+ADAPTIVE_RADIX_TREE_TYPE::~AdaptiveRadixTree() {
+  FreeSubtree(root_);
+  for (auto &retired : garbage_) {
+    FreeNode(retired.second);
+  }
+}
+
+/*****************************************************************************
+ * SEARCH
+ *****************************************************************************/
+template <typename KeyType, typename ValueType>
+bool ADAPTIVE_RADIX_TREE_TYPE::GetValue(const KeyType &key, std::vector<ValueType> *result) {
+  EpochGuard guard(this);
+  Leaf *leaf;
+  while (!TryGetValue(KeyBytes(key), &leaf)) {
+  }
+  if (leaf == nullptr) {
+    return false;
+  }
+  result->push_back(leaf->value_);
+  return true;
+}
+
+template <typename KeyType, typename ValueType>
+bool ADAPTIVE_RADIX_TREE_TYPE::TryGetValue(const uint8_t *key, Leaf **leaf) {
+  *leaf = nullptr;
+  Node *node = root_;
+  uint64_t version;
+  if (!node->ReadLock(&version)) {
+    return false;
+  }
+  uint32_t level = 0;
+  while (true) {
+    uint32_t prefix_len;
+    if (!ReadPrefixLength(node, level, &prefix_len)) {
+      return false;
+    }
+    if (MatchPrefix(node, key, level, prefix_len) < prefix_len) {
+      return node->Validate(version);
+    }
+    level += prefix_len;
+    Node *child = FindChild(node, key[level]);
+    if (!node->Validate(version)) {
+      return false;
+    }
+    if (child == nullptr) {
+      return true;
+    }
+    if (IsLeaf(child)) {
+      // Leaves never change, and a removed leaf is not freed while this operation runs.
+      Leaf *candidate = AsLeaf(child);
+      if (memcmp(KeyBytes(candidate->key_), key, KEY_SIZE) == 0) {
+        *leaf = candidate;
+      }
+      return true;
+    }
+    uint64_t child_version;
+    if (!child->ReadLock(&child_version)) {
+      return false;
+    }
+    // The child may have been merged with its parent in the meantime, which changes both.
+    if (!node->Validate(version)) {
+      return false;
+    }
+    node = child;
+    version = child_version;
+    level++;
+  }
+}
+
+/*****************************************************************************
+ * INSERTION
+ *****************************************************************************/
+template <typename KeyType, typename ValueType>
+bool ADAPTIVE_RADIX_TREE_TYPE::Insert(const KeyType &key, const ValueType &value) {
+  EpochGuard guard(this);
+  auto *leaf = new Leaf{key, value};
+  bool inserted;
+  while (!TryInsert(leaf, &inserted)) {
+  }
+  if (!inserted) {
+    delete leaf;
+    return false;
+  }
+  size_++;
+  return true;
+}
+
+template <typename KeyType, typename ValueType>
+bool ADAPTIVE_RADIX_TREE_TYPE::TryInsert(Leaf *leaf, bool *inserted) {
+  const uint8_t *key = KeyBytes(leaf->key_);
+  Node *parent = nullptr;
+  uint64_t parent_version = 0;
+  uint8_t parent_byte = 0;
+  Node *node = root_;
+  uint64_t version;
+  if (!node->ReadLock(&version)) {
+    return false;
+  }
+  uint32_t level = 0;
+  while (true) {
+    uint32_t prefix_len;
+    if (!ReadPrefixLength(node, level, &prefix_len)) {
+      return false;
+    }
+    uint32_t matched = MatchPrefix(node, key, level, prefix_len);
+    if (matched < prefix_len) {
+      // The key leaves the node's prefix: a new node takes the matching part of the prefix, with the node and
+      // the leaf as its children. The root has no prefix, so the node has a parent.
+      if (!parent->Upgrade(parent_version)) {
+        return false;
+      }
+      if (!node->Upgrade(version)) {
+        parent->WriteUnlock();
+        return false;
+      }
+      Node *split = NewNode(NodeType::NODE4);
+      split->prefix_len_ = matched;
+      memcpy(split->prefix_, node->prefix_, matched);
+      AddChild(split, node->prefix_[matched], node);
+      AddChild(split, key[level + matched], LeafPointer(leaf));
+      node->prefix_len_ = prefix_len - matched - 1;
+      memmove(node->prefix_, node->prefix_ + matched + 1, node->prefix_len_);
+      ChangeChild(parent, parent_byte, split);
+      node->WriteUnlock();
+      parent->WriteUnlock();
+      *inserted = true;
+      return true;
+    }
+    level += prefix_len;
+    uint8_t byte = key[level];
+    Node *child = FindChild(node, byte);
+    if (!node->Validate(version)) {
+      return false;
+    }
+
+    if (child == nullptr) {
+      if (!IsFull(node)) {
+        if (!node->Upgrade(version)) {
+          return false;
+        }
+        AddChild(node, byte, LeafPointer(leaf));
+        node->WriteUnlock();
+        *inserted = true;
+        return true;
+      }
+      // The root never fills up, so the node has a parent that the larger copy is linked into.
+      if (!parent->Upgrade(parent_version)) {
+        return false;
+      }
+      if (!node->Upgrade(version)) {
+        parent->WriteUnlock();
+        return false;
+      }
+      Node *bigger = Grow(node);
+      AddChild(bigger, byte, LeafPointer(leaf));
+      ChangeChild(parent, parent_byte, bigger);
+      parent->WriteUnlock();
+      node->WriteUnlockObsolete();
+      Retire(node);
+      *inserted = true;
+      return true;
+    }
+
+    if (IsLeaf(child)) {
+      const uint8_t *other_key = KeyBytes(AsLeaf(child)->key_);
+      if (memcmp(other_key, key, KEY_SIZE) == 0) {
+        *inserted = false;
+        return true;
+      }
+      if (!node->Upgrade(version)) {
+        return false;
+      }
+      // Both keys match up to level, a new node holds the bytes they share after it and branches where they
+      // differ.
+      uint32_t common = level + 1;
+      while (other_key[common] == key[common]) {
+        common++;
+      }
+      Node *split = NewNode(NodeType::NODE4);
+      split->prefix_len_ = common - level - 1;
+      memcpy(split->prefix_, key + level + 1, split->prefix_len_);
+      AddChild(split, other_key[common], child);
+      AddChild(split, key[common], LeafPointer(leaf));
+      ChangeChild(node, byte, split);
+      node->WriteUnlock();
+      *inserted = true;
+      return true;
+    }
+
+    uint64_t child_version;
+    if (!child->ReadLock(&child_version)) {
+      return false;
+    }
+    if (!node->Validate(version)) {
+      return false;
+    }
+    parent = node;
+    parent_version = version;
+    parent_byte = byte;
+    node = child;
+    version = child_version;
+    level++;
+  }
+}
+
+/*****************************************************************************
+ * REMOVE
+ *****************************************************************************/
+template <typename KeyType, typename ValueType>
+bool ADAPTIVE_RADIX_TREE_TYPE::Remove(const KeyType &key) {
+  EpochGuard guard(this);
+  bool removed;
+  while (!TryRemove(KeyBytes(key), &removed)) {
+  }
+  if (removed) {
+    size_--;
+  }
+  return removed;
+}
+
+template <typename KeyType, typename ValueType>
+bool ADAPTIVE_RADIX_TREE_TYPE::TryRemove(const uint8_t *key, bool *removed) {
+  *removed = false;
+  Node *parent = nullptr;
+  uint64_t parent_version = 0;
+  uint8_t parent_byte = 0;
+  Node *node = root_;
+  uint64_t version;
+  if (!node->ReadLock(&version)) {
+    return false;
+  }
+  uint32_t level = 0;
+  while (true) {
+    uint32_t prefix_len;
+    if (!ReadPrefixLength(node, level, &prefix_len)) {
+      return false;
+    }
+    if (MatchPrefix(node, key, level, prefix_len) < prefix_len) {
+      return node->Validate(version);
+    }
+    level += prefix_len;
+    uint8_t byte = key[level];
+    Node *child = FindChild(node, byte);
+    if (!node->Validate(version)) {
+      return false;
+    }
+    if (child == nullptr) {
+      return true;
+    }
+
+    if (IsLeaf(child)) {
+      if (memcmp(KeyBytes(AsLeaf(child)->key_), key, KEY_SIZE) != 0) {
+        return true;
+      }
+      bool collapse = node->type_ == NodeType::NODE4 && node->num_children_ == 2;
+      if (node != root_ && (collapse || IsUnderfull(node))) {
+        // The node is replaced: by its other child if that is the only one left, by a smaller copy otherwise.
+        if (!parent->Upgrade(parent_version)) {
+          return false;
+        }
+        if (!node->Upgrade(version)) {
+          parent->WriteUnlock();
+          return false;
+        }
+        Node *replacement;
+        if (collapse) {
+          auto *n = static_cast<Node4 *>(node);
+          int other = n->keys_[0] == byte ? 1 : 0;
+          replacement = n->children_[other];
+          if (!IsLeaf(replacement)) {
+            // The other child takes over the node's prefix and the byte that led to it. It cannot be obsolete,
+            // since it is only replaced while its parent, the node, is locked.
+            replacement->WriteLock();
+            memmove(replacement->prefix_ + prefix_len + 1, replacement->prefix_, replacement->prefix_len_);
+            memcpy(replacement->prefix_, node->prefix_, prefix_len);
+            replacement->prefix_[prefix_len] = n->keys_[other];
+            replacement->prefix_len_ += prefix_len + 1;
+            replacement->WriteUnlock();
+          }
+        } else {
+          replacement = Shrink(node, byte);
+        }
+        ChangeChild(parent, parent_byte, replacement);
+        parent->WriteUnlock();
+        node->WriteUnlockObsolete();
+        Retire(node);
+      } else {
+        if (!node->Upgrade(version)) {
+          return false;
+        }
+        RemoveChild(node, byte);
+        node->WriteUnlock();
+      }
+      Retire(child);
+      *removed = true;
+      return true;
+    }
+
+    uint64_t child_version;
+    if (!child->ReadLock(&child_version)) {
+      return false;
+    }
+    if (!node->Validate(version)) {
+      return false;
+    }
+    parent = node;
+    parent_version = version;
+    parent_byte = byte;
+    node = child;
+    version = child_version;
+    level++;
+  }
+}
+
+/*****************************************************************************
+ * RANGE SCAN
+ *****************************************************************************/
+template <typename KeyType, typename ValueType>
+void ADAPTIVE_RADIX_TREE_TYPE::Scan(const KeyType *low, const KeyType *high, size_t max_pairs,
+                                    std::vector<std::pair<KeyType, ValueType>> *result) {
+  if (max_pairs == 0) {
+    return;
+  }
+  EpochGuard guard(this);
+  ScanContext context{low == nullptr ? nullptr : KeyBytes(*low), false, high == nullptr ? nullptr : KeyBytes(*high),
+                      max_pairs, 0, result};
+  KeyType resume_key;
+  while (true) {
+    uint64_t version;
+    if (root_->ReadLock(&version) &&
+        ScanNode(root_, version, 0, context.low_ != nullptr, context.high_ != nullptr, &context) !=
+            ScanState::RESTART) {
+      return;
+    }
+    // Resume after the last pair, the pairs before it are already in the result.
+    if (context.num_pairs_ > 0) {
+      resume_key = result->back().first;
+      context.low_ = KeyBytes(resume_key);
+      context.low_exclusive_ = true;
+    }
+  }
+}
+
+template <typename KeyType, typename ValueType>
+typename ADAPTIVE_RADIX_TREE_TYPE::ScanState ADAPTIVE_RADIX_TREE_TYPE::ScanNode(Node *node, uint64_t version,
+                                                                               uint32_t level, bool on_low,
+                                                                               bool on_high, ScanContext *context) {
+  uint32_t prefix_len;
+  if (!ReadPrefixLength(node, level, &prefix_len)) {
+    return ScanState::RESTART;
+  }
+  uint8_t prefix[KEY_SIZE];
+  memcpy(prefix, node->prefix_, prefix_len);
+  if (!node->Validate(version)) {
+    return ScanState::RESTART;
+  }
+  // The subtree is skipped if its prefix is below the lower bound, and ends the scan if it is above the upper
+  // bound. Once the prefix exceeds a bound, the bound no longer restricts the keys below.
+  for (uint32_t i = 0; i < prefix_len && (on_low || on_high); i++) {
+    if (on_low && prefix[i] != context->low_[level + i]) {
+      if (prefix[i] < context->low_[level + i]) {
+        return ScanState::CONTINUE;
+      }
+      on_low = false;
+    }
+    if (on_high && prefix[i] != context->high_[level + i]) {
+      if (prefix[i] > context->high_[level + i]) {
+        return ScanState::DONE;
+      }
+      on_high = false;
+    }
+  }
+  level += prefix_len;
+
+  uint8_t byte;
+  for (uint32_t from = on_low ? context->low_[level] : 0; from < 256; from = byte + 1U) {
+    Node *child = NextChild(node, from, &byte);
+    if (!node->Validate(version)) {
+      return ScanState::RESTART;
+    }
+    if (child == nullptr) {
+      return ScanState::CONTINUE;
+    }
+    if (on_high && byte > context->high_[level]) {
+      return ScanState::DONE;
+    }
+    if (IsLeaf(child)) {
+      Leaf *leaf = AsLeaf(child);
+      const uint8_t *key = KeyBytes(leaf->key_);
+      if (context->low_ != nullptr) {
+        int cmp = memcmp(key, context->low_, KEY_SIZE);
+        if (cmp < 0 || (cmp == 0 && context->low_exclusive_)) {
+          continue;
+        }
+      }
+      if (context->high_ != nullptr && memcmp(key, context->high_, KEY_SIZE) > 0) {
+        return ScanState::DONE;
+      }
+      context->result_->emplace_back(leaf->key_, leaf->value_);
+      if (++context->num_pairs_ == context->max_pairs_) {
+        return ScanState::DONE;
+      }
+      continue;
+    }
+    uint64_t child_version;
+    if (!child->ReadLock(&child_version) || !node->Validate(version)) {
+      return ScanState::RESTART;
+    }
+    ScanState state = ScanNode(child, child_version, level + 1, on_low && byte == context->low_[level],
+                               on_high && byte == context->high_[level], context);
+    if (state != ScanState::CONTINUE) {
+      return state;
+    }
+  }
+  return ScanState::CONTINUE;
+}
+
+/*****************************************************************************
+ * MEMORY RECLAMATION
+ *****************************************************************************/
+template <typename KeyType, typename ValueType>
+size_t ADAPTIVE_RADIX_TREE_TYPE::EnterEpoch() {
+  size_t slot = std::hash<std::thread::id>()(std::this_thread::get_id()) % NUM_EPOCH_SLOTS;
+  while (true) {
+    uint64_t free_slot = 0;
+    if (epoch_slots_[slot].epoch_.load() == 0 &&
+        epoch_slots_[slot].epoch_.compare_exchange_strong(free_slot, global_epoch_.load())) {
+      return slot;
+    }
+    slot = (slot + 1) % NUM_EPOCH_SLOTS;
+  }
+}
+
+template <typename KeyType, typename ValueType>
+void ADAPTIVE_RADIX_TREE_TYPE::Retire(Node *node) {
+  std::lock_guard<std::mutex> guard(garbage_latch_);
+  // Every retirement starts a new epoch. An operation that entered in a later epoch started after the node was
+  // unlinked, so it cannot reach it.
+  garbage_.emplace_back(global_epoch_.fetch_add(1), node);
+  if (garbage_.size() >= RECLAIM_THRESHOLD) {
+    Reclaim();
+  }
+}
+
+template <typename KeyType, typename ValueType>
+void ADAPTIVE_RADIX_TREE_TYPE::Reclaim() {
+  uint64_t oldest = std::numeric_limits<uint64_t>::max();
+  for (const auto &slot : epoch_slots_) {
+    uint64_t epoch = slot.epoch_.load();
+    if (epoch != 0) {
+      oldest = std::min(oldest, epoch);
+    }
+  }
+  auto unreachable = std::partition(garbage_.begin(), garbage_.end(), [oldest](const auto &retired) {
+    return retired.first >= oldest;
+  });
+  for (auto it = unreachable; it != garbage_.end(); ++it) {
+    FreeNode(it->second);
+  }
+  garbage_.erase(unreachable, garbage_.end());
+}
+
+/*****************************************************************************
+ * TEMPLATE DEFINITIONS - DO NOT TOUCH
+ *****************************************************************************/
+template class AdaptiveRadixTree<GenericKey<4>, RID>;
+template class AdaptiveRadixTree<GenericKey<8>, RID>;
+template class AdaptiveRadixTree<GenericKey<16>, RID>;
+template class AdaptiveRadixTree<GenericKey<32>, RID>;
+template class AdaptiveRadixTree<GenericKey<64>, RID>;
+
+}  // namespace bustub
@@ -10,9 +10,15 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
+#include <array>
 #include <cmath>
+#include <cstring>
 #include <iostream>
 #include <string>
+#include <thread>  // NOLINT
+#include <tuple>
+#include <unordered_map>
 #include <vector>
 
 #include "common/exception.h"
@@ -25,28 +31,41 @@ namespace bustub {
 template <typename KeyType, typename ValueType, typename KeyComparator>
 HASH_TABLE_TYPE::ExtendibleHashTable(const std::string &name, BufferPoolManager *buffer_pool_manager,
                                      const KeyComparator &comparator, HashFunction<KeyType> hash_fn)
+    : ExtendibleHashTable(name, buffer_pool_manager, comparator,
+                          std::make_unique<HashFunction<KeyType>>(std::move(hash_fn))) {}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+HASH_TABLE_TYPE::ExtendibleHashTable(const std::string &name, BufferPoolManager *buffer_pool_manager,
+                                     const KeyComparator &comparator, std::unique_ptr<HashFunction<KeyType>> hash_fn)
     : buffer_pool_manager_(buffer_pool_manager), comparator_(comparator), hash_fn_(std::move(hash_fn)) {
-  auto dir_page = buffer_pool_manager_->NewPage(&directory_page_id_);
-  auto dir_page_data = reinterpret_cast<HashTableDirectoryPage *>(dir_page->GetData());
+  auto header_page_data =
+      reinterpret_cast<HashTableHeaderPage *>(buffer_pool_manager_->NewPage(&header_page_id_)->GetData());
+  page_id_t directory_page_id;
+  auto dir_page_data =
+      reinterpret_cast<HashTableDirectoryPage *>(buffer_pool_manager_->NewPage(&directory_page_id)->GetData());
 
   // initially, there should be two buckets
   page_id_t bucket_0_page_id;
   page_id_t bucket_1_page_id;
-  buffer_pool_manager_->NewPage(&bucket_0_page_id);
-  buffer_pool_manager_->NewPage(&bucket_1_page_id);
+  reinterpret_cast<HASH_TABLE_BUCKET_TYPE *>(buffer_pool_manager_->NewPage(&bucket_0_page_id)->GetData())->Init();
+  reinterpret_cast<HASH_TABLE_BUCKET_TYPE *>(buffer_pool_manager_->NewPage(&bucket_1_page_id)->GetData())->Init();
   dir_page_data->SetBucketPageId(0, bucket_0_page_id);
   dir_page_data->SetLocalDepth(0, 1);
   dir_page_data->SetBucketPageId(1, bucket_1_page_id);
   dir_page_data->SetLocalDepth(1, 1);
 
-  // remeber update directory page
+  // remeber update directory page and the header page
   dir_page_data->IncrGlobalDepth();
-  dir_page_data->SetPageId(directory_page_id_);
+  dir_page_data->SetPageId(directory_page_id);
+  header_page_data->IncrGlobalDepth();
+  header_page_data->SetDirectoryPageId(0, directory_page_id);
+  header_page_data->SetPageId(header_page_id_);
 
   // unpin the pages
-  buffer_pool_manager_->UnpinPage(directory_page_id_, true);
-  buffer_pool_manager_->UnpinPage(bucket_0_page_id, false);
-  buffer_pool_manager_->UnpinPage(bucket_1_page_id, false);
+  buffer_pool_manager_->UnpinPage(header_page_id_, true);
+  buffer_pool_manager_->UnpinPage(directory_page_id, true);
+  buffer_pool_manager_->UnpinPage(bucket_0_page_id, true);
+  buffer_pool_manager_->UnpinPage(bucket_1_page_id, true);
 }
 
 /*****************************************************************************
@@ -61,22 +80,64 @@ HASH_TABLE_TYPE::ExtendibleHashTable(const std::string &name, BufferPoolManager
  */
 template <typename KeyType, typename ValueType, typename KeyComparator>
 uint32_t HASH_TABLE_TYPE::Hash(KeyType key) {
-  return static_cast<uint32_t>(hash_fn_.GetHash(key));
+  return static_cast<uint32_t>(hash_fn_->GetHash(key));
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+inline uint32_t HASH_TABLE_TYPE::KeyToDirectoryIndex(KeyType key, HashTableHeaderPage *header_page) {
+  return Hash(key) & header_page->GetGlobalDepthMask();
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+inline page_id_t HASH_TABLE_TYPE::KeyToPageId(KeyType key, HashTableHeaderPage *header_page) {
+  return HashToPageId(Hash(key), header_page);
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+inline page_id_t HASH_TABLE_TYPE::HashToPageId(uint32_t hash, HashTableHeaderPage *header_page) {
+  auto bucket_idx = hash & header_page->GetGlobalDepthMask();
+  auto dir_page_data = FetchDirectoryPage(header_page, bucket_idx);
+  auto bucket_page_id = dir_page_data->GetBucketPageId(bucket_idx % DIRECTORY_ARRAY_SIZE);
+  buffer_pool_manager_->UnpinPage(dir_page_data->GetPageId(), false);
+  return bucket_page_id;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+HashTableHeaderPage *HASH_TABLE_TYPE::FetchHeaderPage() {
+  return reinterpret_cast<HashTableHeaderPage *>(buffer_pool_manager_->FetchPage(header_page_id_)->GetData());
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
-inline uint32_t HASH_TABLE_TYPE::KeyToDirectoryIndex(KeyType key, HashTableDirectoryPage *dir_page) {
-  return Hash(key) & dir_page->GetGlobalDepthMask();
+HashTableDirectoryPage *HASH_TABLE_TYPE::FetchDirectoryPage(HashTableHeaderPage *header_page, uint32_t bucket_idx) {
+  auto directory_page = buffer_pool_manager_->FetchPage(header_page->GetDirectoryPageId(bucket_idx));
+  return reinterpret_cast<HashTableDirectoryPage *>(directory_page->GetData());
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
-inline page_id_t HASH_TABLE_TYPE::KeyToPageId(KeyType key, HashTableDirectoryPage *dir_page) {
-  return dir_page->GetBucketPageId(KeyToDirectoryIndex(key, dir_page));
+template <typename Visitor>
+void HASH_TABLE_TYPE::ForEachDirectorySlot(HashTableHeaderPage *header_page, uint32_t bucket_idx, uint32_t depth,
+                                           bool is_dirty, Visitor &&visit) {
+  uint32_t step = 1U << depth;
+  HashTableDirectoryPage *dir_page_data = nullptr;
+  for (uint32_t i = bucket_idx & (step - 1); i < header_page->Size(); i += step) {
+    if (dir_page_data == nullptr || i % DIRECTORY_ARRAY_SIZE < step) {
+      // i is the first index of its directory page that matches.
+      if (dir_page_data != nullptr) {
+        buffer_pool_manager_->UnpinPage(dir_page_data->GetPageId(), is_dirty);
+      }
+      dir_page_data = FetchDirectoryPage(header_page, i);
+    }
+    visit(dir_page_data, i % DIRECTORY_ARRAY_SIZE, i);
+  }
+  buffer_pool_manager_->UnpinPage(dir_page_data->GetPageId(), is_dirty);
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
-HashTableDirectoryPage *HASH_TABLE_TYPE::FetchDirectoryPage() {
-  return reinterpret_cast<HashTableDirectoryPage *>(buffer_pool_manager_->FetchPage(directory_page_id_)->GetData());
+uint32_t HASH_TABLE_TYPE::GetLocalDepth(HashTableHeaderPage *header_page, uint32_t bucket_idx) {
+  auto dir_page_data = FetchDirectoryPage(header_page, bucket_idx);
+  auto local_depth = dir_page_data->GetLocalDepth(bucket_idx % DIRECTORY_ARRAY_SIZE);
+  buffer_pool_manager_->UnpinPage(dir_page_data->GetPageId(), false);
+  return local_depth;
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
@@ -91,6 +152,87 @@ uint32_t HASH_TABLE_TYPE::Pow(uint32_t base, uint32_t power) const {
   return static_cast<uint32_t>(std::pow(static_cast<long double>(base), static_cast<long double>(power)));
 }
 
+template <typename KeyType, typename ValueType, typename KeyComparator>
+uint64_t HASH_TABLE_TYPE::BeginDirectoryRead() {
+  auto version = directory_version_.load();
+  while ((version & 1) != 0) {
+    std::this_thread::yield();
+    version = directory_version_.load();
+  }
+  return version;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+std::pair<Page *, HASH_TABLE_BUCKET_TYPE *> HASH_TABLE_TYPE::LatchBucketPage(uint32_t hash,
+                                                                             HashTableHeaderPage *header_page,
+                                                                             bool exclusive) {
+  while (true) {
+    auto version = BeginDirectoryRead();
+    auto [bucket_page, bucket_page_data] = FetchBucketPage(HashToPageId(hash, header_page));
+    exclusive ? bucket_page->WLatch() : bucket_page->RLatch();
+    // a split moves entries while it holds the bucket latch, and bumps the version before it releases it.
+    // So if the version did not change, the directory pointed to this bucket and the bucket is up to date.
+    if (directory_version_.load() == version) {
+      return {bucket_page, bucket_page_data};
+    }
+    exclusive ? bucket_page->WUnlatch() : bucket_page->RUnlatch();
+    buffer_pool_manager_->UnpinPage(bucket_page->GetPageId(), false);
+  }
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+uint32_t HASH_TABLE_TYPE::OverflowHash(HASH_TABLE_BUCKET_TYPE *bucket_page_data) {
+  // the first page of a chain is never empty.
+  uint32_t i = 0;
+  while (!bucket_page_data->IsReadable(i)) {
+    i++;
+  }
+  return Hash(bucket_page_data->KeyAt(i));
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+bool HASH_TABLE_TYPE::FitsBucket(HASH_TABLE_BUCKET_TYPE *bucket_page_data, uint32_t hash) {
+  if (bucket_page_data->GetOverflowPageId() != INVALID_PAGE_ID) {
+    return OverflowHash(bucket_page_data) == hash;
+  }
+  if (!bucket_page_data->IsFull()) {
+    return true;
+  }
+  // a full bucket can only overflow if splitting would never separate its entries from the key. The tags rule
+  // out most buckets before any key is hashed.
+  auto tag = HashToTag(hash);
+  for (uint32_t i = 0; i < BUCKET_ARRAY_SIZE; i++) {
+    if (bucket_page_data->TagAt(i) != tag) {
+      return false;
+    }
+  }
+  for (uint32_t i = 0; i < BUCKET_ARRAY_SIZE; i++) {
+    if (Hash(bucket_page_data->KeyAt(i)) != hash) {
+      return false;
+    }
+  }
+  return true;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+bool HASH_TABLE_TYPE::GetValueInChain(HASH_TABLE_BUCKET_TYPE *bucket_page_data, const KeyType &key,
+                                      std::vector<ValueType> *result, uint32_t hash) {
+  auto tag = HashToTag(hash);
+  auto found = bucket_page_data->GetValue(key, comparator_, result, tag);
+  if (bucket_page_data->GetOverflowPageId() == INVALID_PAGE_ID || OverflowHash(bucket_page_data) != hash) {
+    return found;
+  }
+  auto page_id = bucket_page_data->GetOverflowPageId();
+  while (page_id != INVALID_PAGE_ID) {
+    auto page_data = FetchBucketPage(page_id).second;
+    found = page_data->GetValue(key, comparator_, result, tag) || found;
+    auto next_page_id = page_data->GetOverflowPageId();
+    buffer_pool_manager_->UnpinPage(page_id, false);
+    page_id = next_page_id;
+  }
+  return found;
+}
+
 /*****************************************************************************
  * SEARCH
  *****************************************************************************/
@@ -98,19 +240,110 @@ template <typename KeyType, typename ValueType, typename KeyComparator>
 bool HASH_TABLE_TYPE::GetValue(Transaction *transaction, const KeyType &key, std::vector<ValueType> *result) {
   table_latch_.RLock();
 
-  auto dir_page_data = FetchDirectoryPage();
-  auto bucket_page_id = KeyToPageId(key, dir_page_data);
-  auto [bucket_page, bucket_page_data] = FetchBucketPage(bucket_page_id);
-  bucket_page->RLatch();
-  auto success = bucket_page_data->GetValue(key, comparator_, result);
-  buffer_pool_manager_->UnpinPage(bucket_page_id, false);
-  buffer_pool_manager_->UnpinPage(directory_page_id_, false);
+  auto hash = Hash(key);
+  auto header_page_data = FetchHeaderPage();
+  auto [bucket_page, bucket_page_data] = LatchBucketPage(hash, header_page_data, false);
+  auto success = GetValueInChain(bucket_page_data, key, result, hash);
+  buffer_pool_manager_->UnpinPage(bucket_page->GetPageId(), false);
+  buffer_pool_manager_->UnpinPage(header_page_id_, false);
   bucket_page->RUnlatch();
 
   table_latch_.RUnlock();
   return success;
 }
 
+template <typename KeyType, typename ValueType, typename KeyComparator>
+size_t HASH_TABLE_TYPE::GetValues(Transaction *transaction, const std::vector<KeyType> &keys,
+                                  std::vector<std::vector<ValueType>> *results) {
+  results->assign(keys.size(), std::vector<ValueType>());
+  table_latch_.RLock();
+
+  // the keys of a bucket agree in the low local depth bits of their hashes. Sorted by the bit-reversed hash, they
+  // are next to each other whatever the local depth is.
+  std::vector<uint32_t> hashes(keys.size());
+  std::vector<uint32_t> reversed_hashes(keys.size());
+  std::vector<size_t> order(keys.size());
+  for (size_t i = 0; i < keys.size(); i++) {
+    hashes[i] = Hash(keys[i]);
+    uint32_t reversed = 0;
+    for (uint32_t bits = hashes[i], j = 0; j < 32; j++, bits >>= 1) {
+      reversed = (reversed << 1) | (bits & 1);
+    }
+    reversed_hashes[i] = reversed;
+    order[i] = i;
+  }
+  std::sort(order.begin(), order.end(), [&](size_t a, size_t b) { return reversed_hashes[a] < reversed_hashes[b]; });
+
+  // A probe looks up the keys order[begin_, end_) of one bucket. Once its bucket is set, it has been prefetched and
+  // is waiting for its scan.
+  struct Probe {
+    size_t begin_;
+    size_t end_;
+    uint64_t version_;
+    Page *bucket_page_;
+    HASH_TABLE_BUCKET_TYPE *bucket_page_data_{nullptr};
+  };
+  std::array<Probe, PROBE_GROUP_SIZE> group;
+  auto header_page_data = FetchHeaderPage();
+  auto start_probe = [&](Probe *probe) {
+    probe->version_ = BeginDirectoryRead();
+    auto hash = hashes[order[probe->begin_]];
+    auto bucket_idx = hash & header_page_data->GetGlobalDepthMask();
+    auto dir_page_data = FetchDirectoryPage(header_page_data, bucket_idx);
+    auto local_depth_mask = dir_page_data->GetLocalDepthMask(bucket_idx % DIRECTORY_ARRAY_SIZE);
+    std::tie(probe->bucket_page_, probe->bucket_page_data_) =
+        FetchBucketPage(dir_page_data->GetBucketPageId(bucket_idx % DIRECTORY_ARRAY_SIZE));
+    buffer_pool_manager_->UnpinPage(dir_page_data->GetPageId(), false);
+    probe->bucket_page_data_->Prefetch();
+    probe->end_ = probe->begin_ + 1;
+    while (probe->end_ < keys.size() && ((hashes[order[probe->end_]] ^ hash) & local_depth_mask) == 0) {
+      probe->end_++;
+    }
+  };
+  size_t num_found = 0;
+  size_t next_key = 0;
+  uint32_t num_in_flight = 0;
+  do {
+    for (auto &probe : group) {
+      if (probe.bucket_page_data_ != nullptr) {
+        probe.bucket_page_->RLatch();
+        auto is_valid = directory_version_.load() == probe.version_;
+        for (size_t i = probe.begin_; i < probe.end_ && is_valid; i++) {
+          auto key_idx = order[i];
+          if (GetValueInChain(probe.bucket_page_data_, keys[key_idx], &(*results)[key_idx], hashes[key_idx])) {
+            num_found++;
+          }
+        }
+        buffer_pool_manager_->UnpinPage(probe.bucket_page_->GetPageId(), false);
+        probe.bucket_page_->RUnlatch();
+        // a split got in between, so the keys may belong to several buckets by now. They are looked up one by one.
+        for (size_t i = probe.begin_; i < probe.end_ && !is_valid; i++) {
+          auto key_idx = order[i];
+          auto [bucket_page, bucket_page_data] = LatchBucketPage(hashes[key_idx], header_page_data, false);
+          if (GetValueInChain(bucket_page_data, keys[key_idx], &(*results)[key_idx], hashes[key_idx])) {
+            num_found++;
+          }
+          buffer_pool_manager_->UnpinPage(bucket_page->GetPageId(), false);
+          bucket_page->RUnlatch();
+        }
+        probe.bucket_page_data_ = nullptr;
+        num_in_flight--;
+      }
+      // refill the slot with the next bucket right away, so that its prefetch overlaps with the other scans.
+      if (next_key < keys.size()) {
+        probe.begin_ = next_key;
+        start_probe(&probe);
+        next_key = probe.end_;
+        num_in_flight++;
+      }
+    }
+  } while (num_in_flight > 0);
+  buffer_pool_manager_->UnpinPage(header_page_id_, false);
+
+  table_latch_.RUnlock();
+  return num_found;
+}
+
 /*****************************************************************************
  * INSERTION
  *****************************************************************************/
@@ -118,22 +351,22 @@ template <typename KeyType, typename ValueType, typename KeyComparator>
 bool HASH_TABLE_TYPE::Insert(Transaction *transaction, const KeyType &key, const ValueType &value) {
   table_latch_.RLock();
 
-  auto dir_page_data = FetchDirectoryPage();
-  auto bucket_page_id = KeyToPageId(key, dir_page_data);
-  auto [bucket_page, bucket_page_data] = FetchBucketPage(bucket_page_id);
-  bucket_page->WLatch();
+  auto hash = Hash(key);
+  auto header_page_data = FetchHeaderPage();
+  auto [bucket_page, bucket_page_data] = LatchBucketPage(hash, header_page_data, true);
+  auto bucket_page_id = bucket_page->GetPageId();
 
-  // if the bucket is full, the insertion is handed over to SplitInsert() to complete.
-  if (bucket_page_data->IsFull()) {
+  // if the bucket has to be split, the insertion is handed over to SplitInsert() to complete.
+  if (!FitsBucket(bucket_page_data, hash)) {
     buffer_pool_manager_->UnpinPage(bucket_page_id, false);
-    buffer_pool_manager_->UnpinPage(directory_page_id_, false);
+    buffer_pool_manager_->UnpinPage(header_page_id_, false);
     bucket_page->WUnlatch();
     table_latch_.RUnlock();
     return SplitInsert(transaction, key, value);
   }
-  auto success = bucket_page_data->Insert(key, value, comparator_);
+  auto success = InsertIntoChain(bucket_page_data, key, value, hash);
   buffer_pool_manager_->UnpinPage(bucket_page_id, success);
-  buffer_pool_manager_->UnpinPage(directory_page_id_, false);
+  buffer_pool_manager_->UnpinPage(header_page_id_, false);
   bucket_page->WUnlatch();
 
   table_latch_.RUnlock();
@@ -142,79 +375,182 @@ bool HASH_TABLE_TYPE::Insert(Transaction *transaction, const KeyType &key, const
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
 bool HASH_TABLE_TYPE::SplitInsert(Transaction *transaction, const KeyType &key, const ValueType &value) {
-  table_latch_.WLock();
+  table_latch_.RLock();
 
   auto success = false;
   auto inserted = false;
-  auto is_growing = false;
-  auto dir_page_data = FetchDirectoryPage();
+  auto is_grown = false;
+  auto hash = Hash(key);
+  auto header_page = buffer_pool_manager_->FetchPage(header_page_id_);
+  auto header_page_data = reinterpret_cast<HashTableHeaderPage *>(header_page->GetData());
 
   // insert the key-value pair into the corresponding bucket.
   // If the bucket is full, split until it is successfully inserted into the bucket.
   while (!inserted) {
-    auto old_global_depth = dir_page_data->GetGlobalDepth();
-    auto bucket_idx = KeyToDirectoryIndex(key, dir_page_data);
-    auto bucket_page_id = KeyToPageId(key, dir_page_data);
+    // the header latch serializes splits, so the directory can be read directly here.
+    header_page->WLatch();
+    auto bucket_idx = hash & header_page_data->GetGlobalDepthMask();
+    auto bucket_page_id = HashToPageId(hash, header_page_data);
     auto [bucket_page, bucket_page_data] = FetchBucketPage(bucket_page_id);
     bucket_page->WLatch();
 
-    // split the bucket
-    if (bucket_page_data->IsFull()) {
-      // first check whether we need to grow the directory
-      if (dir_page_data->GetLocalDepth(bucket_idx) == dir_page_data->GetGlobalDepth()) {
-        dir_page_data->IncrGlobalDepth();
-        is_growing = true;
+    if (FitsBucket(bucket_page_data, hash)) {
+      // the bucket is not full (anymore) or overflows, so we can insert the key-value directly.
+      header_page->WUnlatch();
+      success = InsertIntoChain(bucket_page_data, key, value, hash);
+      inserted = true;
+    } else if (GetLocalDepth(header_page_data, bucket_idx) < header_page_data->GetGlobalDepth()) {
+      SplitBucket(header_page_data, bucket_idx, bucket_page_data);
+      header_page->WUnlatch();
+    } else {
+      // the bucket needs a deeper directory first, which blocks the whole table.
+      buffer_pool_manager_->UnpinPage(bucket_page_id, false);
+      bucket_page->WUnlatch();
+      header_page->WUnlatch();
+      table_latch_.RUnlock();
+      auto can_grow = GrowDirectory(key, header_page_data);
+      table_latch_.RLock();
+      is_grown = true;
+      if (!can_grow) {
+        break;
       }
+      continue;
+    }
+    buffer_pool_manager_->UnpinPage(bucket_page_id, true);
+    bucket_page->WUnlatch();
+  }
+  buffer_pool_manager_->UnpinPage(header_page_id_, is_grown);
 
-      // second find the bucket pair, and update them
-      dir_page_data->IncrLocalDepth(bucket_idx);
-      auto split_bucket_idx = dir_page_data->GetSplitImageIndex(bucket_idx);
-      page_id_t split_page_id;
-      auto split_page_data =
-          reinterpret_cast<HASH_TABLE_BUCKET_TYPE *>(buffer_pool_manager_->NewPage(&split_page_id)->GetData());
-      dir_page_data->SetBucketPageId(split_bucket_idx, split_page_id);
-      dir_page_data->SetLocalDepth(split_bucket_idx, dir_page_data->GetLocalDepth(bucket_idx));
-
-      // rehash all key-value pairs in the bucket pair
-      uint32_t num_read = 0;
-      uint32_t num_readable = bucket_page_data->NumReadable();
-      while (num_read != num_readable) {
-        if (bucket_page_data->IsReadable(num_read)) {
-          auto key = bucket_page_data->KeyAt(num_read);
-          uint32_t which_bucket = Hash(key) & (Pow(2, dir_page_data->GetLocalDepth(bucket_idx)) - 1);
-          if ((which_bucket ^ split_bucket_idx) == 0) {
-            // remove from the original bucket and insert the new bucket
-            auto value = bucket_page_data->ValueAt(num_read);
-            split_page_data->Insert(key, value, comparator_);
-            bucket_page_data->RemoveAt(num_read);
-          }
-          num_read++;
-        }
-      }
-      buffer_pool_manager_->UnpinPage(split_page_id, true);
+  table_latch_.RUnlock();
+  return success;
+}
 
-      // redirect the reset of the buckets.
-      //! for more info, see VerifyIntegrity().
-      for (uint32_t i = Pow(2, old_global_depth); i < dir_page_data->Size(); i++) {
-        if (i == split_bucket_idx) {
-          continue;
-        }
-        uint32_t redirect_bucket_idx = i & (Pow(2, old_global_depth) - 1);
-        dir_page_data->SetBucketPageId(i, dir_page_data->GetBucketPageId(redirect_bucket_idx));
-        dir_page_data->SetLocalDepth(i, dir_page_data->GetLocalDepth(redirect_bucket_idx));
+template <typename KeyType, typename ValueType, typename KeyComparator>
+bool HASH_TABLE_TYPE::InsertIntoChain(HASH_TABLE_BUCKET_TYPE *bucket_page_data, const KeyType &key,
+                                      const ValueType &value, uint32_t hash) {
+  if (bucket_page_data->GetOverflowPageId() == INVALID_PAGE_ID && !bucket_page_data->IsFull()) {
+    return bucket_page_data->Insert(key, value, comparator_, HashToTag(hash));
+  }
+  // a bucket page only rejects duplicates among its own entries, the chain is checked as a whole.
+  std::vector<ValueType> values;
+  GetValueInChain(bucket_page_data, key, &values, hash);
+  if (std::find(values.begin(), values.end(), value) != values.end()) {
+    return false;
+  }
+
+  // the first page is pinned by the caller, the pages after it by this loop.
+  page_id_t page_id = INVALID_PAGE_ID;
+  auto page_data = bucket_page_data;
+  while (page_data->IsFull()) {
+    auto next_page_id = page_data->GetOverflowPageId();
+    auto is_linked = next_page_id == INVALID_PAGE_ID;
+    HASH_TABLE_BUCKET_TYPE *next_page_data;
+    if (is_linked) {
+      auto next_page = buffer_pool_manager_->NewPage(&next_page_id);
+      next_page_data = reinterpret_cast<HASH_TABLE_BUCKET_TYPE *>(next_page->GetData());
+      next_page_data->Init();
+      page_data->SetOverflowPageId(next_page_id);
+    } else {
+      next_page_data = FetchBucketPage(next_page_id).second;
+    }
+    if (page_id != INVALID_PAGE_ID) {
+      buffer_pool_manager_->UnpinPage(page_id, is_linked);
+    }
+    page_id = next_page_id;
+    page_data = next_page_data;
+  }
+  auto success = page_data->Insert(key, value, comparator_, HashToTag(hash));
+  if (page_id != INVALID_PAGE_ID) {
+    buffer_pool_manager_->UnpinPage(page_id, success);
+  }
+  return success;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+bool HASH_TABLE_TYPE::GrowDirectory(const KeyType &key, HashTableHeaderPage *header_page) {
+  table_latch_.WLock();
+
+  // another insert may have grown the directory while we waited for the latch.
+  auto bucket_idx = KeyToDirectoryIndex(key, header_page);
+  auto can_grow = true;
+  if (GetLocalDepth(header_page, bucket_idx) == header_page->GetGlobalDepth()) {
+    uint32_t old_size = header_page->Size();
+    if (2 * old_size > header_page->MaxSize()) {
+      can_grow = false;
+    } else if (old_size < DIRECTORY_ARRAY_SIZE) {
+      // the only directory page grows, its new upper half mirrors the lower half.
+      auto dir_page_data = FetchDirectoryPage(header_page, 0);
+      dir_page_data->IncrGlobalDepth();
+      for (uint32_t i = old_size; i < dir_page_data->Size(); i++) {
+        dir_page_data->SetBucketPageId(i, dir_page_data->GetBucketPageId(i - old_size));
+        dir_page_data->SetLocalDepth(i, dir_page_data->GetLocalDepth(i - old_size));
       }
+      buffer_pool_manager_->UnpinPage(dir_page_data->GetPageId(), true);
+      header_page->IncrGlobalDepth();
     } else {
-      // the bucket is not full, so we can insert the key-value directly.
-      success = bucket_page_data->Insert(key, value, comparator_);
-      inserted = true;
+      // the new upper half of the directory pages are copies of the lower half.
+      uint32_t num_pages = header_page->NumDirectoryPages();
+      for (uint32_t i = 0; i < num_pages; i++) {
+        page_id_t copy_page_id;
+        auto copy_page = buffer_pool_manager_->NewPage(&copy_page_id);
+        auto dir_page_data = FetchDirectoryPage(header_page, i * DIRECTORY_ARRAY_SIZE);
+        memcpy(copy_page->GetData(), reinterpret_cast<char *>(dir_page_data), PAGE_SIZE);
+        reinterpret_cast<HashTableDirectoryPage *>(copy_page->GetData())->SetPageId(copy_page_id);
+        header_page->SetDirectoryPageId(num_pages + i, copy_page_id);
+        buffer_pool_manager_->UnpinPage(dir_page_data->GetPageId(), false);
+        buffer_pool_manager_->UnpinPage(copy_page_id, true);
+      }
+      header_page->IncrGlobalDepth();
     }
-    buffer_pool_manager_->UnpinPage(bucket_page_id, true);
-    bucket_page->WUnlatch();
   }
-  buffer_pool_manager_->UnpinPage(directory_page_id_, is_growing);
 
   table_latch_.WUnlock();
-  return success;
+  return can_grow;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void HASH_TABLE_TYPE::SplitBucket(HashTableHeaderPage *header_page, uint32_t bucket_idx,
+                                  HASH_TABLE_BUCKET_TYPE *bucket_page_data) {
+  auto local_depth = GetLocalDepth(header_page, bucket_idx);
+  uint32_t high_bit = 1U << local_depth;
+  page_id_t split_page_id;
+  auto split_page = buffer_pool_manager_->NewPage(&split_page_id);
+  auto split_page_data = reinterpret_cast<HASH_TABLE_BUCKET_TYPE *>(split_page->GetData());
+  split_page_data->Init();
+  split_page->WLatch();
+
+  // the entries of a bucket with an overflow chain share one hash, so the whole chain stays in one half. If that is
+  // the upper half, the bucket keeps its pages and the split image takes the lower half instead.
+  auto is_chained = bucket_page_data->GetOverflowPageId() != INVALID_PAGE_ID;
+  auto moves_chain = is_chained && (OverflowHash(bucket_page_data) & high_bit) != 0;
+
+  // readers that saw the old directory fail their validation from here on.
+  directory_version_++;
+
+  // every slot that points to the bucket matches it in the low local depth bits. Those whose new local depth bit
+  // is set are redirected to the split image, unless the chain moves.
+  //! for more info, see VerifyIntegrity().
+  ForEachDirectorySlot(header_page, bucket_idx, local_depth, true,
+                       [&](HashTableDirectoryPage *dir_page, uint32_t slot, uint32_t i) {
+                         dir_page->SetLocalDepth(slot, local_depth + 1);
+                         if (((i & high_bit) != 0) != moves_chain) {
+                           dir_page->SetBucketPageId(slot, split_page_id);
+                         }
+                       });
+
+  // rehash all key-value pairs in the bucket pair
+  for (uint32_t i = 0; i < BUCKET_ARRAY_SIZE && !is_chained; i++) {
+    if (bucket_page_data->IsReadable(i) && (Hash(bucket_page_data->KeyAt(i)) & high_bit) != 0) {
+      // remove from the original bucket and insert the new bucket
+      split_page_data->Insert(bucket_page_data->KeyAt(i), bucket_page_data->ValueAt(i), comparator_,
+                              bucket_page_data->TagAt(i));
+      bucket_page_data->RemoveAt(i);
+    }
+  }
+
+  directory_version_++;
+  split_page->WUnlatch();
+  buffer_pool_manager_->UnpinPage(split_page_id, true);
 }
 
 /*****************************************************************************
@@ -224,29 +560,75 @@ template <typename KeyType, typename ValueType, typename KeyComparator>
 bool HASH_TABLE_TYPE::Remove(Transaction *transaction, const KeyType &key, const ValueType &value) {
   table_latch_.RLock();
 
-  auto dir_page_data = FetchDirectoryPage();
-  auto bucket_page_id = KeyToPageId(key, dir_page_data);
-  auto [bucket_page, bucket_page_data] = FetchBucketPage(bucket_page_id);
-  bucket_page->WLatch();
-  auto success = bucket_page_data->Remove(key, value, comparator_);
+  auto hash = Hash(key);
+  auto header_page_data = FetchHeaderPage();
+  auto [bucket_page, bucket_page_data] = LatchBucketPage(hash, header_page_data, true);
+  auto bucket_page_id = bucket_page->GetPageId();
+  auto success = RemoveFromChain(bucket_page_data, key, value, hash);
 
   // if the bucket is empty after removing, call Merge().
   if (success && bucket_page_data->IsEmpty()) {
     buffer_pool_manager_->UnpinPage(bucket_page_id, success);
-    buffer_pool_manager_->UnpinPage(directory_page_id_, false);
+    buffer_pool_manager_->UnpinPage(header_page_id_, false);
     bucket_page->WUnlatch();
     table_latch_.RUnlock();
     Merge(transaction, key, value);
     return success;
   }
   buffer_pool_manager_->UnpinPage(bucket_page_id, success);
-  buffer_pool_manager_->UnpinPage(directory_page_id_, false);
+  buffer_pool_manager_->UnpinPage(header_page_id_, false);
   bucket_page->WUnlatch();
 
   table_latch_.RUnlock();
   return success;
 }
 
+template <typename KeyType, typename ValueType, typename KeyComparator>
+bool HASH_TABLE_TYPE::RemoveFromChain(HASH_TABLE_BUCKET_TYPE *bucket_page_data, const KeyType &key,
+                                      const ValueType &value, uint32_t hash) {
+  auto tag = HashToTag(hash);
+  auto page_id = bucket_page_data->GetOverflowPageId();
+  if (bucket_page_data->Remove(key, value, comparator_, tag)) {
+    if (page_id != INVALID_PAGE_ID && bucket_page_data->IsEmpty()) {
+      // the first page of a chain is never empty, the next page takes its place.
+      auto page_data = FetchBucketPage(page_id).second;
+      memcpy(reinterpret_cast<char *>(bucket_page_data), reinterpret_cast<char *>(page_data), PAGE_SIZE);
+      buffer_pool_manager_->UnpinPage(page_id, false);
+      buffer_pool_manager_->DeletePage(page_id);
+    }
+    return true;
+  }
+  if (page_id == INVALID_PAGE_ID || OverflowHash(bucket_page_data) != hash) {
+    return false;
+  }
+
+  // the first page is pinned by the caller, the pages after it by this loop.
+  page_id_t prev_page_id = INVALID_PAGE_ID;
+  auto prev_page_data = bucket_page_data;
+  auto success = false;
+  while (!success && page_id != INVALID_PAGE_ID) {
+    auto page_data = FetchBucketPage(page_id).second;
+    success = page_data->Remove(key, value, comparator_, tag);
+    if (success && page_data->IsEmpty()) {
+      // an overflow page is never left empty, it is unlinked from the chain.
+      prev_page_data->SetOverflowPageId(page_data->GetOverflowPageId());
+      buffer_pool_manager_->UnpinPage(page_id, false);
+      buffer_pool_manager_->DeletePage(page_id);
+      break;
+    }
+    if (prev_page_id != INVALID_PAGE_ID) {
+      buffer_pool_manager_->UnpinPage(prev_page_id, false);
+    }
+    prev_page_id = page_id;
+    prev_page_data = page_data;
+    page_id = page_data->GetOverflowPageId();
+  }
+  if (prev_page_id != INVALID_PAGE_ID) {
+    buffer_pool_manager_->UnpinPage(prev_page_id, success);
+  }
+  return success;
+}
+
 /*****************************************************************************
  * MERGE
  *****************************************************************************/
@@ -254,50 +636,119 @@ template <typename KeyType, typename ValueType, typename KeyComparator>
 void HASH_TABLE_TYPE::Merge(Transaction *transaction, const KeyType &key, const ValueType &value) {
   table_latch_.WLock();
 
-  auto dir_page_data = FetchDirectoryPage();
+  auto header_page_data = FetchHeaderPage();
+  auto is_merged = false;
+  while (MergeBucket(header_page_data, KeyToDirectoryIndex(key, header_page_data), false)) {
+    is_merged = true;
+  }
+  if (is_merged) {
+    ShrinkDirectory(header_page_data);
+  }
+  buffer_pool_manager_->UnpinPage(header_page_id_, is_merged);
 
-  // traverse the directory page and merge all empty buckets.
-  for (uint32_t i = 0;; i++) {
-    // after merging the buckets, the directory page may shrink.
-    // so we have to check every time whether it is out of bounds.
-    if (i >= dir_page_data->Size()) {
-      break;
+  table_latch_.WUnlock();
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+size_t HASH_TABLE_TYPE::Compact(Transaction *transaction) {
+  table_latch_.WLock();
+
+  auto header_page_data = FetchHeaderPage();
+  size_t num_merged = 0;
+  // merges never change the size of the directory, only ShrinkDirectory() does.
+  for (uint32_t bucket_idx = 0; bucket_idx < header_page_data->Size(); bucket_idx++) {
+    while (MergeBucket(header_page_data, bucket_idx, true)) {
+      num_merged++;
     }
-    auto old_local_depth = dir_page_data->GetLocalDepth(i);
-    auto bucket_page_id = dir_page_data->GetBucketPageId(i);
-    auto [bucket_page, bucket_page_data] = FetchBucketPage(bucket_page_id);
-    bucket_page->RLatch();
-    if (old_local_depth > 1 && bucket_page_data->IsEmpty()) {
-      auto split_bucket_idx = dir_page_data->GetSplitImageIndex(i);
-      if (dir_page_data->GetLocalDepth(split_bucket_idx) == old_local_depth) {
-        dir_page_data->DecrLocalDepth(i);
-        dir_page_data->DecrLocalDepth(split_bucket_idx);
-        dir_page_data->SetBucketPageId(i, dir_page_data->GetBucketPageId(split_bucket_idx));
-        auto new_bucket_page_id = dir_page_data->GetBucketPageId(i);
-
-        // after merging the buckets, all buckets with the same page id as the bucket pair need to be updated.
-        //! For more info, see VerifyIntegrity().
-        for (uint32_t j = 0; j < dir_page_data->Size(); j++) {
-          if (j == i || j == split_bucket_idx) {
-            continue;
-          }
-          auto cur_bucket_page_id = dir_page_data->GetBucketPageId(j);
-          if (cur_bucket_page_id == bucket_page_id || cur_bucket_page_id == new_bucket_page_id) {
-            dir_page_data->SetLocalDepth(j, dir_page_data->GetLocalDepth(i));
-            dir_page_data->SetBucketPageId(j, new_bucket_page_id);
-          }
-        }
-      }
-      if (dir_page_data->CanShrink()) {
-        dir_page_data->DecrGlobalDepth();
+  }
+  if (num_merged > 0) {
+    ShrinkDirectory(header_page_data);
+  }
+  buffer_pool_manager_->UnpinPage(header_page_id_, num_merged > 0);
+
+  table_latch_.WUnlock();
+  return num_merged;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+bool HASH_TABLE_TYPE::MergeBucket(HashTableHeaderPage *header_page, uint32_t bucket_idx, bool merge_underfull) {
+  auto local_depth = GetLocalDepth(header_page, bucket_idx);
+  if (local_depth <= 1) {
+    return false;
+  }
+  auto split_bucket_idx = bucket_idx ^ (1U << (local_depth - 1));
+  if (GetLocalDepth(header_page, split_bucket_idx) != local_depth) {
+    return false;
+  }
+  auto bucket_page_id = HashToPageId(bucket_idx, header_page);
+  auto split_page_id = HashToPageId(split_bucket_idx, header_page);
+
+  // no other thread holds table_latch_, so the buckets need no latches.
+  auto bucket_page_data = FetchBucketPage(bucket_page_id).second;
+  auto split_page_data = FetchBucketPage(split_page_id).second;
+  auto size = bucket_page_data->NumReadable();
+  auto split_size = split_page_data->NumReadable();
+  // a bucket with an overflow chain only absorbs an empty split image. Otherwise the merged bucket must be at most
+  // half full, so that the next few inserts do not split it right away.
+  auto is_chained = bucket_page_data->GetOverflowPageId() != INVALID_PAGE_ID ||
+                    split_page_data->GetOverflowPageId() != INVALID_PAGE_ID;
+  auto can_merge = size == 0 || split_size == 0 ||
+                   (merge_underfull && !is_chained && size + split_size <= BUCKET_ARRAY_SIZE / 2);
+  auto keeps_split = size == 0 || size < split_size;
+  auto kept_page_id = keeps_split ? split_page_id : bucket_page_id;
+  auto dropped_page_id = keeps_split ? bucket_page_id : split_page_id;
+  if (can_merge && size != 0 && split_size != 0) {
+    auto kept_page_data = keeps_split ? split_page_data : bucket_page_data;
+    auto dropped_page_data = keeps_split ? bucket_page_data : split_page_data;
+    for (uint32_t i = 0; i < BUCKET_ARRAY_SIZE; i++) {
+      if (dropped_page_data->IsReadable(i)) {
+        kept_page_data->Insert(dropped_page_data->KeyAt(i), dropped_page_data->ValueAt(i), comparator_,
+                               dropped_page_data->TagAt(i));
       }
     }
-    bucket_page->RUnlatch();
-    buffer_pool_manager_->UnpinPage(bucket_page_id, false);
+    buffer_pool_manager_->UnpinPage(kept_page_id, true);
+  } else {
+    buffer_pool_manager_->UnpinPage(kept_page_id, false);
+  }
+  buffer_pool_manager_->UnpinPage(dropped_page_id, false);
+  if (!can_merge) {
+    return false;
   }
-  buffer_pool_manager_->UnpinPage(directory_page_id_, true);
 
-  table_latch_.WUnlock();
+  // both halves now point to the bucket that is kept, the other one is dropped.
+  ForEachDirectorySlot(header_page, bucket_idx, local_depth - 1, true,
+                       [&](HashTableDirectoryPage *dir_page, uint32_t slot, uint32_t i) {
+                         dir_page->SetLocalDepth(slot, local_depth - 1);
+                         dir_page->SetBucketPageId(slot, kept_page_id);
+                       });
+  buffer_pool_manager_->DeletePage(dropped_page_id);
+  return true;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void HASH_TABLE_TYPE::ShrinkDirectory(HashTableHeaderPage *header_page) {
+  while (header_page->GetGlobalDepth() > 1) {
+    auto global_depth = header_page->GetGlobalDepth();
+    auto can_shrink = true;
+    ForEachDirectorySlot(header_page, 0, 0, false, [&](HashTableDirectoryPage *dir_page, uint32_t slot, uint32_t i) {
+      can_shrink = can_shrink && dir_page->GetLocalDepth(slot) < global_depth;
+    });
+    if (!can_shrink) {
+      break;
+    }
+    if (header_page->Size() > DIRECTORY_ARRAY_SIZE) {
+      // the upper half of the directory pages mirrors the lower half.
+      uint32_t num_pages = header_page->NumDirectoryPages();
+      for (uint32_t i = num_pages / 2; i < num_pages; i++) {
+        buffer_pool_manager_->DeletePage(header_page->GetDirectoryPageId(i * DIRECTORY_ARRAY_SIZE));
+      }
+    } else {
+      auto dir_page_data = FetchDirectoryPage(header_page, 0);
+      dir_page_data->DecrGlobalDepth();
+      buffer_pool_manager_->UnpinPage(dir_page_data->GetPageId(), true);
+    }
+    header_page->DecrGlobalDepth();
+  }
 }
 
 /*****************************************************************************
@@ -306,9 +757,9 @@ void HASH_TABLE_TYPE::Merge(Transaction *transaction, const KeyType &key, const
 template <typename KeyType, typename ValueType, typename KeyComparator>
 uint32_t HASH_TABLE_TYPE::GetGlobalDepth() {
   table_latch_.RLock();
-  HashTableDirectoryPage *dir_page = FetchDirectoryPage();
-  uint32_t global_depth = dir_page->GetGlobalDepth();
-  assert(buffer_pool_manager_->UnpinPage(directory_page_id_, false, nullptr));
+  HashTableHeaderPage *header_page = FetchHeaderPage();
+  uint32_t global_depth = header_page->GetGlobalDepth();
+  assert(buffer_pool_manager_->UnpinPage(header_page_id_, false, nullptr));
   table_latch_.RUnlock();
   return global_depth;
 }
@@ -319,9 +770,37 @@ uint32_t HASH_TABLE_TYPE::GetGlobalDepth() {
 template <typename KeyType, typename ValueType, typename KeyComparator>
 void HASH_TABLE_TYPE::VerifyIntegrity() {
   table_latch_.RLock();
-  HashTableDirectoryPage *dir_page = FetchDirectoryPage();
-  dir_page->VerifyIntegrity();
-  assert(buffer_pool_manager_->UnpinPage(directory_page_id_, false, nullptr));
+  HashTableHeaderPage *header_page = FetchHeaderPage();
+  if (header_page->Size() <= DIRECTORY_ARRAY_SIZE) {
+    HashTableDirectoryPage *dir_page = FetchDirectoryPage(header_page, 0);
+    assert(dir_page->GetGlobalDepth() == header_page->GetGlobalDepth());
+    dir_page->VerifyIntegrity();
+    assert(buffer_pool_manager_->UnpinPage(dir_page->GetPageId(), false, nullptr));
+  } else {
+    // the invariants of HashTableDirectoryPage::VerifyIntegrity(), over all directory pages
+    auto global_depth = header_page->GetGlobalDepth();
+    std::unordered_map<page_id_t, uint32_t> page_id_to_count;
+    std::unordered_map<page_id_t, uint32_t> page_id_to_ld;
+    ForEachDirectorySlot(header_page, 0, 0, false, [&](HashTableDirectoryPage *dir_page, uint32_t slot, uint32_t i) {
+      page_id_t curr_page_id = dir_page->GetBucketPageId(slot);
+      uint32_t curr_ld = dir_page->GetLocalDepth(slot);
+      ++page_id_to_count[curr_page_id];
+      uint32_t old_ld = page_id_to_ld.emplace(curr_page_id, curr_ld).first->second;
+      if (curr_ld > global_depth || curr_ld != old_ld) {
+        LOG_WARN("Verify Integrity: curr_local_depth: %u, old_local_depth %u, for bucket_idx: %u", curr_ld, old_ld, i);
+        assert(false);
+      }
+    });
+    for (const auto &[curr_page_id, curr_count] : page_id_to_count) {
+      uint32_t required_count = 0x1 << (global_depth - page_id_to_ld[curr_page_id]);
+      if (curr_count != required_count) {
+        LOG_WARN("Verify Integrity: curr_count: %u, required_count %u, for page_id: %u", curr_count, required_count,
+                 curr_page_id);
+        assert(false);
+      }
+    }
+  }
+  assert(buffer_pool_manager_->UnpinPage(header_page_id_, false, nullptr));
   table_latch_.RUnlock();
 }
 
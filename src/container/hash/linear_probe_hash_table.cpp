@@ -0,0 +1,327 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// linear_probe_hash_table.cpp
+//
+// Identification: src/container/hash/linear_probe_hash_table.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "common/exception.h"
+#include "common/logger.h"
+#include "common/rid.h"
+#include "container/hash/linear_probe_hash_table.h"
+#include "storage/index/generic_key.h"
+
+namespace bustub {
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+LINEAR_PROBE_HASH_TABLE_TYPE::LinearProbeHashTable(const std::string &name, BufferPoolManager *buffer_pool_manager,
+                                                   const KeyComparator &comparator, HashFunction<KeyType> hash_fn)
+    : buffer_pool_manager_(buffer_pool_manager), comparator_(comparator), hash_fn_(std::move(hash_fn)) {
+  auto header_page_data =
+      reinterpret_cast<HashTableBlockHeaderPage *>(buffer_pool_manager_->NewPage(&header_page_id_)->GetData());
+  header_page_data->SetPageId(header_page_id_);
+
+  // initially, there is a single block
+  page_id_t block_page_id;
+  reinterpret_cast<HASH_TABLE_BLOCK_TYPE *>(buffer_pool_manager_->NewPage(&block_page_id)->GetData())->Init();
+  header_page_data->AddBlockPageId(block_page_id);
+
+  buffer_pool_manager_->UnpinPage(header_page_id_, true);
+  buffer_pool_manager_->UnpinPage(block_page_id, true);
+}
+
+/*****************************************************************************
+ * HELPERS
+ *****************************************************************************/
+template <typename KeyType, typename ValueType, typename KeyComparator>
+uint32_t LINEAR_PROBE_HASH_TABLE_TYPE::HashToBlockIndex(uint64_t hash, uint32_t num_blocks) {
+  // 2^level, the number of blocks before the current round of splits started.
+  uint32_t low = 1U << (31 - __builtin_clz(num_blocks));
+  uint32_t block_idx = static_cast<uint32_t>(hash) & (2 * low - 1);
+  return block_idx < num_blocks ? block_idx : block_idx - low;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+HashTableBlockHeaderPage *LINEAR_PROBE_HASH_TABLE_TYPE::FetchHeaderPage() {
+  return reinterpret_cast<HashTableBlockHeaderPage *>(buffer_pool_manager_->FetchPage(header_page_id_)->GetData());
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+std::pair<Page *, HASH_TABLE_BLOCK_TYPE *> LINEAR_PROBE_HASH_TABLE_TYPE::FetchBlockPage(page_id_t block_page_id) {
+  auto block_page = buffer_pool_manager_->FetchPage(block_page_id);
+  return {block_page, reinterpret_cast<HASH_TABLE_BLOCK_TYPE *>(block_page->GetData())};
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+template <typename Visitor>
+bool LINEAR_PROBE_HASH_TABLE_TYPE::ProbeChain(page_id_t block_page_id, HASH_TABLE_BLOCK_TYPE *block_page_data,
+                                              uint64_t hash, bool is_dirty, Visitor &&visit,
+                                              page_id_t *last_page_id) {
+  auto start = HashToSlot(hash);
+  auto page_id = block_page_id;
+  auto page_data = block_page_data;
+  auto is_found = false;
+  auto is_end = false;
+  while (!is_found && !is_end) {
+    // a block only gets an overflow block once all of its slots are occupied.
+    for (slot_offset_t i = 0, slot = start; i < BLOCK_ARRAY_SIZE && !is_found && !is_end; i++) {
+      is_found = visit(page_id, page_data, slot);
+      is_end = !page_data->IsOccupied(slot);
+      slot = slot + 1 == BLOCK_ARRAY_SIZE ? 0 : slot + 1;
+    }
+    auto next_page_id = page_data->GetOverflowPageId();
+    if (is_found || is_end || next_page_id == INVALID_PAGE_ID) {
+      break;
+    }
+    if (page_id != block_page_id) {
+      buffer_pool_manager_->UnpinPage(page_id, false);
+    }
+    page_id = next_page_id;
+    page_data = FetchBlockPage(page_id).second;
+  }
+  if (last_page_id != nullptr) {
+    *last_page_id = page_id;
+  }
+  if (page_id != block_page_id) {
+    buffer_pool_manager_->UnpinPage(page_id, is_found && is_dirty);
+  }
+  return is_found;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+bool LINEAR_PROBE_HASH_TABLE_TYPE::InsertIntoChain(page_id_t block_page_id, HASH_TABLE_BLOCK_TYPE *block_page_data,
+                                                   const KeyType &key, const ValueType &value, uint64_t hash) {
+  // reject a duplicate pair, and remember the first free slot on the way.
+  auto free_page_id = INVALID_PAGE_ID;
+  slot_offset_t free_slot = 0;
+  page_id_t last_page_id;
+  auto is_duplicate = ProbeChain(
+      block_page_id, block_page_data, hash, false,
+      [&](page_id_t page_id, HASH_TABLE_BLOCK_TYPE *page_data, slot_offset_t slot) {
+        if (!page_data->IsReadable(slot)) {
+          if (free_page_id == INVALID_PAGE_ID) {
+            free_page_id = page_id;
+            free_slot = slot;
+          }
+          return false;
+        }
+        return comparator_(key, page_data->KeyAt(slot)) == 0 && page_data->ValueAt(slot) == value;
+      },
+      &last_page_id);
+  if (is_duplicate) {
+    return false;
+  }
+
+  if (free_page_id == block_page_id) {
+    return block_page_data->Insert(free_slot, key, value);
+  }
+  if (free_page_id == INVALID_PAGE_ID) {
+    // every block of the chain is full.
+    page_id_t overflow_page_id;
+    auto overflow_page_data =
+        reinterpret_cast<HASH_TABLE_BLOCK_TYPE *>(buffer_pool_manager_->NewPage(&overflow_page_id)->GetData());
+    overflow_page_data->Init();
+    buffer_pool_manager_->UnpinPage(overflow_page_id, true);
+    if (last_page_id == block_page_id) {
+      block_page_data->SetOverflowPageId(overflow_page_id);
+    } else {
+      FetchBlockPage(last_page_id).second->SetOverflowPageId(overflow_page_id);
+      buffer_pool_manager_->UnpinPage(last_page_id, true);
+    }
+    free_page_id = overflow_page_id;
+    free_slot = HashToSlot(hash);
+  }
+  auto success = FetchBlockPage(free_page_id).second->Insert(free_slot, key, value);
+  buffer_pool_manager_->UnpinPage(free_page_id, success);
+  return success;
+}
+
+/*****************************************************************************
+ * SEARCH
+ *****************************************************************************/
+template <typename KeyType, typename ValueType, typename KeyComparator>
+bool LINEAR_PROBE_HASH_TABLE_TYPE::GetValue(Transaction *transaction, const KeyType &key,
+                                            std::vector<ValueType> *result) {
+  table_latch_.RLock();
+
+  auto hash = hash_fn_.GetHash(key);
+  auto header_page_data = FetchHeaderPage();
+  auto block_page_id = header_page_data->GetBlockPageId(HashToBlockIndex(hash, header_page_data->NumBlocks()));
+  auto [block_page, block_page_data] = FetchBlockPage(block_page_id);
+  block_page->RLatch();
+  auto success = false;
+  ProbeChain(block_page_id, block_page_data, hash, false,
+             [&](page_id_t page_id, HASH_TABLE_BLOCK_TYPE *page_data, slot_offset_t slot) {
+               if (page_data->IsReadable(slot) && comparator_(key, page_data->KeyAt(slot)) == 0) {
+                 result->push_back(page_data->ValueAt(slot));
+                 success = true;
+               }
+               return false;
+             });
+  block_page->RUnlatch();
+  buffer_pool_manager_->UnpinPage(block_page_id, false);
+  buffer_pool_manager_->UnpinPage(header_page_id_, false);
+
+  table_latch_.RUnlock();
+  return success;
+}
+
+/*****************************************************************************
+ * INSERTION
+ *****************************************************************************/
+template <typename KeyType, typename ValueType, typename KeyComparator>
+bool LINEAR_PROBE_HASH_TABLE_TYPE::Insert(Transaction *transaction, const KeyType &key, const ValueType &value) {
+  table_latch_.RLock();
+
+  auto hash = hash_fn_.GetHash(key);
+  auto header_page_data = FetchHeaderPage();
+  auto num_blocks = header_page_data->NumBlocks();
+  auto block_page_id = header_page_data->GetBlockPageId(HashToBlockIndex(hash, num_blocks));
+  auto [block_page, block_page_data] = FetchBlockPage(block_page_id);
+  block_page->WLatch();
+  auto success = InsertIntoChain(block_page_id, block_page_data, key, value, hash);
+  block_page->WUnlatch();
+  buffer_pool_manager_->UnpinPage(block_page_id, success);
+  buffer_pool_manager_->UnpinPage(header_page_id_, false);
+
+  auto is_overfull = success && (++size_) * 100 > num_blocks * BLOCK_ARRAY_SIZE * MAX_FILL_PERCENT &&
+                     num_blocks < header_page_data->MaxBlocks();
+  table_latch_.RUnlock();
+  if (is_overfull) {
+    Grow();
+  }
+  return success;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void LINEAR_PROBE_HASH_TABLE_TYPE::Grow() {
+  table_latch_.WLock();
+
+  // another insert may have split in the meantime.
+  auto header_page_data = FetchHeaderPage();
+  auto is_split = false;
+  while (size_ * 100 > header_page_data->NumBlocks() * BLOCK_ARRAY_SIZE * MAX_FILL_PERCENT &&
+         header_page_data->NumBlocks() < header_page_data->MaxBlocks()) {
+    SplitBlock(header_page_data);
+    is_split = true;
+  }
+  buffer_pool_manager_->UnpinPage(header_page_id_, is_split);
+
+  table_latch_.WUnlock();
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void LINEAR_PROBE_HASH_TABLE_TYPE::SplitBlock(HashTableBlockHeaderPage *header_page) {
+  auto num_blocks = header_page->NumBlocks();
+  auto split_block_idx = num_blocks - (1U << (31 - __builtin_clz(num_blocks)));
+  auto block_page_id = header_page->GetBlockPageId(split_block_idx);
+  page_id_t new_page_id;
+  auto new_page = buffer_pool_manager_->NewPage(&new_page_id);
+  auto new_page_data = reinterpret_cast<HASH_TABLE_BLOCK_TYPE *>(new_page->GetData());
+  new_page_data->Init();
+  header_page->AddBlockPageId(new_page_id);
+
+  // take all pairs out of the block and its overflow blocks, which also drops the tombstones.
+  // no other thread holds table_latch_, so the blocks need no latches.
+  std::vector<MappingType> pairs;
+  auto block_page_data = FetchBlockPage(block_page_id).second;
+  for (auto page_id = block_page_id; page_id != INVALID_PAGE_ID;) {
+    auto page_data = page_id == block_page_id ? block_page_data : FetchBlockPage(page_id).second;
+    for (slot_offset_t slot = 0; slot < BLOCK_ARRAY_SIZE; slot++) {
+      if (page_data->IsReadable(slot)) {
+        pairs.emplace_back(page_data->KeyAt(slot), page_data->ValueAt(slot));
+      }
+    }
+    auto next_page_id = page_data->GetOverflowPageId();
+    if (page_id != block_page_id) {
+      buffer_pool_manager_->UnpinPage(page_id, false);
+      buffer_pool_manager_->DeletePage(page_id);
+    }
+    page_id = next_page_id;
+  }
+  block_page_data->Init();
+
+  // every pair goes back into the block or into the new one.
+  for (const auto &pair : pairs) {
+    auto hash = hash_fn_.GetHash(pair.first);
+    if (HashToBlockIndex(hash, num_blocks + 1) == split_block_idx) {
+      InsertIntoChain(block_page_id, block_page_data, pair.first, pair.second, hash);
+    } else {
+      InsertIntoChain(new_page_id, new_page_data, pair.first, pair.second, hash);
+    }
+  }
+  buffer_pool_manager_->UnpinPage(block_page_id, true);
+  buffer_pool_manager_->UnpinPage(new_page_id, true);
+}
+
+/*****************************************************************************
+ * REMOVE
+ *****************************************************************************/
+template <typename KeyType, typename ValueType, typename KeyComparator>
+bool LINEAR_PROBE_HASH_TABLE_TYPE::Remove(Transaction *transaction, const KeyType &key, const ValueType &value) {
+  table_latch_.RLock();
+
+  auto hash = hash_fn_.GetHash(key);
+  auto header_page_data = FetchHeaderPage();
+  auto block_page_id = header_page_data->GetBlockPageId(HashToBlockIndex(hash, header_page_data->NumBlocks()));
+  auto [block_page, block_page_data] = FetchBlockPage(block_page_id);
+  block_page->WLatch();
+  // the slot stays occupied as a tombstone, later probes must not stop at it.
+  auto success = ProbeChain(block_page_id, block_page_data, hash, true,
+                            [&](page_id_t page_id, HASH_TABLE_BLOCK_TYPE *page_data, slot_offset_t slot) {
+                              if (page_data->IsReadable(slot) && comparator_(key, page_data->KeyAt(slot)) == 0 &&
+                                  page_data->ValueAt(slot) == value) {
+                                page_data->Remove(slot);
+                                return true;
+                              }
+                              return false;
+                            });
+  block_page->WUnlatch();
+  buffer_pool_manager_->UnpinPage(block_page_id, success);
+  buffer_pool_manager_->UnpinPage(header_page_id_, false);
+  if (success) {
+    size_--;
+  }
+
+  table_latch_.RUnlock();
+  return success;
+}
+
+/*****************************************************************************
+ * GETSIZE
+ *****************************************************************************/
+template <typename KeyType, typename ValueType, typename KeyComparator>
+size_t LINEAR_PROBE_HASH_TABLE_TYPE::GetSize() const {
+  return size_;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+uint32_t LINEAR_PROBE_HASH_TABLE_TYPE::GetNumBlocks() {
+  table_latch_.RLock();
+  auto num_blocks = FetchHeaderPage()->NumBlocks();
+  buffer_pool_manager_->UnpinPage(header_page_id_, false);
+  table_latch_.RUnlock();
+  return num_blocks;
+}
+
+/*****************************************************************************
+ * TEMPLATE DEFINITIONS - DO NOT TOUCH
+ *****************************************************************************/
+template class LinearProbeHashTable<int, int, IntComparator>;
+
+template class LinearProbeHashTable<GenericKey<4>, RID, GenericComparator<4>>;
+template class LinearProbeHashTable<GenericKey<8>, RID, GenericComparator<8>>;
+template class LinearProbeHashTable<GenericKey<16>, RID, GenericComparator<16>>;
+template class LinearProbeHashTable<GenericKey<32>, RID, GenericComparator<32>>;
+template class LinearProbeHashTable<GenericKey<64>, RID, GenericComparator<64>>;
+
+}  // namespace bustub
@@ -0,0 +1,405 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// lsm_tree.cpp
+//
+// Identification: src/container/lsm/lsm_tree.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "container/lsm/lsm_tree.h"
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "common/rid.h"
+#include "storage/index/generic_key.h"
+
+namespace bustub {
+
+/*****************************************************************************
+ * SORTED RUNS
+ *****************************************************************************/
+template <typename KeyType, typename ValueType, typename KeyComparator>
+LSM_TREE_TYPE::SortedRun::~SortedRun() {
+  if (is_obsolete_.load()) {
+    for (auto page_id : page_ids_) {
+      buffer_pool_manager_->DeletePage(page_id);
+    }
+  }
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+LSM_TREE_TYPE::RunIterator::RunIterator(const SortedRun *run, size_t page_idx, uint32_t slot)
+    : run_(run), page_idx_(page_idx), slot_(slot) {
+  Settle();
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+LSM_TREE_TYPE::RunIterator::~RunIterator() {
+  if (page_ != nullptr) {
+    run_->buffer_pool_manager_->UnpinPage(page_->GetPageId(), false);
+  }
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void LSM_TREE_TYPE::RunIterator::Next() {
+  slot_++;
+  Settle();
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void LSM_TREE_TYPE::RunIterator::Settle() {
+  while (page_idx_ < run_->page_ids_.size()) {
+    if (page_ == nullptr) {
+      // Run pages are never changed after the run is written, so they are read without latches.
+      page_ = run_->buffer_pool_manager_->FetchPage(run_->page_ids_[page_idx_]);
+      run_page_ = reinterpret_cast<RunPage *>(page_->GetData());
+    }
+    if (slot_ < run_page_->GetSize()) {
+      return;
+    }
+    run_->buffer_pool_manager_->UnpinPage(page_->GetPageId(), false);
+    page_ = nullptr;
+    run_page_ = nullptr;
+    page_idx_++;
+    slot_ = 0;
+  }
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+LSM_TREE_TYPE::RunWriter::RunWriter(LSMTree *tree, size_t expected_pairs, uint32_t level)
+    : tree_(tree), run_(std::make_shared<SortedRun>(tree->buffer_pool_manager_, expected_pairs, level)) {}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+LSM_TREE_TYPE::RunWriter::~RunWriter() {
+  if (run_page_ != nullptr) {
+    tree_->buffer_pool_manager_->UnpinPage(page_id_, true);
+  }
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void LSM_TREE_TYPE::RunWriter::Append(const KeyType &key, const ValueType &value, bool is_deleted) {
+  if (run_page_ == nullptr || run_page_->IsFull()) {
+    if (run_page_ != nullptr) {
+      tree_->buffer_pool_manager_->UnpinPage(page_id_, true);
+    }
+    Page *page = tree_->buffer_pool_manager_->NewPage(&page_id_);
+    run_page_ = reinterpret_cast<RunPage *>(page->GetData());
+    run_page_->Init();
+    run_->page_ids_.push_back(page_id_);
+    run_->first_keys_.push_back(key);
+  }
+  run_page_->Append(key, value, is_deleted);
+  run_->filter_.Insert(tree_->hash_fn_.GetHash(key));
+  run_->num_pairs_++;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+std::shared_ptr<typename LSM_TREE_TYPE::SortedRun> LSM_TREE_TYPE::RunWriter::Finish() {
+  if (run_page_ != nullptr) {
+    tree_->buffer_pool_manager_->UnpinPage(page_id_, true);
+    run_page_ = nullptr;
+  }
+  return run_->num_pairs_ == 0 ? nullptr : std::move(run_);
+}
+
+/*****************************************************************************
+ * TREE
+ *****************************************************************************/
+template <typename KeyType, typename ValueType, typename KeyComparator>
+LSM_TREE_TYPE::LSMTree(const std::string &name, BufferPoolManager *buffer_pool_manager,
+                       const KeyComparator &comparator, HashFunction<KeyType> hash_fn, size_t memtable_capacity)
+    : name_(name),
+      buffer_pool_manager_(buffer_pool_manager),
+      comparator_(comparator),
+      hash_fn_(std::move(hash_fn)),
+      memtable_capacity_(memtable_capacity) {
+  auto version = std::make_shared<Version>();
+  version->memtable_ = std::make_shared<MemTable>(comparator_);
+  memtable_.store(version->memtable_.get());
+  version_ = std::move(version);
+  background_thread_ = std::thread([this] { BackgroundWork(); });
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+LSM_TREE_TYPE::~LSMTree() {
+  {
+    std::lock_guard<std::mutex> guard(version_latch_);
+    stop_ = true;
+  }
+  work_cv_.notify_one();
+  done_cv_.notify_all();
+  background_thread_.join();
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+int LSM_TREE_TYPE::ComparePairs(const KeyType &lhs_key, const ValueType &lhs_value, const KeyType &rhs_key,
+                                const ValueType &rhs_value) const {
+  int cmp = comparator_(lhs_key, rhs_key);
+  return cmp != 0 ? cmp : memcmp(&lhs_value, &rhs_value, sizeof(ValueType));
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+std::shared_ptr<const typename LSM_TREE_TYPE::Version> LSM_TREE_TYPE::GetVersion() {
+  std::lock_guard<std::mutex> guard(version_latch_);
+  return version_;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+size_t LSM_TREE_TYPE::GetNumRuns() {
+  return GetVersion()->runs_.size();
+}
+
+/*****************************************************************************
+ * SEARCH
+ *****************************************************************************/
+template <typename KeyType, typename ValueType, typename KeyComparator>
+bool LSM_TREE_TYPE::GetValue(const KeyType &key, std::vector<ValueType> *result) {
+  auto version = GetVersion();
+  // The values whose newest copy was seen already, older copies of them are ignored.
+  std::vector<ValueType> decided;
+  bool found = false;
+  auto visit = [&](const ValueType &value, bool is_deleted) {
+    for (const auto &other : decided) {
+      if (memcmp(&other, &value, sizeof(ValueType)) == 0) {
+        return;
+      }
+    }
+    decided.push_back(value);
+    if (!is_deleted) {
+      result->push_back(value);
+      found = true;
+    }
+  };
+
+  auto scan_memtable = [&](const MemTable &memtable) {
+    typename MemTable::Iterator iter(&memtable);
+    for (iter.Seek(key); !iter.IsEnd() && comparator_(iter.Key(), key) == 0; iter.Next()) {
+      visit(iter.Value(), iter.IsDeleted());
+    }
+  };
+  scan_memtable(*version->memtable_);
+  for (const auto &memtable : version->immutables_) {
+    scan_memtable(*memtable);
+  }
+
+  hash_t hash = hash_fn_.GetHash(key);
+  for (const auto &run : version->runs_) {
+    if (!run->filter_.MayContain(hash)) {
+      continue;
+    }
+    // The pairs of the key start in the last page whose first key is smaller than the key, or in the first page
+    // that starts with the key.
+    auto first = std::lower_bound(run->first_keys_.begin(), run->first_keys_.end(), key,
+                                  [this](const KeyType &lhs, const KeyType &rhs) { return comparator_(lhs, rhs) < 0; });
+    size_t page_idx = first - run->first_keys_.begin();
+    if (page_idx > 0) {
+      page_idx--;
+    }
+    if (page_idx >= run->page_ids_.size()) {
+      continue;
+    }
+    Page *page = buffer_pool_manager_->FetchPage(run->page_ids_[page_idx]);
+    uint32_t slot = reinterpret_cast<RunPage *>(page->GetData())->LowerBound(key, comparator_);
+    buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
+    for (RunIterator iter(run.get(), page_idx, slot); !iter.IsEnd() && comparator_(iter.Key(), key) == 0;
+         iter.Next()) {
+      visit(iter.Value(), iter.IsDeleted());
+    }
+  }
+  return found;
+}
+
+/*****************************************************************************
+ * INSERTION AND REMOVE
+ *****************************************************************************/
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void LSM_TREE_TYPE::Insert(const KeyType &key, const ValueType &value) {
+  Put(key, value, false);
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void LSM_TREE_TYPE::Remove(const KeyType &key, const ValueType &value) {
+  Put(key, value, true);
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void LSM_TREE_TYPE::Put(const KeyType &key, const ValueType &value, bool is_deleted) {
+  table_latch_.RLock();
+  MemTable *memtable = memtable_.load();
+  memtable->Put(key, value, is_deleted);
+  bool is_full = memtable->GetSize() >= memtable_capacity_;
+  table_latch_.RUnlock();
+  if (is_full) {
+    SwitchMemTable();
+  }
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void LSM_TREE_TYPE::SwitchMemTable() {
+  std::unique_lock<std::mutex> lock(version_latch_);
+  // Inserts wait for the background thread when it falls behind, instead of piling up memtables.
+  done_cv_.wait(lock, [&] { return stop_ || version_->immutables_.size() < MAX_IMMUTABLE_MEMTABLES; });
+  // Another insert switched the memtable already. The size is checked rather than the address, since the full
+  // memtable may have been written and freed, and a new one allocated at the same address.
+  if (version_->memtable_->GetSize() < memtable_capacity_) {
+    return;
+  }
+  // Wait for the inserts that still add to the full memtable.
+  table_latch_.WLock();
+  auto version = std::make_shared<Version>(*version_);
+  version->immutables_.insert(version->immutables_.begin(), version->memtable_);
+  version->memtable_ = std::make_shared<MemTable>(comparator_);
+  memtable_.store(version->memtable_.get());
+  version_ = std::move(version);
+  table_latch_.WUnlock();
+  work_cv_.notify_one();
+}
+
+/*****************************************************************************
+ * BACKGROUND WORK
+ *****************************************************************************/
+template <typename KeyType, typename ValueType, typename KeyComparator>
+bool LSM_TREE_TYPE::PickCompaction(const Version &version, size_t *begin, size_t *end) {
+  const auto &runs = version.runs_;
+  for (size_t i = 0; i < runs.size(); i = *end) {
+    *begin = i;
+    *end = i;
+    while (*end < runs.size() && runs[*end]->level_ == runs[i]->level_) {
+      (*end)++;
+    }
+    if (*end - *begin >= RUNS_PER_LEVEL) {
+      // Merge the oldest runs of the level. A merge pins a page of every input, so it takes no more runs even
+      // when flushes got ahead of merges.
+      *begin = *end - RUNS_PER_LEVEL;
+      return true;
+    }
+  }
+  return false;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void LSM_TREE_TYPE::WaitForBackgroundWork() {
+  std::unique_lock<std::mutex> lock(version_latch_);
+  size_t begin;
+  size_t end;
+  done_cv_.wait(lock, [&] {
+    return stop_ || (!is_busy_ && version_->immutables_.empty() && !PickCompaction(*version_, &begin, &end));
+  });
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void LSM_TREE_TYPE::BackgroundWork() {
+  std::unique_lock<std::mutex> lock(version_latch_);
+  while (true) {
+    size_t begin;
+    size_t end;
+    work_cv_.wait(lock, [&] {
+      return stop_ || !version_->immutables_.empty() || PickCompaction(*version_, &begin, &end);
+    });
+    if (stop_) {
+      return;
+    }
+
+    // Only this thread changes the runs, and only it drops immutable memtables, so the memtable or the runs it
+    // works on are still in place when it installs the result. Flushing goes first, which keeps inserts going.
+    is_busy_ = true;
+    std::shared_ptr<Version> version;
+    if (!version_->immutables_.empty()) {
+      std::shared_ptr<MemTable> memtable = version_->immutables_.back();
+      lock.unlock();
+      auto run = FlushMemTable(*memtable);
+      lock.lock();
+      version = std::make_shared<Version>(*version_);
+      version->immutables_.pop_back();
+      if (run != nullptr) {
+        version->runs_.insert(version->runs_.begin(), std::move(run));
+      }
+    } else {
+      std::vector<std::shared_ptr<SortedRun>> inputs(version_->runs_.begin() + begin, version_->runs_.begin() + end);
+      // deleted pairs can only be dropped when no older run holds a copy they hide
+      bool drop_deleted = end == version_->runs_.size();
+      lock.unlock();
+      auto run = MergeRuns(inputs, drop_deleted);
+      lock.lock();
+      version = std::make_shared<Version>(*version_);
+      version->runs_.erase(version->runs_.begin() + begin, version->runs_.begin() + end);
+      if (run != nullptr) {
+        version->runs_.insert(version->runs_.begin() + begin, std::move(run));
+      }
+      for (auto &input : inputs) {
+        input->is_obsolete_.store(true);
+      }
+    }
+    version_ = std::move(version);
+    is_busy_ = false;
+    done_cv_.notify_all();
+  }
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+std::shared_ptr<typename LSM_TREE_TYPE::SortedRun> LSM_TREE_TYPE::FlushMemTable(const MemTable &memtable) {
+  RunWriter writer(this, memtable.GetSize(), 0);
+  for (typename MemTable::Iterator iter(&memtable); !iter.IsEnd(); iter.Next()) {
+    writer.Append(iter.Key(), iter.Value(), iter.IsDeleted());
+  }
+  return writer.Finish();
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+std::shared_ptr<typename LSM_TREE_TYPE::SortedRun> LSM_TREE_TYPE::MergeRuns(
+    const std::vector<std::shared_ptr<SortedRun>> &runs, bool drop_deleted) {
+  size_t expected_pairs = 0;
+  for (const auto &run : runs) {
+    expected_pairs += run->num_pairs_;
+  }
+  RunWriter writer(this, expected_pairs, runs.front()->level_ + 1);
+  std::vector<std::unique_ptr<RunIterator>> iters;
+  for (const auto &run : runs) {
+    iters.emplace_back(std::make_unique<RunIterator>(run.get(), 0, 0));
+  }
+  while (true) {
+    // The smallest pair, the newest run wins a tie.
+    int smallest = -1;
+    for (size_t i = 0; i < iters.size(); i++) {
+      if (!iters[i]->IsEnd() &&
+          (smallest < 0 || ComparePairs(iters[i]->Key(), iters[i]->Value(), iters[smallest]->Key(),
+                                        iters[smallest]->Value()) < 0)) {
+        smallest = static_cast<int>(i);
+      }
+    }
+    if (smallest < 0) {
+      break;
+    }
+    KeyType key = iters[smallest]->Key();
+    ValueType value = iters[smallest]->Value();
+    bool is_deleted = iters[smallest]->IsDeleted();
+    for (auto &iter : iters) {
+      while (!iter->IsEnd() && ComparePairs(iter->Key(), iter->Value(), key, value) == 0) {
+        iter->Next();
+      }
+    }
+    if (!is_deleted || !drop_deleted) {
+      writer.Append(key, value, is_deleted);
+    }
+  }
+  return writer.Finish();
+}
+
+/*****************************************************************************
+ * TEMPLATE DEFINITIONS - DO NOT TOUCH
+ *****************************************************************************/
+template class LSMTree<GenericKey<4>, RID, GenericComparator<4>>;
+template class LSMTree<GenericKey<8>, RID, GenericComparator<8>>;
+template class LSMTree<GenericKey<16>, RID, GenericComparator<16>>;
+template class LSMTree<GenericKey<32>, RID, GenericComparator<32>>;
+template class LSMTree<GenericKey<64>, RID, GenericComparator<64>>;
+
+}  // namespace bustub
@@ -20,18 +20,18 @@ DistinctExecutor::DistinctExecutor(ExecutorContext *exec_ctx, const DistinctPlan
 
 void DistinctExecutor::Init() {
   child_executor_->Init();
-  hash_table_.clear();
+  hash_table_.Clear();
 }
 
 bool DistinctExecutor::Next(Tuple *tuple, RID *rid) {
   while (child_executor_->Next(tuple, rid)) {
-    DistinctKey key;
-    key.group_bys_.reserve(plan_->OutputSchema()->GetColumnCount());
+    key_.Clear();
     for (uint32_t i = 0; i < plan_->OutputSchema()->GetColumnCount(); i++) {
-      key.group_bys_.push_back(tuple->GetValue(plan_->OutputSchema(), i));
+      key_.Append(tuple->GetValue(plan_->OutputSchema(), i));
     }
-    if (hash_table_.count(key) <= 0) {
-      hash_table_.insert(std::move(key));
+    bool inserted;
+    hash_table_.FindOrInsert(key_, &inserted);
+    if (inserted) {
       return true;
     }
   }
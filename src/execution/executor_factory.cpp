@@ -20,12 +20,15 @@
 #include "execution/executors/delete_executor.h"
 #include "execution/executors/distinct_executor.h"
 #include "execution/executors/hash_join_executor.h"
+#include "execution/executors/hash_semi_join_executor.h"
 #include "execution/executors/index_scan_executor.h"
 #include "execution/executors/insert_executor.h"
 #include "execution/executors/limit_executor.h"
 #include "execution/executors/nested_index_join_executor.h"
 #include "execution/executors/nested_loop_join_executor.h"
+#include "execution/executors/nested_loop_semi_join_executor.h"
 #include "execution/executors/seq_scan_executor.h"
+#include "execution/executors/sort_merge_join_executor.h"
 #include "execution/executors/update_executor.h"
 #include "storage/index/generic_key.h"
 
@@ -111,6 +114,28 @@ std::unique_ptr<AbstractExecutor> ExecutorFactory::CreateExecutor(ExecutorContex
       return std::make_unique<HashJoinExecutor>(exec_ctx, hash_join_plan, std::move(left), std::move(right));
     }
 
+    // Create a new sort-merge join executor
+    case PlanType::SortMergeJoin: {
+      auto sort_merge_join_plan = dynamic_cast<const SortMergeJoinPlanNode *>(plan);
+      auto left = ExecutorFactory::CreateExecutor(exec_ctx, sort_merge_join_plan->GetLeftPlan());
+      auto right = ExecutorFactory::CreateExecutor(exec_ctx, sort_merge_join_plan->GetRightPlan());
+      return std::make_unique<SortMergeJoinExecutor>(exec_ctx, sort_merge_join_plan, std::move(left),
+                                                     std::move(right));
+    }
+
+    // Create a new semi-join or anti-join executor
+    case PlanType::SemiJoin:
+    case PlanType::AntiJoin: {
+      auto semi_join_plan = dynamic_cast<const SemiJoinPlanNode *>(plan);
+      auto left = ExecutorFactory::CreateExecutor(exec_ctx, semi_join_plan->GetLeftPlan());
+      auto right = ExecutorFactory::CreateExecutor(exec_ctx, semi_join_plan->GetRightPlan());
+      if (semi_join_plan->GetStrategy() == SemiJoinStrategy::Hash) {
+        return std::make_unique<HashSemiJoinExecutor>(exec_ctx, semi_join_plan, std::move(left), std::move(right));
+      }
+      return std::make_unique<NestedLoopSemiJoinExecutor>(exec_ctx, semi_join_plan, std::move(left),
+                                                          std::move(right));
+    }
+
     default:
       UNREACHABLE("Unsupported plan type.");
   }
@@ -10,7 +10,10 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <new>
+
 #include "execution/executors/hash_join_executor.h"
+#include "execution/executors/seq_scan_executor.h"
 #include "execution/expressions/abstract_expression.h"
 #include "execution/expressions/column_value_expression.h"
 
@@ -27,19 +30,39 @@ HashJoinExecutor::HashJoinExecutor(ExecutorContext *exec_ctx, const HashJoinPlan
   right_child_executor_->Init();
   Tuple left_tuple;
   RID left_rid;
+  std::vector<hash_t> key_hashes;
   while (left_child_executor_->Next(&left_tuple, &left_rid)) {
-    Value value = plan_->LeftJoinKeyExpression()->Evaluate(&left_tuple, plan_->GetLeftPlan()->OutputSchema());
-    auto left_col_count = plan_->GetLeftPlan()->OutputSchema()->GetColumnCount();
-    std::vector<Value> values;
-    values.reserve(left_col_count);
-    for (uint32_t i = 0; i < left_col_count; i++) {
-      values.push_back(left_tuple.GetValue(plan_->GetLeftPlan()->OutputSchema(), i));
+    key_.Clear();
+    key_.Append(plan_->LeftJoinKeyExpression()->Evaluate(&left_tuple, plan_->GetLeftPlan()->OutputSchema()));
+    if (key_.HasNull()) {
+      // A null join key never compares equal to anything.
+      continue;
     }
-    HashJoinKey key{value};
-    if (hash_table_.count(key) > 0) {
-      hash_table_[key].push_back(std::move(values));
+    // Copy the tuple into the arena of the hash table, right behind its chain link.
+    char *mem = hash_table_.Allocate(sizeof(BuildRow) + sizeof(int32_t) + left_tuple.GetLength(), alignof(BuildRow));
+    auto *row = new (mem) BuildRow{nullptr};
+    left_tuple.SerializeTo(mem + sizeof(BuildRow));
+    bool inserted;
+    hash_t hash = key_.Hash();
+    BuildChain *chain = hash_table_.FindOrInsert(key_.Data(), key_.Size(), hash, &inserted);
+    if (inserted) {
+      chain->head_ = row;
+      key_hashes.push_back(hash);
     } else {
-      hash_table_.insert({key, {values}});
+      chain->tail_->next_ = row;
+    }
+    chain->tail_ = row;
+  }
+
+  // Let a sequential scan on the probe side drop tuples that cannot match before materializing them.
+  auto right_scan = dynamic_cast<SeqScanExecutor *>(right_child_executor_.get());
+  if (right_scan != nullptr) {
+    bloom_filter_ = std::make_unique<BlockedBloomFilter>(key_hashes.size());
+    for (auto hash : key_hashes) {
+      bloom_filter_->Insert(hash);
+    }
+    if (!right_scan->PushRuntimeFilter(plan_->RightJoinKeyExpression(), bloom_filter_.get())) {
+      bloom_filter_.reset();
     }
   }
 }
@@ -47,39 +70,39 @@ HashJoinExecutor::HashJoinExecutor(ExecutorContext *exec_ctx, const HashJoinPlan
 void HashJoinExecutor::Init() {
   left_child_executor_->Init();
   right_child_executor_->Init();
-  next_pos_ = 0;
-  outer_table_buffer_.clear();
+  next_row_ = nullptr;
 }
 
 bool HashJoinExecutor::Next(Tuple *tuple, RID *rid) {
-  bool is_find = false;
-  if (next_pos_ >= outer_table_buffer_.size()) {
-    while (right_child_executor_->Next(tuple, rid)) {
-      Value value = plan_->RightJoinKeyExpression()->Evaluate(tuple, plan_->GetRightPlan()->OutputSchema());
-      auto iter = hash_table_.find(HashJoinKey{value});
-      if (iter != hash_table_.end()) {
-        outer_table_buffer_ = iter->second;
-        next_pos_ = 0;
-        is_find = true;
-        break;
-      }
-    }
-    if (!is_find) {
+  while (next_row_ == nullptr) {
+    if (!right_child_executor_->Next(&right_tuple_, rid)) {
       return false;
     }
+    key_.Clear();
+    key_.Append(plan_->RightJoinKeyExpression()->Evaluate(&right_tuple_, plan_->GetRightPlan()->OutputSchema()));
+    if (key_.HasNull()) {
+      continue;
+    }
+    const BuildChain *chain = hash_table_.Find(key_);
+    if (chain != nullptr) {
+      next_row_ = chain->head_;
+    }
   }
+  Tuple left_tuple;
+  left_tuple.DeserializeFrom(reinterpret_cast<const char *>(next_row_) + sizeof(BuildRow));
+  next_row_ = next_row_->next_;
+
   std::vector<Value> values;
   values.reserve(plan_->OutputSchema()->GetColumnCount());
   for (const auto &column : plan_->OutputSchema()->GetColumns()) {
     auto column_expr = reinterpret_cast<const ColumnValueExpression *>(column.GetExpr());
     if (column_expr->GetTupleIdx() == 0) {
-      values.push_back(outer_table_buffer_[next_pos_][column_expr->GetColIdx()]);
+      values.push_back(left_tuple.GetValue(plan_->GetLeftPlan()->OutputSchema(), column_expr->GetColIdx()));
     } else {
-      values.push_back(tuple->GetValue(plan_->GetRightPlan()->OutputSchema(), column_expr->GetColIdx()));
+      values.push_back(right_tuple_.GetValue(plan_->GetRightPlan()->OutputSchema(), column_expr->GetColIdx()));
     }
   }
   *tuple = Tuple(values, plan_->OutputSchema());
-  next_pos_++;
   return true;
 }
 
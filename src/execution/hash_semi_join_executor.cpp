@@ -0,0 +1,82 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// hash_semi_join_executor.cpp
+//
+// Identification: src/execution/hash_semi_join_executor.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <vector>
+
+#include "execution/executors/hash_semi_join_executor.h"
+#include "execution/executors/seq_scan_executor.h"
+
+namespace bustub {
+
+HashSemiJoinExecutor::HashSemiJoinExecutor(ExecutorContext *exec_ctx, const SemiJoinPlanNode *plan,
+                                           std::unique_ptr<AbstractExecutor> &&left_child,
+                                           std::unique_ptr<AbstractExecutor> &&right_child)
+    : AbstractExecutor(exec_ctx),
+      plan_(plan),
+      left_child_executor_(std::move(left_child)),
+      right_child_executor_(std::move(right_child)),
+      is_anti_(plan->GetType() == PlanType::AntiJoin) {
+  right_child_executor_->Init();
+  Tuple right_tuple;
+  RID right_rid;
+  std::vector<hash_t> key_hashes;
+  while (right_child_executor_->Next(&right_tuple, &right_rid)) {
+    key_.Clear();
+    key_.Append(plan_->RightJoinKeyExpression()->Evaluate(&right_tuple, plan_->GetRightPlan()->OutputSchema()));
+    if (key_.HasNull()) {
+      // A null join key never compares equal to anything.
+      continue;
+    }
+    bool inserted;
+    hash_t hash = key_.Hash();
+    key_set_.FindOrInsert(key_.Data(), key_.Size(), hash, &inserted);
+    if (inserted) {
+      key_hashes.push_back(hash);
+    }
+  }
+
+  // A semi-join only emits left tuples that can match, so a sequential scan can drop the others early.
+  auto left_scan = dynamic_cast<SeqScanExecutor *>(left_child_executor_.get());
+  if (!is_anti_ && left_scan != nullptr) {
+    bloom_filter_ = std::make_unique<BlockedBloomFilter>(key_hashes.size());
+    for (auto hash : key_hashes) {
+      bloom_filter_->Insert(hash);
+    }
+    if (!left_scan->PushRuntimeFilter(plan_->LeftJoinKeyExpression(), bloom_filter_.get())) {
+      bloom_filter_.reset();
+    }
+  }
+}
+
+void HashSemiJoinExecutor::Init() { left_child_executor_->Init(); }
+
+bool HashSemiJoinExecutor::Next(Tuple *tuple, RID *rid) {
+  Tuple left_tuple;
+  const Schema *left_schema = plan_->GetLeftPlan()->OutputSchema();
+  while (left_child_executor_->Next(&left_tuple, rid)) {
+    key_.Clear();
+    key_.Append(plan_->LeftJoinKeyExpression()->Evaluate(&left_tuple, left_schema));
+    bool is_match = !key_.HasNull() && key_set_.Find(key_) != nullptr;
+    if (is_match != is_anti_) {
+      std::vector<Value> values;
+      values.reserve(plan_->OutputSchema()->GetColumnCount());
+      for (const auto &column : plan_->OutputSchema()->GetColumns()) {
+        values.push_back(column.GetExpr()->Evaluate(&left_tuple, left_schema));
+      }
+      *tuple = Tuple(values, plan_->OutputSchema());
+      return true;
+    }
+  }
+  return false;
+}
+
+}  // namespace bustub
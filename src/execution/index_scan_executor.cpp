@@ -11,12 +11,273 @@
 //===----------------------------------------------------------------------===//
 #include "execution/executors/index_scan_executor.h"
 
+#include <algorithm>
+
+#include "common/exception.h"
+#include "execution/expressions/column_value_expression.h"
+#include "execution/expressions/comparison_expression.h"
+#include "execution/expressions/constant_value_expression.h"
+#include "storage/index/adaptive_radix_tree_index.h"
+#include "storage/index/b_plus_tree_index.h"
+#include "type/value_factory.h"
+
 namespace bustub {
+
 IndexScanExecutor::IndexScanExecutor(ExecutorContext *exec_ctx, const IndexScanPlanNode *plan)
-    : AbstractExecutor(exec_ctx) {}
+    : AbstractExecutor(exec_ctx), plan_(plan) {
+  index_info_ = exec_ctx_->GetCatalog()->GetIndex(plan_->GetIndexOid());
+  table_info_ = exec_ctx_->GetCatalog()->GetTable(index_info_->table_name_);
+
+  out_schema_idx_.reserve(plan_->OutputSchema()->GetColumnCount());
+  try {
+    for (uint32_t i = 0; i < plan_->OutputSchema()->GetColumnCount(); i++) {
+      auto col_name = plan_->OutputSchema()->GetColumn(i).GetName();
+      out_schema_idx_.push_back(table_info_->schema_.GetColIdx(col_name));
+    }
+  } catch (const std::logic_error &error) {
+    for (uint32_t i = 0; i < plan_->OutputSchema()->GetColumnCount(); i++) {
+      out_schema_idx_.push_back(i);
+    }
+  }
+
+  if (plan_->GetPredicate() != nullptr) {
+    predicate_ = plan_->GetPredicate();
+  } else {
+    is_alloc_ = true;
+    predicate_ = new ConstantValueExpression(ValueFactory::GetBooleanValue(true));
+  }
+}
+
+IndexScanExecutor::~IndexScanExecutor() {
+  if (is_alloc_) {
+    delete predicate_;
+  }
+  predicate_ = nullptr;
+}
+
+void IndexScanExecutor::Init() {
+  has_low_key_ = false;
+  has_high_key_ = false;
+  has_next_key_ = false;
+  index_done_ = false;
+  rids_.clear();
+  tuples_.clear();
+  pos_ = 0;
+  DeriveKeyRange();
+}
+
+void IndexScanExecutor::DeriveKeyRange() {
+  // Only (key column) op (constant) on a single column index bounds the scan, anything else scans the whole
+  // index and relies on the predicate alone.
+  auto comparison = dynamic_cast<const ComparisonExpression *>(predicate_);
+  const auto &key_attrs = index_info_->index_->GetKeyAttrs();
+  if (comparison == nullptr || key_attrs.size() != 1) {
+    return;
+  }
+  auto comp_type = comparison->GetComparisonType();
+  auto column = dynamic_cast<const ColumnValueExpression *>(comparison->GetChildAt(0));
+  auto constant = dynamic_cast<const ConstantValueExpression *>(comparison->GetChildAt(1));
+  if (column == nullptr || constant == nullptr) {
+    // Try (constant) op (key column), which bounds the key from the other side.
+    column = dynamic_cast<const ColumnValueExpression *>(comparison->GetChildAt(1));
+    constant = dynamic_cast<const ConstantValueExpression *>(comparison->GetChildAt(0));
+    switch (comp_type) {
+      case ComparisonType::LessThan:
+        comp_type = ComparisonType::GreaterThan;
+        break;
+      case ComparisonType::LessThanOrEqual:
+        comp_type = ComparisonType::GreaterThanOrEqual;
+        break;
+      case ComparisonType::GreaterThan:
+        comp_type = ComparisonType::LessThan;
+        break;
+      case ComparisonType::GreaterThanOrEqual:
+        comp_type = ComparisonType::LessThanOrEqual;
+        break;
+      default:
+        break;
+    }
+  }
+  if (column == nullptr || constant == nullptr || column->GetColIdx() != key_attrs[0]) {
+    return;
+  }
+  Value value = constant->Evaluate(nullptr, nullptr);
+  if (value.IsNull()) {
+    return;
+  }
+  Schema *key_schema = index_info_->index_->GetKeySchema();
+  Value key_value;
+  try {
+    key_value = value.CastAs(key_schema->GetColumn(0).GetType());
+  } catch (Exception &e) {
+    // The constant is not representable in the key type, e.g. out of its range. The predicate still answers
+    // the query on a scan of the whole index.
+    return;
+  }
+  Tuple key({key_value}, key_schema);
+  switch (comp_type) {
+    case ComparisonType::Equal:
+      low_key_ = key;
+      high_key_ = key;
+      has_low_key_ = true;
+      has_high_key_ = true;
+      break;
+    case ComparisonType::LessThan:
+    case ComparisonType::LessThanOrEqual:
+      high_key_ = key;
+      has_high_key_ = true;
+      break;
+    case ComparisonType::GreaterThan:
+    case ComparisonType::GreaterThanOrEqual:
+      low_key_ = key;
+      has_low_key_ = true;
+      break;
+    default:
+      break;
+  }
+}
+
+template <size_t KeySize>
+void IndexScanExecutor::ScanIndex() {
+  using KeyType = GenericKey<KeySize>;
+  auto index = dynamic_cast<BPlusTreeIndex<KeyType, RID, GenericComparator<KeySize>> *>(index_info_->index_.get());
+  if (index == nullptr) {
+    ScanRadixTree<KeySize>();
+    return;
+  }
+  Schema *key_schema = index_info_->index_->GetKeySchema();
+  GenericComparator<KeySize> comparator(key_schema);
+  KeyType key;
+  KeyType high_key;
+  if (has_high_key_) {
+    high_key.SetFromKey(high_key_, key_schema);
+  }
+
+  // No iterator is kept across batches, so that no leaf stays latched while the batch is consumed. A batch
+  // resumes at the first key that did not fit into the previous one; keys are unique so nothing is read twice.
+  bool has_start_key = has_next_key_ || has_low_key_;
+  if (has_start_key) {
+    key.SetFromKey(has_next_key_ ? next_key_ : low_key_, key_schema);
+  }
+  auto iter = has_start_key ? index->GetBeginIterator(key) : index->GetBeginIterator();
+  has_next_key_ = false;
+  for (; !iter.IsEnd(); ++iter) {
+    const auto &entry = *iter;
+    if (has_high_key_ && comparator(entry.first, high_key) > 0) {
+      break;
+    }
+    if (rids_.size() == plan_->RidBatchSize()) {
+      std::vector<Value> values;
+      values.reserve(key_schema->GetColumnCount());
+      for (uint32_t i = 0; i < key_schema->GetColumnCount(); i++) {
+        values.push_back(entry.first.ToValue(key_schema, i));
+      }
+      next_key_ = Tuple(values, key_schema);
+      has_next_key_ = true;
+      return;
+    }
+    rids_.push_back(entry.second);
+  }
+  index_done_ = true;
+}
+
+template <size_t KeySize>
+void IndexScanExecutor::ScanRadixTree() {
+  using KeyType = GenericKey<KeySize>;
+  auto index =
+      dynamic_cast<AdaptiveRadixTreeIndex<KeyType, RID, GenericComparator<KeySize>> *>(index_info_->index_.get());
+  if (index == nullptr) {
+    throw NotImplementedException("IndexScanExecutor only supports B+ tree and adaptive radix tree indexes.");
+  }
+  Schema *key_schema = index_info_->index_->GetKeySchema();
+  // The tree orders keys by their bytes, which only matches the key order for normalized keys. Other keys are
+  // scanned in full and filtered by the predicate alone.
+  bool is_normalized = KeyType::IsNormalized(key_schema);
+  KeyType low_key;
+  KeyType high_key;
+  const KeyType *low = nullptr;
+  const KeyType *high = nullptr;
+  if (has_next_key_ || (has_low_key_ && is_normalized)) {
+    low_key.SetFromKey(has_next_key_ ? next_key_ : low_key_, key_schema);
+    low = &low_key;
+  }
+  if (has_high_key_ && is_normalized) {
+    high_key.SetFromKey(high_key_, key_schema);
+    high = &high_key;
+  }
+
+  // One pair past the batch is the key the next batch starts at.
+  std::vector<std::pair<KeyType, RID>> entries;
+  index->ScanRange(low, high, plan_->RidBatchSize() + 1, &entries);
+  has_next_key_ = entries.size() > plan_->RidBatchSize();
+  if (has_next_key_) {
+    std::vector<Value> values;
+    values.reserve(key_schema->GetColumnCount());
+    for (uint32_t i = 0; i < key_schema->GetColumnCount(); i++) {
+      values.push_back(entries.back().first.ToValue(key_schema, i));
+    }
+    next_key_ = Tuple(values, key_schema);
+    entries.pop_back();
+  } else {
+    index_done_ = true;
+  }
+  for (const auto &entry : entries) {
+    rids_.push_back(entry.second);
+  }
+}
 
-void IndexScanExecutor::Init() {}
+void IndexScanExecutor::FillBatch() {
+  rids_.clear();
+  tuples_.clear();
+  pos_ = 0;
+  switch (index_info_->key_size_) {
+    case 4:
+      ScanIndex<4>();
+      break;
+    case 8:
+      ScanIndex<8>();
+      break;
+    case 16:
+      ScanIndex<16>();
+      break;
+    case 32:
+      ScanIndex<32>();
+      break;
+    case 64:
+      ScanIndex<64>();
+      break;
+    default:
+      throw NotImplementedException("Unsupported index key size.");
+  }
+  // Read the batch in heap order so that every table page is fetched once per batch.
+  std::sort(rids_.begin(), rids_.end(), [](const RID &a, const RID &b) {
+    return a.GetPageId() != b.GetPageId() ? a.GetPageId() < b.GetPageId() : a.GetSlotNum() < b.GetSlotNum();
+  });
+  table_info_->table_->GetTuples(rids_, &tuples_, exec_ctx_->GetTransaction());
+}
 
-bool IndexScanExecutor::Next(Tuple *tuple, RID *rid) { return false; }
+bool IndexScanExecutor::Next(Tuple *tuple, RID *rid) {
+  while (true) {
+    while (pos_ < tuples_.size()) {
+      const Tuple &temp = tuples_[pos_++];
+      auto value = predicate_->Evaluate(&temp, &table_info_->schema_);
+      if (value.GetAs<bool>()) {
+        // Only keep the columns of the out schema
+        std::vector<Value> values;
+        values.reserve(out_schema_idx_.size());
+        for (auto i : out_schema_idx_) {
+          values.push_back(temp.GetValue(&table_info_->schema_, i));
+        }
+        *tuple = Tuple(values, plan_->OutputSchema());
+        *rid = temp.GetRid();
+        return true;
+      }
+    }
+    if (index_done_) {
+      return false;
+    }
+    FillBatch();
+  }
+}
 
 }  // namespace bustub
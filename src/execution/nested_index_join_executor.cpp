@@ -12,14 +12,137 @@
 
 #include "execution/executors/nested_index_join_executor.h"
 
+#include <algorithm>
+#include <cstdint>
+
+#include "common/exception.h"
+#include "execution/expressions/column_value_expression.h"
+#include "execution/expressions/comparison_expression.h"
+
 namespace bustub {
 
 NestIndexJoinExecutor::NestIndexJoinExecutor(ExecutorContext *exec_ctx, const NestedIndexJoinPlanNode *plan,
                                              std::unique_ptr<AbstractExecutor> &&child_executor)
-    : AbstractExecutor(exec_ctx) {}
+    : AbstractExecutor(exec_ctx), plan_(plan), child_executor_(std::move(child_executor)) {
+  table_info_ = exec_ctx_->GetCatalog()->GetTable(plan_->GetInnerTableOid());
+  index_info_ = exec_ctx_->GetCatalog()->GetIndex(plan_->GetIndexName(), table_info_->name_);
+
+  // The predicate equates an outer column with the inner key column, its outer side computes the probe key.
+  const auto &key_attrs = index_info_->index_->GetKeyAttrs();
+  auto comparison = dynamic_cast<const ComparisonExpression *>(plan_->Predicate());
+  if (key_attrs.size() == 1 && comparison != nullptr && comparison->GetComparisonType() == ComparisonType::Equal) {
+    for (uint32_t i = 0; i < 2; i++) {
+      auto outer = dynamic_cast<const ColumnValueExpression *>(comparison->GetChildAt(i));
+      auto inner = dynamic_cast<const ColumnValueExpression *>(comparison->GetChildAt(1 - i));
+      if (outer != nullptr && inner != nullptr && outer->GetTupleIdx() == 0 && inner->GetTupleIdx() == 1 &&
+          inner->GetColIdx() == key_attrs[0]) {
+        outer_key_expr_ = outer;
+      }
+    }
+  }
+  if (outer_key_expr_ == nullptr) {
+    throw NotImplementedException("Nested index join needs an equality on the single column key of the index.");
+  }
+}
+
+void NestIndexJoinExecutor::Init() {
+  child_executor_->Init();
+  child_done_ = false;
+  outer_tuples_.clear();
+  out_tuples_.clear();
+  pos_ = 0;
+}
+
+void NestIndexJoinExecutor::JoinBatch() {
+  outer_tuples_.clear();
+  out_tuples_.clear();
+  pos_ = 0;
+  Tuple outer_tuple;
+  RID outer_rid;
+  while (outer_tuples_.size() < plan_->OuterBatchSize() && child_executor_->Next(&outer_tuple, &outer_rid)) {
+    outer_tuples_.push_back(outer_tuple);
+  }
+  child_done_ = outer_tuples_.size() < plan_->OuterBatchSize();
+
+  // Sort the join keys of the batch, so that the index is probed in key order.
+  const Schema *outer_schema = plan_->GetChildPlan()->OutputSchema();
+  Schema *key_schema = &index_info_->key_schema_;
+  TypeId key_type = key_schema->GetColumn(0).GetType();
+  std::vector<std::pair<Value, size_t>> keys;
+  keys.reserve(outer_tuples_.size());
+  for (size_t i = 0; i < outer_tuples_.size(); i++) {
+    Value key = outer_key_expr_->Evaluate(&outer_tuples_[i], outer_schema);
+    // A null join key never compares equal to anything.
+    if (!key.IsNull()) {
+      keys.emplace_back(key.CastAs(key_type), i);
+    }
+  }
+  std::sort(keys.begin(), keys.end(), [](const auto &a, const auto &b) {
+    return a.first.CompareLessThan(b.first) == CmpBool::CmpTrue;
+  });
+
+  // Probe the index once per distinct key, in one batch; key_matches[key_of[i]] are the RIDs matching the i-th
+  // outer tuple.
+  std::vector<Tuple> probe_keys;
+  std::vector<size_t> key_of(outer_tuples_.size(), SIZE_MAX);
+  for (size_t i = 0; i < keys.size(); i++) {
+    if (i == 0 || keys[i].first.CompareEquals(keys[i - 1].first) != CmpBool::CmpTrue) {
+      probe_keys.emplace_back(std::vector<Value>{keys[i].first}, key_schema);
+    }
+    key_of[keys[i].second] = probe_keys.size() - 1;
+  }
+  std::vector<std::vector<RID>> key_matches;
+  index_info_->index_->ScanKeys(probe_keys, &key_matches, exec_ctx_->GetTransaction());
+  std::vector<RID> rids;
+  for (const auto &matches : key_matches) {
+    rids.insert(rids.end(), matches.begin(), matches.end());
+  }
+
+  // Read the inner tuples of the whole batch in heap order, every page once.
+  auto rid_less = [](const RID &a, const RID &b) {
+    return a.GetPageId() != b.GetPageId() ? a.GetPageId() < b.GetPageId() : a.GetSlotNum() < b.GetSlotNum();
+  };
+  std::sort(rids.begin(), rids.end(), rid_less);
+  rids.erase(std::unique(rids.begin(), rids.end()), rids.end());
+  std::vector<Tuple> inner_tuples;
+  table_info_->table_->GetTuples(rids, &inner_tuples, exec_ctx_->GetTransaction());
 
-void NestIndexJoinExecutor::Init() {}
+  // Join in the order of the outer tuples.
+  const Schema *inner_schema = &table_info_->schema_;
+  for (size_t i = 0; i < outer_tuples_.size(); i++) {
+    if (key_of[i] == SIZE_MAX) {
+      continue;
+    }
+    for (const auto &inner_rid : key_matches[key_of[i]]) {
+      auto inner = std::lower_bound(inner_tuples.begin(), inner_tuples.end(), inner_rid,
+                                    [&](const Tuple &tuple, const RID &rid) { return rid_less(tuple.GetRid(), rid); });
+      if (inner == inner_tuples.end() || !(inner->GetRid() == inner_rid)) {
+        continue;
+      }
+      auto value = plan_->Predicate()->EvaluateJoin(&outer_tuples_[i], outer_schema, &*inner, inner_schema);
+      if (!value.GetAs<bool>()) {
+        continue;
+      }
+      std::vector<Value> values;
+      values.reserve(plan_->OutputSchema()->GetColumnCount());
+      for (const auto &column : plan_->OutputSchema()->GetColumns()) {
+        values.push_back(column.GetExpr()->EvaluateJoin(&outer_tuples_[i], outer_schema, &*inner, inner_schema));
+      }
+      out_tuples_.emplace_back(values, plan_->OutputSchema());
+    }
+  }
+}
 
-bool NestIndexJoinExecutor::Next(Tuple *tuple, RID *rid) { return false; }
+bool NestIndexJoinExecutor::Next(Tuple *tuple, RID *rid) {
+  while (pos_ == out_tuples_.size()) {
+    if (child_done_) {
+      return false;
+    }
+    JoinBatch();
+  }
+  *tuple = out_tuples_[pos_++];
+  *rid = tuple->GetRid();
+  return true;
+}
 
 }  // namespace bustub
@@ -45,39 +45,63 @@ NestedLoopJoinExecutor::~NestedLoopJoinExecutor() {
 void NestedLoopJoinExecutor::Init() {
   left_child_executor_->Init();
   right_child_executor_->Init();
-  is_left_selected_ = left_child_executor_->Next(&left_tuple_, &left_rid_);
+  is_right_selected_ = false;
+  LoadOuterBatch();
 }
 
-bool NestedLoopJoinExecutor::Next(Tuple *tuple, RID *rid) {
-  if (!is_left_selected_) {
-    return false;
+bool NestedLoopJoinExecutor::LoadOuterBatch() {
+  outer_batch_.clear();
+  outer_pos_ = 0;
+  uint32_t batch_size = 0;
+  Tuple left_tuple;
+  RID left_rid;
+  // Always take at least one tuple, so that a zero budget gives the tuple-at-a-time join.
+  while (outer_batch_.empty() || batch_size < plan_->OuterBufferSize()) {
+    if (!left_child_executor_->Next(&left_tuple, &left_rid)) {
+      break;
+    }
+    batch_size += left_tuple.GetLength();
+    outer_batch_.push_back(left_tuple);
   }
-  Tuple right_tuple;
+  return !outer_batch_.empty();
+}
+
+bool NestedLoopJoinExecutor::Next(Tuple *tuple, RID *rid) {
   RID right_rid;
-  while (true) {
-    while (!right_child_executor_->Next(&right_tuple, &right_rid)) {
-      if (!left_child_executor_->Next(&left_tuple_, &left_rid_)) {
-        return false;
+  while (!outer_batch_.empty()) {
+    if (!is_right_selected_) {
+      if (!right_child_executor_->Next(&right_tuple_, &right_rid)) {
+        // The inner side is exhausted for this batch, rescan it for the next one.
+        if (!LoadOuterBatch()) {
+          return false;
+        }
+        right_child_executor_->Init();
+        continue;
       }
-      right_child_executor_->Init();
+      is_right_selected_ = true;
+      outer_pos_ = 0;
     }
-    auto value = predicate_->EvaluateJoin(&left_tuple_, plan_->GetLeftPlan()->OutputSchema(), &right_tuple,
-                                          plan_->GetRightPlan()->OutputSchema());
-    if (value.GetAs<bool>()) {
-      std::vector<Value> values;
-      values.reserve(plan_->OutputSchema()->GetColumnCount());
-      for (const auto &column : plan_->OutputSchema()->GetColumns()) {
-        auto column_expr = reinterpret_cast<const ColumnValueExpression *>(column.GetExpr());
-        if (column_expr->GetTupleIdx() == 0) {
-          values.push_back(left_tuple_.GetValue(plan_->GetLeftPlan()->OutputSchema(), column_expr->GetColIdx()));
-        } else {
-          values.push_back(right_tuple.GetValue(plan_->GetRightPlan()->OutputSchema(), column_expr->GetColIdx()));
+    while (outer_pos_ < outer_batch_.size()) {
+      const Tuple &left_tuple = outer_batch_[outer_pos_++];
+      auto value = predicate_->EvaluateJoin(&left_tuple, plan_->GetLeftPlan()->OutputSchema(), &right_tuple_,
+                                            plan_->GetRightPlan()->OutputSchema());
+      if (value.GetAs<bool>()) {
+        std::vector<Value> values;
+        values.reserve(plan_->OutputSchema()->GetColumnCount());
+        for (const auto &column : plan_->OutputSchema()->GetColumns()) {
+          auto column_expr = reinterpret_cast<const ColumnValueExpression *>(column.GetExpr());
+          if (column_expr->GetTupleIdx() == 0) {
+            values.push_back(left_tuple.GetValue(plan_->GetLeftPlan()->OutputSchema(), column_expr->GetColIdx()));
+          } else {
+            values.push_back(right_tuple_.GetValue(plan_->GetRightPlan()->OutputSchema(), column_expr->GetColIdx()));
+          }
         }
+        *tuple = Tuple(values, plan_->OutputSchema());
+        *rid = left_tuple.GetRid();
+        return true;
       }
-      *tuple = Tuple(values, plan_->OutputSchema());
-      *rid = left_tuple_.GetRid();
-      return true;
     }
+    is_right_selected_ = false;
   }
   return false;
 }
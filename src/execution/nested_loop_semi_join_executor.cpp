@@ -0,0 +1,66 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// nested_loop_semi_join_executor.cpp
+//
+// Identification: src/execution/nested_loop_semi_join_executor.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <vector>
+
+#include "execution/executors/nested_loop_semi_join_executor.h"
+#include "execution/expressions/abstract_expression.h"
+
+namespace bustub {
+
+NestedLoopSemiJoinExecutor::NestedLoopSemiJoinExecutor(ExecutorContext *exec_ctx, const SemiJoinPlanNode *plan,
+                                                       std::unique_ptr<AbstractExecutor> &&left_child,
+                                                       std::unique_ptr<AbstractExecutor> &&right_child)
+    : AbstractExecutor(exec_ctx),
+      plan_(plan),
+      left_child_executor_(std::move(left_child)),
+      right_child_executor_(std::move(right_child)),
+      is_anti_(plan->GetType() == PlanType::AntiJoin) {}
+
+void NestedLoopSemiJoinExecutor::Init() { left_child_executor_->Init(); }
+
+bool NestedLoopSemiJoinExecutor::HasMatch(const Tuple &left_tuple) {
+  Tuple right_tuple;
+  RID right_rid;
+  right_child_executor_->Init();
+  while (right_child_executor_->Next(&right_tuple, &right_rid)) {
+    if (plan_->Predicate() == nullptr) {
+      return true;
+    }
+    auto value = plan_->Predicate()->EvaluateJoin(&left_tuple, plan_->GetLeftPlan()->OutputSchema(), &right_tuple,
+                                                  plan_->GetRightPlan()->OutputSchema());
+    if (value.GetAs<bool>()) {
+      // Stop at the first match, the remaining right tuples cannot change the result.
+      return true;
+    }
+  }
+  return false;
+}
+
+bool NestedLoopSemiJoinExecutor::Next(Tuple *tuple, RID *rid) {
+  Tuple left_tuple;
+  const Schema *left_schema = plan_->GetLeftPlan()->OutputSchema();
+  while (left_child_executor_->Next(&left_tuple, rid)) {
+    if (HasMatch(left_tuple) != is_anti_) {
+      std::vector<Value> values;
+      values.reserve(plan_->OutputSchema()->GetColumnCount());
+      for (const auto &column : plan_->OutputSchema()->GetColumns()) {
+        values.push_back(column.GetExpr()->Evaluate(&left_tuple, left_schema));
+      }
+      *tuple = Tuple(values, plan_->OutputSchema());
+      return true;
+    }
+  }
+  return false;
+}
+
+}  // namespace bustub
@@ -13,6 +13,7 @@
 #include <sstream>
 
 #include "execution/executors/seq_scan_executor.h"
+#include "execution/expressions/column_value_expression.h"
 #include "execution/expressions/comparison_expression.h"
 #include "execution/expressions/constant_value_expression.h"
 #include "type/value_factory.h"
@@ -55,9 +56,26 @@ void SeqScanExecutor::Init() {
   end_ = table_info_->table_->End();
 }
 
+bool SeqScanExecutor::PushRuntimeFilter(const AbstractExpression *key_expr, const BlockedBloomFilter *filter) {
+  auto column_expr = dynamic_cast<const ColumnValueExpression *>(key_expr);
+  if (column_expr == nullptr) {
+    return false;
+  }
+  runtime_filter_ = filter;
+  runtime_filter_col_ = out_schema_idx_[column_expr->GetColIdx()];
+  return true;
+}
+
 bool SeqScanExecutor::Next(Tuple *tuple, RID *rid) {
   while (cur_ != end_) {
     auto temp = cur_++;
+    if (runtime_filter_ != nullptr) {
+      runtime_filter_key_.Clear();
+      runtime_filter_key_.Append(temp->GetValue(&table_info_->schema_, runtime_filter_col_));
+      if (runtime_filter_key_.HasNull() || !runtime_filter_->MayContain(runtime_filter_key_.Hash())) {
+        continue;
+      }
+    }
     auto value = predicate_->Evaluate(&(*temp), &table_info_->schema_);
     if (value.GetAs<bool>()) {
       // Only keep the columns of the out schema
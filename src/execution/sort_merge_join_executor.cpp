@@ -0,0 +1,134 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// sort_merge_join_executor.cpp
+//
+// Identification: src/execution/sort_merge_join_executor.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+
+#include "execution/executors/sort_merge_join_executor.h"
+#include "execution/expressions/column_value_expression.h"
+
+namespace bustub {
+
+SortMergeJoinExecutor::SortMergeJoinExecutor(ExecutorContext *exec_ctx, const SortMergeJoinPlanNode *plan,
+                                             std::unique_ptr<AbstractExecutor> &&left_child,
+                                             std::unique_ptr<AbstractExecutor> &&right_child)
+    : AbstractExecutor(exec_ctx), plan_(plan) {
+  left_.child_ = std::move(left_child);
+  left_.schema_ = plan_->GetLeftPlan()->OutputSchema();
+  left_.key_expr_ = plan_->LeftJoinKeyExpression();
+  left_.is_sorted_ = plan_->IsLeftSorted();
+  right_.child_ = std::move(right_child);
+  right_.schema_ = plan_->GetRightPlan()->OutputSchema();
+  right_.key_expr_ = plan_->RightJoinKeyExpression();
+  right_.is_sorted_ = plan_->IsRightSorted();
+}
+
+void SortMergeJoinExecutor::InitInput(MergeInput *input) {
+  if (input->is_sorted_) {
+    input->child_->Init();
+  } else if (!input->is_materialized_) {
+    input->child_->Init();
+    Tuple tuple;
+    RID rid;
+    while (input->child_->Next(&tuple, &rid)) {
+      Value key = input->key_expr_->Evaluate(&tuple, input->schema_);
+      if (!key.IsNull()) {
+        input->sorted_.emplace_back(key, tuple);
+      }
+    }
+    std::stable_sort(input->sorted_.begin(), input->sorted_.end(), [](const auto &a, const auto &b) {
+      return a.first.CompareLessThan(b.first) == CmpBool::CmpTrue;
+    });
+    input->is_materialized_ = true;
+  }
+  input->pos_ = 0;
+  Advance(input);
+}
+
+void SortMergeJoinExecutor::Advance(MergeInput *input) {
+  if (!input->is_sorted_) {
+    input->is_valid_ = input->pos_ < input->sorted_.size();
+    if (input->is_valid_) {
+      input->key_ = input->sorted_[input->pos_].first;
+      input->tuple_ = input->sorted_[input->pos_].second;
+      input->pos_++;
+    }
+    return;
+  }
+  RID rid;
+  while ((input->is_valid_ = input->child_->Next(&input->tuple_, &rid))) {
+    input->key_ = input->key_expr_->Evaluate(&input->tuple_, input->schema_);
+    // A null join key never compares equal to anything.
+    if (!input->key_.IsNull()) {
+      return;
+    }
+  }
+}
+
+void SortMergeJoinExecutor::Init() {
+  InitInput(&left_);
+  InitInput(&right_);
+  right_run_.clear();
+  in_run_ = false;
+  run_pos_ = 0;
+}
+
+bool SortMergeJoinExecutor::Next(Tuple *tuple, RID *rid) {
+  while (true) {
+    if (in_run_) {
+      if (run_pos_ < right_run_.size()) {
+        *tuple = MakeOutputTuple(right_run_[run_pos_++]);
+        return true;
+      }
+      // The current left tuple is done, the next one may share the key and reuse the run.
+      Advance(&left_);
+      if (left_.is_valid_ && left_.key_.CompareEquals(run_key_) == CmpBool::CmpTrue) {
+        run_pos_ = 0;
+        continue;
+      }
+      in_run_ = false;
+      right_run_.clear();
+    }
+    if (!left_.is_valid_ || !right_.is_valid_) {
+      return false;
+    }
+    if (left_.key_.CompareLessThan(right_.key_) == CmpBool::CmpTrue) {
+      Advance(&left_);
+    } else if (right_.key_.CompareLessThan(left_.key_) == CmpBool::CmpTrue) {
+      Advance(&right_);
+    } else {
+      // Buffer the run of right tuples sharing this key.
+      run_key_ = right_.key_;
+      while (right_.is_valid_ && right_.key_.CompareEquals(run_key_) == CmpBool::CmpTrue) {
+        right_run_.push_back(right_.tuple_);
+        Advance(&right_);
+      }
+      in_run_ = true;
+      run_pos_ = 0;
+    }
+  }
+}
+
+Tuple SortMergeJoinExecutor::MakeOutputTuple(const Tuple &right_tuple) const {
+  std::vector<Value> values;
+  values.reserve(plan_->OutputSchema()->GetColumnCount());
+  for (const auto &column : plan_->OutputSchema()->GetColumns()) {
+    auto column_expr = reinterpret_cast<const ColumnValueExpression *>(column.GetExpr());
+    if (column_expr->GetTupleIdx() == 0) {
+      values.push_back(left_.tuple_.GetValue(left_.schema_, column_expr->GetColIdx()));
+    } else {
+      values.push_back(right_tuple.GetValue(right_.schema_, column_expr->GetColIdx()));
+    }
+  }
+  return Tuple(values, plan_->OutputSchema());
+}
+
+}  // namespace bustub
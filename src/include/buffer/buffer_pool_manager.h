@@ -12,6 +12,7 @@
 
 #pragma once
 
+#include <future>  // NOLINT
 #include <list>
 #include <mutex>  // NOLINT
 #include <unordered_map>
@@ -84,6 +85,15 @@ class BufferPoolManager {
     GradingCallback(callback, CallbackType::AFTER, INVALID_PAGE_ID);
   }
 
+  /**
+   * Starts reading a page into the buffer pool in the background, without pinning it. This is only a hint,
+   * the page may not be resident or may already be evicted again when it is fetched.
+   * @param page_id id of page to be prefetched
+   * @return a future that becomes ready once the prefetch is done, the caller must wait for it before it
+   * destroys the buffer pool or the disk manager
+   */
+  std::future<void> PrefetchPage(page_id_t page_id) { return PrefetchPgImp(page_id); }
+
   /** @return size of the buffer pool */
   virtual size_t GetPoolSize() = 0;
 
@@ -141,5 +151,16 @@ class BufferPoolManager {
    * Flushes all the pages in the buffer pool to disk.
    */
   virtual void FlushAllPgsImp() = 0;
+
+  /**
+   * Reads a page into the buffer pool in the background. The default implementation ignores the hint.
+   * @param page_id id of page to be prefetched
+   * @return a future that becomes ready once the prefetch is done
+   */
+  virtual std::future<void> PrefetchPgImp(page_id_t page_id) {
+    std::promise<void> done;
+    done.set_value();
+    return done.get_future();
+  }
 };
 }  // namespace bustub
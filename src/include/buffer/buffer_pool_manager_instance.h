@@ -12,9 +12,13 @@
 
 #pragma once
 
+#include <condition_variable>  // NOLINT
+#include <deque>
 #include <list>
 #include <mutex>  // NOLINT
+#include <thread>  // NOLINT
 #include <unordered_map>
+#include <utility>
 
 #include "buffer/buffer_pool_manager.h"
 #include "buffer/lru_replacer.h"
@@ -100,6 +104,13 @@ class BufferPoolManagerInstance : public BufferPoolManager {
    */
   void FlushAllPgsImp() override;
 
+  /**
+   * Queues a page to be read into the buffer pool by the prefetch thread, which is started on first use.
+   * @param page_id id of page to be prefetched
+   * @return a future that becomes ready once the prefetch is done
+   */
+  std::future<void> PrefetchPgImp(page_id_t page_id) override;
+
   /**
    * Allocate a page on disk.∂
    * @return the id of the allocated page
@@ -145,6 +156,19 @@ class BufferPoolManagerInstance : public BufferPoolManager {
   /** This latch protects shared data structures. We recommend updating this comment to describe what it protects. */
   std::mutex latch_;
 
+  /** Maximum number of queued prefetches, further hints are dropped */
+  static constexpr size_t MAX_PREFETCH_QUEUE_SIZE = 64;
+  /** Pages waiting to be prefetched, with the promises handed to their callers */
+  std::deque<std::pair<page_id_t, std::promise<void>>> prefetch_queue_;
+  /** Protects prefetch_queue_ and stop_prefetch_ */
+  std::mutex prefetch_latch_;
+  /** Signals the prefetch thread that a page was queued or that it has to stop */
+  std::condition_variable prefetch_cv_;
+  /** Reads queued pages into the buffer pool */
+  std::thread prefetch_thread_;
+  /** Set when the buffer pool is destroyed */
+  bool stop_prefetch_{false};
+
  private:
   /**
    * Find a fresh page.
@@ -164,5 +188,14 @@ class BufferPoolManagerInstance : public BufferPoolManager {
    * @return the frame id of the page, or -1 if not found.
    */
   frame_id_t FindPage(page_id_t page_id);
+
+  /** Main loop of the prefetch thread. */
+  void PrefetchLoop();
+
+  /**
+   * Read a page into an unpinned frame, unless it is resident already or every frame is pinned.
+   * @param page_id the page id of the page to be read.
+   */
+  void PrefetchPg(page_id_t page_id);
 };
 }  // namespace bustub
@@ -90,6 +90,13 @@ class ParallelBufferPoolManager : public BufferPoolManager {
    */
   void FlushAllPgsImp() override;
 
+  /**
+   * Reads a page into the buffer pool in the background.
+   * @param page_id id of page to be prefetched
+   * @return a future that becomes ready once the prefetch is done
+   */
+  std::future<void> PrefetchPgImp(page_id_t page_id) override;
+
  private:
   std::vector<BufferPoolManagerInstance *> bpmis_;
   uint32_t last_alloc_index_{0};
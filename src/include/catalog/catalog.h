@@ -21,8 +21,13 @@
 #include "buffer/buffer_pool_manager.h"
 #include "catalog/schema.h"
 #include "container/hash/hash_function.h"
+#include "storage/index/adaptive_radix_tree_index.h"
+#include "storage/index/b_plus_tree_index.h"
 #include "storage/index/extendible_hash_table_index.h"
 #include "storage/index/index.h"
+#include "storage/index/linear_probe_hash_table_index.h"
+#include "storage/index/lsm_tree_index.h"
+#include "storage/index/varlen_b_plus_tree_index.h"
 #include "storage/table/table_heap.h"
 
 namespace bustub {
@@ -34,6 +39,9 @@ using table_oid_t = uint32_t;
 using column_oid_t = uint32_t;
 using index_oid_t = uint32_t;
 
+/** The data structures an index can be built on. */
+enum class IndexType { HashTable, BPlusTree, LinearProbeHashTable, AdaptiveRadixTree, LSMTree, VarlenBPlusTree };
+
 /**
  * The TableInfo class maintains metadata about a table.
  */
@@ -186,12 +194,17 @@ class Catalog {
    * @param key_attrs Key attributes
    * @param keysize Size of the key
    * @param hash_function The hash function for the index
+   * @param index_type The data structure of the index, B+ tree and adaptive radix tree indexes only support unique keys
+   * @param fill_factor Share of every page that is filled when a B+ tree index is bulk loaded
+   * @param build_threads Number of threads that scan and sort the table when a B+ tree index is bulk loaded
    * @return A (non-owning) pointer to the metadata of the new table
    */
   template <class KeyType, class ValueType, class KeyComparator>
   IndexInfo *CreateIndex(Transaction *txn, const std::string &index_name, const std::string &table_name,
                          const Schema &schema, const Schema &key_schema, const std::vector<uint32_t> &key_attrs,
-                         std::size_t keysize, HashFunction<KeyType> hash_function) {
+                         std::size_t keysize, HashFunction<KeyType> hash_function,
+                         IndexType index_type = IndexType::HashTable,
+                         double fill_factor = BPLUSTREE_DEFAULT_FILL_FACTOR, std::size_t build_threads = 1) {
     // Reject the creation request for nonexistent table
     if (table_names_.find(table_name) == table_names_.end()) {
       return NULL_INDEX_INFO;
@@ -210,18 +223,33 @@ class Catalog {
     // Construct index metdata
     auto meta = std::make_unique<IndexMetadata>(index_name, table_name, &schema, key_attrs);
 
-    // Construct the index, take ownership of metadata
-    // TODO(Kyle): We should update the API for CreateIndex
-    // to allow specification of the index type itself, not
-    // just the key, value, and comparator types
-    auto index = std::make_unique<ExtendibleHashTableIndex<KeyType, ValueType, KeyComparator>>(std::move(meta), bpm_,
-                                                                                               hash_function);
-
-    // Populate the index with all tuples in table heap
+    // Construct the index, take ownership of metadata, and populate it with all tuples in table heap
     auto *table_meta = GetTable(table_name);
     auto *heap = table_meta->table_.get();
-    for (auto tuple = heap->Begin(txn); tuple != heap->End(); ++tuple) {
-      index->InsertEntry(tuple->KeyFromTuple(schema, key_schema, key_attrs), tuple->GetRid(), txn);
+    std::unique_ptr<Index> index;
+    if (index_type == IndexType::BPlusTree) {
+      // A B+ tree is bulk loaded from the sorted keys instead of inserting every tuple at a random position
+      auto tree = std::make_unique<BPlusTreeIndex<KeyType, ValueType, KeyComparator>>(std::move(meta), bpm_);
+      tree->BulkLoad(heap, schema, fill_factor, build_threads, txn);
+      index = std::move(tree);
+    } else {
+      if (index_type == IndexType::LinearProbeHashTable) {
+        index = std::make_unique<LinearProbeHashTableIndex<KeyType, ValueType, KeyComparator>>(std::move(meta), bpm_,
+                                                                                              hash_function);
+      } else if (index_type == IndexType::AdaptiveRadixTree) {
+        index = std::make_unique<AdaptiveRadixTreeIndex<KeyType, ValueType, KeyComparator>>(std::move(meta));
+      } else if (index_type == IndexType::LSMTree) {
+        index = std::make_unique<LSMTreeIndex<KeyType, ValueType, KeyComparator>>(std::move(meta), bpm_, hash_function);
+      } else if (index_type == IndexType::VarlenBPlusTree) {
+        // the key size of the template arguments does not apply, keys take up their own length
+        index = std::make_unique<VarlenBPlusTreeIndex>(std::move(meta), bpm_);
+      } else {
+        index = std::make_unique<ExtendibleHashTableIndex<KeyType, ValueType, KeyComparator>>(std::move(meta), bpm_,
+                                                                                             hash_function);
+      }
+      for (auto tuple = heap->Begin(txn); tuple != heap->End(); ++tuple) {
+        index->InsertEntry(tuple->KeyFromTuple(schema, key_schema, key_attrs), tuple->GetRid(), txn);
+      }
     }
 
     // Get the next OID for the new index
@@ -12,25 +12,72 @@
 
 #pragma once
 
-#include <climits>
-#include <condition_variable>  // NOLINT
-#include <mutex>               // NOLINT
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <thread>  // NOLINT
+
+#ifdef __linux__
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
 
 #include "common/macros.h"
 
 namespace bustub {
 
+/** Hints the CPU that the thread is spinning. */
+inline void CpuRelax() {
+#if defined(__x86_64__) || defined(__i386__)
+  __builtin_ia32_pause();
+#elif defined(__aarch64__)
+  asm volatile("yield");  // NOLINT
+#endif
+}
+
+/** Blocks the thread while *word == expected, or until it is woken. May return spuriously. */
+inline void FutexWait(std::atomic<uint32_t> *word, uint32_t expected) {
+  static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t));
+#ifdef __linux__
+  syscall(SYS_futex, reinterpret_cast<uint32_t *>(word), FUTEX_WAIT_PRIVATE, expected, nullptr, nullptr, 0);
+#else
+  // without futexes waiting degrades to yielding
+  (void)word;
+  (void)expected;
+  std::this_thread::yield();
+#endif
+}
+
+/** Wakes every thread blocked in FutexWait() on word. */
+inline void FutexWakeAll(std::atomic<uint32_t> *word) {
+#ifdef __linux__
+  syscall(SYS_futex, reinterpret_cast<uint32_t *>(word), FUTEX_WAKE_PRIVATE, INT32_MAX, nullptr, nullptr, 0);
+#else
+  (void)word;
+#endif
+}
+
 /**
- * Reader-Writer latch backed by std::mutex.
+ * Reader-Writer latch in a single 32-bit word, holding a writer bit, a parked bit and the number of readers.
+ * Uncontended acquires and releases are a single atomic instruction. Waiting threads spin for a while and
+ * then park on the word with a futex; the parked bit tells the releasing thread that it has to wake them.
+ *
+ * Writers are preferred: a writer sets the writer bit first, which keeps new readers out, and then waits
+ * for the readers that are inside to leave.
+ *
+ * The latch is small enough to be embedded in every page. Readers of a latch shared by all threads still
+ * write to the same cache line; StripedReaderWriterLatch avoids that at the cost of a larger footprint.
  */
 class ReaderWriterLatch {
-  using mutex_t = std::mutex;
-  using cond_t = std::condition_variable;
-  static const uint32_t MAX_READERS = UINT_MAX;
+  static constexpr uint32_t WRITER = 1U << 31;
+  static constexpr uint32_t PARKED = 1U << 30;
+  static constexpr uint32_t READER_MASK = PARKED - 1;
+  static constexpr uint32_t SPIN_LIMIT = 128;
 
  public:
   ReaderWriterLatch() = default;
-  ~ReaderWriterLatch() { std::lock_guard<mutex_t> guard(mutex_); }
+  ~ReaderWriterLatch() = default;
 
   DISALLOW_COPY(ReaderWriterLatch);
 
@@ -38,59 +85,230 @@ class ReaderWriterLatch {
    * Acquire a write latch.
    */
   void WLock() {
-    std::unique_lock<mutex_t> latch(mutex_);
-    while (writer_entered_) {
-      reader_.wait(latch);
+    uint32_t spins = 0;
+    uint32_t state = state_.load(std::memory_order_relaxed);
+    while (true) {
+      if ((state & WRITER) == 0) {
+        if (state_.compare_exchange_weak(state, state | WRITER, std::memory_order_acquire,
+                                         std::memory_order_relaxed)) {
+          break;
+        }
+        continue;
+      }
+      state = Wait(state, &spins);
     }
-    writer_entered_ = true;
-    while (reader_count_ > 0) {
-      writer_.wait(latch);
+    // new readers are kept out, wait for the ones inside
+    spins = 0;
+    state = state_.load(std::memory_order_acquire);
+    while ((state & READER_MASK) != 0) {
+      state = Wait(state, &spins);
     }
   }
 
+  /**
+   * Acquire a write latch if no other thread holds the latch.
+   * @return true if the latch was acquired
+   */
+  bool TryWLock() {
+    uint32_t state = state_.load(std::memory_order_relaxed);
+    return (state & (WRITER | READER_MASK)) == 0 &&
+           state_.compare_exchange_strong(state, state | WRITER, std::memory_order_acquire, std::memory_order_relaxed);
+  }
+
   /**
    * Release a write latch.
    */
   void WUnlock() {
-    std::lock_guard<mutex_t> guard(mutex_);
-    writer_entered_ = false;
-    reader_.notify_all();
+    uint32_t state = state_.fetch_and(~(WRITER | PARKED), std::memory_order_release);
+    if ((state & PARKED) != 0) {
+      FutexWakeAll(&state_);
+    }
   }
 
   /**
    * Acquire a read latch.
    */
   void RLock() {
-    std::unique_lock<mutex_t> latch(mutex_);
-    while (writer_entered_ || reader_count_ == MAX_READERS) {
-      reader_.wait(latch);
+    uint32_t spins = 0;
+    uint32_t state = state_.load(std::memory_order_relaxed);
+    while (true) {
+      if ((state & WRITER) == 0) {
+        if (state_.compare_exchange_weak(state, state + 1, std::memory_order_acquire, std::memory_order_relaxed)) {
+          return;
+        }
+        continue;
+      }
+      state = Wait(state, &spins);
+    }
+  }
+
+  /**
+   * Acquire a read latch if no writer holds or waits for the latch.
+   * @return true if the latch was acquired
+   */
+  bool TryRLock() {
+    uint32_t state = state_.load(std::memory_order_relaxed);
+    while ((state & WRITER) == 0) {
+      if (state_.compare_exchange_weak(state, state + 1, std::memory_order_acquire, std::memory_order_relaxed)) {
+        return true;
+      }
     }
-    reader_count_++;
+    return false;
   }
 
   /**
    * Release a read latch.
    */
   void RUnlock() {
-    std::lock_guard<mutex_t> guard(mutex_);
-    reader_count_--;
-    if (writer_entered_) {
-      if (reader_count_ == 0) {
-        writer_.notify_one();
+    uint32_t state = state_.fetch_sub(1, std::memory_order_release);
+    // the last reader wakes a writer waiting for the readers to leave
+    if ((state & READER_MASK) == 1 && (state & PARKED) != 0) {
+      state_.fetch_and(~PARKED, std::memory_order_relaxed);
+      FutexWakeAll(&state_);
+    }
+  }
+
+ private:
+  /**
+   * Waits for the latch word to change from state, spinning first and parking after SPIN_LIMIT rounds.
+   * @return the current state
+   */
+  uint32_t Wait(uint32_t state, uint32_t *spins) {
+    if (*spins < SPIN_LIMIT) {
+      ++*spins;
+      CpuRelax();
+      return state_.load(std::memory_order_acquire);
+    }
+    if ((state & PARKED) == 0) {
+      if (!state_.compare_exchange_weak(state, state | PARKED, std::memory_order_relaxed)) {
+        return state;
+      }
+      state |= PARKED;
+    }
+    // whoever clears the parked bit wakes all parked threads after it
+    FutexWait(&state_, state);
+    return state_.load(std::memory_order_acquire);
+  }
+
+  std::atomic<uint32_t> state_{0};
+};
+
+/**
+ * Reader-Writer latch for latches that every thread takes in read mode, like the global transaction latch.
+ * Readers announce themselves on a per-thread stripe of counters, each in its own cache line, so that
+ * readers on different cores do not write to a shared line. Threads are spread over the stripes round-robin
+ * when they first use a latch; a read latch may be released by another thread than the one that acquired it,
+ * since only the sum of the stripes is meaningful.
+ *
+ * A writer first takes writer_latch_, which serializes the writers, then publishes itself in writer_ and
+ * waits for the sum of the stripes to drop to zero, spinning and then parking on writer_. Readers that see
+ * a writer back out of their stripe and wait on writer_latch_ in read mode until the writer is done, which
+ * gives writers preference. Acquiring a write latch has to visit every stripe, so the latch suits read-mostly
+ * use only.
+ */
+class StripedReaderWriterLatch {
+  static constexpr size_t NUM_STRIPES = 16;
+  static constexpr size_t CACHE_LINE_SIZE = 64;
+  static constexpr uint32_t SPIN_LIMIT = 128;
+
+  /** writer_ states */
+  static constexpr uint32_t NO_WRITER = 0;
+  static constexpr uint32_t WRITER_ACTIVE = 1;
+  static constexpr uint32_t WRITER_PARKED = 2;
+
+ public:
+  StripedReaderWriterLatch() = default;
+  ~StripedReaderWriterLatch() = default;
+
+  DISALLOW_COPY(StripedReaderWriterLatch);
+
+  /**
+   * Acquire a write latch.
+   */
+  void WLock() {
+    writer_latch_.WLock();
+    writer_.store(WRITER_ACTIVE);
+    uint32_t spins = 0;
+    while (ReaderCount() != 0) {
+      if (spins < SPIN_LIMIT) {
+        ++spins;
+        CpuRelax();
+        continue;
       }
-    } else {
-      if (reader_count_ == MAX_READERS - 1) {
-        reader_.notify_one();
+      uint32_t expected = WRITER_ACTIVE;
+      writer_.compare_exchange_strong(expected, WRITER_PARKED);
+      // a reader that leaves after this check sees WRITER_PARKED and wakes the writer
+      if (ReaderCount() == 0) {
+        break;
+      }
+      FutexWait(&writer_, WRITER_PARKED);
+    }
+    writer_.store(WRITER_ACTIVE, std::memory_order_relaxed);
+  }
+
+  /**
+   * Release a write latch.
+   */
+  void WUnlock() {
+    writer_.store(NO_WRITER);
+    writer_latch_.WUnlock();
+  }
+
+  /**
+   * Acquire a read latch.
+   */
+  void RLock() {
+    std::atomic<int64_t> *count = &stripes_[StripeIndex()].count_;
+    while (true) {
+      count->fetch_add(1);
+      if (writer_.load() == NO_WRITER) {
+        return;
       }
+      Leave(count);
+      // block until the writer releases its latch
+      writer_latch_.RLock();
+      writer_latch_.RUnlock();
     }
   }
 
+  /**
+   * Release a read latch.
+   */
+  void RUnlock() { Leave(&stripes_[StripeIndex()].count_); }
+
  private:
-  mutex_t mutex_;
-  cond_t writer_;
-  cond_t reader_;
-  uint32_t reader_count_{0};
-  bool writer_entered_{false};
+  struct alignas(CACHE_LINE_SIZE) Stripe {
+    std::atomic<int64_t> count_{0};
+  };
+
+  /** @return the stripe of the calling thread */
+  static size_t StripeIndex() {
+    static std::atomic<size_t> next_stripe{0};
+    thread_local size_t stripe = next_stripe.fetch_add(1, std::memory_order_relaxed) % NUM_STRIPES;
+    return stripe;
+  }
+
+  /** @return the number of readers holding the latch, or announcing themselves */
+  int64_t ReaderCount() const {
+    int64_t count = 0;
+    for (const auto &stripe : stripes_) {
+      count += stripe.count_.load();
+    }
+    return count;
+  }
+
+  /** Removes a reader from a stripe, and wakes a writer that waits for the readers to leave. */
+  void Leave(std::atomic<int64_t> *count) {
+    count->fetch_sub(1);
+    uint32_t expected = WRITER_PARKED;
+    if (writer_.load() == WRITER_PARKED && writer_.compare_exchange_strong(expected, WRITER_ACTIVE)) {
+      FutexWakeAll(&writer_);
+    }
+  }
+
+  Stripe stripes_[NUM_STRIPES];
+  std::atomic<uint32_t> writer_{NO_WRITER};
+  ReaderWriterLatch writer_latch_;
 };
 
 }  // namespace bustub
@@ -105,8 +105,8 @@ class TransactionManager {
   LockManager *lock_manager_[[maybe_unused]];
   LogManager *log_manager_[[maybe_unused]];
 
-  /** The global transaction latch is used for checkpointing. */
-  ReaderWriterLatch global_txn_latch_;
+  /** The global transaction latch is used for checkpointing. Every transaction holds it in read mode. */
+  StripedReaderWriterLatch global_txn_latch_;
 };
 
 }  // namespace bustub
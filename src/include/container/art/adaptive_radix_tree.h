@@ -0,0 +1,322 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// adaptive_radix_tree.h
+//
+// Identification: src/include/container/art/adaptive_radix_tree.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>  // NOLINT
+#include <utility>
+#include <vector>
+
+#include "common/macros.h"
+
+namespace bustub {
+
+#define ADAPTIVE_RADIX_TREE_TYPE AdaptiveRadixTree<KeyType, ValueType>
+
+/**
+ * Implementation of an adaptive radix tree (ART), an in-memory ordered index that does not go through the
+ * buffer pool. Keys are unique; inserting a key that is already present fails, like in the B+ tree.
+ *
+ * The key is treated as a string of sizeof(KeyType) bytes and the tree branches on one byte per level, so
+ * pairs are ordered by the bytes of their keys. A GenericKey that is stored normalized orders like its
+ * columns. Every inner node stores the bytes that all keys below it share as its prefix, which collapses
+ * chains of single-child nodes. Depending on its number of children an inner node is one of four types
+ * (4, 16, 48 or 256 children), so sparse levels stay small and dense levels are a single array lookup.
+ * Leaves hold the full key and the value; a child pointer with its lowest bit set points to a leaf.
+ *
+ * Concurrency: optimistic lock coupling. Every inner node has a version that writers increment while they
+ * hold the node's lock. Readers do not lock anything: they read a node, then check that its version did not
+ * change, and restart the operation from the root if it did. Writers traverse the same way and only lock the
+ * node they change, plus its parent if the node is replaced. Nodes that are replaced or removed are freed once
+ * no operation that may still read them is running (epoch-based reclamation).
+ */
+template <typename KeyType, typename ValueType>
+class AdaptiveRadixTree {
+ public:
+  AdaptiveRadixTree();
+
+  ~AdaptiveRadixTree();
+
+  DISALLOW_COPY_AND_MOVE(AdaptiveRadixTree);
+
+  /**
+   * Inserts a key-value pair into the tree.
+   *
+   * @param key the key to create
+   * @param value the value to be associated with the key
+   * @return true if insert succeeded, false if the key is already present
+   */
+  bool Insert(const KeyType &key, const ValueType &value);
+
+  /**
+   * Deletes a key and its value from the tree.
+   *
+   * @param key the key to delete
+   * @return true if remove succeeded, false if the key is not present
+   */
+  bool Remove(const KeyType &key);
+
+  /**
+   * Performs a point query on the tree.
+   *
+   * @param key the key to look up
+   * @param[out] result the value associated with the key is appended to it
+   * @return true if the key is present
+   */
+  bool GetValue(const KeyType &key, std::vector<ValueType> *result);
+
+  /**
+   * Appends the pairs with low <= key <= high to result, in key order.
+   *
+   * A scan that is interrupted by a concurrent change resumes after the last pair it appended, so no pair is
+   * returned twice.
+   *
+   * @param low the smallest key of the range, nullptr for no lower bound
+   * @param high the largest key of the range, nullptr for no upper bound
+   * @param max_pairs the scan stops after appending this many pairs
+   * @param[out] result the pairs of the range
+   */
+  void Scan(const KeyType *low, const KeyType *high, size_t max_pairs,
+            std::vector<std::pair<KeyType, ValueType>> *result);
+
+  /**
+   * @return the number of key-value pairs in the tree
+   */
+  size_t GetSize() const { return size_.load(); }
+
+ private:
+  static constexpr uint32_t KEY_SIZE = sizeof(KeyType);
+
+  enum class NodeType : uint8_t { NODE4, NODE16, NODE48, NODE256 };
+
+  /** Header of all inner nodes. */
+  struct Node {
+    explicit Node(NodeType type) : type_(type) {}
+
+    /**
+     * Waits until the node is not locked and reads its version.
+     * @param[out] version the version of the node
+     * @return false if the node is obsolete, the operation has to restart
+     */
+    bool ReadLock(uint64_t *version) const;
+
+    /** @return true if the node was not changed since it had the version */
+    bool Validate(uint64_t version) const;
+
+    /** Locks the node if it still has the version. @return false if it does not, the operation has to restart */
+    bool Upgrade(uint64_t version);
+
+    /** Waits for and locks the node. @return false if the node is obsolete */
+    bool WriteLock();
+
+    void WriteUnlock() { version_.fetch_add(LOCKED); }
+
+    /** Unlocks a node that was unlinked from the tree, all readers of it will restart. */
+    void WriteUnlockObsolete() { version_.fetch_add(LOCKED | OBSOLETE); }
+
+    static constexpr uint64_t OBSOLETE = 0b01;
+    static constexpr uint64_t LOCKED = 0b10;
+
+    std::atomic<uint64_t> version_{0};
+    NodeType type_;
+    uint16_t num_children_{0};
+    // the bytes shared by all keys below the node, which no node on the path stores
+    uint32_t prefix_len_{0};
+    uint8_t prefix_[KEY_SIZE];
+  };
+
+  /** Up to 4 children, keys_ is sorted. */
+  struct Node4 : Node {
+    Node4() : Node(NodeType::NODE4) {}
+    uint8_t keys_[4];
+    Node *children_[4];
+  };
+
+  /** Up to 16 children, keys_ is sorted and searched with one SIMD compare. */
+  struct Node16 : Node {
+    Node16() : Node(NodeType::NODE16) {}
+    uint8_t keys_[16];
+    Node *children_[16];
+  };
+
+  /** Up to 48 children, child_index_ maps a byte to its slot in children_ plus one, 0 if there is no child. */
+  struct Node48 : Node {
+    Node48() : Node(NodeType::NODE48) {}
+    uint8_t child_index_[256]{};
+    Node *children_[48]{};
+  };
+
+  /** A child for every byte. */
+  struct Node256 : Node {
+    Node256() : Node(NodeType::NODE256) {}
+    Node *children_[256]{};
+  };
+
+  struct Leaf {
+    KeyType key_;
+    ValueType value_;
+  };
+
+  /** Outcome of scanning a subtree. */
+  enum class ScanState { CONTINUE, DONE, RESTART };
+
+  /** The range and the output of a scan. */
+  struct ScanContext {
+    const uint8_t *low_;
+    // whether low_ itself is excluded, when a scan resumes after its last pair
+    bool low_exclusive_;
+    const uint8_t *high_;
+    size_t max_pairs_;
+    size_t num_pairs_;
+    std::vector<std::pair<KeyType, ValueType>> *result_;
+  };
+
+  static const uint8_t *KeyBytes(const KeyType &key) { return reinterpret_cast<const uint8_t *>(&key); }
+
+  static bool IsLeaf(const Node *node) { return (reinterpret_cast<uintptr_t>(node) & 1) != 0; }
+
+  static Leaf *AsLeaf(Node *node) { return reinterpret_cast<Leaf *>(reinterpret_cast<uintptr_t>(node) & ~1ULL); }
+
+  static Node *LeafPointer(Leaf *leaf) { return reinterpret_cast<Node *>(reinterpret_cast<uintptr_t>(leaf) | 1); }
+
+  /**
+   * Reads the prefix length of a node at a level. A length that runs past the key can only be read while the
+   * node is changed.
+   *
+   * @param node the node
+   * @param level the number of key bytes consumed above the node
+   * @param[out] prefix_len the prefix length of the node
+   * @return false if the length is inconsistent, the operation has to restart
+   */
+  static bool ReadPrefixLength(const Node *node, uint32_t level, uint32_t *prefix_len);
+
+  /** @return the number of bytes of the node's prefix that match the key from level on */
+  static uint32_t MatchPrefix(const Node *node, const uint8_t *key, uint32_t level, uint32_t prefix_len);
+
+  /** @return the child of node for the byte, nullptr if there is none */
+  static Node *FindChild(const Node *node, uint8_t byte);
+
+  /**
+   * @param node the node
+   * @param from the smallest byte to look at, 256 for none
+   * @param[out] byte the byte of the child
+   * @return the child of node with the smallest byte >= from, nullptr if there is none
+   */
+  static Node *NextChild(const Node *node, uint32_t from, uint8_t *byte);
+
+  /** @return whether a child can only be added after the node is replaced by a larger one */
+  static bool IsFull(const Node *node);
+
+  /** @return whether the node is replaced by a smaller one when a child is removed */
+  static bool IsUnderfull(const Node *node);
+
+  /** Adds a child to a node that is not full. */
+  static void AddChild(Node *node, uint8_t byte, Node *child);
+
+  /** Replaces the child of a node for the byte. */
+  static void ChangeChild(Node *node, uint8_t byte, Node *child);
+
+  /** Removes the child of a node for the byte. */
+  static void RemoveChild(Node *node, uint8_t byte);
+
+  static Node *NewNode(NodeType type);
+
+  /** @return a copy of node with the next larger type */
+  static Node *Grow(const Node *node);
+
+  /** @return a copy of node with the next smaller type, without its child for the byte */
+  static Node *Shrink(const Node *node, uint8_t byte);
+
+  /** Frees an inner node or a leaf. */
+  static void FreeNode(Node *node);
+
+  /** Frees a subtree. */
+  static void FreeSubtree(Node *node);
+
+  /**
+   * One attempt to insert a leaf. @return false if the attempt has to restart, *inserted is set otherwise
+   */
+  bool TryInsert(Leaf *leaf, bool *inserted);
+
+  /**
+   * One attempt to remove a key. @return false if the attempt has to restart, *removed is set otherwise
+   */
+  bool TryRemove(const uint8_t *key, bool *removed);
+
+  /**
+   * One attempt to look up a key. @return false if the attempt has to restart, *leaf is set otherwise
+   */
+  bool TryGetValue(const uint8_t *key, Leaf **leaf);
+
+  /**
+   * Scans the subtree of a node in key order.
+   *
+   * @param node the node, which the caller read with the version
+   * @param version the version of the node
+   * @param level the number of key bytes consumed above the node
+   * @param on_low whether the path to the node equals the lower bound
+   * @param on_high whether the path to the node equals the upper bound
+   * @param context the range and the output of the scan
+   */
+  ScanState ScanNode(Node *node, uint64_t version, uint32_t level, bool on_low, bool on_high,
+                     ScanContext *context);
+
+  /**
+   * Marks the calling thread as reading the tree, nodes retired from now on are not freed until it leaves.
+   * @return the slot of the thread
+   */
+  size_t EnterEpoch();
+
+  void LeaveEpoch(size_t slot) { epoch_slots_[slot].epoch_.store(0); }
+
+  /** Frees a node or leaf that was unlinked from the tree once no running operation can still reach it. */
+  void Retire(Node *node);
+
+  /** Frees the retired nodes that no running operation can reach. The caller holds garbage_latch_. */
+  void Reclaim();
+
+  /** Keeps the calling thread in an epoch for its lifetime. */
+  class EpochGuard {
+   public:
+    explicit EpochGuard(AdaptiveRadixTree *tree) : tree_(tree), slot_(tree->EnterEpoch()) {}
+    ~EpochGuard() { tree_->LeaveEpoch(slot_); }
+    DISALLOW_COPY_AND_MOVE(EpochGuard);
+
+   private:
+    AdaptiveRadixTree *tree_;
+    size_t slot_;
+  };
+
+  /** The epoch of a running operation, 0 if the slot is free. */
+  struct alignas(64) EpochSlot {
+    std::atomic<uint64_t> epoch_{0};
+  };
+
+  static constexpr size_t NUM_EPOCH_SLOTS = 128;
+  // retired nodes are reclaimed in batches of this size
+  static constexpr size_t RECLAIM_THRESHOLD = 64;
+
+  // member variables
+  // the root is a Node256 without prefix, so it is never replaced
+  Node *root_;
+  std::atomic<size_t> size_{0};
+
+  std::atomic<uint64_t> global_epoch_{1};
+  EpochSlot epoch_slots_[NUM_EPOCH_SLOTS];
+  std::mutex garbage_latch_;
+  // retired nodes and the epoch they were retired in
+  std::vector<std::pair<uint64_t, Node *>> garbage_;
+};
+
+}  // namespace bustub
@@ -0,0 +1,93 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// arena.h
+//
+// Identification: src/include/container/hash/arena.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "common/macros.h"
+
+namespace bustub {
+
+/**
+ * Arena is a bump-pointer allocator. Memory is handed out from large blocks and is only released
+ * all at once, when the arena is reset or destroyed. Pointers returned by Allocate() stay valid
+ * until then, so hash tables can keep raw pointers into the arena across rehashes.
+ */
+class Arena {
+ public:
+  /** Default size of each block requested from the system allocator */
+  static constexpr size_t DEFAULT_BLOCK_SIZE = 64 * 1024;
+
+  /**
+   * Creates a new arena.
+   * @param block_size the size of each block requested from the system allocator
+   */
+  explicit Arena(size_t block_size = DEFAULT_BLOCK_SIZE) : block_size_(block_size) {}
+
+  DISALLOW_COPY(Arena);
+  Arena(Arena &&other) noexcept = default;
+  Arena &operator=(Arena &&other) noexcept = default;
+  ~Arena() = default;
+
+  /**
+   * Allocates memory from the arena.
+   * @param size number of bytes to allocate
+   * @param align required alignment, must be a power of two
+   * @return pointer to the allocated memory
+   */
+  char *Allocate(size_t size, size_t align = alignof(std::max_align_t)) {
+    auto cur = reinterpret_cast<uintptr_t>(cur_);
+    auto aligned = (cur + align - 1) & ~(static_cast<uintptr_t>(align) - 1);
+    if (cur_ == nullptr || aligned + size > reinterpret_cast<uintptr_t>(end_)) {
+      // Oversized requests get a block of their own so that they do not waste the rest of the current block.
+      size_t new_block_size = std::max(block_size_, size + align);
+      blocks_.emplace_back(new char[new_block_size]);
+      cur_ = blocks_.back().get();
+      end_ = cur_ + new_block_size;
+      cur = reinterpret_cast<uintptr_t>(cur_);
+      aligned = (cur + align - 1) & ~(static_cast<uintptr_t>(align) - 1);
+    }
+    cur_ += (aligned - cur) + size;
+    allocated_bytes_ += size;
+    return reinterpret_cast<char *>(aligned);
+  }
+
+  /** Releases every block owned by the arena, invalidating all pointers handed out so far. */
+  void Reset() {
+    blocks_.clear();
+    cur_ = nullptr;
+    end_ = nullptr;
+    allocated_bytes_ = 0;
+  }
+
+  /** @return number of bytes handed out by Allocate() since the last reset */
+  size_t AllocatedBytes() const { return allocated_bytes_; }
+
+ private:
+  /** Size of each block requested from the system allocator */
+  size_t block_size_;
+  /** Blocks owned by this arena */
+  std::vector<std::unique_ptr<char[]>> blocks_;
+  /** Next free byte in the current block */
+  char *cur_{nullptr};
+  /** End of the current block */
+  char *end_{nullptr};
+  /** Number of bytes handed out so far */
+  size_t allocated_bytes_{0};
+};
+
+}  // namespace bustub
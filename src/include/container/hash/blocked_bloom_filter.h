@@ -0,0 +1,102 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// blocked_bloom_filter.h
+//
+// Identification: src/include/container/hash/blocked_bloom_filter.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "common/util/hash_util.h"
+
+namespace bustub {
+
+/**
+ * BlockedBloomFilter is a split-block Bloom filter over precomputed 64-bit hashes.
+ *
+ * The low bits of a hash select a 32-byte block, and the high 32 bits set one bit in each of the block's
+ * eight 32-bit words. Every insert and lookup therefore touches a single cache line, and the eight word
+ * tests are independent so the compiler can vectorize them. With the default of 16 bits per key the false
+ * positive rate is well below 1%.
+ */
+class BlockedBloomFilter {
+ public:
+  /** Default number of filter bits per expected key */
+  static constexpr uint32_t DEFAULT_BITS_PER_KEY = 16;
+
+  /**
+   * Creates a new filter.
+   * @param expected_keys the number of keys the filter is sized for
+   * @param bits_per_key number of filter bits per expected key
+   */
+  explicit BlockedBloomFilter(size_t expected_keys, uint32_t bits_per_key = DEFAULT_BITS_PER_KEY) {
+    size_t num_blocks = 1;
+    while (num_blocks * BITS_PER_BLOCK < expected_keys * bits_per_key) {
+      num_blocks <<= 1;
+    }
+    blocks_.resize(num_blocks);
+    mask_ = num_blocks - 1;
+  }
+
+  /**
+   * Adds a hash to the filter.
+   * @param hash the hash of the key
+   */
+  void Insert(hash_t hash) {
+    Block &block = blocks_[hash & mask_];
+    auto key = static_cast<uint32_t>(static_cast<uint64_t>(hash) >> 32);
+    for (uint32_t i = 0; i < WORDS_PER_BLOCK; i++) {
+      block.words_[i] |= BitOf(key, i);
+    }
+  }
+
+  /**
+   * Tests a hash against the filter.
+   * @param hash the hash of the key
+   * @return `false` if the key was definitely never inserted, `true` if it may have been
+   */
+  bool MayContain(hash_t hash) const {
+    const Block &block = blocks_[hash & mask_];
+    auto key = static_cast<uint32_t>(static_cast<uint64_t>(hash) >> 32);
+    uint32_t missing = 0;
+    for (uint32_t i = 0; i < WORDS_PER_BLOCK; i++) {
+      missing |= BitOf(key, i) & ~block.words_[i];
+    }
+    return missing == 0;
+  }
+
+  /** @return the size of the filter in bytes */
+  size_t SizeInBytes() const { return blocks_.size() * sizeof(Block); }
+
+ private:
+  static constexpr uint32_t WORDS_PER_BLOCK = 8;
+  static constexpr size_t BITS_PER_BLOCK = WORDS_PER_BLOCK * 32;
+
+  /** A group of filter bits that never straddles a cache line */
+  struct alignas(32) Block {
+    uint32_t words_[WORDS_PER_BLOCK]{};
+  };
+
+  /** @return the bit a key sets in the i-th word of its block */
+  static uint32_t BitOf(uint32_t key, uint32_t i) {
+    // Odd multipliers from the split block Bloom filter of Putze et al., as used by Impala and Parquet.
+    static constexpr uint32_t SALT[WORDS_PER_BLOCK] = {0x47b6137bU, 0x44974d91U, 0x8824ad5bU, 0xa2b7289dU,
+                                                       0x705495c7U, 0x2df1424bU, 0x9efc4947U, 0x5c6bfb31U};
+    return 1U << ((key * SALT[i]) >> 27);
+  }
+
+  /** The filter bits */
+  std::vector<Block> blocks_;
+  /** blocks_.size() - 1 */
+  size_t mask_;
+};
+
+}  // namespace bustub
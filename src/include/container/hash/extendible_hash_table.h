@@ -12,6 +12,8 @@
 
 #pragma once
 
+#include <atomic>
+#include <memory>
 #include <queue>
 #include <string>
 #include <utility>
@@ -22,6 +24,7 @@
 #include "container/hash/hash_function.h"
 #include "storage/page/hash_table_bucket_page.h"
 #include "storage/page/hash_table_directory_page.h"
+#include "storage/page/hash_table_header_page.h"
 
 namespace bustub {
 
@@ -30,7 +33,14 @@ namespace bustub {
 /**
  * Implementation of extendible hash table that is backed by a buffer pool
  * manager. Non-unique keys are supported. Supports insert and delete. The
- * table grows/shrinks dynamically as buckets become full/empty.
+ * table grows/shrinks dynamically as buckets become full/empty. A bucket whose
+ * entries all share one hash cannot be split, it grows an overflow chain of
+ * further bucket pages instead.
+ *
+ * Concurrency: lookups, inserts and removes read the directory optimistically. They note the directory
+ * version, latch the bucket the directory points to, and retry if the version changed in the meantime.
+ * A bucket split latches the header page and the two buckets involved, and bumps the version around its
+ * directory update. Only doubling the directory, merging and shrinking take table_latch_ exclusively.
  */
 template <typename KeyType, typename ValueType, typename KeyComparator>
 class ExtendibleHashTable {
@@ -45,6 +55,16 @@ class ExtendibleHashTable {
   explicit ExtendibleHashTable(const std::string &name, BufferPoolManager *buffer_pool_manager,
                                const KeyComparator &comparator, HashFunction<KeyType> hash_fn);
 
+  /**
+   * Creates a new ExtendibleHashTable that hashes with a subclass of HashFunction.
+   *
+   * @param buffer_pool_manager buffer pool manager to be used
+   * @param comparator comparator for keys
+   * @param hash_fn the hash function, owned by the table
+   */
+  explicit ExtendibleHashTable(const std::string &name, BufferPoolManager *buffer_pool_manager,
+                               const KeyComparator &comparator, std::unique_ptr<HashFunction<KeyType>> hash_fn);
+
   /**
    * Inserts a key-value pair into the hash table.
    *
@@ -75,6 +95,34 @@ class ExtendibleHashTable {
    */
   bool GetValue(Transaction *transaction, const KeyType &key, std::vector<ValueType> *result);
 
+  /**
+   * Performs a batch of point queries, grouped by bucket and with interleaved probes.
+   *
+   * The keys are sorted so that the keys of a bucket are adjacent, and every bucket is visited once for all of
+   * them: one directory read, one pin and one latch per bucket instead of per key. Up to PROBE_GROUP_SIZE buckets
+   * are in flight at a time (asynchronous memory access chaining). Each probe first pins its bucket page and
+   * prefetches it, and only scans the bucket on its next turn, after the other probes of the group had their go.
+   * The cache misses of the group therefore overlap instead of stalling one lookup after another.
+   *
+   * @param transaction the current transaction
+   * @param keys the keys to look up
+   * @param[out] results results[i] is set to the value(s) associated with keys[i]
+   * @return the number of keys that have at least one value
+   */
+  size_t GetValues(Transaction *transaction, const std::vector<KeyType> &keys,
+                   std::vector<std::vector<ValueType>> *results);
+
+  /**
+   * Merges every bucket that is empty or underfull into its split image, as long as the merged bucket is at most
+   * half full, and halves the directory as far as the local depths allow. Remove() only merges buckets that
+   * become empty, this pass also reclaims the sparse buckets that bulk deletes leave behind. It blocks the whole
+   * table, so it is meant to be run in the background, e.g. by index maintenance after large deletes.
+   *
+   * @param transaction the current transaction
+   * @return the number of merged bucket pairs
+   */
+  size_t Compact(Transaction *transaction);
+
   /**
    * Returns the global depth.  Do not touch.
    */
@@ -107,26 +155,74 @@ class ExtendibleHashTable {
    * representation.
    *
    * @param key the key to use for lookup
-   * @param dir_page to use for lookup of global depth
+   * @param header_page to use for lookup of global depth
    * @return the directory index
    */
-  inline uint32_t KeyToDirectoryIndex(KeyType key, HashTableDirectoryPage *dir_page);
+  inline uint32_t KeyToDirectoryIndex(KeyType key, HashTableHeaderPage *header_page);
 
   /**
    * Get the bucket page_id corresponding to a key.
    *
    * @param key the key for lookup
-   * @param dir_page a pointer to the hash table's directory page
+   * @param header_page a pointer to the hash table's header page
    * @return the bucket page_id corresponding to the input key
    */
-  inline page_id_t KeyToPageId(KeyType key, HashTableDirectoryPage *dir_page);
+  inline page_id_t KeyToPageId(KeyType key, HashTableHeaderPage *header_page);
+
+  /**
+   * Get the bucket page_id corresponding to the hash of a key.
+   *
+   * @param hash the hash of the key for lookup
+   * @param header_page a pointer to the hash table's header page
+   * @return the bucket page_id corresponding to the hash
+   */
+  inline page_id_t HashToPageId(uint32_t hash, HashTableHeaderPage *header_page);
 
   /**
-   * Fetches the directory page from the buffer pool manager.
+   * HashToTag - the fingerprint of a key that bucket pages keep per slot. It is the top byte of the hash, while the
+   * directory index takes the low bits, so keys of one bucket still differ in their tags.
    *
-   * @return a pointer to the directory page
+   * @param hash the hash of the key
+   * @return the tag of the key
    */
-  HashTableDirectoryPage *FetchDirectoryPage();
+  static uint8_t HashToTag(uint32_t hash) { return static_cast<uint8_t>(hash >> 24); }
+
+  /**
+   * Fetches the header page from the buffer pool manager.
+   *
+   * @return a pointer to the header page
+   */
+  HashTableHeaderPage *FetchHeaderPage();
+
+  /**
+   * Fetches the directory page that holds a directory index from the buffer pool manager.
+   *
+   * @param header_page a pointer to the hash table's header page
+   * @param bucket_idx the directory index
+   * @return a pointer to the directory page, bucket_idx % DIRECTORY_ARRAY_SIZE is the index within it
+   */
+  HashTableDirectoryPage *FetchDirectoryPage(HashTableHeaderPage *header_page, uint32_t bucket_idx);
+
+  /**
+   * Calls visit(dir_page, slot, bucket_idx) for every directory index bucket_idx that agrees with bucket_idx in
+   * the low `depth` bits, with the directory page and the slot that hold it. Every directory page is fetched once.
+   *
+   * @param header_page a pointer to the hash table's header page
+   * @param bucket_idx the directory index
+   * @param depth the number of low bits to match
+   * @param is_dirty whether visit modifies the directory
+   * @param visit the function to call
+   */
+  template <typename Visitor>
+  void ForEachDirectorySlot(HashTableHeaderPage *header_page, uint32_t bucket_idx, uint32_t depth, bool is_dirty,
+                            Visitor &&visit);
+
+  /**
+   * @param header_page a pointer to the hash table's header page
+   * @param bucket_idx the directory index
+   * @return the local depth of the bucket at bucket_idx
+   */
+  uint32_t GetLocalDepth(HashTableHeaderPage *header_page, uint32_t bucket_idx);
 
   /**
    * Fetches the a bucket page from the buffer pool manager using the bucket's page_id.
@@ -136,6 +232,79 @@ class ExtendibleHashTable {
    */
   std::pair<Page *, HASH_TABLE_BUCKET_TYPE *> FetchBucketPage(page_id_t bucket_page_id);
 
+  /**
+   * Waits until no directory update is in progress.
+   *
+   * @return the directory version to validate an optimistic directory read against
+   */
+  uint64_t BeginDirectoryRead();
+
+  /**
+   * Fetches and latches the bucket page of a key with an optimistic read of the directory. The caller must
+   * hold table_latch_ in read mode, and has to unlatch and unpin the returned page.
+   *
+   * @param hash the hash of the key for lookup
+   * @param header_page a pointer to the hash table's header page
+   * @param exclusive whether to take the bucket's write latch instead of its read latch
+   * @return a pair contains a pointer to page and a pointer to bucket page
+   */
+  std::pair<Page *, HASH_TABLE_BUCKET_TYPE *> LatchBucketPage(uint32_t hash, HashTableHeaderPage *header_page,
+                                                              bool exclusive);
+
+  /**
+   * @param bucket_page_data the first page of a bucket that has an overflow chain
+   * @return the hash that all entries of the bucket share
+   */
+  uint32_t OverflowHash(HASH_TABLE_BUCKET_TYPE *bucket_page_data);
+
+  /**
+   * Decides whether a key can be inserted into its bucket without a split. A full bucket whose entries all share
+   * the key's hash takes the key into an overflow chain, and a bucket with a chain only takes keys of its hash.
+   *
+   * @param bucket_page_data the first page of the bucket
+   * @param hash the hash of the key to insert
+   * @return true if the key fits, false if the bucket has to be split first
+   */
+  bool FitsBucket(HASH_TABLE_BUCKET_TYPE *bucket_page_data, uint32_t hash);
+
+  /**
+   * Collects the values of a key from a bucket and its overflow chain. The caller holds the bucket's latch.
+   *
+   * @param bucket_page_data the first page of the bucket
+   * @param key the key to look up
+   * @param[out] result the value(s) associated with the key
+   * @param hash the hash of the key
+   * @return true if at least one value was found
+   */
+  bool GetValueInChain(HASH_TABLE_BUCKET_TYPE *bucket_page_data, const KeyType &key, std::vector<ValueType> *result,
+                       uint32_t hash);
+
+  /**
+   * Inserts a key-value pair into the first page of a bucket's chain that has room, and links a new overflow page
+   * if all of them are full. The caller holds the bucket's write latch and has checked FitsBucket().
+   *
+   * @param bucket_page_data the first page of the bucket
+   * @param key the key to insert
+   * @param value the value to insert
+   * @param hash the hash of the key
+   * @return true if inserted, false if the pair is a duplicate
+   */
+  bool InsertIntoChain(HASH_TABLE_BUCKET_TYPE *bucket_page_data, const KeyType &key, const ValueType &value,
+                       uint32_t hash);
+
+  /**
+   * Removes a key-value pair from a bucket or its overflow chain. Overflow pages that become empty are deleted.
+   * The caller holds the bucket's write latch.
+   *
+   * @param bucket_page_data the first page of the bucket
+   * @param key the key to remove
+   * @param value the value to remove
+   * @param hash the hash of the key
+   * @return true if removed, false if not found
+   */
+  bool RemoveFromChain(HASH_TABLE_BUCKET_TYPE *bucket_page_data, const KeyType &key, const ValueType &value,
+                       uint32_t hash);
+
   /**
    * Performs insertion with an optional bucket splitting.
    *
@@ -146,13 +315,45 @@ class ExtendibleHashTable {
    */
   bool SplitInsert(Transaction *transaction, const KeyType &key, const ValueType &value);
 
+  /**
+   * Doubles the directory if the bucket of the key has local depth equal to the global depth. Takes
+   * table_latch_ in write mode, so the caller must not hold it.
+   *
+   * @param key the key whose bucket is to be split
+   * @param header_page a pointer to the hash table's header page
+   * @return false if the directory is already at its maximum size, true otherwise
+   */
+  bool GrowDirectory(const KeyType &key, HashTableHeaderPage *header_page);
+
+  /**
+   * Splits a bucket that cannot take a key into itself and a new split image, both one local depth deeper. The
+   * bucket's local depth must be below the global depth. The caller holds the header page's and the bucket's write
+   * latch.
+   *
+   * @param header_page a pointer to the hash table's header page
+   * @param bucket_idx a directory index that points to the bucket
+   * @param bucket_page_data the bucket to split
+   */
+  void SplitBucket(HashTableHeaderPage *header_page, uint32_t bucket_idx, HASH_TABLE_BUCKET_TYPE *bucket_page_data);
+
+  /**
+   * Halves the directory as long as no bucket has local depth equal to the global depth. The caller holds
+   * table_latch_ in write mode.
+   *
+   * @param header_page a pointer to the hash table's header page
+   */
+  void ShrinkDirectory(HashTableHeaderPage *header_page);
+
   /**
    * Optionally merges an empty bucket into it's pair.  This is called by Remove,
    * if Remove makes a bucket empty.
    *
+   * The merged bucket is merged again with its own split image if possible, and the directory is
+   * shrunk afterwards.
+   *
    * There are three conditions under which we skip the merge:
-   * 1. The bucket is no longer empty.
-   * 2. The bucket has local depth 0.
+   * 1. Neither the bucket nor its split image is empty.
+   * 2. The bucket has local depth 1.
    * 3. The bucket's local depth doesn't match its split image's local depth.
    *
    * @param transaction a pointer to the current transaction
@@ -161,19 +362,35 @@ class ExtendibleHashTable {
    */
   void Merge(Transaction *transaction, const KeyType &key, const ValueType &value);
 
+  /**
+   * Merges the bucket at a directory index into its split image, if both have the same local depth above 1 and
+   * one of them is empty. The caller holds table_latch_ in write mode.
+   *
+   * @param header_page a pointer to the hash table's header page
+   * @param bucket_idx a directory index that points to the bucket
+   * @param merge_underfull whether to also merge two non-empty buckets that fit into half a bucket together
+   * @return true if the buckets were merged
+   */
+  bool MergeBucket(HashTableHeaderPage *header_page, uint32_t bucket_idx, bool merge_underfull);
+
   /**
    * Pow function for uint32_t
    */
   uint32_t Pow(uint32_t base, uint32_t power) const;
 
+  /** Number of probes GetValues() keeps in flight, each of them pins one bucket page */
+  static constexpr uint32_t PROBE_GROUP_SIZE = 8;
+
   // member variables
-  page_id_t directory_page_id_;
+  page_id_t header_page_id_;
   BufferPoolManager *buffer_pool_manager_;
   KeyComparator comparator_;
 
-  // Readers includes inserts and removes, writers are splits and merges
-  ReaderWriterLatch table_latch_;
-  HashFunction<KeyType> hash_fn_;
+  // Readers includes inserts, removes and bucket splits, writers are directory doubling and merges
+  StripedReaderWriterLatch table_latch_;
+  // Odd while a bucket split rewrites the directory, bumped twice per split
+  std::atomic<uint64_t> directory_version_{0};
+  std::unique_ptr<HashFunction<KeyType>> hash_fn_;
 };
 
 }  // namespace bustub
@@ -0,0 +1,285 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// flat_hash_table.h
+//
+// Identification: src/include/container/hash/flat_hash_table.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "common/macros.h"
+#include "common/util/hash_util.h"
+#include "container/hash/arena.h"
+#include "murmur3/MurmurHash3.h"
+#include "type/value.h"
+
+namespace bustub {
+
+/**
+ * FlatHashKey is the serialized form of a list of values, used as the key of a FlatHashTable.
+ *
+ * Every value is written as a one byte null flag followed by its payload. Integer types are widened to
+ * 64 bits so that keys of different integer widths that compare equal also serialize to the same bytes.
+ * A FlatHashKey is meant to be reused across tuples to avoid allocating a new buffer for every key.
+ */
+class FlatHashKey {
+ public:
+  /** Removes all values from the key. */
+  void Clear() {
+    buf_.clear();
+    has_null_ = false;
+  }
+
+  /**
+   * Appends a value to the key.
+   * @param value the value to be appended
+   */
+  void Append(const Value &value) {
+    if (value.IsNull()) {
+      buf_.push_back(1);
+      has_null_ = true;
+      return;
+    }
+    buf_.push_back(0);
+    switch (value.GetTypeId()) {
+      case TypeId::BOOLEAN:
+        buf_.push_back(static_cast<char>(value.GetAs<int8_t>()));
+        break;
+      case TypeId::TINYINT:
+        AppendRaw(static_cast<int64_t>(value.GetAs<int8_t>()));
+        break;
+      case TypeId::SMALLINT:
+        AppendRaw(static_cast<int64_t>(value.GetAs<int16_t>()));
+        break;
+      case TypeId::INTEGER:
+        AppendRaw(static_cast<int64_t>(value.GetAs<int32_t>()));
+        break;
+      case TypeId::BIGINT:
+        AppendRaw(value.GetAs<int64_t>());
+        break;
+      case TypeId::DECIMAL:
+        AppendRaw(value.GetAs<double>());
+        break;
+      case TypeId::TIMESTAMP:
+        AppendRaw(value.GetAs<uint64_t>());
+        break;
+      case TypeId::VARCHAR: {
+        uint32_t len = value.GetLength();
+        AppendRaw(len);
+        buf_.insert(buf_.end(), value.GetData(), value.GetData() + len);
+        break;
+      }
+      default:
+        UNREACHABLE("Unsupported type.");
+    }
+  }
+
+  /** @return pointer to the serialized key */
+  const char *Data() const { return buf_.data(); }
+
+  /** @return size of the serialized key in bytes */
+  uint32_t Size() const { return static_cast<uint32_t>(buf_.size()); }
+
+  /** @return `true` if any of the appended values is null */
+  bool HasNull() const { return has_null_; }
+
+  /** @return hash of the serialized key */
+  hash_t Hash() const {
+    uint64_t hash[2];
+    murmur3::MurmurHash3_x64_128(reinterpret_cast<const void *>(buf_.data()), static_cast<int>(buf_.size()), 0,
+                                 reinterpret_cast<void *>(&hash));
+    return static_cast<hash_t>(hash[0]);
+  }
+
+ private:
+  template <typename T>
+  void AppendRaw(T raw) {
+    const auto *bytes = reinterpret_cast<const char *>(&raw);
+    buf_.insert(buf_.end(), bytes, bytes + sizeof(T));
+  }
+
+  /** The serialized key */
+  std::vector<char> buf_;
+  /** Whether a null value has been appended */
+  bool has_null_{false};
+};
+
+/** Payload type of a FlatHashTable that is used as a set. */
+struct FlatHashTableNoPayload {};
+
+/**
+ * FlatHashTable is an in-memory, open-addressing hash table used by the execution engine (hash join,
+ * aggregation and distinct).
+ *
+ * Keys are serialized byte strings (see FlatHashKey) and are copied, together with a fixed-size payload,
+ * into an arena owned by the table. The slot array only holds the full hash of each key, which is compared
+ * before the key bytes, and a pointer to its arena entry, so lookups touch a single cache line per probe
+ * on a hit and rehashing never moves or rehashes the keys themselves. Collisions are resolved by linear
+ * probing. Entries are never removed individually; Clear() releases the whole table at once.
+ *
+ * @tparam PayloadType trivially copyable data stored with every key
+ */
+template <typename PayloadType = FlatHashTableNoPayload>
+class FlatHashTable {
+  static_assert(std::is_trivially_copyable_v<PayloadType>, "payload must be trivially copyable");
+
+ public:
+  /**
+   * Creates a new FlatHashTable.
+   * @param initial_capacity number of slots to start with, rounded up to a power of two
+   */
+  explicit FlatHashTable(size_t initial_capacity = 64) { Reserve(initial_capacity); }
+
+  DISALLOW_COPY(FlatHashTable);
+
+  /**
+   * Looks up a key, inserting it with a value-initialized payload if it is absent.
+   * @param key pointer to the serialized key
+   * @param key_size size of the serialized key
+   * @param hash hash of the serialized key
+   * @param[out] inserted set to `true` if the key was not present before
+   * @return pointer to the payload of the key, valid until the table is cleared
+   */
+  PayloadType *FindOrInsert(const char *key, uint32_t key_size, hash_t hash, bool *inserted) {
+    if ((size_ + 1) * MAX_LOAD_DENOMINATOR > slots_.size() * MAX_LOAD_NUMERATOR) {
+      Grow();
+    }
+    size_t idx = hash & mask_;
+    while (slots_[idx].entry_ != nullptr) {
+      if (Matches(slots_[idx], key, key_size, hash)) {
+        *inserted = false;
+        return &slots_[idx].entry_->payload_;
+      }
+      idx = (idx + 1) & mask_;
+    }
+    char *mem = arena_.Allocate(sizeof(Entry) + key_size, alignof(Entry));
+    auto *entry = new (mem) Entry{PayloadType{}, key_size};
+    memcpy(mem + sizeof(Entry), key, key_size);
+    slots_[idx].hash_ = hash;
+    slots_[idx].entry_ = entry;
+    size_++;
+    *inserted = true;
+    return &entry->payload_;
+  }
+
+  /** Convenience overload of FindOrInsert() for a FlatHashKey. */
+  PayloadType *FindOrInsert(const FlatHashKey &key, bool *inserted) {
+    return FindOrInsert(key.Data(), key.Size(), key.Hash(), inserted);
+  }
+
+  /**
+   * Looks up a key.
+   * @param key pointer to the serialized key
+   * @param key_size size of the serialized key
+   * @param hash hash of the serialized key
+   * @return pointer to the payload of the key, or nullptr if the key is not present
+   */
+  PayloadType *Find(const char *key, uint32_t key_size, hash_t hash) const {
+    size_t idx = hash & mask_;
+    while (slots_[idx].entry_ != nullptr) {
+      if (Matches(slots_[idx], key, key_size, hash)) {
+        return &slots_[idx].entry_->payload_;
+      }
+      idx = (idx + 1) & mask_;
+    }
+    return nullptr;
+  }
+
+  /** Convenience overload of Find() for a FlatHashKey. */
+  PayloadType *Find(const FlatHashKey &key) const { return Find(key.Data(), key.Size(), key.Hash()); }
+
+  /**
+   * Allocates memory that lives as long as the entries of this table, e.g. for variable-length payload
+   * data referenced from a PayloadType.
+   * @param size number of bytes to allocate
+   * @param align required alignment
+   * @return pointer to the allocated memory
+   */
+  char *Allocate(size_t size, size_t align = alignof(std::max_align_t)) { return arena_.Allocate(size, align); }
+
+  /** Removes all entries and releases the arena. */
+  void Clear() {
+    arena_.Reset();
+    std::fill(slots_.begin(), slots_.end(), Slot{});
+    size_ = 0;
+  }
+
+  /** @return number of keys in the table */
+  size_t Size() const { return size_; }
+
+  /** @return number of slots in the table */
+  size_t Capacity() const { return slots_.size(); }
+
+  /** @return number of bytes allocated from the arena for keys and payloads */
+  size_t ArenaBytes() const { return arena_.AllocatedBytes(); }
+
+ private:
+  /** Maximum load factor (7/10) before the slot array is doubled, linear probing degrades quickly beyond it */
+  static constexpr size_t MAX_LOAD_NUMERATOR = 7;
+  static constexpr size_t MAX_LOAD_DENOMINATOR = 10;
+
+  /** An arena entry; the key bytes directly follow the entry. */
+  struct Entry {
+    PayloadType payload_;
+    uint32_t key_size_;
+  };
+
+  /** A slot in the open-addressing array. */
+  struct Slot {
+    hash_t hash_{0};
+    Entry *entry_{nullptr};
+  };
+
+  static bool Matches(const Slot &slot, const char *key, uint32_t key_size, hash_t hash) {
+    return slot.hash_ == hash && slot.entry_->key_size_ == key_size &&
+           memcmp(reinterpret_cast<const char *>(slot.entry_) + sizeof(Entry), key, key_size) == 0;
+  }
+
+  void Reserve(size_t capacity) {
+    size_t new_capacity = 8;
+    while (new_capacity < capacity) {
+      new_capacity <<= 1;
+    }
+    slots_.assign(new_capacity, Slot{});
+    mask_ = new_capacity - 1;
+  }
+
+  void Grow() {
+    std::vector<Slot> old_slots = std::move(slots_);
+    Reserve(old_slots.size() * 2);
+    for (const auto &slot : old_slots) {
+      if (slot.entry_ == nullptr) {
+        continue;
+      }
+      size_t idx = slot.hash_ & mask_;
+      while (slots_[idx].entry_ != nullptr) {
+        idx = (idx + 1) & mask_;
+      }
+      slots_[idx] = slot;
+    }
+  }
+
+  /** Memory for the keys and payloads */
+  Arena arena_;
+  /** The open-addressing slot array, its size is always a power of two */
+  std::vector<Slot> slots_;
+  /** slots_.size() - 1 */
+  size_t mask_{0};
+  /** Number of keys in the table */
+  size_t size_{0};
+};
+
+}  // namespace bustub
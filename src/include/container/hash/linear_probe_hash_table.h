@@ -0,0 +1,193 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// linear_probe_hash_table.h
+//
+// Identification: src/include/container/hash/linear_probe_hash_table.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "concurrency/transaction.h"
+#include "container/hash/hash_function.h"
+#include "container/hash/hash_table.h"
+#include "storage/page/hash_table_block_header_page.h"
+#include "storage/page/hash_table_block_page.h"
+
+namespace bustub {
+
+#define LINEAR_PROBE_HASH_TABLE_TYPE LinearProbeHashTable<KeyType, ValueType, KeyComparator>
+
+/**
+ * Implementation of linear probing hash table that is backed by a buffer pool
+ * manager. Non-unique keys are supported. Supports insert and delete. The
+ * table grows one block at a time with linear hashing.
+ *
+ * The low bits of a key's hash pick its block, the high bits the slot within the block where probing starts.
+ * Probing wraps around within the block and ends at a slot that was never occupied, so a lookup reads the header
+ * and usually a single block. Once a block is full, further keys of the block go to its overflow blocks.
+ *
+ * The table has 2^level <= n < 2^(level + 1) blocks, of which blocks [0, n - 2^level) have already been split
+ * into themselves and blocks [2^level, n). A key's block is its hash modulo 2^(level + 1), or modulo 2^level if
+ * that block does not exist yet. Whenever the table is fuller than MAX_FILL_PERCENT of its blocks, block
+ * n - 2^level is split by appending block n, which rehashes only that one block instead of the whole table.
+ *
+ * Concurrency: lookups, inserts and removes hold table_latch_ in read mode and latch the first block of their
+ * chain, which protects the overflow blocks behind it. Splits take table_latch_ in write mode.
+ */
+template <typename KeyType, typename ValueType, typename KeyComparator>
+class LinearProbeHashTable : public HashTable<KeyType, ValueType, KeyComparator> {
+ public:
+  /**
+   * Creates a new LinearProbeHashTable.
+   *
+   * @param buffer_pool_manager buffer pool manager to be used
+   * @param comparator comparator for keys
+   * @param hash_fn the hash function
+   */
+  explicit LinearProbeHashTable(const std::string &name, BufferPoolManager *buffer_pool_manager,
+                                const KeyComparator &comparator, HashFunction<KeyType> hash_fn);
+
+  /**
+   * Inserts a key-value pair into the hash table.
+   *
+   * @param transaction the current transaction
+   * @param key the key to create
+   * @param value the value to be associated with the key
+   * @return true if insert succeeded, false otherwise
+   */
+  bool Insert(Transaction *transaction, const KeyType &key, const ValueType &value) override;
+
+  /**
+   * Deletes the associated value for the given key.
+   *
+   * @param transaction the current transaction
+   * @param key the key to delete
+   * @param value the value to delete
+   * @return true if remove succeeded, false otherwise
+   */
+  bool Remove(Transaction *transaction, const KeyType &key, const ValueType &value) override;
+
+  /**
+   * Performs a point query on the hash table.
+   *
+   * @param transaction the current transaction
+   * @param key the key to look up
+   * @param[out] result the value(s) associated with a given key
+   * @return the value(s) associated with the given key
+   */
+  bool GetValue(Transaction *transaction, const KeyType &key, std::vector<ValueType> *result) override;
+
+  /**
+   * @return the number of key-value pairs in the table
+   */
+  size_t GetSize() const;
+
+  /**
+   * @return the number of blocks of the table, not counting overflow blocks
+   */
+  uint32_t GetNumBlocks();
+
+ private:
+  /**
+   * @param hash the hash of a key
+   * @param num_blocks the number of blocks of the table
+   * @return the block of the key
+   */
+  static uint32_t HashToBlockIndex(uint64_t hash, uint32_t num_blocks);
+
+  /**
+   * @param hash the hash of a key
+   * @return the slot at which the probe for the key starts, in its block and in every overflow block
+   */
+  static slot_offset_t HashToSlot(uint64_t hash) { return (hash >> 32) % BLOCK_ARRAY_SIZE; }
+
+  /**
+   * Fetches the header page from the buffer pool manager.
+   *
+   * @return a pointer to the header page
+   */
+  HashTableBlockHeaderPage *FetchHeaderPage();
+
+  /**
+   * Fetches a block page from the buffer pool manager.
+   *
+   * @param block_page_id the page_id to fetch
+   * @return a pair contains a pointer to page and a pointer to block page
+   */
+  std::pair<Page *, HASH_TABLE_BLOCK_TYPE *> FetchBlockPage(page_id_t block_page_id);
+
+  /**
+   * Calls visit(page_id, block_page_data, slot) on the probe sequence of a hash through a block and its overflow
+   * blocks, until visit returns true or the sequence ends. The sequence ends after the first slot that was never
+   * occupied, which visit still sees. The caller pins and latches the first block.
+   *
+   * @param block_page_id the first block of the chain
+   * @param block_page_data the first block of the chain
+   * @param hash the hash of the key
+   * @param is_dirty whether visit modifies the block it returns true on
+   * @param visit the function to call
+   * @param[out] last_page_id if not null, set to the last block that was probed
+   * @return true if visit returned true
+   */
+  template <typename Visitor>
+  bool ProbeChain(page_id_t block_page_id, HASH_TABLE_BLOCK_TYPE *block_page_data, uint64_t hash, bool is_dirty,
+                  Visitor &&visit, page_id_t *last_page_id = nullptr);
+
+  /**
+   * Inserts a key-value pair into the first free slot of its probe sequence, and appends an overflow block if
+   * there is none. The caller holds the write latch of the first block.
+   *
+   * @param block_page_id the first block of the key's chain
+   * @param block_page_data the first block of the key's chain
+   * @param key the key to insert
+   * @param value the value to insert
+   * @param hash the hash of the key
+   * @return true if inserted, false if the pair is a duplicate
+   */
+  bool InsertIntoChain(page_id_t block_page_id, HASH_TABLE_BLOCK_TYPE *block_page_data, const KeyType &key,
+                       const ValueType &value, uint64_t hash);
+
+  /**
+   * Splits blocks while the table is too full. Takes table_latch_ in write mode, so the caller must not hold it.
+   */
+  void Grow();
+
+  /**
+   * Appends a block and moves the keys of the block it splits off from. The caller holds table_latch_ in write
+   * mode.
+   *
+   * @param header_page a pointer to the hash table's header page
+   */
+  void SplitBlock(HashTableBlockHeaderPage *header_page);
+
+  /**
+   * A split is due once the pairs fill more than this share of the blocks' slots. Blocks that were not split yet
+   * in the current round hold up to twice the average, so the share is kept low enough for their probes to stay
+   * short.
+   */
+  static constexpr size_t MAX_FILL_PERCENT = 50;
+
+  // member variables
+  page_id_t header_page_id_;
+  BufferPoolManager *buffer_pool_manager_;
+  KeyComparator comparator_;
+
+  // Readers includes inserts and removes, writers are block splits
+  ReaderWriterLatch table_latch_;
+  // The number of pairs, it decides when to split
+  std::atomic<size_t> size_{0};
+  HashFunction<KeyType> hash_fn_;
+};
+
+}  // namespace bustub
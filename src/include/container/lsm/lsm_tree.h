@@ -0,0 +1,253 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// lsm_tree.h
+//
+// Identification: src/include/container/lsm/lsm_tree.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>  // NOLINT
+#include <memory>
+#include <mutex>  // NOLINT
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "common/rwlatch.h"
+#include "container/hash/blocked_bloom_filter.h"
+#include "container/hash/hash_function.h"
+#include "container/lsm/skip_list.h"
+#include "storage/page/lsm_run_page.h"
+
+namespace bustub {
+
+#define LSM_TREE_TYPE LSMTree<KeyType, ValueType, KeyComparator>
+
+/**
+ * Implementation of a log-structured merge tree that is backed by a buffer pool manager. Non-unique keys are
+ * supported, a key-value pair is stored at most once. Built for insert-heavy tables: an insert or remove only
+ * adds the pair to an in-memory table, and pages are only ever written sequentially, a whole run at a time.
+ *
+ * New pairs go into the memtable, a lock-free skip list. A remove inserts the pair marked as deleted. Once the
+ * memtable holds memtable_capacity pairs it becomes immutable and a new one takes over. A background thread
+ * writes immutable memtables to sorted runs, which are immutable sequences of run pages, and merges runs:
+ * whenever RUNS_PER_LEVEL runs of the same level exist, they are merged into one run of the next level, so
+ * every pair is rewritten once per level. A merge into the oldest run drops the deleted pairs.
+ *
+ * A lookup visits the memtables and then the runs from the newest to the oldest, the newest copy of a pair
+ * decides whether it is present. Every run has a Bloom filter over the hashes of its keys, and keeps the first
+ * key of every page in memory, so a run that does not hold the key costs no page fetch and one that does
+ * usually costs one.
+ *
+ * Concurrency: inserts and removes hold table_latch_ in read mode, only switching the memtable takes it in
+ * write mode. The memtables and runs form an immutable version, lookups work on the version that was current
+ * when they started. Runs that were merged away free their pages when the last lookup using them is done.
+ */
+template <typename KeyType, typename ValueType, typename KeyComparator>
+class LSMTree {
+ public:
+  /** Default number of pairs of a memtable */
+  static constexpr size_t DEFAULT_MEMTABLE_CAPACITY = 16384;
+
+  /**
+   * Creates a new LSMTree and starts its background thread.
+   *
+   * @param name the name of the tree
+   * @param buffer_pool_manager buffer pool manager to be used
+   * @param comparator comparator for keys
+   * @param hash_fn the hash function for the Bloom filters
+   * @param memtable_capacity the number of pairs after which a memtable is written to a run
+   */
+  LSMTree(const std::string &name, BufferPoolManager *buffer_pool_manager, const KeyComparator &comparator,
+          HashFunction<KeyType> hash_fn, size_t memtable_capacity = DEFAULT_MEMTABLE_CAPACITY);
+
+  /** Stops the background thread. Pairs that were not written to a run yet are dropped with the memtables. */
+  ~LSMTree();
+
+  DISALLOW_COPY_AND_MOVE(LSMTree);
+
+  /**
+   * Inserts a key-value pair into the tree.
+   *
+   * @param key the key to create
+   * @param value the value to be associated with the key
+   */
+  void Insert(const KeyType &key, const ValueType &value);
+
+  /**
+   * Deletes a key-value pair from the tree.
+   *
+   * @param key the key to delete
+   * @param value the value to delete
+   */
+  void Remove(const KeyType &key, const ValueType &value);
+
+  /**
+   * Performs a point query on the tree.
+   *
+   * @param key the key to look up
+   * @param[out] result the value(s) associated with a given key
+   * @return true if the key has a value
+   */
+  bool GetValue(const KeyType &key, std::vector<ValueType> *result);
+
+  /** Blocks until the background thread has written every immutable memtable and finished all merges. */
+  void WaitForBackgroundWork();
+
+  /** @return the number of sorted runs */
+  size_t GetNumRuns();
+
+ private:
+  using MemTable = SkipList<KeyType, ValueType, KeyComparator>;
+  using RunPage = LSMRunPage<KeyType, ValueType, KeyComparator>;
+
+  /** An immutable sorted sequence of run pages. */
+  struct SortedRun {
+    SortedRun(BufferPoolManager *buffer_pool_manager, size_t expected_pairs, uint32_t level)
+        : buffer_pool_manager_(buffer_pool_manager), filter_(expected_pairs), level_(level) {}
+
+    /** Deletes the pages of the run once it was merged into another one. */
+    ~SortedRun();
+
+    BufferPoolManager *buffer_pool_manager_;
+    std::vector<page_id_t> page_ids_;
+    // the first key of every page
+    std::vector<KeyType> first_keys_;
+    BlockedBloomFilter filter_;
+    size_t num_pairs_{0};
+    uint32_t level_;
+    // set once the run was replaced by a merged run
+    std::atomic<bool> is_obsolete_{false};
+  };
+
+  /** The memtables and runs of the tree at one point in time, all ordered from the newest to the oldest. */
+  struct Version {
+    std::shared_ptr<MemTable> memtable_;
+    std::vector<std::shared_ptr<MemTable>> immutables_;
+    std::vector<std::shared_ptr<SortedRun>> runs_;
+  };
+
+  /** Iterates the pairs of a run in order, keeping the current page pinned. */
+  class RunIterator {
+   public:
+    /**
+     * @param run the run
+     * @param page_idx the page to start at
+     * @param slot the pair of the page to start at
+     */
+    RunIterator(const SortedRun *run, size_t page_idx, uint32_t slot);
+    ~RunIterator();
+    DISALLOW_COPY_AND_MOVE(RunIterator);
+
+    bool IsEnd() const { return page_ == nullptr; }
+    void Next();
+    const KeyType &Key() const { return run_page_->KeyAt(slot_); }
+    const ValueType &Value() const { return run_page_->ValueAt(slot_); }
+    bool IsDeleted() const { return run_page_->IsDeleted(slot_); }
+
+   private:
+    /** Moves to the first pair at or after slot_ in page page_idx_ or a later page. */
+    void Settle();
+
+    const SortedRun *run_;
+    size_t page_idx_;
+    uint32_t slot_;
+    Page *page_{nullptr};
+    RunPage *run_page_{nullptr};
+  };
+
+  /** Writes pairs in order to the pages of a new run. */
+  class RunWriter {
+   public:
+    RunWriter(LSMTree *tree, size_t expected_pairs, uint32_t level);
+    ~RunWriter();
+    DISALLOW_COPY_AND_MOVE(RunWriter);
+
+    void Append(const KeyType &key, const ValueType &value, bool is_deleted);
+
+    /** @return the run, nullptr if no pair was appended */
+    std::shared_ptr<SortedRun> Finish();
+
+   private:
+    LSMTree *tree_;
+    std::shared_ptr<SortedRun> run_;
+    page_id_t page_id_{INVALID_PAGE_ID};
+    RunPage *run_page_{nullptr};
+  };
+
+  /** Adds a pair to the memtable. */
+  void Put(const KeyType &key, const ValueType &value, bool is_deleted);
+
+  /** Makes the memtable immutable if it is full, and hands it to the background thread. */
+  void SwitchMemTable();
+
+  /** @return the current version */
+  std::shared_ptr<const Version> GetVersion();
+
+  /**
+   * Finds runs to merge: the runs of a level are adjacent, since runs move one level down at a time.
+   * The caller holds version_latch_.
+   * @param version the version to look at
+   * @param[out] begin the first run to merge
+   * @param[out] end one past the last run to merge
+   * @return whether a level has enough runs to be merged
+   */
+  static bool PickCompaction(const Version &version, size_t *begin, size_t *end);
+
+  /** The loop of the background thread. */
+  void BackgroundWork();
+
+  /** Writes an immutable memtable to a new run. */
+  std::shared_ptr<SortedRun> FlushMemTable(const MemTable &memtable);
+
+  /**
+   * Merges runs into one. Of the copies of a pair, the one in the newest run is kept.
+   * @param runs the runs, from the newest to the oldest
+   * @param drop_deleted whether deleted pairs are left out, when no older run exists
+   * @return the merged run, nullptr if it is empty
+   */
+  std::shared_ptr<SortedRun> MergeRuns(const std::vector<std::shared_ptr<SortedRun>> &runs, bool drop_deleted);
+
+  /** Compares two pairs by key, and then by the bytes of the value. */
+  int ComparePairs(const KeyType &lhs_key, const ValueType &lhs_value, const KeyType &rhs_key,
+                   const ValueType &rhs_value) const;
+
+  /** Merge runs once this many runs of a level exist */
+  static constexpr size_t RUNS_PER_LEVEL = 4;
+  /** Inserts wait while this many memtables are waiting to be written */
+  static constexpr size_t MAX_IMMUTABLE_MEMTABLES = 2;
+
+  // member variables
+  std::string name_;
+  BufferPoolManager *buffer_pool_manager_;
+  KeyComparator comparator_;
+  HashFunction<KeyType> hash_fn_;
+  size_t memtable_capacity_;
+
+  // Readers are inserts and removes into the memtable, the writer switches the memtable
+  ReaderWriterLatch table_latch_;
+  // the memtable of version_, inserts read it without version_latch_
+  std::atomic<MemTable *> memtable_;
+
+  // Protects version_, stop_ and is_busy_
+  std::mutex version_latch_;
+  std::shared_ptr<const Version> version_;
+  // signals the background thread that there is work or that it should stop
+  std::condition_variable work_cv_;
+  // signals that the background thread finished a step
+  std::condition_variable done_cv_;
+  bool stop_{false};
+  // whether the background thread works on a memtable or a merge outside of version_latch_
+  bool is_busy_{false};
+  std::thread background_thread_;
+};
+
+}  // namespace bustub
@@ -0,0 +1,216 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// skip_list.h
+//
+// Identification: src/include/container/lsm/skip_list.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <new>
+
+#include "common/macros.h"
+
+namespace bustub {
+
+/**
+ * SkipList is a sorted set of key-value pairs that many threads insert into without locks. It is the memtable
+ * of the LSM tree.
+ *
+ * Pairs are ordered by key and then by the bytes of the value, so all values of a key are adjacent. Every
+ * pair carries a deleted flag: the LSM tree records a removal as a pair that is marked deleted, which hides
+ * older copies of the pair in the sorted runs. Putting a pair that is already present only updates its flag.
+ *
+ * Nothing is ever unlinked, so an insert only has to publish its node with one compare-and-swap per level,
+ * bottom-up, and readers never see a node that is freed. A node is linked into level 0 first, which decides
+ * whether it is in the list. All nodes are freed with the list.
+ */
+template <typename KeyType, typename ValueType, typename KeyComparator>
+class SkipList {
+  struct Node;
+
+ public:
+  explicit SkipList(const KeyComparator &comparator) : comparator_(comparator), head_(NewNode(MAX_HEIGHT)) {}
+
+  ~SkipList() {
+    Node *node = head_;
+    while (node != nullptr) {
+      Node *next = node->Next(0);
+      FreeNode(node);
+      node = next;
+    }
+  }
+
+  DISALLOW_COPY_AND_MOVE(SkipList);
+
+  /**
+   * Inserts a pair, or updates the deleted flag of the pair if it is present.
+   * @param key the key
+   * @param value the value
+   * @param is_deleted whether the pair is a tombstone
+   * @return true if the pair was inserted, false if it was present
+   */
+  bool Put(const KeyType &key, const ValueType &value, bool is_deleted) {
+    Node *preds[MAX_HEIGHT];
+    Node *succs[MAX_HEIGHT];
+    Node *node = nullptr;
+    while (true) {
+      Node *found = FindGreaterOrEqual(key, value, preds, succs);
+      if (found != nullptr && Compare(found, key, value) == 0) {
+        found->is_deleted_.store(is_deleted);
+        if (node != nullptr) {
+          FreeNode(node);
+        }
+        return false;
+      }
+      if (node == nullptr) {
+        node = NewNode(RandomHeight());
+        node->key_ = key;
+        node->value_ = value;
+        node->is_deleted_.store(is_deleted, std::memory_order_relaxed);
+      }
+      node->next_[0].store(succs[0], std::memory_order_relaxed);
+      if (preds[0]->next_[0].compare_exchange_strong(succs[0], node)) {
+        break;
+      }
+      // Another pair was linked in between, search again.
+    }
+
+    for (int level = 1; level < node->height_; level++) {
+      while (true) {
+        node->next_[level].store(succs[level], std::memory_order_relaxed);
+        if (preds[level]->next_[level].compare_exchange_strong(succs[level], node)) {
+          break;
+        }
+        FindGreaterOrEqual(key, value, preds, succs);
+      }
+    }
+    int height = max_height_.load(std::memory_order_relaxed);
+    while (node->height_ > height && !max_height_.compare_exchange_weak(height, node->height_)) {
+    }
+    size_.fetch_add(1);
+    return true;
+  }
+
+  /** @return the number of pairs, including tombstones */
+  size_t GetSize() const { return size_.load(); }
+
+  /** Iterates the pairs in order. The pairs inserted concurrently may or may not be visited. */
+  class Iterator {
+   public:
+    explicit Iterator(const SkipList *list) : list_(list), node_(list->head_->Next(0)) {}
+
+    /** Positions the iterator on the first pair with a key that is not smaller than key. */
+    void Seek(const KeyType &key) {
+      Node *node = list_->head_;
+      for (int level = list_->max_height_.load() - 1; level >= 0; level--) {
+        Node *next = node->Next(level);
+        while (next != nullptr && list_->comparator_(next->key_, key) < 0) {
+          node = next;
+          next = node->Next(level);
+        }
+      }
+      node_ = node->Next(0);
+    }
+
+    bool IsEnd() const { return node_ == nullptr; }
+
+    void Next() { node_ = node_->Next(0); }
+
+    const KeyType &Key() const { return node_->key_; }
+
+    const ValueType &Value() const { return node_->value_; }
+
+    bool IsDeleted() const { return node_->is_deleted_.load(); }
+
+   private:
+    const SkipList *list_;
+    Node *node_;
+  };
+
+ private:
+  static constexpr int MAX_HEIGHT = 12;
+  // a node reaches the next level with probability 1 / BRANCHING
+  static constexpr uint32_t BRANCHING = 4;
+
+  struct Node {
+    Node *Next(int level) const { return next_[level].load(std::memory_order_acquire); }
+
+    KeyType key_;
+    ValueType value_;
+    std::atomic<bool> is_deleted_;
+    int height_;
+    // height_ entries, the node is allocated with room for them
+    std::atomic<Node *> next_[1];
+  };
+
+  static Node *NewNode(int height) {
+    void *memory = ::operator new(sizeof(Node) + sizeof(std::atomic<Node *>) * (height - 1));
+    auto *node = new (memory) Node();
+    node->height_ = height;
+    for (int level = 0; level < height; level++) {
+      new (&node->next_[level]) std::atomic<Node *>(nullptr);
+    }
+    return node;
+  }
+
+  static void FreeNode(Node *node) {
+    node->~Node();
+    ::operator delete(node);
+  }
+
+  static int RandomHeight() {
+    // xorshift, one state per thread so that inserts do not share a cache line
+    thread_local uint32_t state = 2463534242U ^ static_cast<uint32_t>(reinterpret_cast<uintptr_t>(&state));
+    int height = 1;
+    while (height < MAX_HEIGHT) {
+      state ^= state << 13;
+      state ^= state >> 17;
+      state ^= state << 5;
+      if (state % BRANCHING != 0) {
+        break;
+      }
+      height++;
+    }
+    return height;
+  }
+
+  /** Compares the pair of a node with a pair. */
+  int Compare(const Node *node, const KeyType &key, const ValueType &value) const {
+    int cmp = comparator_(node->key_, key);
+    return cmp != 0 ? cmp : memcmp(&node->value_, &value, sizeof(ValueType));
+  }
+
+  /**
+   * Finds the predecessor and the successor of a pair on every level.
+   * @return the first node that is not smaller than the pair, nullptr if there is none
+   */
+  Node *FindGreaterOrEqual(const KeyType &key, const ValueType &value, Node **preds, Node **succs) const {
+    Node *node = head_;
+    for (int level = MAX_HEIGHT - 1; level >= 0; level--) {
+      Node *next = node->Next(level);
+      while (next != nullptr && Compare(next, key, value) < 0) {
+        node = next;
+        next = node->Next(level);
+      }
+      preds[level] = node;
+      succs[level] = next;
+    }
+    return succs[0];
+  }
+
+  KeyComparator comparator_;
+  Node *head_;
+  std::atomic<int> max_height_{1};
+  std::atomic<size_t> size_{0};
+};
+
+}  // namespace bustub
@@ -13,12 +13,10 @@
 #pragma once
 
 #include <memory>
-#include <unordered_map>
 #include <utility>
 #include <vector>
 
-#include "common/util/hash_util.h"
-#include "container/hash/hash_function.h"
+#include "container/hash/flat_hash_table.h"
 #include "execution/executor_context.h"
 #include "execution/executors/abstract_executor.h"
 #include "execution/expressions/abstract_expression.h"
@@ -102,50 +100,66 @@ class SimpleAggregationHashTable {
    * @param agg_val the value to be inserted
    */
   void InsertCombine(const AggregateKey &agg_key, const AggregateValue &agg_val) {
-    if (ht_.count(agg_key) == 0) {
-      ht_.insert({agg_key, GenerateInitialAggregateValue()});
+    key_buf_.Clear();
+    for (const auto &value : agg_key.group_bys_) {
+      key_buf_.Append(value);
     }
-    CombineAggregateValues(&ht_[agg_key], agg_val);
+    bool inserted;
+    uint32_t *group = ht_.FindOrInsert(key_buf_, &inserted);
+    if (inserted) {
+      *group = static_cast<uint32_t>(keys_.size());
+      keys_.push_back(agg_key);
+      vals_.push_back(GenerateInitialAggregateValue());
+    }
+    CombineAggregateValues(&vals_[*group], agg_val);
   }
 
-  /** An iterator over the aggregation hash table */
+  /** An iterator over the aggregation hash table, groups are visited in the order they were first seen */
   class Iterator {
    public:
     /** Creates an iterator for the aggregate map. */
-    explicit Iterator(std::unordered_map<AggregateKey, AggregateValue>::const_iterator iter) : iter_{iter} {}
+    Iterator(const SimpleAggregationHashTable *table, size_t pos) : table_{table}, pos_{pos} {}
 
     /** @return The key of the iterator */
-    const AggregateKey &Key() { return iter_->first; }
+    const AggregateKey &Key() { return table_->keys_[pos_]; }
 
     /** @return The value of the iterator */
-    const AggregateValue &Val() { return iter_->second; }
+    const AggregateValue &Val() { return table_->vals_[pos_]; }
 
     /** @return The iterator before it is incremented */
     Iterator &operator++() {
-      ++iter_;
+      ++pos_;
       return *this;
     }
 
     /** @return `true` if both iterators are identical */
-    bool operator==(const Iterator &other) { return this->iter_ == other.iter_; }
+    bool operator==(const Iterator &other) { return this->table_ == other.table_ && this->pos_ == other.pos_; }
 
     /** @return `true` if both iterators are different */
-    bool operator!=(const Iterator &other) { return this->iter_ != other.iter_; }
+    bool operator!=(const Iterator &other) { return !(*this == other); }
 
    private:
-    /** Aggregates map */
-    std::unordered_map<AggregateKey, AggregateValue>::const_iterator iter_;
+    /** The aggregation hash table */
+    const SimpleAggregationHashTable *table_;
+    /** Index of the current group */
+    size_t pos_;
   };
 
   /** @return Iterator to the start of the hash table */
-  Iterator Begin() { return Iterator{ht_.cbegin()}; }
+  Iterator Begin() { return Iterator{this, 0}; }
 
   /** @return Iterator to the end of the hash table */
-  Iterator End() { return Iterator{ht_.cend()}; }
+  Iterator End() { return Iterator{this, keys_.size()}; }
 
  private:
-  /** The hash table is just a map from aggregate keys to aggregate values */
-  std::unordered_map<AggregateKey, AggregateValue> ht_{};
+  /** Maps the serialized group-by values of every group to its index in keys_ and vals_ */
+  FlatHashTable<uint32_t> ht_{};
+  /** Reusable buffer for serialized group-by values */
+  FlatHashKey key_buf_;
+  /** The group-by values of every group */
+  std::vector<AggregateKey> keys_;
+  /** The running aggregates of every group */
+  std::vector<AggregateValue> vals_;
   /** The aggregate expressions that we have */
   const std::vector<const AbstractExpression *> &agg_exprs_;
   /** The types of aggregations that we have */
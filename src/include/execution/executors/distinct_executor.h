@@ -13,48 +13,15 @@
 #pragma once
 
 #include <memory>
-#include <unordered_set>
 #include <utility>
 #include <vector>
 
-#include "common/util/hash_util.h"
+#include "container/hash/flat_hash_table.h"
 #include "execution/executors/abstract_executor.h"
 #include "execution/plans/distinct_plan.h"
 
 namespace bustub {
 
-struct DistinctKey {
-  std::vector<Value> group_bys_;
-
-  bool operator==(const DistinctKey &other) const {
-    for (uint32_t i = 0; i < other.group_bys_.size(); i++) {
-      if (group_bys_[i].CompareEquals(other.group_bys_[i]) != CmpBool::CmpTrue) {
-        return false;
-      }
-    }
-    return true;
-  }
-};
-}  // namespace bustub
-
-namespace std {
-
-template <>
-struct hash<bustub::DistinctKey> {
-  std::size_t operator()(const bustub::DistinctKey &agg_key) const {
-    size_t curr_hash = 0;
-    for (const auto &key : agg_key.group_bys_) {
-      if (!key.IsNull()) {
-        curr_hash = bustub::HashUtil::CombineHashes(curr_hash, bustub::HashUtil::HashValue(&key));
-      }
-    }
-    return curr_hash;
-  }
-};
-}  // namespace std
-
-namespace bustub {
-
 /**
  * DistinctExecutor removes duplicate rows from child ouput.
  */
@@ -88,7 +55,9 @@ class DistinctExecutor : public AbstractExecutor {
   const DistinctPlanNode *plan_;
   /** The child executor from which tuples are obtained */
   std::unique_ptr<AbstractExecutor> child_executor_;
-  /** Hash table for all columns in the out schema */
-  std::unordered_set<DistinctKey> hash_table_;
+  /** Hash set over all columns in the out schema */
+  FlatHashTable<> hash_table_;
+  /** Reusable buffer for serialized rows */
+  FlatHashKey key_;
 };
 }  // namespace bustub
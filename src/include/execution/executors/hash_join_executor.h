@@ -13,11 +13,11 @@
 #pragma once
 
 #include <memory>
-#include <unordered_map>
 #include <utility>
 #include <vector>
 
-#include "common/util/hash_util.h"
+#include "container/hash/blocked_bloom_filter.h"
+#include "container/hash/flat_hash_table.h"
 #include "execution/executor_context.h"
 #include "execution/executors/abstract_executor.h"
 #include "execution/plans/hash_join_plan.h"
@@ -25,23 +25,6 @@
 
 namespace bustub {
 
-struct HashJoinKey {
-  Value key_;
-
-  bool operator==(const HashJoinKey &other) const { return key_.CompareEquals(other.key_) == CmpBool::CmpTrue; }
-};
-}  // namespace bustub
-
-namespace std {
-
-template <>
-struct hash<bustub::HashJoinKey> {
-  std::size_t operator()(const bustub::HashJoinKey &key) const { return bustub::HashUtil::HashValue(&key.key_); }
-};
-}  // namespace std
-
-namespace bustub {
-
 /**
  * HashJoinExecutor executes a nested-loop JOIN on two tables.
  */
@@ -72,18 +55,33 @@ class HashJoinExecutor : public AbstractExecutor {
   const Schema *GetOutputSchema() override { return plan_->OutputSchema(); }
 
  private:
+  /** A left tuple stored in the hash table arena, the serialized tuple directly follows it. */
+  struct BuildRow {
+    const BuildRow *next_;
+  };
+
+  /** Payload of the hash table: the left tuples sharing a join key, in insertion order. */
+  struct BuildChain {
+    BuildRow *head_;
+    BuildRow *tail_;
+  };
+
   /** The NestedLoopJoin plan node to be executed. */
   const HashJoinPlanNode *plan_;
   /** The left child executor to obtain value from */
   std::unique_ptr<AbstractExecutor> left_child_executor_;
   /** The right child executor to obtain value from */
   std::unique_ptr<AbstractExecutor> right_child_executor_;
-  /** The next index to be accessed in outer_table_buffer_ */
-  std::size_t next_pos_{0};
-  /** Hash table */
-  std::unordered_map<HashJoinKey, std::vector<std::vector<Value>>> hash_table_;
-  /** Buffer of any value of hash_table_ */
-  std::vector<std::vector<Value>> outer_table_buffer_;
+  /** Hash table on the join key of the left child, each key owns a chain of serialized left tuples */
+  FlatHashTable<BuildChain> hash_table_;
+  /** Bloom filter over the left join keys, pushed down into the right child if it is a sequential scan */
+  std::unique_ptr<BlockedBloomFilter> bloom_filter_;
+  /** Reusable buffer for serialized join keys */
+  FlatHashKey key_;
+  /** The right tuple currently being probed */
+  Tuple right_tuple_;
+  /** The next left tuple in the chain that matches right_tuple_ */
+  const BuildRow *next_row_{nullptr};
 };
 
 }  // namespace bustub
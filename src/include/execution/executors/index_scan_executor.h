@@ -14,6 +14,7 @@
 
 #include <vector>
 
+#include "catalog/catalog.h"
 #include "common/rid.h"
 #include "execution/executor_context.h"
 #include "execution/executors/abstract_executor.h"
@@ -23,9 +24,12 @@
 namespace bustub {
 
 /**
- * IndexScanExecutor executes an index scan over a table.
+ * IndexScanExecutor executes an index scan over a table through a B+ tree or an adaptive radix tree index.
+ *
+ * The key range of the scan is derived from the predicate when it compares the (single column) index key with
+ * a constant. RIDs are collected from the index in batches, sorted by page and then read from the table heap
+ * one page at a time, so the heap pages of a range are visited in order instead of once per key.
  */
-
 class IndexScanExecutor : public AbstractExecutor {
  public:
   /**
@@ -35,6 +39,8 @@ class IndexScanExecutor : public AbstractExecutor {
    */
   IndexScanExecutor(ExecutorContext *exec_ctx, const IndexScanPlanNode *plan);
 
+  ~IndexScanExecutor() override;
+
   const Schema *GetOutputSchema() override { return plan_->OutputSchema(); };
 
   void Init() override;
@@ -42,7 +48,48 @@ class IndexScanExecutor : public AbstractExecutor {
   bool Next(Tuple *tuple, RID *rid) override;
 
  private:
+  /** Derive the key range of the scan from the predicate. */
+  void DeriveKeyRange();
+
+  /** Collect the next batch of RIDs from the index and read their tuples. */
+  void FillBatch();
+
+  /** Collect the next batch of RIDs from a B+ tree index with keys of the given size. */
+  template <size_t KeySize>
+  void ScanIndex();
+
+  /** Collect the next batch of RIDs from an adaptive radix tree index with keys of the given size. */
+  template <size_t KeySize>
+  void ScanRadixTree();
+
   /** The index scan plan node to be executed. */
   const IndexScanPlanNode *plan_;
+  /** Metadata of the index to be scanned */
+  IndexInfo *index_info_{Catalog::NULL_INDEX_INFO};
+  /** Metadata of the table the index belongs to */
+  TableInfo *table_info_{Catalog::NULL_TABLE_INFO};
+  /** The idx of each column of the out schema in the table schema */
+  std::vector<uint32_t> out_schema_idx_;
+  /** The predicate tuples are tested against */
+  const AbstractExpression *predicate_{nullptr};
+  /** Whether predicate_ was allocated by this executor */
+  bool is_alloc_{false};
+  /** The smallest key of the range, if has_low_key_ */
+  Tuple low_key_;
+  bool has_low_key_{false};
+  /** The largest key of the range, if has_high_key_ */
+  Tuple high_key_;
+  bool has_high_key_{false};
+  /** The key the next batch starts at, if has_next_key_ */
+  Tuple next_key_;
+  bool has_next_key_{false};
+  /** Whether the key range has been exhausted */
+  bool index_done_{false};
+  /** RIDs of the current batch */
+  std::vector<RID> rids_;
+  /** Tuples of the current batch, in page order */
+  std::vector<Tuple> tuples_;
+  /** Position of the next tuple in tuples_ */
+  size_t pos_{0};
 };
 }  // namespace bustub
@@ -18,6 +18,7 @@
 #include <utility>
 #include <vector>
 
+#include "catalog/catalog.h"
 #include "execution/executor_context.h"
 #include "execution/executors/abstract_executor.h"
 #include "execution/expressions/abstract_expression.h"
@@ -29,6 +30,10 @@ namespace bustub {
 
 /**
  * IndexJoinExecutor executes index join operations.
+ *
+ * The outer tuples are joined in batches. The join keys of a batch are sorted and deduplicated, so that the
+ * inner index is probed once per distinct key and in key order, which keeps the probed index pages hot. The
+ * matching inner tuples of the whole batch are then read from the table heap one page at a time.
  */
 class NestIndexJoinExecutor : public AbstractExecutor {
  public:
@@ -48,7 +53,26 @@ class NestIndexJoinExecutor : public AbstractExecutor {
   bool Next(Tuple *tuple, RID *rid) override;
 
  private:
+  /** Join the next batch of outer tuples into out_tuples_. */
+  void JoinBatch();
+
   /** The nested index join plan node. */
   const NestedIndexJoinPlanNode *plan_;
+  /** The child executor that produces the outer tuples */
+  std::unique_ptr<AbstractExecutor> child_executor_;
+  /** Metadata of the index on the inner table */
+  IndexInfo *index_info_{Catalog::NULL_INDEX_INFO};
+  /** Metadata of the inner table */
+  TableInfo *table_info_{Catalog::NULL_TABLE_INFO};
+  /** The side of the predicate that computes the join key of an outer tuple */
+  const AbstractExpression *outer_key_expr_{nullptr};
+  /** Whether the child executor is exhausted */
+  bool child_done_{false};
+  /** Outer tuples of the current batch */
+  std::vector<Tuple> outer_tuples_;
+  /** Joined tuples of the current batch */
+  std::vector<Tuple> out_tuples_;
+  /** Position of the next tuple in out_tuples_ */
+  size_t pos_{0};
 };
 }  // namespace bustub
@@ -14,6 +14,7 @@
 
 #include <memory>
 #include <utility>
+#include <vector>
 
 #include "execution/executor_context.h"
 #include "execution/executors/abstract_executor.h"
@@ -23,7 +24,8 @@
 namespace bustub {
 
 /**
- * NestedLoopJoinExecutor executes a nested-loop JOIN on two tables.
+ * NestedLoopJoinExecutor executes a block nested-loop JOIN on two tables. Outer tuples are buffered in
+ * batches bounded by the plan's outer buffer size, and each inner tuple is compared against the whole batch.
  */
 class NestedLoopJoinExecutor : public AbstractExecutor {
  public:
@@ -55,6 +57,9 @@ class NestedLoopJoinExecutor : public AbstractExecutor {
   const Schema *GetOutputSchema() override { return plan_->OutputSchema(); }
 
  private:
+  /** Refill outer_batch_ from the left child, @return `false` if the left child is exhausted */
+  bool LoadOuterBatch();
+
   /** The NestedLoopJoin plan node to be executed. */
   const NestedLoopJoinPlanNode *plan_;
   /** The left child executor to obtain value from */
@@ -65,12 +70,14 @@ class NestedLoopJoinExecutor : public AbstractExecutor {
   mutable const AbstractExpression *predicate_{nullptr};
   /** Whether to allocate memory for the predicate_ */
   bool is_alloc_{false};
-  /** The current tuple of outer table */
-  Tuple left_tuple_;
-  /** The current rid of outer table */
-  RID left_rid_;
-  /** Whether the pre-select of outer table is successful */
-  bool is_left_selected_;
+  /** The current batch of outer tuples */
+  std::vector<Tuple> outer_batch_;
+  /** The next tuple in outer_batch_ to be compared with right_tuple_ */
+  std::size_t outer_pos_{0};
+  /** The current tuple of inner table */
+  Tuple right_tuple_;
+  /** Whether right_tuple_ still has to be compared with part of the batch */
+  bool is_right_selected_{false};
 };
 
 }  // namespace bustub
@@ -0,0 +1,70 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// nested_loop_semi_join_executor.h
+//
+// Identification: src/include/execution/executors/nested_loop_semi_join_executor.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <memory>
+#include <utility>
+
+#include "execution/executor_context.h"
+#include "execution/executors/abstract_executor.h"
+#include "execution/plans/semi_join_plan.h"
+#include "storage/table/tuple.h"
+
+namespace bustub {
+
+/**
+ * NestedLoopSemiJoinExecutor executes a semi-join or an anti-join on an arbitrary predicate. The right side
+ * is rescanned for every left tuple, and the scan stops at the first right tuple that satisfies the predicate.
+ */
+class NestedLoopSemiJoinExecutor : public AbstractExecutor {
+ public:
+  /**
+   * Construct a new NestedLoopSemiJoinExecutor instance.
+   * @param exec_ctx The executor context
+   * @param plan The semi-join or anti-join plan to be executed
+   * @param left_child The child executor that produces the tuples to be emitted
+   * @param right_child The child executor that produces the tuples to be matched against
+   */
+  NestedLoopSemiJoinExecutor(ExecutorContext *exec_ctx, const SemiJoinPlanNode *plan,
+                             std::unique_ptr<AbstractExecutor> &&left_child,
+                             std::unique_ptr<AbstractExecutor> &&right_child);
+
+  /** Initialize the join */
+  void Init() override;
+
+  /**
+   * Yield the next tuple from the join.
+   * @param[out] tuple The next tuple produced by the join
+   * @param[out] rid The next tuple RID produced by the join
+   * @return `true` if a tuple was produced, `false` if there are no more tuples
+   */
+  bool Next(Tuple *tuple, RID *rid) override;
+
+  /** @return The output schema for the join */
+  const Schema *GetOutputSchema() override { return plan_->OutputSchema(); }
+
+ private:
+  /** @return `true` if some right tuple satisfies the predicate with the given left tuple */
+  bool HasMatch(const Tuple &left_tuple);
+
+  /** The semi-join or anti-join plan node to be executed */
+  const SemiJoinPlanNode *plan_;
+  /** The left child executor to obtain value from */
+  std::unique_ptr<AbstractExecutor> left_child_executor_;
+  /** The right child executor to obtain value from */
+  std::unique_ptr<AbstractExecutor> right_child_executor_;
+  /** Whether the plan is an anti-join */
+  bool is_anti_;
+};
+
+}  // namespace bustub
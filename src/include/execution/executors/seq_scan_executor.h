@@ -15,6 +15,8 @@
 #include <memory>
 #include <vector>
 
+#include "container/hash/blocked_bloom_filter.h"
+#include "container/hash/flat_hash_table.h"
 #include "execution/executor_context.h"
 #include "execution/executors/abstract_executor.h"
 #include "execution/expressions/abstract_expression.h"
@@ -51,6 +53,15 @@ class SeqScanExecutor : public AbstractExecutor {
   /** @return The output schema for the sequential scan */
   const Schema *GetOutputSchema() override { return plan_->OutputSchema(); }
 
+  /**
+   * Push a runtime filter on a join key down into the scan. Tuples whose key is rejected by the filter,
+   * or is null, are skipped before they are materialized.
+   * @param key_expr The join key, evaluated against the output schema of the scan
+   * @param filter The filter over FlatHashKey hashes of the key, it must outlive the scan
+   * @return `true` if the filter was accepted, only plain column keys can be pushed down
+   */
+  bool PushRuntimeFilter(const AbstractExpression *key_expr, const BlockedBloomFilter *filter);
+
  private:
   /** The sequential scan plan node to be executed */
   const SeqScanPlanNode *plan_;
@@ -66,5 +77,11 @@ class SeqScanExecutor : public AbstractExecutor {
   bool is_alloc_{false};
   /** The idx of each column of the out schema in the origin schema */
   std::vector<uint32_t> out_schema_idx_;
+  /** The runtime filter pushed down by a join, or nullptr */
+  const BlockedBloomFilter *runtime_filter_{nullptr};
+  /** The idx of the filtered column in the origin schema */
+  uint32_t runtime_filter_col_{0};
+  /** Reusable buffer for the serialized filter key */
+  FlatHashKey runtime_filter_key_;
 };
 }  // namespace bustub
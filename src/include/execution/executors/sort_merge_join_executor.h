@@ -0,0 +1,110 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// sort_merge_join_executor.h
+//
+// Identification: src/include/execution/executors/sort_merge_join_executor.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "execution/executor_context.h"
+#include "execution/executors/abstract_executor.h"
+#include "execution/plans/sort_merge_join_plan.h"
+#include "storage/table/tuple.h"
+
+namespace bustub {
+
+/**
+ * SortMergeJoinExecutor executes an equi-JOIN on two inputs ordered on their join keys.
+ *
+ * Inputs that the plan does not mark as sorted are materialized and sorted on their first Init().
+ * The right tuples sharing a key are buffered as a run, and every left tuple with that key is joined
+ * with the whole run, so duplicate keys on both sides are handled without rescanning either input.
+ */
+class SortMergeJoinExecutor : public AbstractExecutor {
+ public:
+  /**
+   * Construct a new SortMergeJoinExecutor instance.
+   * @param exec_ctx The executor context
+   * @param plan The sort-merge join plan to be executed
+   * @param left_child The child executor that produces tuples for the left side of join
+   * @param right_child The child executor that produces tuples for the right side of join
+   */
+  SortMergeJoinExecutor(ExecutorContext *exec_ctx, const SortMergeJoinPlanNode *plan,
+                        std::unique_ptr<AbstractExecutor> &&left_child,
+                        std::unique_ptr<AbstractExecutor> &&right_child);
+
+  /** Initialize the join */
+  void Init() override;
+
+  /**
+   * Yield the next tuple from the join.
+   * @param[out] tuple The next tuple produced by the join
+   * @param[out] rid The next tuple RID produced by the join
+   * @return `true` if a tuple was produced, `false` if there are no more tuples
+   */
+  bool Next(Tuple *tuple, RID *rid) override;
+
+  /** @return The output schema for the join */
+  const Schema *GetOutputSchema() override { return plan_->OutputSchema(); }
+
+ private:
+  /** One input of the merge, read either directly from its child or from its sorted materialization. */
+  struct MergeInput {
+    /** The child executor */
+    std::unique_ptr<AbstractExecutor> child_;
+    /** The output schema of the child */
+    const Schema *schema_;
+    /** The expression to compute the join key */
+    const AbstractExpression *key_expr_;
+    /** Whether the child already produces tuples in key order */
+    bool is_sorted_;
+    /** Whether sorted_ has been built */
+    bool is_materialized_{false};
+    /** The tuples of the child and their keys in key order, if the child is not sorted */
+    std::vector<std::pair<Value, Tuple>> sorted_;
+    /** The next position in sorted_ */
+    std::size_t pos_{0};
+    /** Whether key_ and tuple_ hold the current tuple */
+    bool is_valid_{false};
+    /** The key of the current tuple */
+    Value key_;
+    /** The current tuple */
+    Tuple tuple_;
+  };
+
+  /** Rewind an input to its first tuple, sorting it first if needed. */
+  static void InitInput(MergeInput *input);
+
+  /** Move an input to its next tuple with a non-null key. */
+  static void Advance(MergeInput *input);
+
+  /** @return the output tuple joining left_.tuple_ and the given right tuple */
+  Tuple MakeOutputTuple(const Tuple &right_tuple) const;
+
+  /** The SortMergeJoin plan node to be executed. */
+  const SortMergeJoinPlanNode *plan_;
+  /** The left input */
+  MergeInput left_;
+  /** The right input */
+  MergeInput right_;
+  /** The right tuples that share the key of the current left tuple */
+  std::vector<Tuple> right_run_;
+  /** The key of right_run_ */
+  Value run_key_;
+  /** Whether the current left tuple is being joined with right_run_ */
+  bool in_run_{false};
+  /** The next index to be accessed in right_run_ */
+  std::size_t run_pos_{0};
+};
+
+}  // namespace bustub
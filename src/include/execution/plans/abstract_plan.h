@@ -31,7 +31,10 @@ enum class PlanType {
   Distinct,
   NestedLoopJoin,
   NestedIndexJoin,
-  HashJoin
+  HashJoin,
+  SortMergeJoin,
+  SemiJoin,
+  AntiJoin
 };
 
 /**
@@ -22,29 +22,40 @@ namespace bustub {
  */
 class IndexScanPlanNode : public AbstractPlanNode {
  public:
+  /** Default number of RIDs that are collected from the index before the table is read */
+  static constexpr uint32_t DEFAULT_RID_BATCH_SIZE = 1024;
+
   /**
    * Creates a new index scan plan node.
    * @param output the output format of this scan plan node
    * @param predicate the predicate to scan with, tuples are returned if predicate(tuple) == true or predicate ==
    * nullptr
-   * @param table_oid the identifier of table to be scanned
+   * @param index_oid the identifier of the B+ tree index to be scanned
+   * @param rid_batch_size the number of RIDs that are collected from the index and sorted by page before the
+   * table is read, tuples are returned in key order across batches but in page order within one
    */
-  IndexScanPlanNode(const Schema *output, const AbstractExpression *predicate, index_oid_t index_oid)
-      : AbstractPlanNode(output, {}), predicate_{predicate}, index_oid_(index_oid) {}
+  IndexScanPlanNode(const Schema *output, const AbstractExpression *predicate, index_oid_t index_oid,
+                    uint32_t rid_batch_size = DEFAULT_RID_BATCH_SIZE)
+      : AbstractPlanNode(output, {}), predicate_{predicate}, index_oid_(index_oid), rid_batch_size_(rid_batch_size) {}
 
   PlanType GetType() const override { return PlanType::IndexScan; }
 
   /** @return the predicate to test tuples against; tuples should only be returned if they evaluate to true */
   const AbstractExpression *GetPredicate() const { return predicate_; }
 
-  /** @return the identifier of the table that should be scanned */
+  /** @return the identifier of the index that should be scanned */
   index_oid_t GetIndexOid() const { return index_oid_; }
 
+  /** @return the number of RIDs that are collected from the index before the table is read */
+  uint32_t RidBatchSize() const { return rid_batch_size_; }
+
  private:
   /** The predicate that all returned tuples must satisfy. */
   const AbstractExpression *predicate_;
-  /** The table whose tuples should be scanned. */
+  /** The index whose tuples should be scanned. */
   index_oid_t index_oid_;
+  /** The number of RIDs that are collected from the index before the table is read. */
+  uint32_t rid_batch_size_;
 };
 
 }  // namespace bustub
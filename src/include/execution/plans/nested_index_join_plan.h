@@ -29,15 +29,31 @@ namespace bustub {
  */
 class NestedIndexJoinPlanNode : public AbstractPlanNode {
  public:
+  /** Default number of outer tuples whose index probes are batched together */
+  static constexpr uint32_t DEFAULT_OUTER_BATCH_SIZE = 1024;
+
+  /**
+   * Creates a new nested index join plan node.
+   * @param output_schema the output format of this nested index join node
+   * @param children the child plan that produces the outer tuples
+   * @param predicate the join predicate, an equality between an outer column and the inner index key column
+   * @param inner_table_oid the table oid of the inner table
+   * @param index_name the name of the index on the inner table
+   * @param outer_table_schema schema of the outer tuples
+   * @param inner_table_schema schema of the inner tuples
+   * @param outer_batch_size number of outer tuples whose index probes are batched together
+   */
   NestedIndexJoinPlanNode(const Schema *output_schema, std::vector<const AbstractPlanNode *> &&children,
                           const AbstractExpression *predicate, table_oid_t inner_table_oid, std::string index_name,
-                          const Schema *outer_table_schema, const Schema *inner_table_schema)
+                          const Schema *outer_table_schema, const Schema *inner_table_schema,
+                          uint32_t outer_batch_size = DEFAULT_OUTER_BATCH_SIZE)
       : AbstractPlanNode(output_schema, std::move(children)),
         predicate_(predicate),
         inner_table_oid_(inner_table_oid),
         index_name_(std::move(index_name)),
         outer_table_schema_(outer_table_schema),
-        inner_table_schema_(inner_table_schema) {}
+        inner_table_schema_(inner_table_schema),
+        outer_batch_size_(outer_batch_size) {}
 
   PlanType GetType() const override { return PlanType::NestedIndexJoin; }
 
@@ -59,6 +75,9 @@ class NestedIndexJoinPlanNode : public AbstractPlanNode {
   /** @return Schema with needed columns in from the inner table */
   const Schema *InnerTableSchema() const { return inner_table_schema_; }
 
+  /** @return the number of outer tuples whose index probes are batched together */
+  uint32_t OuterBatchSize() const { return outer_batch_size_; }
+
  private:
   /** The nested index join predicate. */
   const AbstractExpression *predicate_;
@@ -66,5 +85,6 @@ class NestedIndexJoinPlanNode : public AbstractPlanNode {
   const std::string index_name_;
   const Schema *outer_table_schema_;
   const Schema *inner_table_schema_;
+  uint32_t outer_batch_size_;
 };
 }  // namespace bustub
@@ -23,19 +23,29 @@ namespace bustub {
 
 /**
  * NestedLoopJoinPlanNode joins tuples from two child plan nodes.
+ *
+ * The join is executed as a block nested loop join: the outer (left) side is consumed in batches of up to
+ * `outer_buffer_size` bytes, and the inner (right) side is scanned once per batch rather than once per outer
+ * tuple. A buffer size of zero degenerates to the tuple-at-a-time nested loop join.
  */
 class NestedLoopJoinPlanNode : public AbstractPlanNode {
  public:
+  /** Default memory budget for a batch of outer tuples */
+  static constexpr uint32_t DEFAULT_OUTER_BUFFER_SIZE = 16 * PAGE_SIZE;
+
   /**
    * Construct a new NestedLoopJoinPlanNode instance.
    * @param output The output format of this nested loop join node
    * @param children Two sequential scan children plans
    * @param predicate The predicate to join with, the tuples are joined
    * if predicate(tuple) = true or predicate = `nullptr`
+   * @param outer_buffer_size The memory budget in bytes for a batch of outer tuples
    */
   NestedLoopJoinPlanNode(const Schema *output_schema, std::vector<const AbstractPlanNode *> &&children,
-                         const AbstractExpression *predicate)
-      : AbstractPlanNode(output_schema, std::move(children)), predicate_(predicate) {}
+                         const AbstractExpression *predicate, uint32_t outer_buffer_size = DEFAULT_OUTER_BUFFER_SIZE)
+      : AbstractPlanNode(output_schema, std::move(children)),
+        predicate_(predicate),
+        outer_buffer_size_(outer_buffer_size) {}
 
   /** @return The type of the plan node */
   PlanType GetType() const override { return PlanType::NestedLoopJoin; }
@@ -43,6 +53,9 @@ class NestedLoopJoinPlanNode : public AbstractPlanNode {
   /** @return The predicate to be used in the nested loop join */
   const AbstractExpression *Predicate() const { return predicate_; }
 
+  /** @return The memory budget in bytes for a batch of outer tuples */
+  uint32_t OuterBufferSize() const { return outer_buffer_size_; }
+
   /** @return The left plan node of the nested loop join, by convention it should be the smaller table */
   const AbstractPlanNode *GetLeftPlan() const {
     BUSTUB_ASSERT(GetChildren().size() == 2, "Nested loop joins should have exactly two children plans.");
@@ -58,6 +71,8 @@ class NestedLoopJoinPlanNode : public AbstractPlanNode {
  private:
   /** The join predicate */
   const AbstractExpression *predicate_;
+  /** The memory budget in bytes for a batch of outer tuples */
+  uint32_t outer_buffer_size_;
 };
 
 }  // namespace bustub
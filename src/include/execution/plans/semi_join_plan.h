@@ -0,0 +1,111 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// semi_join_plan.h
+//
+// Identification: src/include/execution/plans/semi_join_plan.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <utility>
+#include <vector>
+
+#include "execution/plans/abstract_plan.h"
+
+namespace bustub {
+
+/** The algorithms a semi-join or an anti-join can be executed with. */
+enum class SemiJoinStrategy { Hash, NestedLoop };
+
+/**
+ * SemiJoinPlanNode emits every left tuple that has at least one matching right tuple, once, and only the
+ * columns of the left tuple (EXISTS / IN).
+ *
+ * The hash strategy matches tuples on equal join keys and keeps only the set of right keys. The nested loop
+ * strategy matches tuples on an arbitrary predicate and rescans the right side for every left tuple, stopping
+ * at the first match.
+ */
+class SemiJoinPlanNode : public AbstractPlanNode {
+ public:
+  /**
+   * Construct a new hash SemiJoinPlanNode instance.
+   * @param output_schema The output schema, its columns refer to the left tuple only
+   * @param children The child plans from which tuples are obtained
+   * @param left_key_expression The expression for the left JOIN key
+   * @param right_key_expression The expression for the right JOIN key
+   */
+  SemiJoinPlanNode(const Schema *output_schema, std::vector<const AbstractPlanNode *> &&children,
+                   const AbstractExpression *left_key_expression, const AbstractExpression *right_key_expression)
+      : AbstractPlanNode(output_schema, std::move(children)),
+        strategy_{SemiJoinStrategy::Hash},
+        left_key_expression_{left_key_expression},
+        right_key_expression_{right_key_expression} {}
+
+  /**
+   * Construct a new nested loop SemiJoinPlanNode instance.
+   * @param output_schema The output schema, its columns refer to the left tuple only
+   * @param children The child plans from which tuples are obtained
+   * @param predicate The predicate to join with, `nullptr` matches every pair of tuples
+   */
+  SemiJoinPlanNode(const Schema *output_schema, std::vector<const AbstractPlanNode *> &&children,
+                   const AbstractExpression *predicate)
+      : AbstractPlanNode(output_schema, std::move(children)),
+        strategy_{SemiJoinStrategy::NestedLoop},
+        predicate_{predicate} {}
+
+  /** @return The type of the plan node */
+  PlanType GetType() const override { return PlanType::SemiJoin; }
+
+  /** @return The algorithm to execute the join with */
+  SemiJoinStrategy GetStrategy() const { return strategy_; }
+
+  /** @return The expression to compute the left join key, for the hash strategy */
+  const AbstractExpression *LeftJoinKeyExpression() const { return left_key_expression_; }
+
+  /** @return The expression to compute the right join key, for the hash strategy */
+  const AbstractExpression *RightJoinKeyExpression() const { return right_key_expression_; }
+
+  /** @return The predicate to join with, for the nested loop strategy */
+  const AbstractExpression *Predicate() const { return predicate_; }
+
+  /** @return The left plan node, whose tuples are emitted */
+  const AbstractPlanNode *GetLeftPlan() const {
+    BUSTUB_ASSERT(GetChildren().size() == 2, "Semi joins should have exactly two children plans.");
+    return GetChildAt(0);
+  }
+
+  /** @return The right plan node, whose tuples are only tested for a match */
+  const AbstractPlanNode *GetRightPlan() const {
+    BUSTUB_ASSERT(GetChildren().size() == 2, "Semi joins should have exactly two children plans.");
+    return GetChildAt(1);
+  }
+
+ private:
+  /** The algorithm to execute the join with */
+  SemiJoinStrategy strategy_;
+  /** The expression to compute the left JOIN key */
+  const AbstractExpression *left_key_expression_{nullptr};
+  /** The expression to compute the right JOIN key */
+  const AbstractExpression *right_key_expression_{nullptr};
+  /** The join predicate */
+  const AbstractExpression *predicate_{nullptr};
+};
+
+/**
+ * AntiJoinPlanNode emits every left tuple that has no matching right tuple (NOT EXISTS). Keys are compared
+ * with NOT EXISTS semantics: a null key never matches, so a left tuple with a null key is always emitted.
+ */
+class AntiJoinPlanNode : public SemiJoinPlanNode {
+ public:
+  using SemiJoinPlanNode::SemiJoinPlanNode;
+
+  /** @return The type of the plan node */
+  PlanType GetType() const override { return PlanType::AntiJoin; }
+};
+
+}  // namespace bustub
@@ -0,0 +1,85 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// sort_merge_join_plan.h
+//
+// Identification: src/include/execution/plans/sort_merge_join_plan.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <utility>
+#include <vector>
+
+#include "execution/plans/abstract_plan.h"
+
+namespace bustub {
+
+/**
+ * Sort-merge join performs an equi-JOIN by merging two inputs ordered on their join keys.
+ * Each input is either known to be produced in ascending key order already (e.g. by an index scan),
+ * or is materialized and sorted by the executor. The output is ordered on the join key.
+ */
+class SortMergeJoinPlanNode : public AbstractPlanNode {
+ public:
+  /**
+   * Construct a new SortMergeJoinPlanNode instance.
+   * @param output_schema The output schema for the JOIN
+   * @param children The child plans from which tuples are obtained
+   * @param left_key_expression The expression for the left JOIN key
+   * @param right_key_expression The expression for the right JOIN key
+   * @param is_left_sorted Whether the left child already produces tuples in ascending left key order
+   * @param is_right_sorted Whether the right child already produces tuples in ascending right key order
+   */
+  SortMergeJoinPlanNode(const Schema *output_schema, std::vector<const AbstractPlanNode *> &&children,
+                        const AbstractExpression *left_key_expression, const AbstractExpression *right_key_expression,
+                        bool is_left_sorted = false, bool is_right_sorted = false)
+      : AbstractPlanNode(output_schema, std::move(children)),
+        left_key_expression_{left_key_expression},
+        right_key_expression_{right_key_expression},
+        is_left_sorted_{is_left_sorted},
+        is_right_sorted_{is_right_sorted} {}
+
+  /** @return The type of the plan node */
+  PlanType GetType() const override { return PlanType::SortMergeJoin; }
+
+  /** @return The expression to compute the left join key */
+  const AbstractExpression *LeftJoinKeyExpression() const { return left_key_expression_; }
+
+  /** @return The expression to compute the right join key */
+  const AbstractExpression *RightJoinKeyExpression() const { return right_key_expression_; }
+
+  /** @return `true` if the left child already produces tuples in ascending key order */
+  bool IsLeftSorted() const { return is_left_sorted_; }
+
+  /** @return `true` if the right child already produces tuples in ascending key order */
+  bool IsRightSorted() const { return is_right_sorted_; }
+
+  /** @return The left plan node of the sort-merge join */
+  const AbstractPlanNode *GetLeftPlan() const {
+    BUSTUB_ASSERT(GetChildren().size() == 2, "Sort-merge joins should have exactly two children plans.");
+    return GetChildAt(0);
+  }
+
+  /** @return The right plan node of the sort-merge join */
+  const AbstractPlanNode *GetRightPlan() const {
+    BUSTUB_ASSERT(GetChildren().size() == 2, "Sort-merge joins should have exactly two children plans.");
+    return GetChildAt(1);
+  }
+
+ private:
+  /** The expression to compute the left JOIN key */
+  const AbstractExpression *left_key_expression_;
+  /** The expression to compute the right JOIN key */
+  const AbstractExpression *right_key_expression_;
+  /** Whether the left child is already sorted on the left JOIN key */
+  bool is_left_sorted_;
+  /** Whether the right child is already sorted on the right JOIN key */
+  bool is_right_sorted_;
+};
+
+}  // namespace bustub
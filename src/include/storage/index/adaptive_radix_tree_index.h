@@ -0,0 +1,58 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// adaptive_radix_tree_index.h
+//
+// Identification: src/include/storage/index/adaptive_radix_tree_index.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "container/art/adaptive_radix_tree.h"
+#include "storage/index/index.h"
+
+namespace bustub {
+
+#define ADAPTIVE_RADIX_TREE_INDEX_TYPE AdaptiveRadixTreeIndex<KeyType, ValueType, KeyComparator>
+
+/**
+ * An index held in memory by an adaptive radix tree. Keys are unique like in the B+ tree index. The tree
+ * orders keys by their bytes, which is the order of the key columns when GenericKey stores the key normalized.
+ */
+template <typename KeyType, typename ValueType, typename KeyComparator>
+class AdaptiveRadixTreeIndex : public Index {
+ public:
+  explicit AdaptiveRadixTreeIndex(std::unique_ptr<IndexMetadata> &&metadata);
+
+  ~AdaptiveRadixTreeIndex() override = default;
+
+  void InsertEntry(const Tuple &key, RID rid, Transaction *transaction) override;
+
+  void DeleteEntry(const Tuple &key, RID rid, Transaction *transaction) override;
+
+  void ScanKey(const Tuple &key, std::vector<RID> *result, Transaction *transaction) override;
+
+  /**
+   * Collects the entries with low <= key <= high in the order of the tree.
+   * @param low the smallest key, nullptr for no lower bound
+   * @param high the largest key, nullptr for no upper bound
+   * @param max_pairs the most entries to collect
+   * @param[out] result the entries are appended to it
+   */
+  void ScanRange(const KeyType *low, const KeyType *high, size_t max_pairs,
+                 std::vector<std::pair<KeyType, ValueType>> *result);
+
+ protected:
+  // container
+  AdaptiveRadixTree<KeyType, ValueType> container_;
+};
+
+}  // namespace bustub
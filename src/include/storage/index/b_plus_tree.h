@@ -10,12 +10,16 @@
 //===----------------------------------------------------------------------===//
 #pragma once
 
+#include <atomic>
+#include <memory>
 #include <queue>
 #include <string>
 #include <vector>
 
+#include "common/rwlatch.h"
 #include "concurrency/transaction.h"
 #include "storage/index/index_iterator.h"
+#include "storage/index/swizzle_table.h"
 #include "storage/page/b_plus_tree_internal_page.h"
 #include "storage/page/b_plus_tree_leaf_page.h"
 
@@ -23,6 +27,9 @@ namespace bustub {
 
 #define BPLUSTREE_TYPE BPlusTree<KeyType, ValueType, KeyComparator>
 
+/** Share of the capacity of a page that is filled when bulk loading a B+ tree */
+static constexpr double BPLUSTREE_DEFAULT_FILL_FACTOR = 0.9;
+
 /**
  * Main class providing the API for the Interactive B+ Tree.
  *
@@ -32,6 +39,16 @@ namespace bustub {
  * (2) support insert & remove
  * (3) The structure should shrink and grow dynamically
  * (4) Implement index iterator for range scan
+ *
+ * Concurrency control is latch crabbing. Readers descend with read latches, releasing a parent as soon as
+ * the child is latched. When keys compare by their bytes, descents first do without latching internal pages
+ * at all: they read a page optimistically and validate its version (see Page::ReadOptimistic()) before
+ * following a child page id, so that lookups do not write to the latches of the upper levels. Writers first
+ * try such a descent that write-latches only the leaf; when the leaf would split or underflow they release
+ * everything and restart pessimistically, write-latching the path from the root and releasing the ancestors
+ * of every page that is safe for the operation. Since most modifications stay within one leaf, writers rarely
+ * serialize on the upper levels. root_latch_ guards root_page_id_ and acts as the latch of a virtual parent
+ * of the root.
  */
 INDEX_TEMPLATE_ARGUMENTS
 class BPlusTree {
@@ -40,7 +57,23 @@ class BPlusTree {
 
  public:
   explicit BPlusTree(std::string name, BufferPoolManager *buffer_pool_manager, const KeyComparator &comparator,
-                     int leaf_max_size = LEAF_PAGE_SIZE, int internal_max_size = INTERNAL_PAGE_SIZE);
+                     int leaf_max_size = LEAF_PAGE_SIZE, int internal_max_size = INTERNAL_PAGE_SIZE,
+                     page_id_t header_page_id = HEADER_PAGE_ID);
+
+  ~BPlusTree();
+
+  /**
+   * Lets descents follow swizzled references to internal pages: an internal page that a descent fetches is
+   * kept pinned and recorded in a SwizzleTable, and later descents take it from there without going through
+   * the buffer pool. Leaves are always fetched. A swizzled page is unswizzled when it is deleted, when the
+   * buffer pool has no frame left for the tree, by UnswizzleAll() and when the tree is destroyed, so the
+   * buffer pool has to outlive the tree. Must be called before the tree is used concurrently.
+   * @param max_pages the most pages that are kept swizzled, and pinned, at a time, at most half the pool
+   */
+  void EnableSwizzling(size_t max_pages);
+
+  /** Unswizzles every page and gives up their pins. No other operation may run on the tree meanwhile. */
+  void UnswizzleAll();
 
   // Returns true if this B+ tree has no keys and values.
   bool IsEmpty() const;
@@ -51,6 +84,9 @@ class BPlusTree {
   // Remove a key and its value from this B+ tree.
   void Remove(const KeyType &key, Transaction *transaction = nullptr);
 
+  // Build this empty B+ tree from pairs that are sorted by key and free of duplicates.
+  bool BulkLoad(const std::vector<MappingType> &items, double fill_factor = BPLUSTREE_DEFAULT_FILL_FACTOR);
+
   // return the value associated with a given key
   bool GetValue(const KeyType &key, std::vector<ValueType> *result, Transaction *transaction = nullptr);
 
@@ -76,10 +112,100 @@ class BPlusTree {
 
   // read data from file and remove one by one
   void RemoveFromFile(const std::string &file_name, Transaction *transaction = nullptr);
-  // expose for test purpose
+  // expose for test purpose, the returned leaf is pinned and read-latched
   Page *FindLeafPage(const KeyType &key, bool leftMost = false);
 
  private:
+  /** The kind of operation a descent is made for, it decides which latches are taken and when a page is safe. */
+  enum class Operation { SEARCH, INSERT, REMOVE };
+
+  /**
+   * The buffer pool as the pages of the tree see it. Internal pages fetch the children they adopt through it,
+   * so that those fetches unswizzle pages too when the buffer pool has no frame left.
+   */
+  class PagePool : public BufferPoolManager {
+   public:
+    explicit PagePool(BPlusTree *tree) : tree_(tree) {}
+
+    size_t GetPoolSize() override { return tree_->buffer_pool_manager_->GetPoolSize(); }
+
+   protected:
+    Page *FetchPgImp(page_id_t page_id) override { return tree_->FetchPageOrUnswizzle(page_id); }
+    bool UnpinPgImp(page_id_t page_id, bool is_dirty) override {
+      return tree_->buffer_pool_manager_->UnpinPage(page_id, is_dirty);
+    }
+    bool FlushPgImp(page_id_t page_id) override { return tree_->buffer_pool_manager_->FlushPage(page_id); }
+    Page *NewPgImp(page_id_t *page_id) override { return tree_->NewPageOrUnswizzle(page_id); }
+    bool DeletePgImp(page_id_t page_id) override { return tree_->buffer_pool_manager_->DeletePage(page_id); }
+    void FlushAllPgsImp() override { tree_->buffer_pool_manager_->FlushAllPages(); }
+
+   private:
+    BPlusTree *tree_;
+  };
+
+  /** Descents that fail to validate before the reader falls back to latch crabbing */
+  static constexpr int MAX_OPTIMISTIC_DESCENTS = 3;
+
+  Page *FindLeafPage(const KeyType &key, bool left_most, Operation op);
+
+  /**
+   * Descends to a leaf without latching internal pages, see FindLeafPage().
+   * @param[out] leaf the leaf page, pinned and latched, or nullptr if the tree is empty
+   * @return false if a page changed on the way, nothing is pinned or latched then
+   */
+  bool FindLeafPageOptimistic(const KeyType &key, bool left_most, Operation op, Page **leaf);
+
+  /** Latches a page on a descent: leaves are write-latched unless op is a search, internal pages read-latched. */
+  static void LatchForDescent(Page *page, Operation op);
+
+  Page *FindLeafPageExclusive(const KeyType &key, Operation op, Transaction *transaction);
+
+  bool IsSafe(BPlusTreePage *node, Operation op, bool is_root) const;
+
+  /**
+   * Fetches and latches a page for a latch crabbing descent, from the swizzle table if it is swizzled.
+   * @param[out] pinned whether the page was pinned for the caller, swizzled pages are not
+   * @return the latched page, or nullptr if the buffer pool has no frame for it
+   */
+  Page *FetchForDescent(page_id_t page_id, Operation op, bool *pinned);
+
+  /**
+   * Takes a swizzled page for a descent without pinning or latching it.
+   * @param[out] version the version of the page, to validate reads of the frame against
+   * @return the frame of the page, or nullptr if the page is not swizzled or is write-latched
+   */
+  Page *GetSwizzled(page_id_t page_id, uint64_t *version) const;
+
+  /**
+   * Checks the header of a frame that an optimistic descent has not pinned before the frame is searched.
+   * @return true if the frame holds the internal page page_id, with a size that keeps a search within the page
+   */
+  bool HoldsInternalPage(Page *page, page_id_t page_id) const;
+
+  /**
+   * Swizzles an internal page that the caller has pinned and latched, the swizzle table takes over the pin.
+   * @return false if the page stays pinned by the caller
+   */
+  bool TrySwizzle(Page *page);
+
+  /**
+   * Unswizzles the swizzled pages that no thread has latched, which makes their frames evictable.
+   * @return true if a page was unswizzled
+   */
+  bool UnswizzleUnlatched();
+
+  /** Fetches a page, unswizzling pages first if the buffer pool has no frame left. */
+  Page *FetchPageOrUnswizzle(page_id_t page_id);
+
+  /** Allocates a page, unswizzling pages first if the buffer pool has no frame left. */
+  Page *NewPageOrUnswizzle(page_id_t *page_id);
+
+  void ReleaseLatches(Transaction *transaction, bool is_dirty);
+
+  void DeletePages(Transaction *transaction);
+
+  bool FindParent(BPlusTreePage *node, Transaction *transaction, InternalPage **parent) const;
+
   void StartNewTree(const KeyType &key, const ValueType &value);
 
   bool InsertIntoLeaf(const KeyType &key, const ValueType &value, Transaction *transaction = nullptr);
@@ -98,12 +224,14 @@ class BPlusTree {
                 int index, Transaction *transaction = nullptr);
 
   template <typename N>
-  void Redistribute(N *neighbor_node, N *node, int index);
+  void Redistribute(N *neighbor_node, N *node, InternalPage *parent, int index);
 
   bool AdjustRoot(BPlusTreePage *node);
 
   void UpdateRootPageId(int insert_record = 0);
 
+  static std::vector<int> BulkLoadPageSizes(size_t count, int max_entries, int max_size, double fill_factor);
+
   /* Debug Routines for FREE!! */
   void ToGraph(BPlusTreePage *page, BufferPoolManager *bpm, std::ofstream &out) const;
 
@@ -113,9 +241,19 @@ class BPlusTree {
   std::string index_name_;
   page_id_t root_page_id_;
   BufferPoolManager *buffer_pool_manager_;
+  /** Handed to the pages of the tree in place of buffer_pool_manager_ */
+  PagePool page_pool_{this};
   KeyComparator comparator_;
   int leaf_max_size_;
   int internal_max_size_;
+  /** The header page that records the root page id of the tree */
+  page_id_t header_page_id_;
+  /** Protects root_page_id_, read-latched by every descent */
+  mutable StripedReaderWriterLatch root_latch_;
+  /** Swizzled internal pages, nullptr unless EnableSwizzling() was called */
+  std::unique_ptr<SwizzleTable> swizzle_table_;
+  size_t max_swizzled_pages_{0};
+  std::atomic<size_t> num_swizzled_pages_{0};
 };
 
 }  // namespace bustub
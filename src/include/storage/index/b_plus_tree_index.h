@@ -18,6 +18,7 @@
 
 #include "storage/index/b_plus_tree.h"
 #include "storage/index/index.h"
+#include "storage/table/table_heap.h"
 
 namespace bustub {
 
@@ -34,6 +35,20 @@ class BPlusTreeIndex : public Index {
 
   void ScanKey(const Tuple &key, std::vector<RID> *result, Transaction *transaction) override;
 
+  /**
+   * Builds the index over every tuple of a table, which is much faster than inserting the tuples one by one.
+   * The (key, RID) pairs are extracted and sorted by num_threads threads, each scanning a contiguous part of
+   * the table, and the tree is then packed bottom-up. Like InsertEntry(), only the first tuple in table order
+   * is indexed when several tuples share a key. The index must be empty.
+   * @param table_heap the table to index
+   * @param tuple_schema the schema of the tuples of the table
+   * @param fill_factor share of the capacity of every page that is filled
+   * @param num_threads number of threads that scan and sort the table, one while logging is enabled
+   * @param transaction the transaction reading the table
+   */
+  void BulkLoad(TableHeap *table_heap, const Schema &tuple_schema, double fill_factor, size_t num_threads,
+                Transaction *transaction);
+
   INDEXITERATOR_TYPE GetBeginIterator();
 
   INDEXITERATOR_TYPE GetBeginIterator(const KeyType &key);
@@ -43,6 +58,8 @@ class BPlusTreeIndex : public Index {
  protected:
   // comparator for key
   KeyComparator comparator_;
+  // header page recording the root page id of the container
+  page_id_t header_page_id_;
   // container
   BPlusTree<KeyType, ValueType, KeyComparator> container_;
 };
@@ -14,7 +14,10 @@
 
 #include <cstring>
 
+#include "common/macros.h"
 #include "storage/table/tuple.h"
+#include "type/limits.h"
+#include "type/type.h"
 #include "type/value.h"
 
 namespace bustub {
@@ -25,27 +28,76 @@ namespace bustub {
  * This key type uses an fixed length array to hold data for indexing
  * purposes, the actual size of which is specified and instantiated
  * with a template argument.
+ *
+ * When every column of the key schema is a fixed-size number and the key fits into KeySize bytes, the key is
+ * stored normalized: each column keeps its offset in the key tuple, but is encoded big-endian with the sign
+ * bit flipped (integers), as an order-preserving bit pattern (decimals) or shifted by one (timestamps). Null
+ * values sort before every other value. Two normalized keys then compare like their bytes, so the
+ * comparator does not have to deserialize any column. Other keys hold the raw key tuple.
  */
 template <size_t KeySize>
 class GenericKey {
  public:
-  inline void SetFromKey(const Tuple &tuple) {
+  /**
+   * @param key_schema the schema of the key
+   * @return whether keys of the schema are stored normalized
+   */
+  static bool IsNormalized(const Schema *key_schema) {
+    if (key_schema->GetLength() > KeySize) {
+      return false;
+    }
+    for (const auto &col : key_schema->GetColumns()) {
+      switch (col.GetType()) {
+        case TypeId::BOOLEAN:
+        case TypeId::TINYINT:
+        case TypeId::SMALLINT:
+        case TypeId::INTEGER:
+        case TypeId::BIGINT:
+        case TypeId::DECIMAL:
+        case TypeId::TIMESTAMP:
+          break;
+        default:
+          return false;
+      }
+    }
+    return true;
+  }
+
+  inline void SetFromKey(const Tuple &tuple, const Schema *key_schema) {
     // intialize to 0
     memset(data_, 0, KeySize);
     memcpy(data_, tuple.GetData(), tuple.GetLength());
+    if (IsNormalized(key_schema)) {
+      for (const auto &col : key_schema->GetColumns()) {
+        Normalize(data_ + col.GetOffset(), col.GetType());
+      }
+    }
   }
 
   // NOTE: for test purpose only
+  // the key is stored normalized, as for a key schema of a single bigint column
   inline void SetFromInteger(int64_t key) {
     memset(data_, 0, KeySize);
-    memcpy(data_, &key, sizeof(int64_t));
+    if constexpr (KeySize >= sizeof(int64_t)) {
+      StoreBigEndian(data_, static_cast<uint64_t>(key) ^ SIGN_BIT_64);
+    }
   }
 
   inline Value ToValue(Schema *schema, uint32_t column_idx) const {
+    return ToValue(schema, column_idx, IsNormalized(schema));
+  }
+
+  inline Value ToValue(Schema *schema, uint32_t column_idx, bool is_normalized) const {
     const char *data_ptr;
     const auto &col = schema->GetColumn(column_idx);
     const TypeId column_type = col.GetType();
     const bool is_inlined = col.IsInlined();
+    if (is_normalized) {
+      char column[sizeof(uint64_t)];
+      memcpy(column, data_ + col.GetOffset(), Type::GetTypeSize(column_type));
+      Denormalize(column, column_type);
+      return Value::DeserializeFrom(column, column_type);
+    }
     if (is_inlined) {
       data_ptr = (data_ + col.GetOffset());
     } else {
@@ -56,32 +108,153 @@ class GenericKey {
   }
 
   // NOTE: for test purpose only
-  // interpret the first 8 bytes as int64_t from data vector
-  inline int64_t ToString() const { return *reinterpret_cast<int64_t *>(const_cast<char *>(data_)); }
+  // interpret the first 8 bytes as a normalized int64_t from data vector
+  inline int64_t ToString() const {
+    if constexpr (KeySize >= sizeof(int64_t)) {
+      return static_cast<int64_t>(LoadBigEndian<uint64_t>(data_) ^ SIGN_BIT_64);
+    }
+    return 0;
+  }
 
   // NOTE: for test purpose only
-  // interpret the first 8 bytes as int64_t from data vector
+  // interpret the first 8 bytes as a normalized int64_t from data vector
   friend std::ostream &operator<<(std::ostream &os, const GenericKey &key) {
     os << key.ToString();
     return os;
   }
 
+  /** @return the unsigned integer stored big-endian at data */
+  template <typename U>
+  static U LoadBigEndian(const char *data) {
+    U bits = 0;
+    for (size_t i = 0; i < sizeof(U); i++) {
+      bits = static_cast<U>(bits << 8) | static_cast<uint8_t>(data[i]);
+    }
+    return bits;
+  }
+
   // actual location of data, extends past the end.
   char data_[KeySize];
+
+ private:
+  static constexpr uint64_t SIGN_BIT_64 = 1ULL << 63;
+
+  template <typename U>
+  static void StoreBigEndian(char *data, U bits) {
+    for (size_t i = 0; i < sizeof(U); i++) {
+      data[i] = static_cast<char>(bits >> (8 * (sizeof(U) - 1 - i)));
+    }
+  }
+
+  /** Flips the sign bit of a signed integer so that it orders like an unsigned one. */
+  template <typename S, typename U>
+  static void NormalizeSigned(char *data) {
+    S value;
+    memcpy(&value, data, sizeof(S));
+    StoreBigEndian(data, static_cast<U>(static_cast<U>(value) ^ (static_cast<U>(1) << (8 * sizeof(U) - 1))));
+  }
+
+  template <typename S, typename U>
+  static void DenormalizeSigned(char *data) {
+    auto value = static_cast<S>(LoadBigEndian<U>(data) ^ (static_cast<U>(1) << (8 * sizeof(U) - 1)));
+    memcpy(data, &value, sizeof(S));
+  }
+
+  /** Encodes one column of a key tuple in place. */
+  static void Normalize(char *data, TypeId type) {
+    switch (type) {
+      case TypeId::BOOLEAN:
+      case TypeId::TINYINT:
+        NormalizeSigned<int8_t, uint8_t>(data);
+        break;
+      case TypeId::SMALLINT:
+        NormalizeSigned<int16_t, uint16_t>(data);
+        break;
+      case TypeId::INTEGER:
+        NormalizeSigned<int32_t, uint32_t>(data);
+        break;
+      case TypeId::BIGINT:
+        NormalizeSigned<int64_t, uint64_t>(data);
+        break;
+      case TypeId::DECIMAL: {
+        double value;
+        memcpy(&value, data, sizeof(double));
+        if (value == 0) {
+          // -0.0 and 0.0 are equal
+          value = 0;
+        }
+        uint64_t bits;
+        memcpy(&bits, &value, sizeof(double));
+        // Negative numbers order inversely to their magnitude, so all of their bits are flipped.
+        bits = (bits & SIGN_BIT_64) != 0 ? ~bits : bits ^ SIGN_BIT_64;
+        StoreBigEndian(data, bits);
+        break;
+      }
+      case TypeId::TIMESTAMP: {
+        uint64_t value;
+        memcpy(&value, data, sizeof(uint64_t));
+        // The null timestamp is the largest one, it moves to the front.
+        StoreBigEndian(data, value == BUSTUB_TIMESTAMP_NULL ? 0 : value + 1);
+        break;
+      }
+      default:
+        UNREACHABLE("Unsupported type.");
+    }
+  }
+
+  /** Decodes one normalized column in place. */
+  static void Denormalize(char *data, TypeId type) {
+    switch (type) {
+      case TypeId::BOOLEAN:
+      case TypeId::TINYINT:
+        DenormalizeSigned<int8_t, uint8_t>(data);
+        break;
+      case TypeId::SMALLINT:
+        DenormalizeSigned<int16_t, uint16_t>(data);
+        break;
+      case TypeId::INTEGER:
+        DenormalizeSigned<int32_t, uint32_t>(data);
+        break;
+      case TypeId::BIGINT:
+        DenormalizeSigned<int64_t, uint64_t>(data);
+        break;
+      case TypeId::DECIMAL: {
+        auto bits = LoadBigEndian<uint64_t>(data);
+        bits = (bits & SIGN_BIT_64) != 0 ? bits ^ SIGN_BIT_64 : ~bits;
+        memcpy(data, &bits, sizeof(uint64_t));
+        break;
+      }
+      case TypeId::TIMESTAMP: {
+        auto value = LoadBigEndian<uint64_t>(data);
+        value = value == 0 ? BUSTUB_TIMESTAMP_NULL : value - 1;
+        memcpy(data, &value, sizeof(uint64_t));
+        break;
+      }
+      default:
+        UNREACHABLE("Unsupported type.");
+    }
+  }
 };
 
 /**
  * Function object returns true if lhs < rhs, used for trees
+ *
+ * Normalized keys are compared by their bytes, starting with a single 64-bit compare of the first 8 bytes.
+ * Other keys are compared column by column.
  */
 template <size_t KeySize>
 class GenericComparator {
  public:
   inline int operator()(const GenericKey<KeySize> &lhs, const GenericKey<KeySize> &rhs) const {
+    if (is_normalized_) {
+      return CompareNormalized(lhs, rhs);
+    }
+
     uint32_t column_count = key_schema_->GetColumnCount();
 
     for (uint32_t i = 0; i < column_count; i++) {
-      Value lhs_value = (lhs.ToValue(key_schema_, i));
-      Value rhs_value = (rhs.ToValue(key_schema_, i));
+      Value lhs_value = (lhs.ToValue(key_schema_, i, false));
+      Value rhs_value = (rhs.ToValue(key_schema_, i, false));
 
       if (lhs_value.CompareLessThan(rhs_value) == CmpBool::CmpTrue) {
         return -1;
@@ -94,18 +267,49 @@ class GenericComparator {
     return 0;
   }
 
-  GenericComparator(const GenericComparator &other) : key_schema_{other.key_schema_} {}
+  GenericComparator(const GenericComparator &other)
+      : key_schema_{other.key_schema_}, is_normalized_{other.is_normalized_}, key_length_{other.key_length_} {}
 
   GenericComparator &operator=(const GenericComparator &other) {
     key_schema_ = other.key_schema_;
+    is_normalized_ = other.is_normalized_;
+    key_length_ = other.key_length_;
     return *this;
   }
 
   // constructor
-  explicit GenericComparator(Schema *key_schema) : key_schema_(key_schema) {}
+  explicit GenericComparator(Schema *key_schema)
+      : key_schema_(key_schema),
+        is_normalized_(GenericKey<KeySize>::IsNormalized(key_schema)),
+        key_length_(key_schema->GetLength()) {}
+
+  /** @return whether keys are compared by their bytes, which never reads past a key even if it is garbage */
+  inline bool IsNormalized() const { return is_normalized_; }
 
  private:
+  inline int CompareNormalized(const GenericKey<KeySize> &lhs, const GenericKey<KeySize> &rhs) const {
+    size_t prefix = 0;
+    if constexpr (KeySize >= sizeof(uint64_t)) {
+      // The bytes past the key are zero, so the prefix may cover them.
+      auto lhs_prefix = GenericKey<KeySize>::template LoadBigEndian<uint64_t>(lhs.data_);
+      auto rhs_prefix = GenericKey<KeySize>::template LoadBigEndian<uint64_t>(rhs.data_);
+      if (lhs_prefix != rhs_prefix) {
+        return lhs_prefix < rhs_prefix ? -1 : 1;
+      }
+      prefix = sizeof(uint64_t);
+    }
+    if (key_length_ <= prefix) {
+      return 0;
+    }
+    int cmp = memcmp(lhs.data_ + prefix, rhs.data_ + prefix, key_length_ - prefix);
+    return (cmp > 0) - (cmp < 0);
+  }
+
   Schema *key_schema_;
+  // whether keys of key_schema_ are stored normalized
+  bool is_normalized_;
+  // the number of bytes of a normalized key
+  uint32_t key_length_;
 };
 
 }  // namespace bustub
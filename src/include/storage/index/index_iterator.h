@@ -13,18 +13,44 @@
  * For range scan of b+ tree
  */
 #pragma once
+#include <future>  // NOLINT
+
 #include "storage/page/b_plus_tree_leaf_page.h"
 
 namespace bustub {
 
 #define INDEXITERATOR_TYPE IndexIterator<KeyType, ValueType, KeyComparator>
 
+/**
+ * IndexIterator walks the leaf chain of a B+ tree in key order.
+ *
+ * The iterator keeps the leaf it is positioned on pinned and read-latched, so the pairs it hands out stay
+ * valid until it moves on, and the thread owning it must not modify the tree in the meantime. Leaves are
+ * latched left to right, the next one before the current one is released. Whenever the iterator enters a
+ * leaf it asks the buffer pool to prefetch the next leaf in the background, so a scan over cold pages
+ * overlaps reading a leaf with processing the previous one.
+ */
 INDEX_TEMPLATE_ARGUMENTS
 class IndexIterator {
+  using LeafPage = BPlusTreeLeafPage<KeyType, ValueType, KeyComparator>;
+
  public:
-  // you may define your own constructor based on your member variables
-  IndexIterator();
-  ~IndexIterator() = default;
+  /** Creates an iterator at the end. */
+  IndexIterator() = default;
+
+  /**
+   * Creates an iterator positioned on a pair of a leaf.
+   * @param buffer_pool_manager the buffer pool of the tree
+   * @param page the leaf page, pinned and read-latched, the iterator takes over both
+   * @param index the index of the pair in the leaf, if it is past the last pair the iterator moves on
+   */
+  IndexIterator(BufferPoolManager *buffer_pool_manager, Page *page, int index);
+
+  ~IndexIterator();
+
+  DISALLOW_COPY(IndexIterator);
+  IndexIterator(IndexIterator &&other) noexcept;
+  IndexIterator &operator=(IndexIterator &&other) noexcept;
 
   bool IsEnd();
 
@@ -32,12 +58,30 @@ class IndexIterator {
 
   IndexIterator &operator++();
 
-  bool operator==(const IndexIterator &itr) const { throw std::runtime_error("unimplemented"); }
+  bool operator==(const IndexIterator &itr) const {
+    return page_ == nullptr || itr.page_ == nullptr ? page_ == itr.page_ : page_ == itr.page_ && index_ == itr.index_;
+  }
 
-  bool operator!=(const IndexIterator &itr) const { throw std::runtime_error("unimplemented"); }
+  bool operator!=(const IndexIterator &itr) const { return !(*this == itr); }
 
  private:
-  // add your own private member variables here
+  /** Moves to the first pair of the next non-empty leaf, or to the end. */
+  void NextLeaf();
+
+  /** Starts prefetching the successor of the current leaf. */
+  void Prefetch();
+
+  /** Releases the current leaf and waits for an outstanding prefetch. */
+  void Release();
+
+  BufferPoolManager *buffer_pool_manager_{nullptr};
+  /** The current leaf page, nullptr at the end */
+  Page *page_{nullptr};
+  LeafPage *leaf_{nullptr};
+  /** Index of the current pair in leaf_ */
+  int index_{0};
+  /** Completion of the prefetch of the next leaf */
+  std::future<void> prefetch_;
 };
 
 }  // namespace bustub
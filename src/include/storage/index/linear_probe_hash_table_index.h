@@ -0,0 +1,48 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// linear_probe_hash_table_index.h
+//
+// Identification: src/include/storage/index/linear_probe_hash_table_index.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "container/hash/hash_function.h"
+#include "container/hash/linear_probe_hash_table.h"
+#include "storage/index/index.h"
+
+namespace bustub {
+
+#define LINEAR_PROBE_HASH_TABLE_INDEX_TYPE LinearProbeHashTableIndex<KeyType, ValueType, KeyComparator>
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+class LinearProbeHashTableIndex : public Index {
+ public:
+  LinearProbeHashTableIndex(std::unique_ptr<IndexMetadata> &&metadata, BufferPoolManager *buffer_pool_manager,
+                            const HashFunction<KeyType> &hash_fn);
+
+  ~LinearProbeHashTableIndex() override = default;
+
+  void InsertEntry(const Tuple &key, RID rid, Transaction *transaction) override;
+
+  void DeleteEntry(const Tuple &key, RID rid, Transaction *transaction) override;
+
+  void ScanKey(const Tuple &key, std::vector<RID> *result, Transaction *transaction) override;
+
+ protected:
+  // comparator for key
+  KeyComparator comparator_;
+  // container
+  LinearProbeHashTable<KeyType, ValueType, KeyComparator> container_;
+};
+
+}  // namespace bustub
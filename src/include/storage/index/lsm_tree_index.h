@@ -0,0 +1,48 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// lsm_tree_index.h
+//
+// Identification: src/include/storage/index/lsm_tree_index.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "container/hash/hash_function.h"
+#include "container/lsm/lsm_tree.h"
+#include "storage/index/index.h"
+
+namespace bustub {
+
+#define LSM_TREE_INDEX_TYPE LSMTreeIndex<KeyType, ValueType, KeyComparator>
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+class LSMTreeIndex : public Index {
+ public:
+  LSMTreeIndex(std::unique_ptr<IndexMetadata> &&metadata, BufferPoolManager *buffer_pool_manager,
+               const HashFunction<KeyType> &hash_fn);
+
+  ~LSMTreeIndex() override = default;
+
+  void InsertEntry(const Tuple &key, RID rid, Transaction *transaction) override;
+
+  void DeleteEntry(const Tuple &key, RID rid, Transaction *transaction) override;
+
+  void ScanKey(const Tuple &key, std::vector<RID> *result, Transaction *transaction) override;
+
+ protected:
+  // comparator for key
+  KeyComparator comparator_;
+  // container
+  LSMTree<KeyType, ValueType, KeyComparator> container_;
+};
+
+}  // namespace bustub
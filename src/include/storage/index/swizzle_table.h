@@ -0,0 +1,139 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// swizzle_table.h
+//
+// Identification: src/include/storage/index/swizzle_table.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <memory>
+
+#include "common/config.h"
+#include "storage/page/page.h"
+
+namespace bustub {
+
+/**
+ * Swizzled references of an index: a direct mapping from page ids to the frames of resident pages, so that
+ * following a child reference costs two array loads instead of a buffer pool fetch. Page ids are dense,
+ * so the table is an array indexed by page id, split into chunks that are allocated on first use. Readers
+ * never write to shared memory.
+ *
+ * The table only stores the mapping. Its owner keeps every swizzled page pinned, which keeps the frame
+ * from being evicted, and removes a page from the table before the pin is given up.
+ */
+class SwizzleTable {
+ public:
+  /** Page ids up to MAX_CHUNKS * CHUNK_SIZE can be swizzled, larger ones are always fetched */
+  static constexpr size_t CHUNK_SIZE = 1024;
+  static constexpr size_t MAX_CHUNKS = 4096;
+
+  SwizzleTable() : chunks_(new std::atomic<std::atomic<Page *> *>[MAX_CHUNKS]) {
+    for (size_t i = 0; i < MAX_CHUNKS; i++) {
+      chunks_[i].store(nullptr, std::memory_order_relaxed);
+    }
+  }
+
+  ~SwizzleTable() {
+    for (size_t i = 0; i < MAX_CHUNKS; i++) {
+      delete[] chunks_[i].load(std::memory_order_relaxed);
+    }
+  }
+
+  SwizzleTable(const SwizzleTable &) = delete;
+  SwizzleTable &operator=(const SwizzleTable &) = delete;
+
+  /** @return the frame of a swizzled page, or nullptr */
+  Page *Get(page_id_t page_id) const {
+    auto *chunk = GetChunk(page_id, false);
+    return chunk == nullptr ? nullptr : chunk[page_id % CHUNK_SIZE].load(std::memory_order_acquire);
+  }
+
+  /**
+   * Swizzles a page, unless it is swizzled already.
+   * @return true if the page was added to the table
+   */
+  bool Install(page_id_t page_id, Page *page) {
+    auto *chunk = GetChunk(page_id, true);
+    if (chunk == nullptr) {
+      return false;
+    }
+    Page *expected = nullptr;
+    return chunk[page_id % CHUNK_SIZE].compare_exchange_strong(expected, page, std::memory_order_release);
+  }
+
+  /** @return the frame the page was swizzled to, or nullptr if it was not swizzled */
+  Page *Remove(page_id_t page_id) {
+    auto *chunk = GetChunk(page_id, false);
+    return chunk == nullptr ? nullptr : chunk[page_id % CHUNK_SIZE].exchange(nullptr, std::memory_order_acq_rel);
+  }
+
+  /**
+   * Unswizzles a page only if it is swizzled to the given frame.
+   * @return true if the page was removed from the table
+   */
+  bool Remove(page_id_t page_id, Page *page) {
+    auto *chunk = GetChunk(page_id, false);
+    return chunk != nullptr && chunk[page_id % CHUNK_SIZE].compare_exchange_strong(page, nullptr);
+  }
+
+  /** Calls a function with every swizzled page. Pages may be swizzled and unswizzled meanwhile. */
+  void ForEach(const std::function<void(page_id_t, Page *)> &callback) const {
+    for (size_t i = 0; i < MAX_CHUNKS; i++) {
+      auto *chunk = chunks_[i].load(std::memory_order_acquire);
+      for (size_t j = 0; chunk != nullptr && j < CHUNK_SIZE; j++) {
+        Page *page = chunk[j].load(std::memory_order_acquire);
+        if (page != nullptr) {
+          callback(static_cast<page_id_t>(i * CHUNK_SIZE + j), page);
+        }
+      }
+    }
+  }
+
+  /** Removes every page from the table, and calls a function with each of them. */
+  void RemoveAll(const std::function<void(Page *)> &callback) {
+    for (size_t i = 0; i < MAX_CHUNKS; i++) {
+      auto *chunk = chunks_[i].load(std::memory_order_acquire);
+      for (size_t j = 0; chunk != nullptr && j < CHUNK_SIZE; j++) {
+        Page *page = chunk[j].exchange(nullptr, std::memory_order_acq_rel);
+        if (page != nullptr) {
+          callback(page);
+        }
+      }
+    }
+  }
+
+ private:
+  std::atomic<Page *> *GetChunk(page_id_t page_id, bool create) const {
+    if (page_id < 0 || static_cast<size_t>(page_id) >= MAX_CHUNKS * CHUNK_SIZE) {
+      return nullptr;
+    }
+    auto &slot = chunks_[page_id / CHUNK_SIZE];
+    auto *chunk = slot.load(std::memory_order_acquire);
+    if (chunk != nullptr || !create) {
+      return chunk;
+    }
+    auto *fresh = new std::atomic<Page *>[CHUNK_SIZE];
+    for (size_t i = 0; i < CHUNK_SIZE; i++) {
+      fresh[i].store(nullptr, std::memory_order_relaxed);
+    }
+    if (slot.compare_exchange_strong(chunk, fresh, std::memory_order_acq_rel)) {
+      return fresh;
+    }
+    // another thread was first, chunk holds its array now
+    delete[] fresh;
+    return chunk;
+  }
+
+  std::unique_ptr<std::atomic<std::atomic<Page *> *>[]> chunks_;
+};
+
+}  // namespace bustub
@@ -0,0 +1,145 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// varlen_b_plus_tree.h
+//
+// Identification: src/include/storage/index/varlen_b_plus_tree.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "common/rid.h"
+#include "common/rwlatch.h"
+#include "storage/page/varlen_b_plus_tree_page.h"
+
+namespace bustub {
+
+/**
+ * A B+ tree over variable-length byte string keys, which compare like memcmp. Only unique keys are supported.
+ *
+ * Unlike BPlusTree, whose keys take up a fixed-size GenericKey slot, a key takes up its own length in a
+ * slotted page, and less: every page stores the prefix that its keys share only once (prefix compression,
+ * see VarlenBPlusTreePage). When a leaf splits, the separator pushed into the parent is the shortest key
+ * that tells the two halves apart, and the split point is moved within the middle of the page to where that
+ * separator is shortest (suffix truncation). Internal pages therefore hold short keys, which raises the
+ * fanout and keeps the tree flat for long string keys.
+ *
+ * Two pages are merged when a page falls under a quarter of its space and the pair fits into one page.
+ *
+ * Concurrency: tree_latch_ is taken in read mode by lookups and in write mode by inserts and removes.
+ */
+class VarlenBPlusTree {
+  using LeafPage = VarlenBPlusTreePage<RID>;
+  using InternalPage = VarlenBPlusTreePage<page_id_t>;
+
+ public:
+  /** Keys must not be longer, so that every page has room for its fences and a few keys */
+  static constexpr size_t MAX_KEY_SIZE = PAGE_SIZE / 8;
+
+  explicit VarlenBPlusTree(std::string name, BufferPoolManager *buffer_pool_manager,
+                           page_id_t header_page_id = HEADER_PAGE_ID);
+
+  // Returns true if this B+ tree has no keys and values.
+  bool IsEmpty();
+
+  /**
+   * Inserts a key-value pair into the tree.
+   * @return false if the key exists already
+   * @throws Exception if the key is longer than MAX_KEY_SIZE
+   */
+  bool Insert(const std::string &key, const RID &value);
+
+  // Remove a key and its value from this B+ tree.
+  void Remove(const std::string &key);
+
+  // return the value associated with a given key
+  bool GetValue(const std::string &key, std::vector<RID> *result);
+
+  /** @return the number of levels of the tree, 0 if it is empty */
+  int GetHeight();
+
+ private:
+  /** The internal pages from the root down to a leaf, and which child was taken in each. */
+  struct Path {
+    std::vector<Page *> pages_;
+    std::vector<int> child_indexes_;
+    // pages that were merged away, they are deleted once the path is released
+    std::vector<page_id_t> deleted_page_ids_;
+  };
+
+  /** Descends to the leaf of a key. The leaf and the pages of the path stay pinned until ReleasePath(). */
+  Page *FindLeafPage(const std::string &key, Path *path);
+
+  /** Unpins the pages of the path and deletes the pages that were merged away. */
+  void ReleasePath(Path *path, bool is_dirty);
+
+  /** @return the position of the child that covers a key */
+  static int ChildIndex(const InternalPage *page, const std::string &key);
+
+  static page_id_t ChildAt(const InternalPage *page, int index);
+
+  static void SetChildAt(InternalPage *page, int index, page_id_t child);
+
+  /**
+   * Splits a leaf that has no room for a key, and inserts the key into one of the halves.
+   * @param index the index of the key in the leaf
+   */
+  void SplitLeaf(Path *path, LeafPage *leaf, int index, const std::string &key, const RID &value);
+
+  /**
+   * Inserts the separator of a page that was split into its parent, splitting the parent if needed.
+   * @param level the level of the parent in the path, -1 if the split page is the root
+   */
+  void InsertIntoParent(Path *path, int level, const std::string &separator, page_id_t left, page_id_t right);
+
+  /**
+   * Merges a page that became underfull with a sibling if both fit into one page.
+   * @param level the level of the parent in the path, -1 if the page is the root
+   */
+  template <typename N>
+  void CoalesceIfUnderfull(Path *path, int level, N *node);
+
+  /**
+   * Fills a page with keys and values in order.
+   * @param items the pairs, the keys have to lie within the fences
+   */
+  template <typename V>
+  static void BuildPage(VarlenBPlusTreePage<V> *page, page_id_t page_id, IndexPageType page_type,
+                        const std::string &lower_fence, const std::string *upper_fence,
+                        const std::vector<std::pair<std::string, V>> &items);
+
+  /** @return the pairs of a page, with full keys */
+  template <typename V>
+  static std::vector<std::pair<std::string, V>> GetItems(const VarlenBPlusTreePage<V> *page);
+
+  /** @return the bytes a page with the given fences and keys takes up */
+  template <typename V>
+  static size_t GetPageSpace(const std::string &lower_fence, const std::string *upper_fence,
+                             const std::vector<std::pair<std::string, V>> &items);
+
+  /** @return the shortest key s with lhs < s <= rhs, for lhs < rhs */
+  static std::string ShortestSeparator(const std::string &lhs, const std::string &rhs);
+
+  Page *NewPage(page_id_t *page_id);
+
+  void UpdateRootPageId(int insert_record = 0);
+
+  // member variable
+  std::string index_name_;
+  page_id_t root_page_id_;
+  BufferPoolManager *buffer_pool_manager_;
+  /** The header page that records the root page id of the tree */
+  page_id_t header_page_id_;
+  ReaderWriterLatch tree_latch_;
+};
+
+}  // namespace bustub
@@ -0,0 +1,53 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// varlen_b_plus_tree_index.h
+//
+// Identification: src/include/storage/index/varlen_b_plus_tree_index.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "storage/index/index.h"
+#include "storage/index/varlen_b_plus_tree.h"
+
+namespace bustub {
+
+/**
+ * An index on a VarlenBPlusTree. Unlike the other indexes it takes no key size: every key tuple is encoded
+ * into a byte string of its own length that compares like the tuple (see EncodeKey()), so string keys are
+ * neither cut off nor padded.
+ */
+class VarlenBPlusTreeIndex : public Index {
+ public:
+  VarlenBPlusTreeIndex(std::unique_ptr<IndexMetadata> &&metadata, BufferPoolManager *buffer_pool_manager);
+
+  ~VarlenBPlusTreeIndex() override = default;
+
+  void InsertEntry(const Tuple &key, RID rid, Transaction *transaction) override;
+
+  void DeleteEntry(const Tuple &key, RID rid, Transaction *transaction) override;
+
+  void ScanKey(const Tuple &key, std::vector<RID> *result, Transaction *transaction) override;
+
+ protected:
+  /**
+   * Encodes a key tuple so that memcmp orders the encodings like the tuples. Every column starts with a byte
+   * that is 0 for null and 1 otherwise. Numbers follow big-endian with the sign bit flipped, strings follow
+   * with 0x00 escaped as 0x00 0xFF and end with 0x00 0x00, except in the last column, which needs no end.
+   */
+  std::string EncodeKey(const Tuple &key) const;
+
+  // container
+  VarlenBPlusTree container_;
+};
+
+}  // namespace bustub
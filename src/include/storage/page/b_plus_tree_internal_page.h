@@ -10,6 +10,7 @@
 //===----------------------------------------------------------------------===//
 #pragma once
 
+#include <algorithm>
 #include <queue>
 
 #include "storage/page/b_plus_tree_page.h"
@@ -37,6 +38,8 @@ class BPlusTreeInternalPage : public BPlusTreePage {
  public:
   // must call initialize method after "create" a new node
   void Init(page_id_t page_id, page_id_t parent_id = INVALID_PAGE_ID, int max_size = INTERNAL_PAGE_SIZE) {
+    page_type_ = IndexPageType::INTERNAL_PAGE;
+    size_ = 0;
     page_id_ = page_id;
     parent_page_id_ = parent_id;
     max_size_ = max_size;
@@ -59,15 +62,26 @@ class BPlusTreeInternalPage : public BPlusTreePage {
 
   ValueType ValueAt(int index) const { return array_[index].second; }
 
+  /**
+   * Finds the child whose subtree covers a key, i.e. the child i with KeyAt(i) <= key < KeyAt(i + 1).
+   * @return the page id of that child
+   */
   ValueType Lookup(const KeyType &key, const KeyComparator &comparator) const {
-    page_id_t page_id{INVALID_PAGE_ID};
-    for (int i = 0; i < size_; i++) {
-      if (comparator(key, array_[i].first) == 0) {
-        page_id = array_[i].second;
-        break;
+    // Binary search for the last index in [1, size) whose key is <= key, falling back to the first child.
+    // Optimistic readers may search a page that is being overwritten, so the size is read once and kept
+    // within the array.
+    int size = GetSize();
+    int lo = 1;
+    int hi = std::max(1, std::min(size, static_cast<int>(INTERNAL_PAGE_SIZE)));
+    while (lo < hi) {
+      int mid = lo + (hi - lo) / 2;
+      if (comparator(array_[mid].first, key) <= 0) {
+        lo = mid + 1;
+      } else {
+        hi = mid;
       }
     }
-    return page_id;
+    return array_[lo - 1].second;
   }
 
   void PopulateNewRoot(const ValueType &old_value, const KeyType &new_key, const ValueType &new_value) {
@@ -78,17 +92,8 @@ class BPlusTreeInternalPage : public BPlusTreePage {
   }
 
   int InsertNodeAfter(const ValueType &old_value, const KeyType &new_key, const ValueType &new_value) {
-    int index = 0;
-    while (index < size_) {
-      if (old_value == array_[index].second) {
-        break;
-      }
-      index++;
-    }
-    index++;
-    for (int i = size_ - 1; i >= index; i--) {
-      array_[i + 1] = array_[i];
-    }
+    int index = ValueIndex(old_value) + 1;
+    std::move_backward(array_ + index, array_ + size_, array_ + size_ + 1);
     array_[index].first = new_key;
     array_[index].second = new_value;
     size_++;
@@ -96,26 +101,90 @@ class BPlusTreeInternalPage : public BPlusTreePage {
   }
 
   void Remove(int index) {
-    for (int i = index; i < size_; i++) {
-      array_[i] = array_[i + 1];
-    }
+    std::move(array_ + index + 1, array_ + size_, array_ + index);
     size_--;
   }
 
+  /** Removes the only child of a root that has shrunk to a single pointer and returns it. */
   ValueType RemoveAndReturnOnlyChild() {
-    size_ = 1;
-    return array_[1].second;
+    size_ = 0;
+    return array_[0].second;
   }
 
   // Split and Merge utility methods
-  void MoveAllTo(BPlusTreeInternalPage *recipient, const KeyType &middle_key, BufferPoolManager *buffer_pool_manager) {}
-  void MoveHalfTo(BPlusTreeInternalPage *recipient, BufferPoolManager *buffer_pool_manager) {}
+  // Children that move between pages are adopted by the recipient, i.e. their parent page id is updated
+  // through the buffer pool manager.
+
+  /**
+   * Moves every pair to the end of recipient, which is this page's left sibling.
+   * @param middle_key the separator of the two pages in their parent, it becomes the key of the first child
+   */
+  void MoveAllTo(BPlusTreeInternalPage *recipient, const KeyType &middle_key, BufferPoolManager *buffer_pool_manager) {
+    array_[0].first = middle_key;
+    recipient->CopyNFrom(array_, size_, buffer_pool_manager);
+    size_ = 0;
+  }
+
+  /**
+   * Moves the upper half of the pairs to recipient, used when splitting this page. The first key of recipient
+   * is the separator that has to be pushed up into the parent.
+   */
+  void MoveHalfTo(BPlusTreeInternalPage *recipient, BufferPoolManager *buffer_pool_manager) {
+    int keep = size_ - size_ / 2;
+    recipient->CopyNFrom(array_ + keep, size_ - keep, buffer_pool_manager);
+    size_ = keep;
+  }
+
+  /**
+   * Moves the first child to the end of recipient, which is this page's left sibling. Afterwards KeyAt(0)
+   * holds the new separator of the two pages.
+   * @param middle_key the separator of the two pages in their parent
+   */
   void MoveFirstToEndOf(BPlusTreeInternalPage *recipient, const KeyType &middle_key,
-                        BufferPoolManager *buffer_pool_manager) {}
+                        BufferPoolManager *buffer_pool_manager) {
+    array_[0].first = middle_key;
+    recipient->CopyNFrom(array_, 1, buffer_pool_manager);
+    std::move(array_ + 1, array_ + size_, array_);
+    size_--;
+  }
+
+  /**
+   * Moves the last child to the front of recipient, which is this page's right sibling. Afterwards
+   * recipient->KeyAt(0) holds the new separator of the two pages.
+   * @param middle_key the separator of the two pages in their parent
+   */
   void MoveLastToFrontOf(BPlusTreeInternalPage *recipient, const KeyType &middle_key,
-                         BufferPoolManager *buffer_pool_manager) {}
+                         BufferPoolManager *buffer_pool_manager) {
+    size_--;
+    recipient->CopyFirstFrom(array_[size_], middle_key, buffer_pool_manager);
+  }
+
+  /** Appends children whose keys follow the keys of this page and adopts them, also used when bulk loading. */
+  void CopyNFrom(const MappingType *items, int size, BufferPoolManager *buffer_pool_manager) {
+    std::copy(items, items + size, array_ + size_);
+    for (int i = 0; i < size; i++) {
+      Adopt(items[i].second, buffer_pool_manager);
+    }
+    size_ += size;
+  }
 
  private:
+  void CopyFirstFrom(const MappingType &item, const KeyType &middle_key, BufferPoolManager *buffer_pool_manager) {
+    std::move_backward(array_, array_ + size_, array_ + size_ + 1);
+    array_[1].first = middle_key;
+    array_[0] = item;
+    Adopt(item.second, buffer_pool_manager);
+    size_++;
+  }
+
+  /** Makes this page the parent of a child page. */
+  void Adopt(page_id_t child_page_id, BufferPoolManager *buffer_pool_manager) {
+    Page *page = buffer_pool_manager->FetchPage(child_page_id);
+    BUSTUB_ASSERT(page != nullptr, "child page must be fetchable");
+    reinterpret_cast<BPlusTreePage *>(page->GetData())->SetParentPageId(page_id_);
+    buffer_pool_manager->UnpinPage(child_page_id, true);
+  }
+
   MappingType array_[INTERNAL_PAGE_SIZE];
 };
 }  // namespace bustub
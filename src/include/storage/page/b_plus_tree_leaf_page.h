@@ -10,6 +10,7 @@
 //===----------------------------------------------------------------------===//
 #pragma once
 
+#include <algorithm>
 #include <utility>
 #include <vector>
 
@@ -45,9 +46,12 @@ class BPlusTreeLeafPage : public BPlusTreePage {
   // After creating a new leaf page from buffer pool, must call initialize
   // method to set default values
   void Init(page_id_t page_id, page_id_t parent_id = INVALID_PAGE_ID, int max_size = LEAF_PAGE_SIZE) {
+    page_type_ = IndexPageType::LEAF_PAGE;
+    size_ = 0;
     page_id_ = page_id;
     parent_page_id_ = parent_id;
     max_size_ = max_size;
+    next_page_id_ = INVALID_PAGE_ID;
   }
 
   // helper methods
@@ -57,63 +61,110 @@ class BPlusTreeLeafPage : public BPlusTreePage {
 
   KeyType KeyAt(int index) const { return array_[index].first; }
 
+  /**
+   * @return the first index i such that KeyAt(i) >= key, or GetSize() if every key is smaller
+   */
   int KeyIndex(const KeyType &key, const KeyComparator &comparator) const {
-    for (int i = 0; i < size_; i++) {
-      if (comparator(key, array_[i].first) == 0) {
-        return i;
+    int lo = 0;
+    int hi = size_;
+    while (lo < hi) {
+      int mid = lo + (hi - lo) / 2;
+      if (comparator(array_[mid].first, key) < 0) {
+        lo = mid + 1;
+      } else {
+        hi = mid;
       }
     }
-    return -1;
+    return lo;
   }
 
   const MappingType &GetItem(int index) { return array_[index]; }
 
   // insert and delete methods
+
+  /**
+   * Inserts a key & value pair in key order. Duplicate keys are rejected.
+   * @return the page size after the insertion
+   */
   int Insert(const KeyType &key, const ValueType &value, const KeyComparator &comparator) {
-    for (int i = 0; i < size_; i++) {
-      if (comparator(key, array_[i].first) == 0) {
-        return size_;
-      }
+    int index = KeyIndex(key, comparator);
+    if (index < size_ && comparator(array_[index].first, key) == 0) {
+      return size_;
     }
-    array_[size_].first = key;
-    array_[size_].second = value;
+    std::move_backward(array_ + index, array_ + size_, array_ + size_ + 1);
+    array_[index].first = key;
+    array_[index].second = value;
     size_++;
     return size_;
   }
 
   bool Lookup(const KeyType &key, ValueType *value, const KeyComparator &comparator) const {
-    for (int i = 0; i < size_; i++) {
-      if (comparator(key, array_[i].first) == 0) {
-        *value = array_[i].second;
-        return true;
-      }
+    int index = KeyIndex(key, comparator);
+    if (index < size_ && comparator(array_[index].first, key) == 0) {
+      *value = array_[index].second;
+      return true;
     }
     return false;
   }
 
+  /**
+   * Removes the pair of a key, if it exists.
+   * @return the page size after the deletion
+   */
   int RemoveAndDeleteRecord(const KeyType &key, const KeyComparator &comparator) {
-    for (int i = 0; i < size_; i++) {
-      if (comparator(key, array_[i].first) == 0) {
-        for (int j = i; j < size_; j++) {
-          array_[j] = array_[j + 1];
-          size_--;
-          break;
-        }
-      }
+    int index = KeyIndex(key, comparator);
+    if (index < size_ && comparator(array_[index].first, key) == 0) {
+      std::move(array_ + index + 1, array_ + size_, array_ + index);
+      size_--;
     }
     return size_;
   }
 
   // Split and Merge utility methods
-  void MoveHalfTo(BPlusTreeLeafPage *recipient) {}
 
-  void MoveAllTo(BPlusTreeLeafPage *recipient) {}
+  /** Moves the upper half of the pairs to the end of recipient, used when splitting this page. */
+  void MoveHalfTo(BPlusTreeLeafPage *recipient) {
+    int keep = size_ - size_ / 2;
+    recipient->CopyNFrom(array_ + keep, size_ - keep);
+    size_ = keep;
+  }
+
+  /**
+   * Moves every pair to the end of recipient, which then links to this page's successor. The next page id
+   * of this page is kept so that scans positioned on it can still move on.
+   */
+  void MoveAllTo(BPlusTreeLeafPage *recipient) {
+    recipient->CopyNFrom(array_, size_);
+    recipient->SetNextPageId(next_page_id_);
+    size_ = 0;
+  }
+
+  /** Moves the first pair to the end of recipient, recipient is this page's left sibling. */
+  void MoveFirstToEndOf(BPlusTreeLeafPage *recipient) {
+    recipient->CopyNFrom(array_, 1);
+    std::move(array_ + 1, array_ + size_, array_);
+    size_--;
+  }
 
-  void MoveFirstToEndOf(BPlusTreeLeafPage *recipient) {}
+  /** Moves the last pair to the front of recipient, recipient is this page's right sibling. */
+  void MoveLastToFrontOf(BPlusTreeLeafPage *recipient) {
+    size_--;
+    recipient->CopyFirstFrom(array_[size_]);
+  }
 
-  void MoveLastToFrontOf(BPlusTreeLeafPage *recipient) {}
+  /** Appends pairs whose keys follow the keys of this page, also used when bulk loading. */
+  void CopyNFrom(const MappingType *items, int size) {
+    std::copy(items, items + size, array_ + size_);
+    size_ += size;
+  }
 
  private:
+  void CopyFirstFrom(const MappingType &item) {
+    std::move_backward(array_, array_ + size_, array_ + size_ + 1);
+    array_[0] = item;
+    size_++;
+  }
+
   page_id_t next_page_id_{INVALID_PAGE_ID};
   MappingType array_[LEAF_PAGE_SIZE];
 };
@@ -0,0 +1,92 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// hash_table_block_header_page.h
+//
+// Identification: src/include/storage/page/hash_table_block_header_page.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+
+#include "common/config.h"
+#include "storage/page/hash_table_page_defs.h"
+
+namespace bustub {
+
+/**
+ *
+ * Header Page for linear probe hash table.
+ *
+ * The header lists the page ids of the table's blocks in block order. The table grows one block at a time, the
+ * new block is appended to the list.
+ *
+ * Header format (size in byte):
+ * ----------------------------------------------------------------------------------
+ * | LSN (4) | PageId(4) | NumBlocks(4) | BlockPageIds(4080)
+ * ----------------------------------------------------------------------------------
+ */
+class HashTableBlockHeaderPage {
+ public:
+  /**
+   * @return the page ID of this page
+   */
+  page_id_t GetPageId() const;
+
+  /**
+   * Sets the page ID of this page
+   *
+   * @param page_id the page id to which to set the page_id_ field
+   */
+  void SetPageId(page_id_t page_id);
+
+  /**
+   * @return the lsn of this page
+   */
+  lsn_t GetLSN() const;
+
+  /**
+   * Sets the LSN of this page
+   *
+   * @param lsn the log sequence number to which to set the lsn field
+   */
+  void SetLSN(lsn_t lsn);
+
+  /**
+   * @return the number of blocks of the table
+   */
+  uint32_t NumBlocks() const;
+
+  /**
+   * @return the maximum number of blocks of the table
+   */
+  uint32_t MaxBlocks() const;
+
+  /**
+   * Lookup the page id of a block
+   *
+   * @param block_idx the number of the block
+   * @return page_id of the block
+   */
+  page_id_t GetBlockPageId(uint32_t block_idx) const;
+
+  /**
+   * Appends a block to the table
+   *
+   * @param block_page_id page_id of the new block
+   */
+  void AddBlockPageId(page_id_t block_page_id);
+
+ private:
+  page_id_t page_id_;
+  lsn_t lsn_;
+  uint32_t num_blocks_{0};
+  page_id_t block_page_ids_[BLOCK_HEADER_ARRAY_SIZE];
+};
+
+}  // namespace bustub
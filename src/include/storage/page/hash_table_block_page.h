@@ -0,0 +1,118 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// hash_table_block_page.h
+//
+// Identification: src/include/storage/page/hash_table_block_page.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+#include <utility>
+
+#include "common/config.h"
+#include "storage/index/int_comparator.h"
+#include "storage/page/hash_table_page_defs.h"
+
+namespace bustub {
+/**
+ * Store indexed key and and value together within block page. Supports
+ * non-unique keys.
+ *
+ * Block page format (keys are stored in order):
+ *  ----------------------------------------------------------------
+ * | KEY(1) + VALUE(1) | KEY(2) + VALUE(2) | ... | KEY(n) + VALUE(n)
+ *  ----------------------------------------------------------------
+ *
+ *  Here '+' means concatenation.
+ *  The above format omits the space required for the occupied_ and
+ *  readable_ arrays, and the page id of the block's overflow block.
+ *
+ *  The block does not hash keys itself. The linear probe hash table picks
+ *  the slot of every key and probes the slots after it.
+ */
+template <typename KeyType, typename ValueType, typename KeyComparator>
+class HashTableBlockPage {
+ public:
+  // Delete all constructor / destructor to ensure memory safety
+  HashTableBlockPage() = delete;
+
+  /**
+   * Init method after creating a new block page, or to clear a block page. The block has no overflow block.
+   */
+  void Init();
+
+  /**
+   * Gets the key at an index in the block.
+   *
+   * @param bucket_ind the index in the block to get the key at
+   * @return key at index bucket_ind of the block
+   */
+  KeyType KeyAt(slot_offset_t bucket_ind) const;
+
+  /**
+   * Gets the value at an index in the block.
+   *
+   * @param bucket_ind the index in the block to get the value at
+   * @return value at index bucket_ind of the block
+   */
+  ValueType ValueAt(slot_offset_t bucket_ind) const;
+
+  /**
+   * Attempts to insert a key and value into an index in the block.
+   *
+   * @param bucket_ind index to write the key and value to
+   * @param key key to insert
+   * @param value value to insert
+   * @return true if insert succeeded, false if the slot already holds a pair
+   */
+  bool Insert(slot_offset_t bucket_ind, const KeyType &key, const ValueType &value);
+
+  /**
+   * Removes a key and value at index. The slot stays occupied, so that probes continue past it.
+   *
+   * @param bucket_ind ind to remove the value
+   */
+  void Remove(slot_offset_t bucket_ind);
+
+  /**
+   * Returns whether or not an index is occupied (key/value pair or tombstone)
+   *
+   * @param bucket_ind index to look at
+   * @return true if the index is occupied, false otherwise
+   */
+  bool IsOccupied(slot_offset_t bucket_ind) const;
+
+  /**
+   * Returns whether or not an index is readable (valid key/value pair)
+   *
+   * @param bucket_ind index to look at
+   * @return true if the index is readable, false otherwise
+   */
+  bool IsReadable(slot_offset_t bucket_ind) const;
+
+  /**
+   * @return the page id of the block's overflow block, INVALID_PAGE_ID if there is none
+   */
+  page_id_t GetOverflowPageId() const { return overflow_page_id_; }
+
+  /**
+   * @param overflow_page_id the page id of the block's overflow block
+   */
+  void SetOverflowPageId(page_id_t overflow_page_id) { overflow_page_id_ = overflow_page_id; }
+
+ private:
+  page_id_t overflow_page_id_;
+  //  For more on BLOCK_ARRAY_SIZE see storage/page/hash_table_page_defs.h
+  char occupied_[(BLOCK_ARRAY_SIZE - 1) / 8 + 1];
+  // 0 if tombstone/brand new (never occupied), 1 otherwise.
+  char readable_[(BLOCK_ARRAY_SIZE - 1) / 8 + 1];
+  MappingType array_[BLOCK_ARRAY_SIZE];
+};
+
+}  // namespace bustub
@@ -12,6 +12,7 @@
 
 #pragma once
 
+#include <cstdint>
 #include <utility>
 #include <vector>
 
@@ -31,8 +32,17 @@ namespace bustub {
  *
  *  Here '+' means concatenation.
  *  The above format omits the space required for the occupied_ and
- *  readable_ arrays. More information is in storage/page/hash_table_page_defs.h.
+ *  readable_ arrays and the one byte fingerprint (tag) of every slot.
+ *  More information is in storage/page/hash_table_page_defs.h.
  *
+ *  Lookups compare the tag of a key against the tags of BUCKET_GROUP_SIZE
+ *  slots at once with SIMD instructions, and only run the comparator on
+ *  readable slots whose tag matches. Every caller has to derive the tag of
+ *  a key the same way, the extendible hash table uses the top byte of the hash.
+ *
+ *  Entries that share one hash value can never be split apart, so a full
+ *  bucket of them links further bucket pages into an overflow chain. The
+ *  pages of a chain are only ever accessed under the latch of its first page.
  */
 template <typename KeyType, typename ValueType, typename KeyComparator>
 class HashTableBucketPage {
@@ -40,12 +50,28 @@ class HashTableBucketPage {
   // Delete all constructor / destructor to ensure memory safety
   HashTableBucketPage() = delete;
 
+  /**
+   * Init method after creating a new bucket page, a new bucket has no overflow page.
+   */
+  void Init();
+
+  /**
+   * @return the page id of the next page of the bucket's overflow chain, INVALID_PAGE_ID if there is none
+   */
+  page_id_t GetOverflowPageId() const { return overflow_page_id_; }
+
+  /**
+   * @param overflow_page_id the page id of the next page of the bucket's overflow chain
+   */
+  void SetOverflowPageId(page_id_t overflow_page_id) { overflow_page_id_ = overflow_page_id; }
+
   /**
    * Scan the bucket and collect values that have the matching key
    *
+   * @param tag the fingerprint of the key
    * @return true if at least one key matched
    */
-  bool GetValue(KeyType key, KeyComparator cmp, std::vector<ValueType> *result);
+  bool GetValue(KeyType key, KeyComparator cmp, std::vector<ValueType> *result, uint8_t tag = 0);
 
   /**
    * Attempts to insert a key and value in the bucket.  Uses the occupied_
@@ -53,16 +79,18 @@ class HashTableBucketPage {
    *
    * @param key key to insert
    * @param value value to insert
+   * @param tag the fingerprint of the key
    * @return true if inserted, false if duplicate KV pair or bucket is full
    */
-  bool Insert(KeyType key, ValueType value, KeyComparator cmp);
+  bool Insert(KeyType key, ValueType value, KeyComparator cmp, uint8_t tag = 0);
 
   /**
    * Removes a key and value.
    *
+   * @param tag the fingerprint of the key
    * @return true if removed, false if not found
    */
-  bool Remove(KeyType key, ValueType value, KeyComparator cmp);
+  bool Remove(KeyType key, ValueType value, KeyComparator cmp, uint8_t tag = 0);
 
   /**
    * Gets the key at an index in the bucket.
@@ -80,6 +108,14 @@ class HashTableBucketPage {
    */
   ValueType ValueAt(uint32_t bucket_idx) const;
 
+  /**
+   * Gets the fingerprint of the key at an index in the bucket.
+   *
+   * @param bucket_idx the index in the bucket to get the tag at
+   * @return tag at index bucket_idx of the bucket
+   */
+  uint8_t TagAt(uint32_t bucket_idx) const;
+
   /**
    * Remove the KV pair at bucket_idx
    */
@@ -139,6 +175,12 @@ class HashTableBucketPage {
    */
   void PrintBucket();
 
+  /**
+   * Hints the CPU to load the readable flags and the tags into the cache, which is all GetValue() reads before
+   * it compares keys.
+   */
+  void Prefetch() const;
+
   /**
    * @return the length of occupied_ or readable_
    */
@@ -171,10 +213,26 @@ class HashTableBucketPage {
   }
 
  private:
+  /**
+   * @param group_idx the index of the first slot of a group of BUCKET_GROUP_SIZE slots
+   * @return a bit per slot of the group that is set if the slot exists and is readable
+   */
+  uint32_t ReadableInGroup(uint32_t group_idx) const;
+
+  /**
+   * @param group_idx the index of the first slot of a group of BUCKET_GROUP_SIZE slots
+   * @param tag the fingerprint to match
+   * @return a bit per slot of the group that is set if the slot is readable and has the tag
+   */
+  uint32_t MatchInGroup(uint32_t group_idx, uint8_t tag) const;
+
+  page_id_t overflow_page_id_;
   //  For more on BUCKET_ARRAY_SIZE see storage/page/hash_table_page_defs.h
-  char occupied_[(BUCKET_ARRAY_SIZE - 1) / 8 + 1]{0};
+  //  The flags and tags are padded to whole groups, the padding is never readable.
+  char occupied_[BUCKET_PADDED_SIZE / 8]{0};
   // 0 if tombstone/brand new (never occupied), 1 otherwise.
-  char readable_[(BUCKET_ARRAY_SIZE - 1) / 8 + 1]{0};
+  char readable_[BUCKET_PADDED_SIZE / 8]{0};
+  uint8_t tags_[BUCKET_PADDED_SIZE];
   MappingType array_[BUCKET_ARRAY_SIZE];
 };
 
@@ -0,0 +1,122 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// hash_table_header_page.h
+//
+// Identification: src/include/storage/page/hash_table_header_page.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+
+#include "common/config.h"
+#include "storage/page/hash_table_page_defs.h"
+
+namespace bustub {
+
+/**
+ *
+ * Header Page for extendible hash table.
+ *
+ * The header is the root of a two level directory. Directory index i lives in slot i % DIRECTORY_ARRAY_SIZE of
+ * directory page i / DIRECTORY_ARRAY_SIZE, so a lookup always reads the header, one directory page and one bucket.
+ * While the global depth is at most 9 there is a single directory page whose global depth equals the table's,
+ * beyond that every directory page is full and has global depth 9.
+ *
+ * Header format (size in byte):
+ * ----------------------------------------------------------------------------------
+ * | LSN (4) | PageId(4) | GlobalDepth(4) | DirectoryPageIds(2048) | Free(2036)
+ * ----------------------------------------------------------------------------------
+ */
+class HashTableHeaderPage {
+ public:
+  /**
+   * @return the page ID of this page
+   */
+  page_id_t GetPageId() const;
+
+  /**
+   * Sets the page ID of this page
+   *
+   * @param page_id the page id to which to set the page_id_ field
+   */
+  void SetPageId(page_id_t page_id);
+
+  /**
+   * @return the lsn of this page
+   */
+  lsn_t GetLSN() const;
+
+  /**
+   * Sets the LSN of this page
+   *
+   * @param lsn the log sequence number to which to set the lsn field
+   */
+  void SetLSN(lsn_t lsn);
+
+  /**
+   * Get the global depth of the hash table directory
+   *
+   * @return the global depth of the directory
+   */
+  uint32_t GetGlobalDepth() const;
+
+  /**
+   * @return mask of global_depth 1's and the rest 0's (with 1's from LSB upwards)
+   */
+  uint32_t GetGlobalDepthMask() const;
+
+  /**
+   * Increment the global depth of the directory
+   */
+  void IncrGlobalDepth();
+
+  /**
+   * Decrement the global depth of the directory
+   */
+  void DecrGlobalDepth();
+
+  /**
+   * @return the current directory size, summed over all directory pages
+   */
+  uint32_t Size() const;
+
+  /**
+   * @return the maximum directory size
+   */
+  uint32_t MaxSize() const;
+
+  /**
+   * @return the number of directory pages in use
+   */
+  uint32_t NumDirectoryPages() const;
+
+  /**
+   * Lookup the directory page that holds a directory index
+   *
+   * @param bucket_idx the index in the directory to lookup
+   * @return page_id of the directory page that holds bucket_idx
+   */
+  page_id_t GetDirectoryPageId(uint32_t bucket_idx) const;
+
+  /**
+   * Sets the page_id of a directory page
+   *
+   * @param directory_page_idx the number of the directory page
+   * @param directory_page_id page_id of the directory page
+   */
+  void SetDirectoryPageId(uint32_t directory_page_idx, page_id_t directory_page_id);
+
+ private:
+  page_id_t page_id_;
+  lsn_t lsn_;
+  uint32_t global_depth_{0};
+  page_id_t directory_page_ids_[HEADER_ARRAY_SIZE];
+};
+
+}  // namespace bustub
@@ -24,9 +24,15 @@
  * approximate calculation based on the size of MappingType (which is a std::pair of KeyType and ValueType). For each
  * key/value pair, we need two additional bits for occupied_ and readable_. 4 * PAGE_SIZE / (4 * sizeof (MappingType) +
  * 1) = PAGE_SIZE/(sizeof (MappingType) + 0.25) because 0.25 bytes = 2 bits is the space required to maintain the
- * occupied and readable flags for a key value pair.
+ * occupied and readable flags for a key value pair. The first 4 bytes of the page hold the page id of the block's
+ * overflow block.
  */
-#define BLOCK_ARRAY_SIZE (4 * PAGE_SIZE / (4 * sizeof(MappingType) + 1))
+#define BLOCK_ARRAY_SIZE (4 * (PAGE_SIZE - 4) / (4 * sizeof(MappingType) + 1))
+
+/**
+ * BLOCK_HEADER_ARRAY_SIZE is the number of block pages a linear probe hash table header page points to.
+ */
+#define BLOCK_HEADER_ARRAY_SIZE 1020
 
 /**
  * Extendible Hashing Definitions
@@ -34,11 +40,27 @@
 #define HASH_TABLE_BUCKET_TYPE HashTableBucketPage<KeyType, ValueType, KeyComparator>
 #define DIRECTORY_ARRAY_SIZE 512
 
+/**
+ * HEADER_ARRAY_SIZE is the number of directory pages an extendible hash table header page points to. The directory
+ * therefore holds up to DIRECTORY_ARRAY_SIZE * HEADER_ARRAY_SIZE = 2^18 entries, a global depth of 18.
+ */
+#define HEADER_ARRAY_SIZE 512
+
 /**
  * BUCKET_ARRAY_SIZE is the number of (key, value) pairs that can be stored in an extendible hashing bucket page.
  * It is an approximate calculation based on the size of MappingType (which is a std::pair of KeyType and ValueType).
- * For each key/value pair, we need two additional bits for occupied_ and readable_. 4 * (PAGE_SIZE - 4) / (4 * sizeof
- * (MappingType) + 1) = (PAGE_SIZE - 4)/(sizeof (MappingType) + 0.25) because 0.25 bytes = 2 bits is the space required
- * to maintain the occupied and readable flags for a key value pair.
+ * For each key/value pair, we need a one byte fingerprint and two additional bits for occupied_ and readable_.
+ * 4 * (PAGE_SIZE - 64) / (4 * sizeof (MappingType) + 5) = (PAGE_SIZE - 64)/(sizeof (MappingType) + 1.25) because
+ * 1.25 bytes is the space required for the fingerprint and the occupied and readable flags of a key value pair. The 64
+ * bytes leave room to pad the fingerprints and flags to whole groups of BUCKET_GROUP_SIZE slots, and for the page id of
+ * the bucket's overflow page. The result is rounded
+ * down to a multiple of 8, so that the flags fill whole bytes.
+ */
+#define BUCKET_ARRAY_SIZE (4 * (PAGE_SIZE - 64) / (4 * sizeof(MappingType) + 5) / 8 * 8)
+
+/**
+ * BUCKET_GROUP_SIZE is the number of slot fingerprints an extendible hashing bucket page matches at once, and
+ * BUCKET_PADDED_SIZE is BUCKET_ARRAY_SIZE rounded up to whole groups.
  */
-#define BUCKET_ARRAY_SIZE (4 * PAGE_SIZE / (4 * sizeof(MappingType) + 1))
+#define BUCKET_GROUP_SIZE 32
+#define BUCKET_PADDED_SIZE ((BUCKET_ARRAY_SIZE + BUCKET_GROUP_SIZE - 1) / BUCKET_GROUP_SIZE * BUCKET_GROUP_SIZE)
@@ -0,0 +1,81 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// lsm_run_page.h
+//
+// Identification: src/include/storage/page/lsm_run_page.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+#include <utility>
+
+#include "common/config.h"
+
+namespace bustub {
+
+#define LSM_RUN_PAGE_TYPE LSMRunPage<KeyType, ValueType, KeyComparator>
+
+/**
+ * A page of a sorted run of the LSM tree. A run is written once, page by page in order, and never changed
+ * afterwards, so its pages are read without latches.
+ *
+ * Run page format (keys are stored in order):
+ *  --------------------------------------------------------------------------
+ * | NumEntries (4) | Deleted bits | KEY(1) + VALUE(1) | ... | KEY(n) + VALUE(n)
+ *  --------------------------------------------------------------------------
+ *
+ *  A deleted bit marks a pair that was removed, which hides older copies of the pair in older runs.
+ */
+template <typename KeyType, typename ValueType, typename KeyComparator>
+class LSMRunPage {
+ public:
+  // Delete all constructor / destructor to ensure memory safety
+  LSMRunPage() = delete;
+
+  /** The number of pairs that fit into a page, one bit per pair is needed for the deleted flags. */
+  static constexpr uint32_t CAPACITY =
+      static_cast<uint32_t>(4 * (PAGE_SIZE - sizeof(uint32_t)) / (4 * sizeof(std::pair<KeyType, ValueType>) + 1));
+
+  /** Init method after creating a new run page. */
+  void Init() { num_entries_ = 0; }
+
+  /** @return the number of pairs in the page */
+  uint32_t GetSize() const { return num_entries_; }
+
+  /** @return whether no pair can be appended */
+  bool IsFull() const { return num_entries_ == CAPACITY; }
+
+  const KeyType &KeyAt(uint32_t index) const { return array_[index].first; }
+
+  const ValueType &ValueAt(uint32_t index) const { return array_[index].second; }
+
+  bool IsDeleted(uint32_t index) const { return (deleted_[index / 8] & (1 << (index % 8))) != 0; }
+
+  /**
+   * Appends a pair, which must not be smaller than the last pair of the page. The page must not be full.
+   * @param key the key
+   * @param value the value
+   * @param is_deleted whether the pair is a tombstone
+   */
+  void Append(const KeyType &key, const ValueType &value, bool is_deleted);
+
+  /**
+   * @param key the key to look for
+   * @param comparator comparator for keys
+   * @return the index of the first pair whose key is not smaller than key, GetSize() if there is none
+   */
+  uint32_t LowerBound(const KeyType &key, const KeyComparator &comparator) const;
+
+ private:
+  uint32_t num_entries_;
+  char deleted_[(CAPACITY - 1) / 8 + 1];
+  std::pair<KeyType, ValueType> array_[CAPACITY];
+};
+
+}  // namespace bustub
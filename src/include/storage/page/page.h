@@ -12,8 +12,10 @@
 
 #pragma once
 
+#include <atomic>
 #include <cstring>
 #include <iostream>
+#include <thread>  // NOLINT
 
 #include "common/config.h"
 #include "common/rwlatch.h"
@@ -24,6 +26,12 @@ namespace bustub {
  * Page is the basic unit of storage within the database system. Page provides a wrapper for actual data pages being
  * held in main memory. Page also contains book-keeping information that is used by the buffer pool manager, e.g.
  * pin count, dirty flag, page id, etc.
+ *
+ * Besides the latch, a page has a version that works like a seqlock: it is odd while the page is write-latched
+ * and grows whenever the write latch is released. A reader can read a pinned page without latching it, and
+ * without writing to shared memory, between ReadOptimistic() and Validate(); if Validate() fails, a writer
+ * may have changed the page in between and what was read has to be thrown away. Such a reader must be prepared
+ * for inconsistent data until it validates, e.g. it must not follow a page id it has not validated yet.
  */
 class Page {
   // There is book-keeping information inside the page that should only be relevant to the buffer pool manager.
@@ -49,14 +57,55 @@ class Page {
   inline bool IsDirty() { return is_dirty_; }
 
   /** Acquire the page write latch. */
-  inline void WLatch() { rwlatch_.WLock(); }
+  inline void WLatch() {
+    rwlatch_.WLock();
+    BeginWrite();
+  }
+
+  /** @return true if the page write latch was acquired, false if another thread holds the latch */
+  inline bool TryWLatch() {
+    if (!rwlatch_.TryWLock()) {
+      return false;
+    }
+    BeginWrite();
+    return true;
+  }
 
   /** Release the page write latch. */
-  inline void WUnlatch() { rwlatch_.WUnlock(); }
+  inline void WUnlatch() {
+    version_.store(version_.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    rwlatch_.WUnlock();
+  }
+
+  /** @return the version to validate an optimistic read against, waits while the page is write-latched */
+  inline uint64_t ReadOptimistic() const {
+    uint64_t version = version_.load(std::memory_order_acquire);
+    while ((version & 1) != 0) {
+      std::this_thread::yield();
+      version = version_.load(std::memory_order_acquire);
+    }
+    return version;
+  }
+
+  /** @return false if the page is write-latched, otherwise sets the version like ReadOptimistic() */
+  inline bool TryReadOptimistic(uint64_t *version) const {
+    *version = version_.load(std::memory_order_acquire);
+    return (*version & 1) == 0;
+  }
+
+  /** @return true if the page was not write-latched since ReadOptimistic() returned the version */
+  inline bool Validate(uint64_t version) const {
+    // the reads of the page must not move past the version check
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return version_.load(std::memory_order_relaxed) == version;
+  }
 
   /** Acquire the page read latch. */
   inline void RLatch() { rwlatch_.RLock(); }
 
+  /** @return true if the page read latch was acquired, false if a writer holds or waits for the latch */
+  inline bool TryRLatch() { return rwlatch_.TryRLock(); }
+
   /** Release the page read latch. */
   inline void RUnlatch() { rwlatch_.RUnlock(); }
 
@@ -75,6 +124,13 @@ class Page {
   static constexpr size_t OFFSET_LSN = 4;
 
  private:
+  /** Makes the version odd after the write latch was acquired. */
+  inline void BeginWrite() {
+    version_.store(version_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    // the odd version has to be visible before any of the writes to the page
+    std::atomic_thread_fence(std::memory_order_release);
+  }
+
   /** Zeroes out the data that is held within the page. */
   inline void ResetMemory() { memset(data_, OFFSET_PAGE_START, PAGE_SIZE); }
 
@@ -88,6 +144,8 @@ class Page {
   bool is_dirty_ = false;
   /** Page latch. */
   ReaderWriterLatch rwlatch_;
+  /** Seqlock version, odd while the page is write-latched */
+  std::atomic<uint64_t> version_{0};
 };
 
 }  // namespace bustub
@@ -0,0 +1,264 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// varlen_b_plus_tree_page.h
+//
+// Identification: src/include/storage/page/varlen_b_plus_tree_page.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+#include "common/config.h"
+#include "common/macros.h"
+#include "storage/page/b_plus_tree_page.h"
+
+namespace bustub {
+
+/**
+ * A page of the variable-length key B+ tree, both leaf and internal pages use this format. Keys are byte
+ * strings that compare like memcmp, with a shorter key sorting before its extensions.
+ *
+ * Keys are stored in slotted format: an array of fixed-size slots grows from the front of the page and
+ * points into a heap of key suffixes that grows from the back. Removing a key leaves a hole in the heap,
+ * which is reclaimed by compacting the page once the space is needed.
+ *
+ * Every page knows the range of keys it may hold from its fence keys, the separators around the page in its
+ * parent: lower fence <= key < upper fence. All keys of the page share the common prefix of the two fences,
+ * so the prefix is stored once, as part of the lower fence, and the slots only keep the rest of each key.
+ * A slot also holds the first bytes of the suffix as an integer, so that a binary search rarely has to look
+ * into the heap.
+ *
+ * A leaf stores a value next to every key and links to its right sibling. An internal page stores n keys and
+ * n + 1 children: the child of key i covers the keys below it (and at or above key i - 1), the last child,
+ * kept in the header, covers the keys at or above the last key.
+ *
+ * Page format:
+ *  ----------------------------------------------------------------------------------------
+ * | HEADER | SLOT(1) | SLOT(2) | ... | SLOT(n) | free space | heap of fences and suffixes |
+ *  ----------------------------------------------------------------------------------------
+ *
+ * Header format (size in byte, 44 bytes in total):
+ *  ----------------------------------------------------------------------------------------
+ * | BPlusTreePage header (24) | NextPageId (4) | PrefixLength (2) | LowerFenceOffset (2) |
+ *  ----------------------------------------------------------------------------------------
+ *  ----------------------------------------------------------------------------------------
+ * | LowerFenceLength (2) | UpperFenceOffset (2) | UpperFenceLength (2) | HeapBegin (2) |
+ *  ----------------------------------------------------------------------------------------
+ *  ----------------------
+ * | FreeSpace (2) | (2) |
+ *  ----------------------
+ *
+ * Slot format (8 bytes): | Offset (2) | SuffixLength (2) | Head (4) |, the heap entry of a slot is the
+ * value followed by the key suffix.
+ */
+template <typename ValueType>
+class VarlenBPlusTreePage : public BPlusTreePage {
+ public:
+  // Delete all constructor / destructor to ensure memory safety
+  VarlenBPlusTreePage() = delete;
+
+  /** The bytes of a page that hold slots, fences and keys */
+  static constexpr size_t DATA_SIZE = PAGE_SIZE - 44;
+
+  /**
+   * Must be called after the page is created, and clears all keys.
+   * @param page_id the page id
+   * @param page_type leaf or internal page
+   * @param lower_fence the smallest key the page may hold
+   * @param upper_fence the key that all keys of the page are smaller than, nullptr if there is no bound
+   */
+  void Init(page_id_t page_id, IndexPageType page_type, const std::string &lower_fence,
+            const std::string *upper_fence) {
+    page_type_ = page_type;
+    size_ = 0;
+    max_size_ = 0;
+    parent_page_id_ = INVALID_PAGE_ID;
+    page_id_ = page_id;
+    next_page_id_ = INVALID_PAGE_ID;
+    heap_begin_ = DATA_SIZE;
+    free_space_ = DATA_SIZE;
+    lower_fence_offset_ = AllocateHeap(lower_fence.size());
+    lower_fence_length_ = static_cast<uint16_t>(lower_fence.size());
+    memcpy(data_ + lower_fence_offset_, lower_fence.data(), lower_fence.size());
+    if (upper_fence == nullptr) {
+      upper_fence_offset_ = NO_FENCE;
+      upper_fence_length_ = 0;
+      prefix_length_ = 0;
+    } else {
+      upper_fence_offset_ = AllocateHeap(upper_fence->size());
+      upper_fence_length_ = static_cast<uint16_t>(upper_fence->size());
+      memcpy(data_ + upper_fence_offset_, upper_fence->data(), upper_fence->size());
+      auto mismatch = std::mismatch(lower_fence.begin(), lower_fence.end(), upper_fence->begin(), upper_fence->end());
+      prefix_length_ = static_cast<uint16_t>(mismatch.first - lower_fence.begin());
+    }
+  }
+
+  /** Leaf pages: the right sibling. Internal pages: the last child. */
+  page_id_t GetNextPageId() const { return next_page_id_; }
+
+  void SetNextPageId(page_id_t next_page_id) { next_page_id_ = next_page_id; }
+
+  std::string GetLowerFence() const { return std::string(data_ + lower_fence_offset_, lower_fence_length_); }
+
+  bool HasUpperFence() const { return upper_fence_offset_ != NO_FENCE; }
+
+  std::string GetUpperFence() const { return std::string(data_ + upper_fence_offset_, upper_fence_length_); }
+
+  /** @return the number of bytes all keys of the page start with */
+  size_t GetPrefixLength() const { return prefix_length_; }
+
+  std::string KeyAt(int index) const {
+    std::string key(data_ + lower_fence_offset_, prefix_length_);
+    key.append(data_ + slots_[index].offset_ + sizeof(ValueType), slots_[index].length_);
+    return key;
+  }
+
+  ValueType ValueAt(int index) const {
+    ValueType value;
+    memcpy(&value, data_ + slots_[index].offset_, sizeof(ValueType));
+    return value;
+  }
+
+  void SetValueAt(int index, const ValueType &value) {
+    memcpy(data_ + slots_[index].offset_, &value, sizeof(ValueType));
+  }
+
+  /**
+   * Binary search for a key, which must lie within the fences of the page.
+   * @param[out] found whether KeyAt() of the returned index is the key
+   * @return the first index i such that KeyAt(i) >= key, or GetSize() if every key is smaller
+   */
+  int KeyIndex(const std::string &key, bool *found) const {
+    const char *suffix = key.data() + prefix_length_;
+    size_t length = key.size() - prefix_length_;
+    uint32_t head = Head(suffix, length);
+    int lo = 0;
+    int hi = size_;
+    while (lo < hi) {
+      int mid = lo + (hi - lo) / 2;
+      if (CompareSlot(slots_[mid], suffix, length, head) < 0) {
+        lo = mid + 1;
+      } else {
+        hi = mid;
+      }
+    }
+    *found = lo < size_ && CompareSlot(slots_[lo], suffix, length, head) == 0;
+    return lo;
+  }
+
+  /**
+   * Inserts a key at an index, the caller keeps the keys in order.
+   * @return false if the page has no room for the key
+   */
+  bool InsertAt(int index, const std::string &key, const ValueType &value) {
+    size_t length = key.size() - prefix_length_;
+    if (free_space_ < SpaceFor(length)) {
+      return false;
+    }
+    if (heap_begin_ - size_ * sizeof(Slot) < SpaceFor(length)) {
+      Compact();
+    }
+    uint16_t offset = AllocateHeap(sizeof(ValueType) + length);
+    memcpy(data_ + offset, &value, sizeof(ValueType));
+    memcpy(data_ + offset + sizeof(ValueType), key.data() + prefix_length_, length);
+    std::move_backward(slots_ + index, slots_ + size_, slots_ + size_ + 1);
+    slots_[index] = Slot{offset, static_cast<uint16_t>(length), Head(key.data() + prefix_length_, length)};
+    size_++;
+    free_space_ -= sizeof(Slot);
+    return true;
+  }
+
+  void RemoveAt(int index) {
+    // the heap entry becomes a hole that is reclaimed by the next compaction
+    free_space_ += SpaceFor(slots_[index].length_);
+    std::move(slots_ + index + 1, slots_ + size_, slots_ + index);
+    size_--;
+  }
+
+  /** @return the bytes that are left for slots and keys, including the holes in the heap */
+  size_t GetFreeSpace() const { return free_space_; }
+
+  /** @return the bytes a key with a suffix of the given length takes up */
+  static size_t SpaceFor(size_t suffix_length) { return sizeof(Slot) + sizeof(ValueType) + suffix_length; }
+
+ private:
+  struct Slot {
+    uint16_t offset_;
+    uint16_t length_;
+    // the first bytes of the suffix, big-endian and padded with zeros
+    uint32_t head_;
+  };
+
+  static constexpr uint16_t NO_FENCE = UINT16_MAX;
+
+  static uint32_t Head(const char *suffix, size_t length) {
+    uint32_t head = 0;
+    for (size_t i = 0; i < sizeof(uint32_t); i++) {
+      head = (head << 8) | (i < length ? static_cast<uint8_t>(suffix[i]) : 0);
+    }
+    return head;
+  }
+
+  /** Compares the key of a slot with a key suffix. */
+  int CompareSlot(const Slot &slot, const char *suffix, size_t length, uint32_t head) const {
+    if (slot.head_ != head) {
+      return slot.head_ < head ? -1 : 1;
+    }
+    int cmp = memcmp(data_ + slot.offset_ + sizeof(ValueType), suffix, std::min<size_t>(slot.length_, length));
+    if (cmp != 0) {
+      return cmp;
+    }
+    return slot.length_ < length ? -1 : (slot.length_ > length ? 1 : 0);
+  }
+
+  /** Takes bytes from the front of the heap, the caller made sure that they are free. */
+  uint16_t AllocateHeap(size_t length) {
+    heap_begin_ -= length;
+    free_space_ -= length;
+    return heap_begin_;
+  }
+
+  /** Moves the fences and the heap entries of all slots to the end of the page, closing the holes. */
+  void Compact() {
+    char heap[DATA_SIZE];
+    size_t end = DATA_SIZE;
+    auto move = [&](uint16_t offset, size_t length) {
+      end -= length;
+      memcpy(heap + end, data_ + offset, length);
+      return static_cast<uint16_t>(end);
+    };
+    lower_fence_offset_ = move(lower_fence_offset_, lower_fence_length_);
+    if (HasUpperFence()) {
+      upper_fence_offset_ = move(upper_fence_offset_, upper_fence_length_);
+    }
+    for (int i = 0; i < size_; i++) {
+      slots_[i].offset_ = move(slots_[i].offset_, sizeof(ValueType) + slots_[i].length_);
+    }
+    memcpy(data_ + end, heap + end, DATA_SIZE - end);
+    heap_begin_ = end;
+  }
+
+  page_id_t next_page_id_;
+  uint16_t prefix_length_;
+  uint16_t lower_fence_offset_;
+  uint16_t lower_fence_length_;
+  uint16_t upper_fence_offset_;
+  uint16_t upper_fence_length_;
+  uint16_t heap_begin_;
+  uint16_t free_space_;
+  union {
+    Slot slots_[DATA_SIZE / sizeof(Slot)];
+    char data_[DATA_SIZE];
+  };
+};
+
+}  // namespace bustub
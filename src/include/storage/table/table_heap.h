@@ -12,6 +12,8 @@
 
 #pragma once
 
+#include <vector>
+
 #include "buffer/buffer_pool_manager.h"
 #include "recovery/log_manager.h"
 #include "storage/page/table_page.h"
@@ -99,6 +101,30 @@ class TableHeap {
    */
   bool GetTuple(const RID &rid, Tuple *tuple, Transaction *txn);
 
+  /**
+   * Read a batch of tuples from the table. Each run of rids on the same page is read under a single fetch and
+   * latch of that page, so rids should be sorted by page id.
+   * @param rids rids of the tuples to read
+   * @param[out] tuples output variable for the tuples that exist, in the order of rids
+   * @param txn transaction performing the read
+   */
+  void GetTuples(const std::vector<RID> &rids, std::vector<Tuple> *tuples, Transaction *txn);
+
+  /**
+   * Read every tuple stored on one page of the table. Together with GetPageIds() this lets several threads
+   * scan disjoint parts of the table.
+   * @param page_id id of a page of this table
+   * @param[out] tuples output variable the tuples of the page are appended to
+   * @param txn transaction performing the read
+   */
+  void GetPageTuples(page_id_t page_id, std::vector<Tuple> *tuples, Transaction *txn);
+
+  /**
+   * Collect the ids of all pages of the table.
+   * @param[out] page_ids output variable for the page ids, in table order
+   */
+  void GetPageIds(std::vector<page_id_t> *page_ids);
+
   /** @return the begin iterator of this table */
   TableIterator Begin(Transaction *txn);
 
@@ -0,0 +1,53 @@
+#include <vector>
+
+#include "storage/index/adaptive_radix_tree_index.h"
+#include "storage/index/generic_key.h"
+
+namespace bustub {
+/*
+ * Constructor
+ */
+template <typename KeyType, typename ValueType, typename KeyComparator>
+ADAPTIVE_RADIX_TREE_INDEX_TYPE::AdaptiveRadixTreeIndex(std::unique_ptr<IndexMetadata> &&metadata)
+    : Index(std::move(metadata)) {}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void ADAPTIVE_RADIX_TREE_INDEX_TYPE::InsertEntry(const Tuple &key, RID rid, Transaction *transaction) {
+  // construct insert index key
+  KeyType index_key;
+  index_key.SetFromKey(key, GetKeySchema());
+
+  container_.Insert(index_key, rid);
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void ADAPTIVE_RADIX_TREE_INDEX_TYPE::DeleteEntry(const Tuple &key, RID rid, Transaction *transaction) {
+  // construct delete index key
+  KeyType index_key;
+  index_key.SetFromKey(key, GetKeySchema());
+
+  container_.Remove(index_key);
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void ADAPTIVE_RADIX_TREE_INDEX_TYPE::ScanKey(const Tuple &key, std::vector<RID> *result, Transaction *transaction) {
+  // construct scan index key
+  KeyType index_key;
+  index_key.SetFromKey(key, GetKeySchema());
+
+  container_.GetValue(index_key, result);
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void ADAPTIVE_RADIX_TREE_INDEX_TYPE::ScanRange(const KeyType *low, const KeyType *high, size_t max_pairs,
+                                               std::vector<std::pair<KeyType, ValueType>> *result) {
+  container_.Scan(low, high, max_pairs, result);
+}
+
+template class AdaptiveRadixTreeIndex<GenericKey<4>, RID, GenericComparator<4>>;
+template class AdaptiveRadixTreeIndex<GenericKey<8>, RID, GenericComparator<8>>;
+template class AdaptiveRadixTreeIndex<GenericKey<16>, RID, GenericComparator<16>>;
+template class AdaptiveRadixTreeIndex<GenericKey<32>, RID, GenericComparator<32>>;
+template class AdaptiveRadixTreeIndex<GenericKey<64>, RID, GenericComparator<64>>;
+
+}  // namespace bustub
@@ -9,7 +9,12 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
+#include <iterator>
 #include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
 #include "common/exception.h"
 #include "common/rid.h"
@@ -19,19 +24,50 @@
 namespace bustub {
 INDEX_TEMPLATE_ARGUMENTS
 BPLUSTREE_TYPE::BPlusTree(std::string name, BufferPoolManager *buffer_pool_manager, const KeyComparator &comparator,
-                          int leaf_max_size, int internal_max_size)
+                          int leaf_max_size, int internal_max_size, page_id_t header_page_id)
     : index_name_(std::move(name)),
       root_page_id_(INVALID_PAGE_ID),
       buffer_pool_manager_(buffer_pool_manager),
       comparator_(comparator),
       leaf_max_size_(leaf_max_size),
-      internal_max_size_(internal_max_size) {}
+      internal_max_size_(internal_max_size),
+      header_page_id_(header_page_id) {}
+
+INDEX_TEMPLATE_ARGUMENTS
+BPLUSTREE_TYPE::~BPlusTree() {
+  if (swizzle_table_ != nullptr) {
+    UnswizzleAll();
+  }
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::EnableSwizzling(size_t max_pages) {
+  if (swizzle_table_ == nullptr) {
+    swizzle_table_ = std::make_unique<SwizzleTable>();
+  }
+  // the pinned swizzled pages must leave the buffer pool enough frames for everything else
+  max_swizzled_pages_ = std::min(max_pages, buffer_pool_manager_->GetPoolSize() / 2);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::UnswizzleAll() {
+  if (swizzle_table_ == nullptr) {
+    return;
+  }
+  swizzle_table_->RemoveAll([this](Page *page) { buffer_pool_manager_->UnpinPage(page->GetPageId(), false); });
+  num_swizzled_pages_ = 0;
+}
 
 /*
  * Helper function to decide whether current b+tree is empty
  */
 INDEX_TEMPLATE_ARGUMENTS
-bool BPLUSTREE_TYPE::IsEmpty() const { return true; }
+bool BPLUSTREE_TYPE::IsEmpty() const {
+  root_latch_.RLock();
+  bool empty = root_page_id_ == INVALID_PAGE_ID;
+  root_latch_.RUnlock();
+  return empty;
+}
 /*****************************************************************************
  * SEARCH
  *****************************************************************************/
@@ -42,7 +78,19 @@ bool BPLUSTREE_TYPE::IsEmpty() const { return true; }
  */
 INDEX_TEMPLATE_ARGUMENTS
 bool BPLUSTREE_TYPE::GetValue(const KeyType &key, std::vector<ValueType> *result, Transaction *transaction) {
-  return false;
+  Page *page = FindLeafPage(key, false, Operation::SEARCH);
+  if (page == nullptr) {
+    return false;
+  }
+  auto *leaf = reinterpret_cast<LeafPage *>(page->GetData());
+  ValueType value;
+  bool found = leaf->Lookup(key, &value, comparator_);
+  page->RUnlatch();
+  buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
+  if (found) {
+    result->push_back(value);
+  }
+  return found;
 }
 
 /*****************************************************************************
@@ -56,19 +104,64 @@ bool BPLUSTREE_TYPE::GetValue(const KeyType &key, std::vector<ValueType> *result
  * keys return false, otherwise return true.
  */
 INDEX_TEMPLATE_ARGUMENTS
-bool BPLUSTREE_TYPE::Insert(const KeyType &key, const ValueType &value, Transaction *transaction) { return false; }
+bool BPLUSTREE_TYPE::Insert(const KeyType &key, const ValueType &value, Transaction *transaction) {
+  // Optimistic pass: only the leaf is write-latched, which is enough unless the leaf has to split.
+  Page *page = FindLeafPage(key, false, Operation::INSERT);
+  if (page != nullptr) {
+    auto *leaf = reinterpret_cast<LeafPage *>(page->GetData());
+    ValueType old_value;
+    bool duplicate = leaf->Lookup(key, &old_value, comparator_);
+    bool safe = !duplicate && IsSafe(leaf, Operation::INSERT, false);
+    if (safe) {
+      leaf->Insert(key, value, comparator_);
+    }
+    page->WUnlatch();
+    buffer_pool_manager_->UnpinPage(page->GetPageId(), safe);
+    if (duplicate || safe) {
+      return safe;
+    }
+  }
+
+  // Pessimistic pass: write-latch every page that may be split.
+  Transaction local_transaction(INVALID_TXN_ID);
+  if (transaction == nullptr) {
+    transaction = &local_transaction;
+  }
+  bool inserted = true;
+  if (FindLeafPageExclusive(key, Operation::INSERT, transaction) == nullptr) {
+    StartNewTree(key, value);
+  } else {
+    inserted = InsertIntoLeaf(key, value, transaction);
+  }
+  ReleaseLatches(transaction, true);
+  return inserted;
+}
 /*
  * Insert constant key & value pair into an empty tree
  * User needs to first ask for new page from buffer pool manager(NOTICE: throw
  * an "out of memory" exception if returned value is nullptr), then update b+
  * tree's root page id and insert entry directly into leaf page.
+ * The caller holds root_latch_ in write mode.
  */
 INDEX_TEMPLATE_ARGUMENTS
-void BPLUSTREE_TYPE::StartNewTree(const KeyType &key, const ValueType &value) {}
+void BPLUSTREE_TYPE::StartNewTree(const KeyType &key, const ValueType &value) {
+  page_id_t page_id;
+  Page *page = NewPageOrUnswizzle(&page_id);
+  if (page == nullptr) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "cannot allocate a new root page");
+  }
+  auto *root = reinterpret_cast<LeafPage *>(page->GetData());
+  root->Init(page_id, INVALID_PAGE_ID, leaf_max_size_);
+  root->Insert(key, value, comparator_);
+  root_page_id_ = page_id;
+  UpdateRootPageId(1);
+  buffer_pool_manager_->UnpinPage(page_id, true);
+}
 
 /*
  * Insert constant key & value pair into leaf page
- * User needs to first find the right leaf page as insertion target, then look
+ * The target leaf page is the last page of the transaction's page set, write
+ * latched together with every ancestor that may be affected by a split. Look
  * through leaf page to see whether insert key exist or not. If exist, return
  * immdiately, otherwise insert entry. Remember to deal with split if necessary.
  * @return: since we only support unique key, if user try to insert duplicate
@@ -76,7 +169,19 @@ void BPLUSTREE_TYPE::StartNewTree(const KeyType &key, const ValueType &value) {}
  */
 INDEX_TEMPLATE_ARGUMENTS
 bool BPLUSTREE_TYPE::InsertIntoLeaf(const KeyType &key, const ValueType &value, Transaction *transaction) {
-  return false;
+  auto *leaf = reinterpret_cast<LeafPage *>(transaction->GetPageSet()->back()->GetData());
+  int size = leaf->GetSize();
+  if (leaf->Insert(key, value, comparator_) == size) {
+    return false;
+  }
+  if (leaf->GetSize() >= leaf->GetMaxSize()) {
+    LeafPage *new_leaf = Split(leaf);
+    new_leaf->SetNextPageId(leaf->GetNextPageId());
+    leaf->SetNextPageId(new_leaf->GetPageId());
+    InsertIntoParent(leaf, new_leaf->KeyAt(0), new_leaf, transaction);
+    buffer_pool_manager_->UnpinPage(new_leaf->GetPageId(), true);
+  }
+  return true;
 }
 
 /*
@@ -85,11 +190,25 @@ bool BPLUSTREE_TYPE::InsertIntoLeaf(const KeyType &key, const ValueType &value,
  * User needs to first ask for new page from buffer pool manager(NOTICE: throw
  * an "out of memory" exception if returned value is nullptr), then move half
  * of key & value pairs from input page to newly created page
+ * The new page is returned pinned but not latched: until the parent, which the
+ * caller holds write-latched, points to it nobody else can reach it.
  */
 INDEX_TEMPLATE_ARGUMENTS
 template <typename N>
 N *BPLUSTREE_TYPE::Split(N *node) {
-  return nullptr;
+  page_id_t page_id;
+  Page *page = NewPageOrUnswizzle(&page_id);
+  if (page == nullptr) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "cannot allocate a page to split into");
+  }
+  auto *new_node = reinterpret_cast<N *>(page->GetData());
+  new_node->Init(page_id, node->GetParentPageId(), node->GetMaxSize());
+  if constexpr (std::is_same_v<N, LeafPage>) {
+    node->MoveHalfTo(new_node);
+  } else {
+    node->MoveHalfTo(new_node, &page_pool_);
+  }
+  return new_node;
 }
 
 /*
@@ -97,13 +216,141 @@ N *BPLUSTREE_TYPE::Split(N *node) {
  * @param   old_node      input page from split() method
  * @param   key
  * @param   new_node      returned page from split() method
- * User needs to first find the parent page of old_node, parent node must be
- * adjusted to take info of new_node into account. Remember to deal with split
- * recursively if necessary.
+ * The parent page of old_node is the page before it in the transaction's page
+ * set, or the virtual parent (root_latch_) if old_node is the root. Parent node
+ * must be adjusted to take info of new_node into account. Split recursively if
+ * necessary.
  */
 INDEX_TEMPLATE_ARGUMENTS
 void BPLUSTREE_TYPE::InsertIntoParent(BPlusTreePage *old_node, const KeyType &key, BPlusTreePage *new_node,
-                                      Transaction *transaction) {}
+                                      Transaction *transaction) {
+  InternalPage *parent;
+  [[maybe_unused]] bool parent_latched = FindParent(old_node, transaction, &parent);
+  BUSTUB_ASSERT(parent_latched, "a page that splits must have its parent latched");
+  if (parent == nullptr) {
+    page_id_t page_id;
+    Page *page = NewPageOrUnswizzle(&page_id);
+    if (page == nullptr) {
+      throw Exception(ExceptionType::OUT_OF_MEMORY, "cannot allocate a new root page");
+    }
+    auto *root = reinterpret_cast<InternalPage *>(page->GetData());
+    root->Init(page_id, INVALID_PAGE_ID, internal_max_size_);
+    root->PopulateNewRoot(old_node->GetPageId(), key, new_node->GetPageId());
+    old_node->SetParentPageId(page_id);
+    new_node->SetParentPageId(page_id);
+    root_page_id_ = page_id;
+    UpdateRootPageId(0);
+    buffer_pool_manager_->UnpinPage(page_id, true);
+    return;
+  }
+
+  new_node->SetParentPageId(parent->GetPageId());
+  if (parent->InsertNodeAfter(old_node->GetPageId(), key, new_node->GetPageId()) > parent->GetMaxSize()) {
+    InternalPage *new_parent = Split(parent);
+    InsertIntoParent(parent, new_parent->KeyAt(0), new_parent, transaction);
+    buffer_pool_manager_->UnpinPage(new_parent->GetPageId(), true);
+  }
+}
+
+/*****************************************************************************
+ * BULK LOAD
+ *****************************************************************************/
+/*
+ * Build the tree bottom-up from key & value pairs that are sorted by key and
+ * free of duplicates. Leaves are packed left to right and linked, then every
+ * internal level is packed over the level below until a single root is left.
+ * Each page gets about fill_factor of its capacity, but never less than its
+ * minimum size unless it is the root, so the loaded pages have room for later
+ * inserts without splitting right away.
+ * @return: false if the tree is not empty, nothing is loaded then.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+bool BPLUSTREE_TYPE::BulkLoad(const std::vector<MappingType> &items, double fill_factor) {
+  root_latch_.WLock();
+  if (root_page_id_ != INVALID_PAGE_ID) {
+    root_latch_.WUnlock();
+    return false;
+  }
+  if (items.empty()) {
+    root_latch_.WUnlock();
+    return true;
+  }
+
+  // The first key and the page id of every page on the level that was packed last.
+  std::vector<std::pair<KeyType, page_id_t>> level;
+  std::vector<int> sizes = BulkLoadPageSizes(items.size(), leaf_max_size_ - 1, leaf_max_size_, fill_factor);
+  level.reserve(sizes.size());
+  LeafPage *prev_leaf = nullptr;
+  size_t offset = 0;
+  for (int size : sizes) {
+    page_id_t page_id;
+    Page *page = NewPageOrUnswizzle(&page_id);
+    if (page == nullptr) {
+      throw Exception(ExceptionType::OUT_OF_MEMORY, "cannot allocate a new leaf page");
+    }
+    auto *leaf = reinterpret_cast<LeafPage *>(page->GetData());
+    leaf->Init(page_id, INVALID_PAGE_ID, leaf_max_size_);
+    leaf->CopyNFrom(&items[offset], size);
+    level.emplace_back(items[offset].first, page_id);
+    offset += size;
+    if (prev_leaf != nullptr) {
+      prev_leaf->SetNextPageId(page_id);
+      buffer_pool_manager_->UnpinPage(prev_leaf->GetPageId(), true);
+    }
+    prev_leaf = leaf;
+  }
+  buffer_pool_manager_->UnpinPage(prev_leaf->GetPageId(), true);
+
+  while (level.size() > 1) {
+    std::vector<std::pair<KeyType, page_id_t>> parents;
+    sizes = BulkLoadPageSizes(level.size(), internal_max_size_, internal_max_size_, fill_factor);
+    parents.reserve(sizes.size());
+    offset = 0;
+    for (int size : sizes) {
+      page_id_t page_id;
+      Page *page = NewPageOrUnswizzle(&page_id);
+      if (page == nullptr) {
+        throw Exception(ExceptionType::OUT_OF_MEMORY, "cannot allocate a new internal page");
+      }
+      auto *internal = reinterpret_cast<InternalPage *>(page->GetData());
+      internal->Init(page_id, INVALID_PAGE_ID, internal_max_size_);
+      // KeyAt(0) is never looked at, it keeps the first key of the subtree for the level above.
+      internal->CopyNFrom(&level[offset], size, &page_pool_);
+      parents.emplace_back(level[offset].first, page_id);
+      offset += size;
+      buffer_pool_manager_->UnpinPage(page_id, true);
+    }
+    level = std::move(parents);
+  }
+
+  root_page_id_ = level[0].second;
+  UpdateRootPageId(1);
+  root_latch_.WUnlock();
+  return true;
+}
+
+/*
+ * Split count entries into the sizes of the pages of one level. The sizes
+ * differ by at most one, stay within max_entries and, as long as there are
+ * enough entries, do not fall below the minimum size of a page.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+std::vector<int> BPLUSTREE_TYPE::BulkLoadPageSizes(size_t count, int max_entries, int max_size, double fill_factor) {
+  int min_entries = (max_size + 1) / 2;
+  auto target = static_cast<int>(fill_factor * max_entries);
+  target = std::max(std::min(target, max_entries), std::min(min_entries, max_entries));
+  target = std::max(target, 1);
+  size_t num_pages = (count + target - 1) / target;
+  // Fewer, fuller pages if an even split would leave the pages under the minimum size.
+  if (num_pages > 1 && count / num_pages < static_cast<size_t>(min_entries)) {
+    num_pages = std::max<size_t>(count / min_entries, (count + max_entries - 1) / max_entries);
+  }
+  std::vector<int> sizes(num_pages, static_cast<int>(count / num_pages));
+  for (size_t i = 0; i < count % num_pages; i++) {
+    sizes[i]++;
+  }
+  return sizes;
+}
 
 /*****************************************************************************
  * REMOVE
@@ -116,19 +363,99 @@ void BPLUSTREE_TYPE::InsertIntoParent(BPlusTreePage *old_node, const KeyType &ke
  * necessary.
  */
 INDEX_TEMPLATE_ARGUMENTS
-void BPLUSTREE_TYPE::Remove(const KeyType &key, Transaction *transaction) {}
+void BPLUSTREE_TYPE::Remove(const KeyType &key, Transaction *transaction) {
+  // Optimistic pass: only the leaf is write-latched, which is enough unless the leaf underflows.
+  Page *page = FindLeafPage(key, false, Operation::REMOVE);
+  if (page == nullptr) {
+    return;
+  }
+  auto *leaf = reinterpret_cast<LeafPage *>(page->GetData());
+  ValueType old_value;
+  bool found = leaf->Lookup(key, &old_value, comparator_);
+  bool safe = found && IsSafe(leaf, Operation::REMOVE, false);
+  if (safe) {
+    leaf->RemoveAndDeleteRecord(key, comparator_);
+  }
+  page->WUnlatch();
+  buffer_pool_manager_->UnpinPage(page->GetPageId(), safe);
+  if (!found || safe) {
+    return;
+  }
+
+  // Pessimistic pass: write-latch every page that may be merged or redistributed.
+  Transaction local_transaction(INVALID_TXN_ID);
+  if (transaction == nullptr) {
+    transaction = &local_transaction;
+  }
+  page = FindLeafPageExclusive(key, Operation::REMOVE, transaction);
+  if (page != nullptr) {
+    leaf = reinterpret_cast<LeafPage *>(page->GetData());
+    int size = leaf->GetSize();
+    if (leaf->RemoveAndDeleteRecord(key, comparator_) != size) {
+      CoalesceOrRedistribute(leaf, transaction);
+    }
+  }
+  ReleaseLatches(transaction, true);
+  DeletePages(transaction);
+}
 
 /*
  * User needs to first find the sibling of input page. If sibling's size + input
  * page's size > page's max size, then redistribute. Otherwise, merge.
  * Using template N to represent either internal page or leaf page.
+ * Pages that become empty are added to the transaction's deleted page set and
+ * are deleted once all latches have been released.
  * @return: true means target leaf page should be deleted, false means no
  * deletion happens
  */
 INDEX_TEMPLATE_ARGUMENTS
 template <typename N>
 bool BPLUSTREE_TYPE::CoalesceOrRedistribute(N *node, Transaction *transaction) {
-  return false;
+  InternalPage *parent;
+  if (!FindParent(node, transaction, &parent)) {
+    return false;
+  }
+  if (parent == nullptr) {
+    if (AdjustRoot(node)) {
+      transaction->AddIntoDeletedPageSet(node->GetPageId());
+      return true;
+    }
+    return false;
+  }
+  if (node->GetSize() >= node->GetMinSize()) {
+    return false;
+  }
+
+  // Prefer the left sibling, the first child borrows from or merges with its right sibling.
+  int index = parent->ValueIndex(node->GetPageId());
+  page_id_t sibling_page_id = parent->ValueAt(index == 0 ? 1 : index - 1);
+  Page *sibling_page = FetchPageOrUnswizzle(sibling_page_id);
+  BUSTUB_ASSERT(sibling_page != nullptr, "sibling page must be fetchable");
+  if (index == 0) {
+    sibling_page->WLatch();
+  } else {
+    // Siblings are latched left to right, the order in which iterators walk the leaves. While node is
+    // unlatched, the write-latched parent keeps every writer out, so only iterators can pass through it.
+    Page *page = buffer_pool_manager_->FetchPage(node->GetPageId());
+    page->WUnlatch();
+    sibling_page->WLatch();
+    page->WLatch();
+    buffer_pool_manager_->UnpinPage(node->GetPageId(), false);
+  }
+  auto *sibling = reinterpret_cast<N *>(sibling_page->GetData());
+
+  // A merged leaf must stay below its max size, since a full leaf is split right away.
+  int merged_size = sibling->GetSize() + node->GetSize();
+  bool node_deleted = false;
+  if (node->IsLeafPage() ? merged_size < node->GetMaxSize() : merged_size <= node->GetMaxSize()) {
+    node_deleted = index != 0;
+    Coalesce(&sibling, &node, &parent, index, transaction);
+  } else {
+    Redistribute(sibling, node, parent, index);
+  }
+  sibling_page->WUnlatch();
+  buffer_pool_manager_->UnpinPage(sibling_page_id, true);
+  return node_deleted;
 }
 
 /*
@@ -140,6 +467,8 @@ bool BPLUSTREE_TYPE::CoalesceOrRedistribute(N *node, Transaction *transaction) {
  * @param   neighbor_node      sibling page of input "node"
  * @param   node               input from method coalesceOrRedistribute()
  * @param   parent             parent page of input "node"
+ * @param   index              index of "node" in parent, if it is 0 the
+ *                             neighbor is merged into "node" instead
  * @return  true means parent node should be deleted, false means no deletion
  * happend
  */
@@ -148,7 +477,22 @@ template <typename N>
 bool BPLUSTREE_TYPE::Coalesce(N **neighbor_node, N **node,
                               BPlusTreeInternalPage<KeyType, page_id_t, KeyComparator> **parent, int index,
                               Transaction *transaction) {
-  return false;
+  // Always move the right page into the left one, so that the leaf chain only needs a single update.
+  N *left = *neighbor_node;
+  N *right = *node;
+  int right_index = index;
+  if (index == 0) {
+    std::swap(left, right);
+    right_index = 1;
+  }
+  if constexpr (std::is_same_v<N, LeafPage>) {
+    right->MoveAllTo(left);
+  } else {
+    right->MoveAllTo(left, (*parent)->KeyAt(right_index), &page_pool_);
+  }
+  transaction->AddIntoDeletedPageSet(right->GetPageId());
+  (*parent)->Remove(right_index);
+  return CoalesceOrRedistribute(*parent, transaction);
 }
 
 /*
@@ -159,10 +503,27 @@ bool BPLUSTREE_TYPE::Coalesce(N **neighbor_node, N **node,
  * Using template N to represent either internal page or leaf page.
  * @param   neighbor_node      sibling page of input "node"
  * @param   node               input from method coalesceOrRedistribute()
+ * @param   parent             parent page of both pages, whose separator is updated
  */
 INDEX_TEMPLATE_ARGUMENTS
 template <typename N>
-void BPLUSTREE_TYPE::Redistribute(N *neighbor_node, N *node, int index) {}
+void BPLUSTREE_TYPE::Redistribute(N *neighbor_node, N *node, InternalPage *parent, int index) {
+  if (index == 0) {
+    if constexpr (std::is_same_v<N, LeafPage>) {
+      neighbor_node->MoveFirstToEndOf(node);
+    } else {
+      neighbor_node->MoveFirstToEndOf(node, parent->KeyAt(1), &page_pool_);
+    }
+    parent->SetKeyAt(1, neighbor_node->KeyAt(0));
+  } else {
+    if constexpr (std::is_same_v<N, LeafPage>) {
+      neighbor_node->MoveLastToFrontOf(node);
+    } else {
+      neighbor_node->MoveLastToFrontOf(node, parent->KeyAt(index), &page_pool_);
+    }
+    parent->SetKeyAt(index, node->KeyAt(0));
+  }
+}
 /*
  * Update root page if necessary
  * NOTE: size of root page can be less than min size and this method is only
@@ -170,11 +531,32 @@ void BPLUSTREE_TYPE::Redistribute(N *neighbor_node, N *node, int index) {}
  * case 1: when you delete the last element in root page, but root page still
  * has one last child
  * case 2: when you delete the last element in whole b+ tree
+ * The caller holds root_latch_ in write mode.
  * @return : true means root page should be deleted, false means no deletion
  * happend
  */
 INDEX_TEMPLATE_ARGUMENTS
-bool BPLUSTREE_TYPE::AdjustRoot(BPlusTreePage *old_root_node) { return false; }
+bool BPLUSTREE_TYPE::AdjustRoot(BPlusTreePage *old_root_node) {
+  if (old_root_node->IsLeafPage()) {
+    if (old_root_node->GetSize() > 0) {
+      return false;
+    }
+    root_page_id_ = INVALID_PAGE_ID;
+    UpdateRootPageId(0);
+    return true;
+  }
+  if (old_root_node->GetSize() > 1) {
+    return false;
+  }
+  // The only child can only be reached through the old root, which is write-latched by us.
+  root_page_id_ = reinterpret_cast<InternalPage *>(old_root_node)->RemoveAndReturnOnlyChild();
+  UpdateRootPageId(0);
+  Page *page = FetchPageOrUnswizzle(root_page_id_);
+  BUSTUB_ASSERT(page != nullptr, "new root page must be fetchable");
+  reinterpret_cast<BPlusTreePage *>(page->GetData())->SetParentPageId(INVALID_PAGE_ID);
+  buffer_pool_manager_->UnpinPage(root_page_id_, true);
+  return true;
+}
 
 /*****************************************************************************
  * INDEX ITERATOR
@@ -185,7 +567,10 @@ bool BPLUSTREE_TYPE::AdjustRoot(BPlusTreePage *old_root_node) { return false; }
  * @return : index iterator
  */
 INDEX_TEMPLATE_ARGUMENTS
-INDEXITERATOR_TYPE BPLUSTREE_TYPE::Begin() { return INDEXITERATOR_TYPE(); }
+INDEXITERATOR_TYPE BPLUSTREE_TYPE::Begin() {
+  KeyType key{};
+  return INDEXITERATOR_TYPE(buffer_pool_manager_, FindLeafPage(key, true, Operation::SEARCH), 0);
+}
 
 /*
  * Input parameter is low key, find the leaf page that contains the input key
@@ -193,7 +578,14 @@ INDEXITERATOR_TYPE BPLUSTREE_TYPE::Begin() { return INDEXITERATOR_TYPE(); }
  * @return : index iterator
  */
 INDEX_TEMPLATE_ARGUMENTS
-INDEXITERATOR_TYPE BPLUSTREE_TYPE::Begin(const KeyType &key) { return INDEXITERATOR_TYPE(); }
+INDEXITERATOR_TYPE BPLUSTREE_TYPE::Begin(const KeyType &key) {
+  Page *page = FindLeafPage(key, false, Operation::SEARCH);
+  if (page == nullptr) {
+    return INDEXITERATOR_TYPE();
+  }
+  int index = reinterpret_cast<LeafPage *>(page->GetData())->KeyIndex(key, comparator_);
+  return INDEXITERATOR_TYPE(buffer_pool_manager_, page, index);
+}
 
 /*
  * Input parameter is void, construct an index iterator representing the end
@@ -209,15 +601,403 @@ INDEXITERATOR_TYPE BPLUSTREE_TYPE::End() { return INDEXITERATOR_TYPE(); }
 /*
  * Find leaf page containing particular key, if leftMost flag == true, find
  * the left most leaf page
+ * @return : the leaf page, pinned and read-latched, or nullptr if the tree is empty
  */
 INDEX_TEMPLATE_ARGUMENTS
 Page *BPLUSTREE_TYPE::FindLeafPage(const KeyType &key, bool leftMost) {
-  throw Exception(ExceptionType::NOT_IMPLEMENTED, "Implement this for test");
+  return FindLeafPage(key, leftMost, Operation::SEARCH);
 }
 
 /*
- * Update/Insert root page id in header page(where page_id = 0, header_page is
- * defined under include/page/header_page.h)
+ * Descend to a leaf by read latch crabbing. The leaf itself is write-latched
+ * unless op is a search. The optimistic descent is tried first, a few times.
+ * @return : the leaf page, pinned and latched, or nullptr if the tree is empty
+ */
+INDEX_TEMPLATE_ARGUMENTS
+Page *BPLUSTREE_TYPE::FindLeafPage(const KeyType &key, bool left_most, Operation op) {
+  // Garbage keys read from a page that is being written could send other comparators out of the page.
+  if (comparator_.IsNormalized()) {
+    for (int attempt = 0; attempt < MAX_OPTIMISTIC_DESCENTS; attempt++) {
+      Page *leaf;
+      if (FindLeafPageOptimistic(key, left_most, op, &leaf)) {
+        return leaf;
+      }
+    }
+  }
+  root_latch_.RLock();
+  if (root_page_id_ == INVALID_PAGE_ID) {
+    root_latch_.RUnlock();
+    return nullptr;
+  }
+  bool pinned;
+  Page *page = FetchForDescent(root_page_id_, op, &pinned);
+  BUSTUB_ASSERT(page != nullptr, "root page must be fetchable");
+  root_latch_.RUnlock();
+
+  auto *node = reinterpret_cast<BPlusTreePage *>(page->GetData());
+  // Internal pages are swizzled once they are latched, leaves always stay pinned for the caller.
+  if (pinned && !node->IsLeafPage()) {
+    pinned = !TrySwizzle(page);
+  }
+  while (!node->IsLeafPage()) {
+    auto *internal = reinterpret_cast<InternalPage *>(node);
+    page_id_t child_page_id = left_most ? internal->ValueAt(0) : internal->Lookup(key, comparator_);
+    bool child_pinned;
+    Page *child = FetchForDescent(child_page_id, op, &child_pinned);
+    BUSTUB_ASSERT(child != nullptr, "child page must be fetchable");
+    if (child_pinned && !reinterpret_cast<BPlusTreePage *>(child->GetData())->IsLeafPage()) {
+      child_pinned = !TrySwizzle(child);
+    }
+    page->RUnlatch();
+    if (pinned) {
+      buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
+    }
+    page = child;
+    pinned = child_pinned;
+    node = reinterpret_cast<BPlusTreePage *>(page->GetData());
+  }
+  return page;
+}
+
+/*
+ * Optimistic lock coupling: the child page id read from a page is only used once
+ * the version of the page validates, and the page is only let go once the version
+ * of the child has been read, so the next validation covers every change to the
+ * child since. The leaf is latched and then checked against its parent's version,
+ * which changes whenever the leaf is split or merged away.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+bool BPLUSTREE_TYPE::FindLeafPageOptimistic(const KeyType &key, bool left_most, Operation op, Page **leaf) {
+  auto release = [this](Page *page, bool pinned) {
+    if (pinned) {
+      buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
+    }
+  };
+
+  root_latch_.RLock();
+  if (root_page_id_ == INVALID_PAGE_ID) {
+    root_latch_.RUnlock();
+    *leaf = nullptr;
+    return true;
+  }
+  page_id_t page_id = root_page_id_;
+  uint64_t version;
+  Page *page = GetSwizzled(page_id, &version);
+  bool pinned = page == nullptr;
+  if (pinned) {
+    page = FetchPageOrUnswizzle(page_id);
+    BUSTUB_ASSERT(page != nullptr, "root page must be fetchable");
+    if (reinterpret_cast<BPlusTreePage *>(page->GetData())->IsLeafPage()) {
+      LatchForDescent(page, op);
+      root_latch_.RUnlock();
+      *leaf = page;
+      return true;
+    }
+    // a root that is read before root_latch_ is released is still the root, or its version changes
+    version = page->ReadOptimistic();
+  }
+  root_latch_.RUnlock();
+
+  while (true) {
+    if (!pinned && !HoldsInternalPage(page, page_id)) {
+      return false;
+    }
+    auto *internal = reinterpret_cast<InternalPage *>(page->GetData());
+    page_id_t child_page_id = left_most ? internal->ValueAt(0) : internal->Lookup(key, comparator_);
+    if (!page->Validate(version)) {
+      release(page, pinned);
+      return false;
+    }
+    // a swizzled child is an internal page, HoldsInternalPage() checks it before it is searched
+    uint64_t child_version;
+    Page *child = GetSwizzled(child_page_id, &child_version);
+    bool child_pinned = child == nullptr;
+    if (child_pinned) {
+      child = FetchPageOrUnswizzle(child_page_id);
+      BUSTUB_ASSERT(child != nullptr, "child page must be fetchable");
+      if (reinterpret_cast<BPlusTreePage *>(child->GetData())->IsLeafPage()) {
+        LatchForDescent(child, op);
+        bool valid = page->Validate(version);
+        release(page, pinned);
+        if (!valid) {
+          op == Operation::SEARCH ? child->RUnlatch() : child->WUnlatch();
+          release(child, child_pinned);
+          return false;
+        }
+        *leaf = child;
+        return true;
+      }
+      // The page is swizzled under its latch, which its deletion has to wait for.
+      child->RLatch();
+      child_version = child->ReadOptimistic();
+      if (page->Validate(version)) {
+        child_pinned = !TrySwizzle(child);
+      }
+      child->RUnlatch();
+    }
+    bool valid = page->Validate(version);
+    release(page, pinned);
+    if (!valid) {
+      release(child, child_pinned);
+      return false;
+    }
+    page = child;
+    page_id = child_page_id;
+    pinned = child_pinned;
+    version = child_version;
+  }
+}
+
+/*
+ * The type of a page never changes while it is part of the tree, and it cannot
+ * leave the tree while its parent (or root_latch_ for the root) is latched, so it
+ * is safe to inspect before latching the page.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::LatchForDescent(Page *page, Operation op) {
+  if (op != Operation::SEARCH && reinterpret_cast<BPlusTreePage *>(page->GetData())->IsLeafPage()) {
+    page->WLatch();
+  } else {
+    page->RLatch();
+  }
+}
+
+/*
+ * Descend to a leaf by write latch crabbing. Every latched page is added to the
+ * transaction's page set, with a nullptr standing for root_latch_. Whenever a
+ * page is safe for op, the latches of all its ancestors are released.
+ * @return : the leaf page, or nullptr if the tree is empty, in which case
+ * root_latch_ is still held
+ */
+INDEX_TEMPLATE_ARGUMENTS
+Page *BPLUSTREE_TYPE::FindLeafPageExclusive(const KeyType &key, Operation op, Transaction *transaction) {
+  root_latch_.WLock();
+  transaction->AddIntoPageSet(nullptr);
+  if (root_page_id_ == INVALID_PAGE_ID) {
+    return nullptr;
+  }
+
+  page_id_t page_id = root_page_id_;
+  bool is_root = true;
+  while (true) {
+    Page *page = FetchPageOrUnswizzle(page_id);
+    BUSTUB_ASSERT(page != nullptr, "tree page must be fetchable");
+    page->WLatch();
+    auto *node = reinterpret_cast<BPlusTreePage *>(page->GetData());
+    if (IsSafe(node, op, is_root)) {
+      ReleaseLatches(transaction, false);
+    }
+    transaction->AddIntoPageSet(page);
+    if (node->IsLeafPage()) {
+      return page;
+    }
+    page_id = reinterpret_cast<InternalPage *>(node)->Lookup(key, comparator_);
+    is_root = false;
+  }
+}
+
+/*
+ * A swizzled page is only used while its version validates, and a latched one
+ * only if its version validates once it is latched.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+Page *BPLUSTREE_TYPE::FetchForDescent(page_id_t page_id, Operation op, bool *pinned) {
+  uint64_t version;
+  Page *page = GetSwizzled(page_id, &version);
+  // A frame that was unswizzled since may hold another page by now, whose latch must not be waited for.
+  if (page != nullptr && page->TryRLatch()) {
+    if (page->Validate(version)) {
+      *pinned = false;
+      return page;
+    }
+    page->RUnlatch();
+  }
+  *pinned = true;
+  page = FetchPageOrUnswizzle(page_id);
+  if (page != nullptr) {
+    LatchForDescent(page, op);
+  }
+  return page;
+}
+
+/*
+ * Swizzled pages cannot be evicted while they are in the swizzle table, since
+ * the table holds a pin on them. A page leaves the table while it is write-
+ * latched, both when it is unswizzled and when it leaves the tree, which
+ * changes its version before the frame is unpinned. The version is read here
+ * before the table is checked again, so a frame that is reused later fails
+ * the validation of this version.
+ *
+ * An optimistic descent latches no parents, so a swizzled page can still be
+ * deleted, and its frame handed to any other page, while a descent is on its
+ * way to it. The descent follows a child page id only after the parent's
+ * version validates past reading the child's version: the child was still in
+ * the tree when its version was read. Until the child is validated itself, the
+ * descent may search a frame that holds another page, HoldsInternalPage() and
+ * the bounded search of InternalPage::Lookup() keep it within the frame.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+Page *BPLUSTREE_TYPE::GetSwizzled(page_id_t page_id, uint64_t *version) const {
+  if (swizzle_table_ == nullptr) {
+    return nullptr;
+  }
+  Page *page = swizzle_table_->Get(page_id);
+  if (page == nullptr || !page->TryReadOptimistic(version)) {
+    return nullptr;
+  }
+  return swizzle_table_->Get(page_id) == page ? page : nullptr;
+}
+
+/*
+ * A page that the caller, or anybody else, has latched stays swizzled. Trying
+ * the latch never waits, so pages can be unswizzled while latches are held.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+bool BPLUSTREE_TYPE::UnswizzleUnlatched() {
+  if (swizzle_table_ == nullptr) {
+    return false;
+  }
+  bool unswizzled = false;
+  swizzle_table_->ForEach([&](page_id_t page_id, Page *page) {
+    if (!page->TryWLatch()) {
+      return;
+    }
+    // the frame may have been unswizzled and reused since it was read from the table
+    bool removed = swizzle_table_->Remove(page_id, page);
+    page->WUnlatch();
+    if (removed) {
+      num_swizzled_pages_--;
+      buffer_pool_manager_->UnpinPage(page_id, false);
+      unswizzled = true;
+    }
+  });
+  return unswizzled;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+Page *BPLUSTREE_TYPE::FetchPageOrUnswizzle(page_id_t page_id) {
+  Page *page = buffer_pool_manager_->FetchPage(page_id);
+  if (page == nullptr && UnswizzleUnlatched()) {
+    page = buffer_pool_manager_->FetchPage(page_id);
+  }
+  return page;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+Page *BPLUSTREE_TYPE::NewPageOrUnswizzle(page_id_t *page_id) {
+  Page *page = buffer_pool_manager_->NewPage(page_id);
+  if (page == nullptr && UnswizzleUnlatched()) {
+    page = buffer_pool_manager_->NewPage(page_id);
+  }
+  return page;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+bool BPLUSTREE_TYPE::HoldsInternalPage(Page *page, page_id_t page_id) const {
+  auto *node = reinterpret_cast<BPlusTreePage *>(page->GetData());
+  int size = node->GetSize();
+  return node->GetPageId() == page_id && !node->IsLeafPage() && size >= 1 && size <= internal_max_size_ + 1;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+bool BPLUSTREE_TYPE::TrySwizzle(Page *page) {
+  if (swizzle_table_ == nullptr || num_swizzled_pages_.load(std::memory_order_relaxed) >= max_swizzled_pages_) {
+    return false;
+  }
+  if (num_swizzled_pages_.fetch_add(1) >= max_swizzled_pages_) {
+    num_swizzled_pages_--;
+    return false;
+  }
+  // another descent may have swizzled the page since it was fetched
+  if (!swizzle_table_->Install(page->GetPageId(), page)) {
+    num_swizzled_pages_--;
+    return false;
+  }
+  return true;
+}
+
+/*
+ * A page is safe for an operation if the operation cannot propagate a split or
+ * a merge to its parent.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+bool BPLUSTREE_TYPE::IsSafe(BPlusTreePage *node, Operation op, bool is_root) const {
+  switch (op) {
+    case Operation::SEARCH:
+      return true;
+    case Operation::INSERT:
+      // A leaf splits as soon as it becomes full, an internal page once it overflows.
+      return node->IsLeafPage() ? node->GetSize() + 1 < node->GetMaxSize() : node->GetSize() < node->GetMaxSize();
+    case Operation::REMOVE:
+      if (is_root) {
+        return node->GetSize() > (node->IsLeafPage() ? 1 : 2);
+      }
+      return node->GetSize() > node->GetMinSize();
+  }
+  return false;
+}
+
+/*
+ * Release every latch in the transaction's page set, in top-down order, and
+ * unpin the pages.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::ReleaseLatches(Transaction *transaction, bool is_dirty) {
+  auto page_set = transaction->GetPageSet();
+  for (Page *page : *page_set) {
+    if (page == nullptr) {
+      root_latch_.WUnlock();
+    } else {
+      page->WUnlatch();
+      buffer_pool_manager_->UnpinPage(page->GetPageId(), is_dirty);
+    }
+  }
+  page_set->clear();
+}
+
+/*
+ * Delete the pages emptied by a merge, after their latches have been released.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::DeletePages(Transaction *transaction) {
+  auto deleted_page_set = transaction->GetDeletedPageSet();
+  for (page_id_t page_id : *deleted_page_set) {
+    // a descent still on its way to the page through the swizzle table fails to validate its version
+    if (swizzle_table_ != nullptr && swizzle_table_->Remove(page_id) != nullptr) {
+      num_swizzled_pages_--;
+      buffer_pool_manager_->UnpinPage(page_id, false);
+    }
+    buffer_pool_manager_->DeletePage(page_id);
+  }
+  deleted_page_set->clear();
+}
+
+/*
+ * Find the parent of a page write-latched by FindLeafPageExclusive().
+ * @param   parent      set to the parent, or nullptr if the page is the root
+ * @return : false if the parent is not latched because the page was safe for
+ * the operation, then the page can not propagate any change upwards
+ */
+INDEX_TEMPLATE_ARGUMENTS
+bool BPLUSTREE_TYPE::FindParent(BPlusTreePage *node, Transaction *transaction, InternalPage **parent) const {
+  auto page_set = transaction->GetPageSet();
+  for (auto it = page_set->begin(); it != page_set->end(); ++it) {
+    if (*it != nullptr && (*it)->GetPageId() == node->GetPageId()) {
+      if (it == page_set->begin()) {
+        return false;
+      }
+      Page *parent_page = *std::prev(it);
+      *parent = parent_page == nullptr ? nullptr : reinterpret_cast<InternalPage *>(parent_page->GetData());
+      return true;
+    }
+  }
+  UNREACHABLE("page is not latched");
+}
+
+/*
+ * Update/Insert root page id in header page(where page_id = 0 unless another
+ * header page is given to the constructor, header_page is defined under
+ * include/page/header_page.h)
  * Call this method everytime root page id is changed.
  * @parameter: insert_record      defualt value is false. When set to true,
  * insert a record <index_name, root_page_id> into header page instead of
@@ -225,15 +1005,21 @@ Page *BPLUSTREE_TYPE::FindLeafPage(const KeyType &key, bool leftMost) {
  */
 INDEX_TEMPLATE_ARGUMENTS
 void BPLUSTREE_TYPE::UpdateRootPageId(int insert_record) {
-  HeaderPage *header_page = static_cast<HeaderPage *>(buffer_pool_manager_->FetchPage(HEADER_PAGE_ID));
+  HeaderPage *header_page = static_cast<HeaderPage *>(buffer_pool_manager_->FetchPage(header_page_id_));
+  // the header page is shared by every index in the database
+  header_page->WLatch();
   if (insert_record != 0) {
-    // create a new record<index_name + root_page_id> in header_page
-    header_page->InsertRecord(index_name_, root_page_id_);
+    // create a new record<index_name + root_page_id> in header_page, the
+    // record survives if the tree has been emptied before
+    if (!header_page->InsertRecord(index_name_, root_page_id_)) {
+      header_page->UpdateRecord(index_name_, root_page_id_);
+    }
   } else {
     // update root_page_id in header_page
     header_page->UpdateRecord(index_name_, root_page_id_);
   }
-  buffer_pool_manager_->UnpinPage(HEADER_PAGE_ID, true);
+  header_page->WUnlatch();
+  buffer_pool_manager_->UnpinPage(header_page_id_, true);
 }
 
 /*
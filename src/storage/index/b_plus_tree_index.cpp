@@ -11,7 +11,29 @@
 
 #include "storage/index/b_plus_tree_index.h"
 
+#include <algorithm>
+#include <thread>  // NOLINT
+#include <utility>
+
+#include "common/exception.h"
+#include "storage/page/header_page.h"
+
 namespace bustub {
+/*
+ * Allocate an empty header page. Page 0 is not reserved for the database
+ * header, so every index records its root page id in a header page of its own.
+ */
+static page_id_t NewHeaderPage(BufferPoolManager *buffer_pool_manager) {
+  page_id_t page_id;
+  auto *header_page = static_cast<HeaderPage *>(buffer_pool_manager->NewPage(&page_id));
+  if (header_page == nullptr) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "cannot allocate the index header page");
+  }
+  header_page->Init();
+  buffer_pool_manager->UnpinPage(page_id, true);
+  return page_id;
+}
+
 /*
  * Constructor
  */
@@ -19,13 +41,15 @@ INDEX_TEMPLATE_ARGUMENTS
 BPLUSTREE_INDEX_TYPE::BPlusTreeIndex(std::unique_ptr<IndexMetadata> &&metadata, BufferPoolManager *buffer_pool_manager)
     : Index(std::move(metadata)),
       comparator_(GetMetadata()->GetKeySchema()),
-      container_(GetMetadata()->GetName(), buffer_pool_manager, comparator_) {}
+      header_page_id_(NewHeaderPage(buffer_pool_manager)),
+      container_(GetMetadata()->GetName(), buffer_pool_manager, comparator_, LEAF_PAGE_SIZE, INTERNAL_PAGE_SIZE,
+                 header_page_id_) {}
 
 INDEX_TEMPLATE_ARGUMENTS
 void BPLUSTREE_INDEX_TYPE::InsertEntry(const Tuple &key, RID rid, Transaction *transaction) {
   // construct insert index key
   KeyType index_key;
-  index_key.SetFromKey(key);
+  index_key.SetFromKey(key, GetKeySchema());
 
   container_.Insert(index_key, rid, transaction);
 }
@@ -34,7 +58,7 @@ INDEX_TEMPLATE_ARGUMENTS
 void BPLUSTREE_INDEX_TYPE::DeleteEntry(const Tuple &key, RID rid, Transaction *transaction) {
   // construct delete index key
   KeyType index_key;
-  index_key.SetFromKey(key);
+  index_key.SetFromKey(key, GetKeySchema());
 
   container_.Remove(index_key, transaction);
 }
@@ -43,11 +67,81 @@ INDEX_TEMPLATE_ARGUMENTS
 void BPLUSTREE_INDEX_TYPE::ScanKey(const Tuple &key, std::vector<RID> *result, Transaction *transaction) {
   // construct scan index key
   KeyType index_key;
-  index_key.SetFromKey(key);
+  index_key.SetFromKey(key, GetKeySchema());
 
   container_.GetValue(index_key, result, transaction);
 }
 
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_INDEX_TYPE::BulkLoad(TableHeap *table_heap, const Schema &tuple_schema, double fill_factor,
+                                    size_t num_threads, Transaction *transaction) {
+  std::vector<page_id_t> page_ids;
+  table_heap->GetPageIds(&page_ids);
+  num_threads = std::max<size_t>(1, std::min(num_threads, page_ids.size()));
+  // With logging on, reading a tuple takes a shared lock for the transaction and may abort it. The lock sets
+  // and the state of a transaction are not thread safe, so the table is scanned by this thread alone.
+  if (enable_logging) {
+    num_threads = 1;
+  }
+  auto less = [this](const MappingType &lhs, const MappingType &rhs) { return comparator_(lhs.first, rhs.first) < 0; };
+
+  // Every thread sorts the pairs of a contiguous range of pages into a run. Stable sorts and merges keep
+  // pairs with equal keys in table order.
+  std::vector<std::vector<MappingType>> runs(num_threads);
+  auto build_run = [&](size_t part) {
+    std::vector<Tuple> tuples;
+    auto &run = runs[part];
+    size_t end = page_ids.size() * (part + 1) / num_threads;
+    for (size_t i = page_ids.size() * part / num_threads; i < end; i++) {
+      tuples.clear();
+      table_heap->GetPageTuples(page_ids[i], &tuples, transaction);
+      for (auto &tuple : tuples) {
+        KeyType index_key;
+        index_key.SetFromKey(tuple.KeyFromTuple(tuple_schema, *GetKeySchema(), GetKeyAttrs()), GetKeySchema());
+        run.emplace_back(index_key, tuple.GetRid());
+      }
+    }
+    std::stable_sort(run.begin(), run.end(), less);
+  };
+  std::vector<std::thread> threads;
+  for (size_t part = 1; part < num_threads; part++) {
+    threads.emplace_back(build_run, part);
+  }
+  build_run(0);
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  std::vector<MappingType> items;
+  std::vector<size_t> run_begins;
+  for (auto &run : runs) {
+    run_begins.push_back(items.size());
+    items.insert(items.end(), run.begin(), run.end());
+    std::vector<MappingType>().swap(run);
+  }
+  run_begins.push_back(items.size());
+  // Merge neighbouring runs pairwise until one run is left.
+  while (run_begins.size() > 2) {
+    std::vector<size_t> merged_begins;
+    for (size_t i = 0; i + 1 < run_begins.size(); i += 2) {
+      merged_begins.push_back(run_begins[i]);
+      if (i + 2 < run_begins.size()) {
+        std::inplace_merge(items.begin() + run_begins[i], items.begin() + run_begins[i + 1],
+                           items.begin() + run_begins[i + 2], less);
+      }
+    }
+    merged_begins.push_back(items.size());
+    run_begins = std::move(merged_begins);
+  }
+  items.erase(std::unique(items.begin(), items.end(),
+                          [this](const MappingType &lhs, const MappingType &rhs) {
+                            return comparator_(lhs.first, rhs.first) == 0;
+                          }),
+              items.end());
+
+  container_.BulkLoad(items, fill_factor);
+}
+
 INDEX_TEMPLATE_ARGUMENTS
 INDEXITERATOR_TYPE BPLUSTREE_INDEX_TYPE::GetBeginIterator() { return container_.Begin(); }
 
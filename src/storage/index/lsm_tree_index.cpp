@@ -0,0 +1,49 @@
+#include <vector>
+
+#include "storage/index/generic_key.h"
+#include "storage/index/lsm_tree_index.h"
+
+namespace bustub {
+/*
+ * Constructor
+ */
+template <typename KeyType, typename ValueType, typename KeyComparator>
+LSM_TREE_INDEX_TYPE::LSMTreeIndex(std::unique_ptr<IndexMetadata> &&metadata, BufferPoolManager *buffer_pool_manager,
+                                  const HashFunction<KeyType> &hash_fn)
+    : Index(std::move(metadata)),
+      comparator_(GetMetadata()->GetKeySchema()),
+      container_(GetMetadata()->GetName(), buffer_pool_manager, comparator_, hash_fn) {}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void LSM_TREE_INDEX_TYPE::InsertEntry(const Tuple &key, RID rid, Transaction *transaction) {
+  // construct insert index key
+  KeyType index_key;
+  index_key.SetFromKey(key, GetKeySchema());
+
+  container_.Insert(index_key, rid);
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void LSM_TREE_INDEX_TYPE::DeleteEntry(const Tuple &key, RID rid, Transaction *transaction) {
+  // construct delete index key
+  KeyType index_key;
+  index_key.SetFromKey(key, GetKeySchema());
+
+  container_.Remove(index_key, rid);
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void LSM_TREE_INDEX_TYPE::ScanKey(const Tuple &key, std::vector<RID> *result, Transaction *transaction) {
+  // construct scan index key
+  KeyType index_key;
+  index_key.SetFromKey(key, GetKeySchema());
+
+  container_.GetValue(index_key, result);
+}
+template class LSMTreeIndex<GenericKey<4>, RID, GenericComparator<4>>;
+template class LSMTreeIndex<GenericKey<8>, RID, GenericComparator<8>>;
+template class LSMTreeIndex<GenericKey<16>, RID, GenericComparator<16>>;
+template class LSMTreeIndex<GenericKey<32>, RID, GenericComparator<32>>;
+template class LSMTreeIndex<GenericKey<64>, RID, GenericComparator<64>>;
+
+}  // namespace bustub
@@ -0,0 +1,420 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// varlen_b_plus_tree.cpp
+//
+// Identification: src/storage/index/varlen_b_plus_tree.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "common/exception.h"
+#include "storage/index/varlen_b_plus_tree.h"
+#include "storage/page/header_page.h"
+
+namespace bustub {
+
+static_assert(sizeof(VarlenBPlusTreePage<RID>) == PAGE_SIZE, "a leaf page must fill a page exactly");
+static_assert(sizeof(VarlenBPlusTreePage<page_id_t>) == PAGE_SIZE, "an internal page must fill a page exactly");
+
+VarlenBPlusTree::VarlenBPlusTree(std::string name, BufferPoolManager *buffer_pool_manager, page_id_t header_page_id)
+    : index_name_(std::move(name)),
+      root_page_id_(INVALID_PAGE_ID),
+      buffer_pool_manager_(buffer_pool_manager),
+      header_page_id_(header_page_id) {}
+
+bool VarlenBPlusTree::IsEmpty() {
+  tree_latch_.RLock();
+  bool empty = root_page_id_ == INVALID_PAGE_ID;
+  tree_latch_.RUnlock();
+  return empty;
+}
+
+/*****************************************************************************
+ * SEARCH
+ *****************************************************************************/
+bool VarlenBPlusTree::GetValue(const std::string &key, std::vector<RID> *result) {
+  tree_latch_.RLock();
+  if (root_page_id_ == INVALID_PAGE_ID) {
+    tree_latch_.RUnlock();
+    return false;
+  }
+  Path path;
+  auto *leaf = reinterpret_cast<LeafPage *>(FindLeafPage(key, &path)->GetData());
+  bool found;
+  int index = leaf->KeyIndex(key, &found);
+  if (found) {
+    result->push_back(leaf->ValueAt(index));
+  }
+  ReleasePath(&path, false);
+  tree_latch_.RUnlock();
+  return found;
+}
+
+int VarlenBPlusTree::GetHeight() {
+  tree_latch_.RLock();
+  int height = 0;
+  page_id_t page_id = root_page_id_;
+  while (page_id != INVALID_PAGE_ID) {
+    height++;
+    auto *node = reinterpret_cast<BPlusTreePage *>(buffer_pool_manager_->FetchPage(page_id)->GetData());
+    page_id_t child = INVALID_PAGE_ID;
+    if (!node->IsLeafPage()) {
+      child = ChildAt(reinterpret_cast<InternalPage *>(node), 0);
+    }
+    buffer_pool_manager_->UnpinPage(page_id, false);
+    page_id = child;
+  }
+  tree_latch_.RUnlock();
+  return height;
+}
+
+/*****************************************************************************
+ * INSERTION
+ *****************************************************************************/
+bool VarlenBPlusTree::Insert(const std::string &key, const RID &value) {
+  if (key.size() > MAX_KEY_SIZE) {
+    throw Exception(ExceptionType::OUT_OF_RANGE, "key is too long for the variable-length key B+ tree");
+  }
+  tree_latch_.WLock();
+  if (root_page_id_ == INVALID_PAGE_ID) {
+    page_id_t page_id;
+    auto *root = reinterpret_cast<LeafPage *>(NewPage(&page_id)->GetData());
+    root->Init(page_id, IndexPageType::LEAF_PAGE, "", nullptr);
+    root->InsertAt(0, key, value);
+    root_page_id_ = page_id;
+    UpdateRootPageId(1);
+    buffer_pool_manager_->UnpinPage(page_id, true);
+    tree_latch_.WUnlock();
+    return true;
+  }
+
+  Path path;
+  auto *leaf = reinterpret_cast<LeafPage *>(FindLeafPage(key, &path)->GetData());
+  bool found;
+  int index = leaf->KeyIndex(key, &found);
+  if (!found && !leaf->InsertAt(index, key, value)) {
+    SplitLeaf(&path, leaf, index, key, value);
+  }
+  ReleasePath(&path, !found);
+  tree_latch_.WUnlock();
+  return !found;
+}
+
+void VarlenBPlusTree::SplitLeaf(Path *path, LeafPage *leaf, int index, const std::string &key, const RID &value) {
+  auto items = GetItems(leaf);
+  items.emplace(items.begin() + index, key, value);
+  std::string lower_fence = leaf->GetLowerFence();
+  std::string upper_fence = leaf->GetUpperFence();
+  const std::string *upper = leaf->HasUpperFence() ? &upper_fence : nullptr;
+
+  // all keys share the prefix of the page, so the rest of the keys weighs the halves
+  std::vector<size_t> left_space(items.size() + 1, 0);
+  for (size_t i = 0; i < items.size(); i++) {
+    left_space[i + 1] = left_space[i] + LeafPage::SpaceFor(items[i].first.size() - leaf->GetPrefixLength());
+  }
+  size_t total = left_space[items.size()];
+  // suffix truncation: within the middle of the page, split where the separator is shortest
+  size_t split = 0;
+  std::string separator;
+  for (size_t m = 1; m < items.size(); m++) {
+    if (left_space[m] * 10 < total * 4 || left_space[m] * 10 > total * 6) {
+      continue;
+    }
+    std::string candidate = ShortestSeparator(items[m - 1].first, items[m].first);
+    if (split == 0 || candidate.size() < separator.size()) {
+      split = m;
+      separator = std::move(candidate);
+    }
+  }
+  if (split == 0) {
+    // a few large keys, split at the middle
+    split = std::upper_bound(left_space.begin() + 1, left_space.end() - 1, total / 2) - left_space.begin();
+    split = std::min(split, items.size() - 1);
+    separator = ShortestSeparator(items[split - 1].first, items[split].first);
+  }
+
+  page_id_t right_page_id;
+  Page *right_page = NewPage(&right_page_id);
+  auto *right = reinterpret_cast<LeafPage *>(right_page->GetData());
+  page_id_t next_page_id = leaf->GetNextPageId();
+  page_id_t leaf_page_id = leaf->GetPageId();
+  BuildPage(right, right_page_id, IndexPageType::LEAF_PAGE, separator, upper,
+            std::vector<std::pair<std::string, RID>>(items.begin() + split, items.end()));
+  right->SetNextPageId(next_page_id);
+  items.resize(split);
+  BuildPage(leaf, leaf_page_id, IndexPageType::LEAF_PAGE, lower_fence, &separator, items);
+  leaf->SetNextPageId(right_page_id);
+  buffer_pool_manager_->UnpinPage(right_page_id, true);
+
+  InsertIntoParent(path, static_cast<int>(path->child_indexes_.size()) - 1, separator, leaf_page_id, right_page_id);
+}
+
+void VarlenBPlusTree::InsertIntoParent(Path *path, int level, const std::string &separator, page_id_t left,
+                                       page_id_t right) {
+  if (level < 0) {
+    page_id_t root_page_id;
+    auto *root = reinterpret_cast<InternalPage *>(NewPage(&root_page_id)->GetData());
+    root->Init(root_page_id, IndexPageType::INTERNAL_PAGE, "", nullptr);
+    root->InsertAt(0, separator, left);
+    root->SetNextPageId(right);
+    root_page_id_ = root_page_id;
+    UpdateRootPageId();
+    buffer_pool_manager_->UnpinPage(root_page_id, true);
+    return;
+  }
+
+  auto *parent = reinterpret_cast<InternalPage *>(path->pages_[level]->GetData());
+  int index = path->child_indexes_[level];
+  // the child at index was split: left stays below the separator, right takes its place above it
+  if (parent->InsertAt(index, separator, left)) {
+    SetChildAt(parent, index + 1, right);
+    return;
+  }
+
+  auto items = GetItems(parent);
+  page_id_t last_child = parent->GetNextPageId();
+  items.emplace(items.begin() + index, separator, left);
+  if (index + 1 < static_cast<int>(items.size())) {
+    items[index + 1].second = right;
+  } else {
+    last_child = right;
+  }
+  std::string lower_fence = parent->GetLowerFence();
+  std::string upper_fence = parent->GetUpperFence();
+  const std::string *upper = parent->HasUpperFence() ? &upper_fence : nullptr;
+
+  // the middle key moves up, its child becomes the last child of the left half
+  size_t total = 0;
+  for (const auto &item : items) {
+    total += InternalPage::SpaceFor(item.first.size() - parent->GetPrefixLength());
+  }
+  size_t split = 0;
+  for (size_t space = 0; split + 1 < items.size(); split++) {
+    space += InternalPage::SpaceFor(items[split].first.size() - parent->GetPrefixLength());
+    if (space * 2 >= total) {
+      break;
+    }
+  }
+  std::string push_up = items[split].first;
+
+  page_id_t parent_page_id = parent->GetPageId();
+  page_id_t right_page_id;
+  auto *right_page = reinterpret_cast<InternalPage *>(NewPage(&right_page_id)->GetData());
+  BuildPage(right_page, right_page_id, IndexPageType::INTERNAL_PAGE, push_up, upper,
+            std::vector<std::pair<std::string, page_id_t>>(items.begin() + split + 1, items.end()));
+  right_page->SetNextPageId(last_child);
+  page_id_t middle_child = items[split].second;
+  items.resize(split);
+  BuildPage(parent, parent_page_id, IndexPageType::INTERNAL_PAGE, lower_fence, &push_up, items);
+  parent->SetNextPageId(middle_child);
+  buffer_pool_manager_->UnpinPage(right_page_id, true);
+
+  InsertIntoParent(path, level - 1, push_up, parent_page_id, right_page_id);
+}
+
+/*****************************************************************************
+ * REMOVE
+ *****************************************************************************/
+void VarlenBPlusTree::Remove(const std::string &key) {
+  tree_latch_.WLock();
+  if (root_page_id_ == INVALID_PAGE_ID) {
+    tree_latch_.WUnlock();
+    return;
+  }
+  Path path;
+  auto *leaf = reinterpret_cast<LeafPage *>(FindLeafPage(key, &path)->GetData());
+  bool found;
+  int index = leaf->KeyIndex(key, &found);
+  if (found) {
+    leaf->RemoveAt(index);
+    CoalesceIfUnderfull(&path, static_cast<int>(path.child_indexes_.size()) - 1, leaf);
+  }
+  ReleasePath(&path, found);
+  tree_latch_.WUnlock();
+}
+
+template <typename N>
+void VarlenBPlusTree::CoalesceIfUnderfull(Path *path, int level, N *node) {
+  if (level < 0) {
+    // the root goes away once it is an empty leaf, or an internal page with a single child
+    if (node->GetSize() == 0) {
+      path->deleted_page_ids_.push_back(node->GetPageId());
+      root_page_id_ = node->IsLeafPage() ? INVALID_PAGE_ID : node->GetNextPageId();
+      UpdateRootPageId();
+    }
+    return;
+  }
+  if (node->GetFreeSpace() * 4 < N::DATA_SIZE * 3) {
+    return;
+  }
+
+  auto *parent = reinterpret_cast<InternalPage *>(path->pages_[level]->GetData());
+  int index = path->child_indexes_[level];
+  // merge with the right sibling, or with the left one if the page is the last child
+  int left_index = index < parent->GetSize() ? index : index - 1;
+  if (left_index < 0) {
+    return;
+  }
+  page_id_t left_page_id = ChildAt(parent, left_index);
+  page_id_t right_page_id = ChildAt(parent, left_index + 1);
+  page_id_t sibling_page_id = left_index == index ? right_page_id : left_page_id;
+  auto *sibling = reinterpret_cast<N *>(buffer_pool_manager_->FetchPage(sibling_page_id)->GetData());
+  N *left = left_index == index ? node : sibling;
+  N *right = left_index == index ? sibling : node;
+
+  auto items = GetItems(left);
+  if (!left->IsLeafPage()) {
+    // the separator comes down between the last child of the left page and the first one of the right page
+    items.emplace_back(parent->KeyAt(left_index), left->GetNextPageId());
+  }
+  for (auto &item : GetItems(right)) {
+    items.push_back(std::move(item));
+  }
+  std::string lower_fence = left->GetLowerFence();
+  std::string upper_fence = right->GetUpperFence();
+  const std::string *upper = right->HasUpperFence() ? &upper_fence : nullptr;
+  if (GetPageSpace(lower_fence, upper, items) > N::DATA_SIZE) {
+    buffer_pool_manager_->UnpinPage(sibling_page_id, false);
+    return;
+  }
+
+  page_id_t next_page_id = right->GetNextPageId();
+  BuildPage(left, left_page_id, left->IsLeafPage() ? IndexPageType::LEAF_PAGE : IndexPageType::INTERNAL_PAGE,
+            lower_fence, upper, items);
+  left->SetNextPageId(next_page_id);
+  path->deleted_page_ids_.push_back(right_page_id);
+  buffer_pool_manager_->UnpinPage(sibling_page_id, true);
+
+  parent->RemoveAt(left_index);
+  SetChildAt(parent, left_index, left_page_id);
+  CoalesceIfUnderfull(path, level - 1, parent);
+}
+
+/*****************************************************************************
+ * UTILITIES AND DEBUG
+ *****************************************************************************/
+Page *VarlenBPlusTree::FindLeafPage(const std::string &key, Path *path) {
+  Page *page = buffer_pool_manager_->FetchPage(root_page_id_);
+  auto *node = reinterpret_cast<BPlusTreePage *>(page->GetData());
+  while (!node->IsLeafPage()) {
+    auto *internal = reinterpret_cast<InternalPage *>(node);
+    int index = ChildIndex(internal, key);
+    path->pages_.push_back(page);
+    path->child_indexes_.push_back(index);
+    page = buffer_pool_manager_->FetchPage(ChildAt(internal, index));
+    node = reinterpret_cast<BPlusTreePage *>(page->GetData());
+  }
+  path->pages_.push_back(page);
+  return page;
+}
+
+void VarlenBPlusTree::ReleasePath(Path *path, bool is_dirty) {
+  for (Page *page : path->pages_) {
+    buffer_pool_manager_->UnpinPage(page->GetPageId(), is_dirty);
+  }
+  for (page_id_t page_id : path->deleted_page_ids_) {
+    buffer_pool_manager_->DeletePage(page_id);
+  }
+}
+
+int VarlenBPlusTree::ChildIndex(const InternalPage *page, const std::string &key) {
+  bool found;
+  int index = page->KeyIndex(key, &found);
+  return found ? index + 1 : index;
+}
+
+page_id_t VarlenBPlusTree::ChildAt(const InternalPage *page, int index) {
+  return index < page->GetSize() ? page->ValueAt(index) : page->GetNextPageId();
+}
+
+void VarlenBPlusTree::SetChildAt(InternalPage *page, int index, page_id_t child) {
+  if (index < page->GetSize()) {
+    page->SetValueAt(index, child);
+  } else {
+    page->SetNextPageId(child);
+  }
+}
+
+template <typename V>
+void VarlenBPlusTree::BuildPage(VarlenBPlusTreePage<V> *page, page_id_t page_id, IndexPageType page_type,
+                                const std::string &lower_fence, const std::string *upper_fence,
+                                const std::vector<std::pair<std::string, V>> &items) {
+  page->Init(page_id, page_type, lower_fence, upper_fence);
+  for (size_t i = 0; i < items.size(); i++) {
+    bool inserted = page->InsertAt(static_cast<int>(i), items[i].first, items[i].second);
+    BUSTUB_ASSERT(inserted, "the keys must fit into the page");
+  }
+}
+
+template <typename V>
+std::vector<std::pair<std::string, V>> VarlenBPlusTree::GetItems(const VarlenBPlusTreePage<V> *page) {
+  std::vector<std::pair<std::string, V>> items;
+  items.reserve(page->GetSize());
+  for (int i = 0; i < page->GetSize(); i++) {
+    items.emplace_back(page->KeyAt(i), page->ValueAt(i));
+  }
+  return items;
+}
+
+template <typename V>
+size_t VarlenBPlusTree::GetPageSpace(const std::string &lower_fence, const std::string *upper_fence,
+                                     const std::vector<std::pair<std::string, V>> &items) {
+  size_t prefix_length = 0;
+  size_t space = lower_fence.size();
+  if (upper_fence != nullptr) {
+    auto mismatch = std::mismatch(lower_fence.begin(), lower_fence.end(), upper_fence->begin(), upper_fence->end());
+    prefix_length = mismatch.first - lower_fence.begin();
+    space += upper_fence->size();
+  }
+  for (const auto &item : items) {
+    space += VarlenBPlusTreePage<V>::SpaceFor(item.first.size() - prefix_length);
+  }
+  return space;
+}
+
+std::string VarlenBPlusTree::ShortestSeparator(const std::string &lhs, const std::string &rhs) {
+  auto mismatch = std::mismatch(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+  return rhs.substr(0, mismatch.second - rhs.begin() + 1);
+}
+
+Page *VarlenBPlusTree::NewPage(page_id_t *page_id) {
+  Page *page = buffer_pool_manager_->NewPage(page_id);
+  if (page == nullptr) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "cannot allocate a new B+ tree page");
+  }
+  return page;
+}
+
+/*
+ * Update/Insert root page id in header page(where page_id = 0, header_page is
+ * defined under include/page/header_page.h)
+ * Call this method everytime root page id is changed.
+ * @parameter: insert_record      default value is false. When set to true,
+ * insert a record <index_name, root_page_id> into header page instead of
+ * updating it.
+ */
+void VarlenBPlusTree::UpdateRootPageId(int insert_record) {
+  HeaderPage *header_page = static_cast<HeaderPage *>(buffer_pool_manager_->FetchPage(header_page_id_));
+  // the header page is shared by every index in the database
+  header_page->WLatch();
+  if (insert_record != 0) {
+    // the record survives if the tree has been emptied before
+    if (!header_page->InsertRecord(index_name_, root_page_id_)) {
+      header_page->UpdateRecord(index_name_, root_page_id_);
+    }
+  } else {
+    header_page->UpdateRecord(index_name_, root_page_id_);
+  }
+  header_page->WUnlatch();
+  buffer_pool_manager_->UnpinPage(header_page_id_, true);
+}
+
+}  // namespace bustub
@@ -0,0 +1,106 @@
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "storage/index/varlen_b_plus_tree_index.h"
+
+namespace bustub {
+
+namespace {
+
+void AppendBigEndian(std::string *key, uint64_t bits, size_t size) {
+  for (size_t i = 0; i < size; i++) {
+    key->push_back(static_cast<char>(bits >> (8 * (size - 1 - i))));
+  }
+}
+
+template <typename S>
+void AppendSigned(std::string *key, const Value &value) {
+  auto bits = static_cast<uint64_t>(static_cast<int64_t>(value.GetAs<S>()));
+  AppendBigEndian(key, bits ^ (1ULL << (8 * sizeof(S) - 1)), sizeof(S));
+}
+
+}  // namespace
+
+/*
+ * Constructor
+ */
+VarlenBPlusTreeIndex::VarlenBPlusTreeIndex(std::unique_ptr<IndexMetadata> &&metadata,
+                                           BufferPoolManager *buffer_pool_manager)
+    : Index(std::move(metadata)), container_(GetMetadata()->GetName(), buffer_pool_manager) {}
+
+void VarlenBPlusTreeIndex::InsertEntry(const Tuple &key, RID rid, Transaction *transaction) {
+  container_.Insert(EncodeKey(key), rid);
+}
+
+void VarlenBPlusTreeIndex::DeleteEntry(const Tuple &key, RID rid, Transaction *transaction) {
+  container_.Remove(EncodeKey(key));
+}
+
+void VarlenBPlusTreeIndex::ScanKey(const Tuple &key, std::vector<RID> *result, Transaction *transaction) {
+  container_.GetValue(EncodeKey(key), result);
+}
+
+std::string VarlenBPlusTreeIndex::EncodeKey(const Tuple &key) const {
+  std::string encoded;
+  const Schema *key_schema = GetKeySchema();
+  uint32_t column_count = key_schema->GetColumnCount();
+  for (uint32_t i = 0; i < column_count; i++) {
+    Value value = key.GetValue(key_schema, i);
+    if (value.IsNull()) {
+      encoded.push_back('\0');
+      continue;
+    }
+    encoded.push_back('\1');
+    switch (value.GetTypeId()) {
+      case TypeId::BOOLEAN:
+      case TypeId::TINYINT:
+        AppendSigned<int8_t>(&encoded, value);
+        break;
+      case TypeId::SMALLINT:
+        AppendSigned<int16_t>(&encoded, value);
+        break;
+      case TypeId::INTEGER:
+        AppendSigned<int32_t>(&encoded, value);
+        break;
+      case TypeId::BIGINT:
+        AppendSigned<int64_t>(&encoded, value);
+        break;
+      case TypeId::DECIMAL: {
+        // -0.0 and 0.0 are equal
+        double number = value.GetAs<double>() == 0 ? 0 : value.GetAs<double>();
+        uint64_t bits;
+        memcpy(&bits, &number, sizeof(double));
+        // Negative numbers order inversely to their magnitude, so all of their bits are flipped.
+        bits = (bits & (1ULL << 63)) != 0 ? ~bits : bits ^ (1ULL << 63);
+        AppendBigEndian(&encoded, bits, sizeof(uint64_t));
+        break;
+      }
+      case TypeId::TIMESTAMP:
+        AppendBigEndian(&encoded, value.GetAs<uint64_t>(), sizeof(uint64_t));
+        break;
+      case TypeId::VARCHAR: {
+        // the length includes the terminating '\0'
+        const char *data = value.GetData();
+        size_t length = value.GetLength() - 1;
+        if (i + 1 == column_count) {
+          encoded.append(data, length);
+          break;
+        }
+        for (size_t j = 0; j < length; j++) {
+          encoded.push_back(data[j]);
+          if (data[j] == '\0') {
+            encoded.push_back('\xff');
+          }
+        }
+        encoded.append(2, '\0');
+        break;
+      }
+      default:
+        UNREACHABLE("Unsupported type.");
+    }
+  }
+  return encoded;
+}
+
+}  // namespace bustub
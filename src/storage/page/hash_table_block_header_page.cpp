@@ -0,0 +1,36 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// hash_table_block_header_page.cpp
+//
+// Identification: src/storage/page/hash_table_block_header_page.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/page/hash_table_block_header_page.h"
+
+namespace bustub {
+page_id_t HashTableBlockHeaderPage::GetPageId() const { return page_id_; }
+
+void HashTableBlockHeaderPage::SetPageId(page_id_t page_id) { page_id_ = page_id; }
+
+lsn_t HashTableBlockHeaderPage::GetLSN() const { return lsn_; }
+
+void HashTableBlockHeaderPage::SetLSN(lsn_t lsn) { lsn_ = lsn; }
+
+uint32_t HashTableBlockHeaderPage::NumBlocks() const { return num_blocks_; }
+
+uint32_t HashTableBlockHeaderPage::MaxBlocks() const { return BLOCK_HEADER_ARRAY_SIZE; }
+
+page_id_t HashTableBlockHeaderPage::GetBlockPageId(uint32_t block_idx) const { return block_page_ids_[block_idx]; }
+
+void HashTableBlockHeaderPage::AddBlockPageId(page_id_t block_page_id) {
+  block_page_ids_[num_blocks_++] = block_page_id;
+}
+
+static_assert(sizeof(HashTableBlockHeaderPage) <= PAGE_SIZE);
+
+}  // namespace bustub
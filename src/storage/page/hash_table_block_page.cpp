@@ -0,0 +1,80 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// hash_table_block_page.cpp
+//
+// Identification: src/storage/page/hash_table_block_page.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/page/hash_table_block_page.h"
+
+#include <cstring>
+
+#include "storage/index/generic_key.h"
+
+namespace bustub {
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void HASH_TABLE_BLOCK_TYPE::Init() {
+  overflow_page_id_ = INVALID_PAGE_ID;
+  memset(occupied_, 0, sizeof(occupied_));
+  memset(readable_, 0, sizeof(readable_));
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+KeyType HASH_TABLE_BLOCK_TYPE::KeyAt(slot_offset_t bucket_ind) const {
+  return array_[bucket_ind].first;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+ValueType HASH_TABLE_BLOCK_TYPE::ValueAt(slot_offset_t bucket_ind) const {
+  return array_[bucket_ind].second;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+bool HASH_TABLE_BLOCK_TYPE::Insert(slot_offset_t bucket_ind, const KeyType &key, const ValueType &value) {
+  if (IsReadable(bucket_ind)) {
+    return false;
+  }
+  array_[bucket_ind] = MappingType(key, value);
+  occupied_[bucket_ind / 8] |= static_cast<char>(1 << (bucket_ind % 8));
+  readable_[bucket_ind / 8] |= static_cast<char>(1 << (bucket_ind % 8));
+  return true;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void HASH_TABLE_BLOCK_TYPE::Remove(slot_offset_t bucket_ind) {
+  readable_[bucket_ind / 8] &= static_cast<char>(~(1 << (bucket_ind % 8)));
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+bool HASH_TABLE_BLOCK_TYPE::IsOccupied(slot_offset_t bucket_ind) const {
+  return (occupied_[bucket_ind / 8] & (1 << (bucket_ind % 8))) != 0;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+bool HASH_TABLE_BLOCK_TYPE::IsReadable(slot_offset_t bucket_ind) const {
+  return (readable_[bucket_ind / 8] & (1 << (bucket_ind % 8))) != 0;
+}
+
+// DO NOT REMOVE ANYTHING BELOW THIS LINE
+template class HashTableBlockPage<int, int, IntComparator>;
+
+template class HashTableBlockPage<GenericKey<4>, RID, GenericComparator<4>>;
+template class HashTableBlockPage<GenericKey<8>, RID, GenericComparator<8>>;
+template class HashTableBlockPage<GenericKey<16>, RID, GenericComparator<16>>;
+template class HashTableBlockPage<GenericKey<32>, RID, GenericComparator<32>>;
+template class HashTableBlockPage<GenericKey<64>, RID, GenericComparator<64>>;
+
+static_assert(sizeof(HashTableBlockPage<int, int, IntComparator>) <= PAGE_SIZE);
+static_assert(sizeof(HashTableBlockPage<GenericKey<4>, RID, GenericComparator<4>>) <= PAGE_SIZE);
+static_assert(sizeof(HashTableBlockPage<GenericKey<8>, RID, GenericComparator<8>>) <= PAGE_SIZE);
+static_assert(sizeof(HashTableBlockPage<GenericKey<16>, RID, GenericComparator<16>>) <= PAGE_SIZE);
+static_assert(sizeof(HashTableBlockPage<GenericKey<32>, RID, GenericComparator<32>>) <= PAGE_SIZE);
+static_assert(sizeof(HashTableBlockPage<GenericKey<64>, RID, GenericComparator<64>>) <= PAGE_SIZE);
+
+}  // namespace bustub
@@ -13,8 +13,13 @@
 #include "storage/page/hash_table_bucket_page.h"
 
 #include <algorithm>
+#include <cstring>
 #include <iostream>
 
+#if defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
 #include "common/logger.h"
 #include "common/util/hash_util.h"
 #include "storage/index/generic_key.h"
@@ -24,57 +29,93 @@
 namespace bustub {
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
-bool HASH_TABLE_BUCKET_TYPE::GetValue(KeyType key, KeyComparator cmp, std::vector<ValueType> *result) {
-  for (uint32_t i = 0; i < BUCKET_ARRAY_SIZE; i++) {
-    if (!IsReadable(i)) {
-      if (!IsOccupied(i)) {
-        break;
+void HASH_TABLE_BUCKET_TYPE::Init() {
+  overflow_page_id_ = INVALID_PAGE_ID;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+uint32_t HASH_TABLE_BUCKET_TYPE::ReadableInGroup(uint32_t group_idx) const {
+  uint32_t readable;
+  memcpy(&readable, readable_ + group_idx / 8, sizeof(readable));
+  // slots past BUCKET_ARRAY_SIZE are never readable, so no extra mask is needed for the last group.
+  return readable;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+uint32_t HASH_TABLE_BUCKET_TYPE::MatchInGroup(uint32_t group_idx, uint8_t tag) const {
+  static_assert(BUCKET_GROUP_SIZE == 32, "a group is matched as one 32 bit mask");
+#if defined(__AVX2__)
+  auto tags = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(tags_ + group_idx));
+  auto hits = _mm256_cmpeq_epi8(tags, _mm256_set1_epi8(static_cast<char>(tag)));
+  auto matches = static_cast<uint32_t>(_mm256_movemask_epi8(hits));
+#elif defined(__SSE2__)
+  auto needle = _mm_set1_epi8(static_cast<char>(tag));
+  auto low = _mm_loadu_si128(reinterpret_cast<const __m128i *>(tags_ + group_idx));
+  auto high = _mm_loadu_si128(reinterpret_cast<const __m128i *>(tags_ + group_idx + 16));
+  auto matches = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(low, needle))) |
+                 static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(high, needle))) << 16;
+#else
+  uint32_t matches = 0;
+  for (uint32_t i = 0; i < BUCKET_GROUP_SIZE; i++) {
+    matches |= static_cast<uint32_t>(tags_[group_idx + i] == tag) << i;
+  }
+#endif
+  return matches & ReadableInGroup(group_idx);
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+bool HASH_TABLE_BUCKET_TYPE::GetValue(KeyType key, KeyComparator cmp, std::vector<ValueType> *result, uint8_t tag) {
+  bool found = false;
+  for (uint32_t group_idx = 0; group_idx < BUCKET_ARRAY_SIZE; group_idx += BUCKET_GROUP_SIZE) {
+    for (uint32_t matches = MatchInGroup(group_idx, tag); matches != 0; matches &= matches - 1) {
+      uint32_t i = group_idx + __builtin_ctz(matches);
+      if (cmp(key, KeyAt(i)) == 0) {
+        result->push_back(ValueAt(i));
+        found = true;
       }
-      continue;
-    }
-    if (cmp(key, KeyAt(i)) == 0) {
-      result->push_back(ValueAt(i));
     }
   }
-  return !result->empty();
+  return found;
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
-bool HASH_TABLE_BUCKET_TYPE::Insert(KeyType key, ValueType value, KeyComparator cmp) {
-  if (IsFull()) {
-    return false;
+bool HASH_TABLE_BUCKET_TYPE::Insert(KeyType key, ValueType value, KeyComparator cmp, uint8_t tag) {
+  // reject a duplicate pair, and remember the first free slot on the way.
+  uint32_t free_idx = BUCKET_ARRAY_SIZE;
+  for (uint32_t group_idx = 0; group_idx < BUCKET_ARRAY_SIZE; group_idx += BUCKET_GROUP_SIZE) {
+    for (uint32_t matches = MatchInGroup(group_idx, tag); matches != 0; matches &= matches - 1) {
+      uint32_t i = group_idx + __builtin_ctz(matches);
+      if (cmp(key, KeyAt(i)) == 0 && ValueAt(i) == value) {
+        return false;
+      }
+    }
+    uint32_t free = ~ReadableInGroup(group_idx);
+    if (free_idx == BUCKET_ARRAY_SIZE && free != 0) {
+      free_idx = std::min<uint32_t>(group_idx + __builtin_ctz(free), BUCKET_ARRAY_SIZE);
+    }
   }
-  std::vector<ValueType> result;
-  GetValue(key, cmp, &result);
-  if (std::find(result.cbegin(), result.cend(), value) != result.cend()) {
+  if (free_idx == BUCKET_ARRAY_SIZE) {
     return false;
   }
-
-  for (uint32_t i = 0; i < BUCKET_ARRAY_SIZE; i++) {
-    if (!IsReadable(i)) {
-      array_[i] = MappingType(key, value);
-      SetReadable(i, 1);
-      SetOccupied(i, 1);
-      break;
-    }
-  }
+  array_[free_idx] = MappingType(key, value);
+  tags_[free_idx] = tag;
+  SetReadable(free_idx, 1);
+  SetOccupied(free_idx, 1);
   return true;
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
-bool HASH_TABLE_BUCKET_TYPE::Remove(KeyType key, ValueType value, KeyComparator cmp) {
-  bool success = false;
-  for (uint32_t i = 0; i < BUCKET_ARRAY_SIZE; i++) {
-    if (!IsReadable(i)) {
-      continue;
-    }
-    if (cmp(key, KeyAt(i)) == 0 && ValueAt(i) == value) {
-      SetReadable(i, 0);
-      success = true;
-      break;
+bool HASH_TABLE_BUCKET_TYPE::Remove(KeyType key, ValueType value, KeyComparator cmp, uint8_t tag) {
+  for (uint32_t group_idx = 0; group_idx < BUCKET_ARRAY_SIZE; group_idx += BUCKET_GROUP_SIZE) {
+    for (uint32_t matches = MatchInGroup(group_idx, tag); matches != 0; matches &= matches - 1) {
+      uint32_t i = group_idx + __builtin_ctz(matches);
+      if (cmp(key, KeyAt(i)) == 0 && ValueAt(i) == value) {
+        SetReadable(i, 0);
+        return true;
+      }
     }
   }
-  return success;
+  return false;
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
@@ -87,6 +128,11 @@ ValueType HASH_TABLE_BUCKET_TYPE::ValueAt(uint32_t bucket_idx) const {
   return array_[bucket_idx].second;
 }
 
+template <typename KeyType, typename ValueType, typename KeyComparator>
+uint8_t HASH_TABLE_BUCKET_TYPE::TagAt(uint32_t bucket_idx) const {
+  return tags_[bucket_idx];
+}
+
 template <typename KeyType, typename ValueType, typename KeyComparator>
 void HASH_TABLE_BUCKET_TYPE::RemoveAt(uint32_t bucket_idx) {
   SetOccupied(bucket_idx, 1);
@@ -135,12 +181,8 @@ bool HASH_TABLE_BUCKET_TYPE::IsFull() {
 template <typename KeyType, typename ValueType, typename KeyComparator>
 uint32_t HASH_TABLE_BUCKET_TYPE::NumReadable() {
   uint32_t num_readable = 0;
-  for (int i = 0; i < GetNumofChars(); i++) {
-    uint8_t readable = readable_[i];
-    while (readable != 0) {
-      readable &= (readable - 1);
-      num_readable++;
-    }
+  for (uint32_t group_idx = 0; group_idx < BUCKET_ARRAY_SIZE; group_idx += BUCKET_GROUP_SIZE) {
+    num_readable += __builtin_popcount(ReadableInGroup(group_idx));
   }
   return num_readable;
 }
@@ -168,6 +210,15 @@ void HASH_TABLE_BUCKET_TYPE::PrintBucket() {
   LOG_INFO("Bucket Capacity: %lu, Size: %u, Taken: %u, Free: %u", BUCKET_ARRAY_SIZE, size, taken, free);
 }
 
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void HASH_TABLE_BUCKET_TYPE::Prefetch() const {
+  static constexpr size_t cache_line_size = 64;
+  __builtin_prefetch(readable_);
+  for (size_t offset = 0; offset < sizeof(tags_); offset += cache_line_size) {
+    __builtin_prefetch(tags_ + offset);
+  }
+}
+
 // DO NOT REMOVE ANYTHING BELOW THIS LINE
 template class HashTableBucketPage<int, int, IntComparator>;
 
@@ -179,4 +230,11 @@ template class HashTableBucketPage<GenericKey<64>, RID, GenericComparator<64>>;
 
 // template class HashTableBucketPage<hash_t, TmpTuple, HashComparator>;
 
+static_assert(sizeof(HashTableBucketPage<int, int, IntComparator>) <= PAGE_SIZE);
+static_assert(sizeof(HashTableBucketPage<GenericKey<4>, RID, GenericComparator<4>>) <= PAGE_SIZE);
+static_assert(sizeof(HashTableBucketPage<GenericKey<8>, RID, GenericComparator<8>>) <= PAGE_SIZE);
+static_assert(sizeof(HashTableBucketPage<GenericKey<16>, RID, GenericComparator<16>>) <= PAGE_SIZE);
+static_assert(sizeof(HashTableBucketPage<GenericKey<32>, RID, GenericComparator<32>>) <= PAGE_SIZE);
+static_assert(sizeof(HashTableBucketPage<GenericKey<64>, RID, GenericComparator<64>>) <= PAGE_SIZE);
+
 }  // namespace bustub
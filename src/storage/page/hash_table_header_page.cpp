@@ -0,0 +1,46 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// hash_table_header_page.cpp
+//
+// Identification: src/storage/page/hash_table_header_page.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/page/hash_table_header_page.h"
+
+namespace bustub {
+page_id_t HashTableHeaderPage::GetPageId() const { return page_id_; }
+
+void HashTableHeaderPage::SetPageId(page_id_t page_id) { page_id_ = page_id; }
+
+lsn_t HashTableHeaderPage::GetLSN() const { return lsn_; }
+
+void HashTableHeaderPage::SetLSN(lsn_t lsn) { lsn_ = lsn; }
+
+uint32_t HashTableHeaderPage::GetGlobalDepth() const { return global_depth_; }
+
+uint32_t HashTableHeaderPage::GetGlobalDepthMask() const { return Size() - 1; }
+
+void HashTableHeaderPage::IncrGlobalDepth() { global_depth_++; }
+
+void HashTableHeaderPage::DecrGlobalDepth() { global_depth_--; }
+
+uint32_t HashTableHeaderPage::Size() const { return 1U << global_depth_; }
+
+uint32_t HashTableHeaderPage::MaxSize() const { return DIRECTORY_ARRAY_SIZE * HEADER_ARRAY_SIZE; }
+
+uint32_t HashTableHeaderPage::NumDirectoryPages() const { return (Size() - 1) / DIRECTORY_ARRAY_SIZE + 1; }
+
+page_id_t HashTableHeaderPage::GetDirectoryPageId(uint32_t bucket_idx) const {
+  return directory_page_ids_[bucket_idx / DIRECTORY_ARRAY_SIZE];
+}
+
+void HashTableHeaderPage::SetDirectoryPageId(uint32_t directory_page_idx, page_id_t directory_page_id) {
+  directory_page_ids_[directory_page_idx] = directory_page_id;
+}
+
+}  // namespace bustub
@@ -0,0 +1,58 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// lsm_run_page.cpp
+//
+// Identification: src/storage/page/lsm_run_page.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/page/lsm_run_page.h"
+
+#include "common/rid.h"
+#include "storage/index/generic_key.h"
+
+namespace bustub {
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void LSM_RUN_PAGE_TYPE::Append(const KeyType &key, const ValueType &value, bool is_deleted) {
+  uint32_t index = num_entries_++;
+  array_[index] = std::make_pair(key, value);
+  if (is_deleted) {
+    deleted_[index / 8] |= static_cast<char>(1 << (index % 8));
+  } else {
+    deleted_[index / 8] &= static_cast<char>(~(1 << (index % 8)));
+  }
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+uint32_t LSM_RUN_PAGE_TYPE::LowerBound(const KeyType &key, const KeyComparator &comparator) const {
+  uint32_t low = 0;
+  uint32_t high = num_entries_;
+  while (low < high) {
+    uint32_t mid = low + (high - low) / 2;
+    if (comparator(array_[mid].first, key) < 0) {
+      low = mid + 1;
+    } else {
+      high = mid;
+    }
+  }
+  return low;
+}
+
+template class LSMRunPage<GenericKey<4>, RID, GenericComparator<4>>;
+template class LSMRunPage<GenericKey<8>, RID, GenericComparator<8>>;
+template class LSMRunPage<GenericKey<16>, RID, GenericComparator<16>>;
+template class LSMRunPage<GenericKey<32>, RID, GenericComparator<32>>;
+template class LSMRunPage<GenericKey<64>, RID, GenericComparator<64>>;
+
+static_assert(sizeof(LSMRunPage<GenericKey<4>, RID, GenericComparator<4>>) <= PAGE_SIZE);
+static_assert(sizeof(LSMRunPage<GenericKey<8>, RID, GenericComparator<8>>) <= PAGE_SIZE);
+static_assert(sizeof(LSMRunPage<GenericKey<16>, RID, GenericComparator<16>>) <= PAGE_SIZE);
+static_assert(sizeof(LSMRunPage<GenericKey<32>, RID, GenericComparator<32>>) <= PAGE_SIZE);
+static_assert(sizeof(LSMRunPage<GenericKey<64>, RID, GenericComparator<64>>) <= PAGE_SIZE);
+
+}  // namespace bustub
@@ -169,6 +169,69 @@ bool TableHeap::GetTuple(const RID &rid, Tuple *tuple, Transaction *txn) {
   return res;
 }
 
+void TableHeap::GetTuples(const std::vector<RID> &rids, std::vector<Tuple> *tuples, Transaction *txn) {
+  size_t begin = 0;
+  while (begin < rids.size()) {
+    page_id_t page_id = rids[begin].GetPageId();
+    size_t end = begin + 1;
+    while (end < rids.size() && rids[end].GetPageId() == page_id) {
+      end++;
+    }
+    // Find the page which contains the run of tuples.
+    auto page = static_cast<TablePage *>(buffer_pool_manager_->FetchPage(page_id));
+    // If the page could not be found, then abort the transaction.
+    if (page == nullptr) {
+      txn->SetState(TransactionState::ABORTED);
+      return;
+    }
+    // Read the tuples from the page.
+    page->RLatch();
+    for (size_t i = begin; i < end; i++) {
+      tuples->emplace_back();
+      if (!page->GetTuple(rids[i], &tuples->back(), txn, lock_manager_)) {
+        tuples->pop_back();
+      }
+    }
+    page->RUnlatch();
+    buffer_pool_manager_->UnpinPage(page_id, false);
+    begin = end;
+  }
+}
+
+void TableHeap::GetPageTuples(page_id_t page_id, std::vector<Tuple> *tuples, Transaction *txn) {
+  auto page = static_cast<TablePage *>(buffer_pool_manager_->FetchPage(page_id));
+  if (page == nullptr) {
+    txn->SetState(TransactionState::ABORTED);
+    return;
+  }
+  page->RLatch();
+  RID rid;
+  bool found_tuple = page->GetFirstTupleRid(&rid);
+  while (found_tuple) {
+    tuples->emplace_back();
+    if (!page->GetTuple(rid, &tuples->back(), txn, lock_manager_)) {
+      tuples->pop_back();
+    }
+    found_tuple = page->GetNextTupleRid(rid, &rid);
+  }
+  page->RUnlatch();
+  buffer_pool_manager_->UnpinPage(page_id, false);
+}
+
+void TableHeap::GetPageIds(std::vector<page_id_t> *page_ids) {
+  auto page_id = first_page_id_;
+  while (page_id != INVALID_PAGE_ID) {
+    page_ids->push_back(page_id);
+    auto page = static_cast<TablePage *>(buffer_pool_manager_->FetchPage(page_id));
+    BUSTUB_ASSERT(page != nullptr, "Table page could not be fetched.");
+    page->RLatch();
+    auto next_page_id = page->GetNextPageId();
+    page->RUnlatch();
+    buffer_pool_manager_->UnpinPage(page_id, false);
+    page_id = next_page_id;
+  }
+}
+
 TableIterator TableHeap::Begin(Transaction *txn) {
   // Start an iterator from the first page.
   // TODO(Wuwen): Hacky fix for now. Removing empty pages is a better way to handle this.
@@ -16,6 +16,8 @@
 #include <cstdio>
 #include <random>
 #include <string>
+#include <thread>  // NOLINT
+#include <vector>
 #include "buffer/buffer_pool_manager.h"
 #include "gtest/gtest.h"
 
@@ -207,4 +209,64 @@ TEST(BufferPoolManagerInstanceTest, DeleteTest) {
   delete disk_manager;
 }
 
+// Check that optimistic reads only validate if no writer latched the page in between
+TEST(BufferPoolManagerInstanceTest, OptimisticReadTest) {
+  const std::string db_name = "test.db";
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new BufferPoolManagerInstance(5, disk_manager);
+  page_id_t page_id;
+  Page *page = bpm->NewPage(&page_id);
+
+  uint64_t version = page->ReadOptimistic();
+  EXPECT_TRUE(page->Validate(version));
+  // readers do not change the version
+  page->RLatch();
+  page->RUnlatch();
+  EXPECT_TRUE(page->Validate(version));
+  page->WLatch();
+  EXPECT_FALSE(page->Validate(version));
+  page->WUnlatch();
+  EXPECT_FALSE(page->Validate(version));
+  version = page->ReadOptimistic();
+  EXPECT_TRUE(page->Validate(version));
+
+  // A writer keeps two counters at the ends of the page equal, readers must never validate different ones.
+  auto *data = reinterpret_cast<volatile uint64_t *>(page->GetData());
+  const size_t last = PAGE_SIZE / sizeof(uint64_t) - 1;
+  const uint64_t num_writes = 100000;
+  std::thread writer([&] {
+    for (uint64_t i = 1; i <= num_writes; i++) {
+      page->WLatch();
+      data[0] = i;
+      data[last] = i;
+      page->WUnlatch();
+    }
+  });
+  std::vector<std::thread> readers;
+  for (int i = 0; i < 4; i++) {
+    readers.emplace_back([&] {
+      uint64_t first = 0;
+      while (first != num_writes) {
+        uint64_t read_version = page->ReadOptimistic();
+        first = data[0];
+        uint64_t second = data[last];
+        if (page->Validate(read_version)) {
+          ASSERT_EQ(first, second);
+        } else {
+          first = 0;
+        }
+      }
+    });
+  }
+  writer.join();
+  for (auto &reader : readers) {
+    reader.join();
+  }
+
+  bpm->UnpinPage(page_id, true);
+  delete bpm;
+  delete disk_manager;
+  remove("test.db");
+}
+
 }  // namespace bustub
@@ -10,6 +10,11 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>  // NOLINT
+#include <iostream>
+#include <shared_mutex>
 #include <thread>  // NOLINT
 #include <vector>
 
@@ -18,6 +23,7 @@
 
 namespace bustub {
 
+template <typename Latch = ReaderWriterLatch>
 class Counter {
  public:
   Counter() = default;
@@ -36,13 +42,13 @@ class Counter {
 
  private:
   int count_{0};
-  ReaderWriterLatch mutex_{};
+  Latch mutex_{};
 };
 
 // NOLINTNEXTLINE
 TEST(RWLatchTest, BasicTest) {
   int num_threads = 100;
-  Counter counter{};
+  Counter<> counter{};
   counter.Add(5);
   std::vector<std::thread> threads;
   for (int tid = 0; tid < num_threads; tid++) {
@@ -57,4 +63,124 @@ TEST(RWLatchTest, BasicTest) {
   }
   EXPECT_EQ(counter.Read(), 55);
 }
+
+// NOLINTNEXTLINE
+TEST(RWLatchTest, StripedBasicTest) {
+  int num_threads = 100;
+  Counter<StripedReaderWriterLatch> counter{};
+  counter.Add(5);
+  std::vector<std::thread> threads;
+  for (int tid = 0; tid < num_threads; tid++) {
+    if (tid % 2 == 0) {
+      threads.emplace_back([&counter]() { counter.Read(); });
+    } else {
+      threads.emplace_back([&counter]() { counter.Add(1); });
+    }
+  }
+  for (int i = 0; i < num_threads; i++) {
+    threads[i].join();
+  }
+  EXPECT_EQ(counter.Read(), 55);
+}
+
+namespace {
+
+/** Readers check that they never see a writer halfway through its update of two values. */
+template <typename Latch>
+void ExclusionTest() {
+  Latch latch;
+  int64_t first = 0;
+  int64_t second = 0;
+  std::atomic<bool> torn{false};
+  std::vector<std::thread> threads;
+  for (int tid = 0; tid < 8; tid++) {
+    threads.emplace_back([&, tid]() {
+      for (int i = 0; i < 20000; i++) {
+        if ((i + tid) % 16 == 0) {
+          latch.WLock();
+          first++;
+          std::this_thread::yield();
+          second++;
+          latch.WUnlock();
+        } else {
+          latch.RLock();
+          if (first != second) {
+            torn = true;
+          }
+          latch.RUnlock();
+        }
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  EXPECT_FALSE(torn);
+  EXPECT_EQ(first, 8 * 20000 / 16);
+  EXPECT_EQ(second, first);
+}
+
+/** Runs a read-mostly workload on one latch and returns the number of operations per millisecond. */
+template <typename Latch, typename RLock, typename RUnlock, typename WLock, typename WUnlock>
+double MeasureThroughput(int num_threads, RLock r_lock, RUnlock r_unlock, WLock w_lock, WUnlock w_unlock) {
+  const int ops_per_thread = 200000;
+  Latch latch;
+  int64_t data[8] = {};
+  std::vector<std::thread> threads;
+  auto start = std::chrono::steady_clock::now();
+  for (int tid = 0; tid < num_threads; tid++) {
+    threads.emplace_back([&]() {
+      int64_t sum = 0;
+      for (int i = 0; i < ops_per_thread; i++) {
+        // one write in every 64 operations
+        if (i % 64 == 63) {
+          w_lock(&latch);
+          data[i % 8]++;
+          w_unlock(&latch);
+        } else {
+          r_lock(&latch);
+          sum += data[i % 8];
+          r_unlock(&latch);
+        }
+      }
+      EXPECT_GE(sum, 0);
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+  return static_cast<double>(num_threads) * ops_per_thread * 1000 / std::max<int64_t>(elapsed.count(), 1);
+}
+
+template <typename Latch>
+double MeasureBusTubLatch(int num_threads) {
+  return MeasureThroughput<Latch>(
+      num_threads, [](Latch *latch) { latch->RLock(); }, [](Latch *latch) { latch->RUnlock(); },
+      [](Latch *latch) { latch->WLock(); }, [](Latch *latch) { latch->WUnlock(); });
+}
+
+}  // namespace
+
+// NOLINTNEXTLINE
+TEST(RWLatchTest, ExclusionTest) {
+  ExclusionTest<ReaderWriterLatch>();
+  ExclusionTest<StripedReaderWriterLatch>();
+}
+
+/** Throughput of the latches under a read-mostly workload, from 1 to 64 threads. */
+// NOLINTNEXTLINE
+TEST(RWLatchTest, DISABLED_ContentionBenchmark) {
+  std::cout << "threads\tReaderWriterLatch\tStripedReaderWriterLatch\tstd::shared_mutex (ops/ms)" << std::endl;
+  for (int num_threads = 1; num_threads <= 64; num_threads *= 2) {
+    double compact = MeasureBusTubLatch<ReaderWriterLatch>(num_threads);
+    double striped = MeasureBusTubLatch<StripedReaderWriterLatch>(num_threads);
+    double shared = MeasureThroughput<std::shared_mutex>(
+        num_threads, [](std::shared_mutex *latch) { latch->lock_shared(); },
+        [](std::shared_mutex *latch) { latch->unlock_shared(); }, [](std::shared_mutex *latch) { latch->lock(); },
+        [](std::shared_mutex *latch) { latch->unlock(); });
+    std::cout << num_threads << "\t" << compact << "\t" << striped << "\t" << shared << std::endl;
+  }
+}
+
 }  // namespace bustub
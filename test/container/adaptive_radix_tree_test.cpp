@@ -0,0 +1,265 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// adaptive_radix_tree_test.cpp
+//
+// Identification: test/container/adaptive_radix_tree_test.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <chrono>  // NOLINT
+#include <iostream>
+#include <random>
+#include <thread>  // NOLINT
+#include <utility>
+#include <vector>
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "container/art/adaptive_radix_tree.h"
+#include "gtest/gtest.h"
+#include "storage/index/b_plus_tree.h"
+#include "test_util.h"  // NOLINT
+
+namespace bustub {
+
+using ARTree = AdaptiveRadixTree<GenericKey<8>, RID>;
+
+static GenericKey<8> MakeKey(int64_t key) {
+  GenericKey<8> index_key;
+  index_key.SetFromInteger(key);
+  return index_key;
+}
+
+static std::vector<int64_t> ScanKeys(ARTree *tree, const int64_t *low, const int64_t *high, size_t max_pairs) {
+  GenericKey<8> low_key = MakeKey(low == nullptr ? 0 : *low);
+  GenericKey<8> high_key = MakeKey(high == nullptr ? 0 : *high);
+  std::vector<std::pair<GenericKey<8>, RID>> pairs;
+  tree->Scan(low == nullptr ? nullptr : &low_key, high == nullptr ? nullptr : &high_key, max_pairs, &pairs);
+  std::vector<int64_t> keys;
+  for (const auto &pair : pairs) {
+    EXPECT_EQ(RID(pair.first.ToString()), pair.second);
+    keys.push_back(pair.first.ToString());
+  }
+  return keys;
+}
+
+// NOLINTNEXTLINE
+TEST(AdaptiveRadixTreeTest, SampleTest) {
+  ARTree tree;
+
+  // insert a few values
+  for (int64_t i = 0; i < 5; i++) {
+    EXPECT_TRUE(tree.Insert(MakeKey(i), RID(i)));
+    std::vector<RID> res;
+    EXPECT_TRUE(tree.GetValue(MakeKey(i), &res));
+    EXPECT_EQ(std::vector<RID>{RID(i)}, res);
+  }
+
+  // keys are unique
+  for (int64_t i = 0; i < 5; i++) {
+    EXPECT_FALSE(tree.Insert(MakeKey(i), RID(i + 1)));
+  }
+  EXPECT_EQ(5, tree.GetSize());
+
+  // removed keys are gone
+  for (int64_t i = 0; i < 5; i += 2) {
+    EXPECT_TRUE(tree.Remove(MakeKey(i)));
+    EXPECT_FALSE(tree.Remove(MakeKey(i)));
+  }
+  for (int64_t i = 0; i < 5; i++) {
+    std::vector<RID> res;
+    EXPECT_EQ(i % 2 == 1, tree.GetValue(MakeKey(i), &res));
+  }
+  std::vector<RID> res;
+  EXPECT_FALSE(tree.GetValue(MakeKey(-1), &res));
+  EXPECT_FALSE(tree.GetValue(MakeKey(1LL << 40), &res));
+  EXPECT_EQ(2, tree.GetSize());
+}
+
+// NOLINTNEXTLINE
+TEST(AdaptiveRadixTreeTest, GrowShrinkTest) {
+  ARTree tree;
+
+  // Keys with shared prefixes of different lengths, and levels with 1 to 256 children, so that every node type
+  // is grown into, prefixes are split, and nodes are shrunk and merged with their only child again.
+  std::vector<int64_t> keys;
+  for (int64_t fanout : {2, 5, 17, 49, 256}) {
+    for (int64_t i = 0; i < fanout; i++) {
+      keys.push_back((fanout << 40) | (i << 16));
+      keys.push_back((fanout << 40) | (i << 16) | (i << 8) | i);
+    }
+  }
+  std::mt19937 rng(15445);
+  for (int i = 0; i < 20000; i++) {
+    keys.push_back(static_cast<int64_t>(rng()) - static_cast<int64_t>(rng()));
+  }
+  std::sort(keys.begin(), keys.end());
+  keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+  std::shuffle(keys.begin(), keys.end(), rng);
+
+  for (auto key : keys) {
+    ASSERT_TRUE(tree.Insert(MakeKey(key), RID(key)));
+  }
+  EXPECT_EQ(keys.size(), tree.GetSize());
+  for (auto key : keys) {
+    std::vector<RID> res;
+    ASSERT_TRUE(tree.GetValue(MakeKey(key), &res));
+    EXPECT_EQ(std::vector<RID>{RID(key)}, res);
+  }
+
+  // a full scan returns every key in order
+  std::vector<int64_t> sorted = keys;
+  std::sort(sorted.begin(), sorted.end());
+  EXPECT_EQ(sorted, ScanKeys(&tree, nullptr, nullptr, keys.size() + 1));
+
+  // remove most keys, the rest stay reachable
+  for (size_t i = 0; i < keys.size(); i++) {
+    if (i % 8 != 0) {
+      ASSERT_TRUE(tree.Remove(MakeKey(keys[i])));
+    }
+  }
+  for (size_t i = 0; i < keys.size(); i++) {
+    std::vector<RID> res;
+    ASSERT_EQ(i % 8 == 0, tree.GetValue(MakeKey(keys[i]), &res));
+  }
+  for (size_t i = 0; i < keys.size(); i += 8) {
+    ASSERT_TRUE(tree.Remove(MakeKey(keys[i])));
+  }
+  EXPECT_EQ(0, tree.GetSize());
+  EXPECT_TRUE(ScanKeys(&tree, nullptr, nullptr, 10).empty());
+}
+
+// NOLINTNEXTLINE
+TEST(AdaptiveRadixTreeTest, ScanTest) {
+  ARTree tree;
+  for (int64_t i = -1000; i < 1000; i += 2) {
+    tree.Insert(MakeKey(i), RID(i));
+  }
+
+  // bounds that are and are not keys
+  int64_t low = -11;
+  int64_t high = 20;
+  EXPECT_EQ((std::vector<int64_t>{-10, -8, -6, -4, -2, 0, 2, 4, 6, 8, 10, 12, 14, 16, 18, 20}),
+            ScanKeys(&tree, &low, &high, 100));
+  low = 990;
+  EXPECT_EQ((std::vector<int64_t>{990, 992, 994, 996, 998}), ScanKeys(&tree, &low, nullptr, 100));
+  high = -995;
+  EXPECT_EQ((std::vector<int64_t>{-1000, -998, -996}), ScanKeys(&tree, nullptr, &high, 100));
+  low = 3;
+  high = 3;
+  EXPECT_TRUE(ScanKeys(&tree, &low, &high, 100).empty());
+  low = 1000;
+  EXPECT_TRUE(ScanKeys(&tree, &low, nullptr, 100).empty());
+
+  // a scan stops after max_pairs
+  low = 0;
+  EXPECT_EQ((std::vector<int64_t>{0, 2, 4}), ScanKeys(&tree, &low, nullptr, 3));
+  EXPECT_EQ(1000, ScanKeys(&tree, nullptr, nullptr, 2000).size());
+}
+
+// NOLINTNEXTLINE
+TEST(AdaptiveRadixTreeTest, ConcurrentTest) {
+  ARTree tree;
+  const int64_t num_threads = 4;
+  const int64_t keys_per_thread = 20000;
+  // even keys are there from the start and removed concurrently, odd keys are inserted concurrently
+  for (int64_t i = 0; i < num_threads * keys_per_thread; i += 2) {
+    tree.Insert(MakeKey(i * 997), RID(i * 997));
+  }
+
+  std::vector<std::thread> threads;
+  for (int64_t t = 0; t < num_threads; t++) {
+    threads.emplace_back([&tree, t] {
+      for (int64_t i = t; i < num_threads * keys_per_thread; i += num_threads) {
+        if (i % 2 == 1) {
+          EXPECT_TRUE(tree.Insert(MakeKey(i * 997), RID(i * 997)));
+        } else {
+          EXPECT_TRUE(tree.Remove(MakeKey(i * 997)));
+        }
+      }
+    });
+  }
+  // readers see every key at most once and in order
+  for (int t = 0; t < 2; t++) {
+    threads.emplace_back([&tree] {
+      for (int round = 0; round < 20; round++) {
+        auto keys = ScanKeys(&tree, nullptr, nullptr, num_threads * keys_per_thread);
+        EXPECT_TRUE(std::is_sorted(keys.begin(), keys.end()));
+        EXPECT_EQ(keys.end(), std::adjacent_find(keys.begin(), keys.end()));
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  EXPECT_EQ(num_threads * keys_per_thread / 2, tree.GetSize());
+  for (int64_t i = 0; i < num_threads * keys_per_thread; i++) {
+    std::vector<RID> res;
+    EXPECT_EQ(i % 2 == 1, tree.GetValue(MakeKey(i * 997), &res));
+  }
+}
+
+// Compares point lookups against the B+ tree, on a tree that fits into the buffer pool.
+// NOLINTNEXTLINE
+TEST(AdaptiveRadixTreeTest, DISABLED_LookupBenchmark) {
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManagerInstance(4096, disk_manager);
+  page_id_t header_page_id;
+  bpm->NewPage(&header_page_id);
+  BPlusTree<GenericKey<8>, RID, GenericComparator<8>> b_plus_tree("foo_pk", bpm, comparator);
+  ARTree radix_tree;
+
+  const int num_keys = 500000;
+  std::mt19937 rng(15445);
+  std::vector<int64_t> keys;
+  for (int i = 0; i < num_keys; i++) {
+    keys.push_back(static_cast<int64_t>(rng()));
+    b_plus_tree.Insert(MakeKey(keys.back()), RID(keys.back()));
+    radix_tree.Insert(MakeKey(keys.back()), RID(keys.back()));
+  }
+
+  const size_t num_probes = 2000000;
+  std::uniform_int_distribution<size_t> dist(0, keys.size() - 1);
+  std::vector<GenericKey<8>> probes;
+  for (size_t i = 0; i < num_probes; i++) {
+    probes.push_back(MakeKey(keys[dist(rng)]));
+  }
+
+  auto to_ns = [](auto duration) { return std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count(); };
+  std::vector<RID> result;
+  size_t radix_found = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (const auto &key : probes) {
+    result.clear();
+    radix_found += radix_tree.GetValue(key, &result) ? 1 : 0;
+  }
+  auto radix_time = std::chrono::steady_clock::now() - start;
+
+  size_t b_plus_found = 0;
+  start = std::chrono::steady_clock::now();
+  for (const auto &key : probes) {
+    result.clear();
+    b_plus_found += b_plus_tree.GetValue(key, &result) ? 1 : 0;
+  }
+  auto b_plus_time = std::chrono::steady_clock::now() - start;
+
+  EXPECT_EQ(num_probes, radix_found);
+  EXPECT_EQ(num_probes, b_plus_found);
+  std::cout << "adaptive radix tree: " << to_ns(radix_time) / num_probes << " ns, b+ tree: "
+            << to_ns(b_plus_time) / num_probes << " ns per lookup" << std::endl;
+
+  bpm->UnpinPage(header_page_id, true);
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete disk_manager;
+  delete bpm;
+}
+
+}  // namespace bustub
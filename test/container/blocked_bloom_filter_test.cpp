@@ -0,0 +1,61 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// blocked_bloom_filter_test.cpp
+//
+// Identification: test/container/blocked_bloom_filter_test.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "container/hash/blocked_bloom_filter.h"
+#include "container/hash/flat_hash_table.h"
+#include "gtest/gtest.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+// NOLINTNEXTLINE
+TEST(BlockedBloomFilterTest, FalsePositiveRateTest) {
+  const int num_keys = 10000;
+  BlockedBloomFilter filter(num_keys);
+  FlatHashKey key;
+
+  for (int i = 0; i < num_keys; i++) {
+    key.Clear();
+    key.Append(ValueFactory::GetIntegerValue(i * 2));
+    filter.Insert(key.Hash());
+  }
+
+  // No false negatives.
+  for (int i = 0; i < num_keys; i++) {
+    key.Clear();
+    key.Append(ValueFactory::GetIntegerValue(i * 2));
+    EXPECT_TRUE(filter.MayContain(key.Hash()));
+  }
+
+  // Few false positives.
+  int false_positives = 0;
+  for (int i = 0; i < num_keys; i++) {
+    key.Clear();
+    key.Append(ValueFactory::GetIntegerValue(i * 2 + 1));
+    false_positives += filter.MayContain(key.Hash()) ? 1 : 0;
+  }
+  EXPECT_LT(false_positives, num_keys / 100);
+}
+
+// NOLINTNEXTLINE
+TEST(BlockedBloomFilterTest, EmptyFilterTest) {
+  BlockedBloomFilter filter(0);
+  FlatHashKey key;
+  for (int i = 0; i < 1000; i++) {
+    key.Clear();
+    key.Append(ValueFactory::GetIntegerValue(i));
+    EXPECT_FALSE(filter.MayContain(key.Hash()));
+  }
+  EXPECT_GT(filter.SizeInBytes(), 0);
+}
+
+}  // namespace bustub
@@ -0,0 +1,110 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// flat_hash_table_test.cpp
+//
+// Identification: test/container/flat_hash_table_test.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "container/hash/flat_hash_table.h"
+#include "gtest/gtest.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+// NOLINTNEXTLINE
+TEST(FlatHashTableTest, FindOrInsertTest) {
+  FlatHashTable<uint32_t> ht(8);
+  FlatHashKey key;
+  const uint32_t num_keys = 10000;
+
+  for (uint32_t i = 0; i < num_keys; i++) {
+    key.Clear();
+    key.Append(ValueFactory::GetIntegerValue(i));
+    key.Append(ValueFactory::GetVarcharValue(std::to_string(i % 7)));
+    bool inserted;
+    uint32_t *payload = ht.FindOrInsert(key, &inserted);
+    EXPECT_TRUE(inserted);
+    *payload = i * 2;
+  }
+  EXPECT_EQ(num_keys, ht.Size());
+  EXPECT_GE(ht.Capacity(), num_keys);
+
+  for (uint32_t i = 0; i < num_keys; i++) {
+    key.Clear();
+    key.Append(ValueFactory::GetIntegerValue(i));
+    key.Append(ValueFactory::GetVarcharValue(std::to_string(i % 7)));
+    uint32_t *payload = ht.Find(key);
+    ASSERT_NE(nullptr, payload);
+    EXPECT_EQ(i * 2, *payload);
+
+    bool inserted;
+    EXPECT_EQ(payload, ht.FindOrInsert(key, &inserted));
+    EXPECT_FALSE(inserted);
+  }
+
+  // Same integer, different string.
+  key.Clear();
+  key.Append(ValueFactory::GetIntegerValue(1));
+  key.Append(ValueFactory::GetVarcharValue("2"));
+  EXPECT_EQ(nullptr, ht.Find(key));
+
+  ht.Clear();
+  EXPECT_EQ(0, ht.Size());
+  EXPECT_EQ(0, ht.ArenaBytes());
+  key.Clear();
+  key.Append(ValueFactory::GetIntegerValue(1));
+  key.Append(ValueFactory::GetVarcharValue("1"));
+  EXPECT_EQ(nullptr, ht.Find(key));
+}
+
+// NOLINTNEXTLINE
+TEST(FlatHashTableTest, KeyEncodingTest) {
+  FlatHashKey a;
+  FlatHashKey b;
+
+  // Integers of different widths that compare equal serialize to the same key.
+  a.Append(ValueFactory::GetSmallIntValue(42));
+  b.Append(ValueFactory::GetBigIntValue(42));
+  EXPECT_EQ(a.Size(), b.Size());
+  EXPECT_EQ(0, memcmp(a.Data(), b.Data(), a.Size()));
+  EXPECT_EQ(a.Hash(), b.Hash());
+
+  // Nulls are tracked and are distinct from any value.
+  a.Clear();
+  b.Clear();
+  a.Append(ValueFactory::GetNullValueByType(TypeId::INTEGER));
+  b.Append(ValueFactory::GetIntegerValue(0));
+  EXPECT_TRUE(a.HasNull());
+  EXPECT_FALSE(b.HasNull());
+  EXPECT_FALSE(a.Size() == b.Size() && memcmp(a.Data(), b.Data(), a.Size()) == 0);
+
+  // Variable-length values are length-prefixed, so ("ab", "c") differs from ("a", "bc").
+  a.Clear();
+  b.Clear();
+  a.Append(ValueFactory::GetVarcharValue("ab"));
+  a.Append(ValueFactory::GetVarcharValue("c"));
+  b.Append(ValueFactory::GetVarcharValue("a"));
+  b.Append(ValueFactory::GetVarcharValue("bc"));
+  EXPECT_FALSE(a.Size() == b.Size() && memcmp(a.Data(), b.Data(), a.Size()) == 0);
+
+  FlatHashTable<> set;
+  bool inserted;
+  set.FindOrInsert(a, &inserted);
+  EXPECT_TRUE(inserted);
+  set.FindOrInsert(b, &inserted);
+  EXPECT_TRUE(inserted);
+  set.FindOrInsert(a, &inserted);
+  EXPECT_FALSE(inserted);
+  EXPECT_EQ(2, set.Size());
+}
+
+}  // namespace bustub
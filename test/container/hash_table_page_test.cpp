@@ -22,6 +22,7 @@
 #include "storage/disk/disk_manager.h"
 #include "storage/page/hash_table_bucket_page.h"
 #include "storage/page/hash_table_directory_page.h"
+#include "storage/page/hash_table_header_page.h"
 
 namespace bustub {
 
@@ -210,7 +211,7 @@ TEST(HashTablePageTest, BucketPageSetBitTest) {
   auto bucket_page = reinterpret_cast<HashTableBucketPage<int, int, IntComparator> *>(
       bpm->NewPage(&bucket_page_id, nullptr)->GetData());
 
-  int bucket_array_size = (4 * PAGE_SIZE) / (4 * sizeof(std::pair<int, int>) + 1);
+  int bucket_array_size = (4 * (PAGE_SIZE - 64)) / (4 * sizeof(std::pair<int, int>) + 5) / 8 * 8;
 
   for (int i = 0; i < 50; i++) {
     int which = std::rand() % bucket_array_size;
@@ -235,6 +236,53 @@ TEST(HashTablePageTest, BucketPageSetBitTest) {
   delete bpm;
 }
 
+// NOLINTNEXTLINE
+TEST(HashTablePageTest, BucketPageTagTest) {
+  DiskManager *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManagerInstance(5, disk_manager);
+  page_id_t bucket_page_id = INVALID_PAGE_ID;
+  auto bucket_page = reinterpret_cast<HashTableBucketPage<int, int, IntComparator> *>(
+      bpm->NewPage(&bucket_page_id, nullptr)->GetData());
+
+  int bucket_array_size = (4 * (PAGE_SIZE - 64)) / (4 * sizeof(std::pair<int, int>) + 5) / 8 * 8;
+
+  // few distinct tags, so that every group holds matching slots with different keys.
+  auto tag_of = [](int key) { return static_cast<uint8_t>(key % 3); };
+  for (int i = 0; i < bucket_array_size; i++) {
+    EXPECT_TRUE(bucket_page->Insert(i, i, IntComparator(), tag_of(i)));
+    EXPECT_EQ(tag_of(i), bucket_page->TagAt(i));
+  }
+  EXPECT_TRUE(bucket_page->IsFull());
+  EXPECT_FALSE(bucket_page->Insert(bucket_array_size, 0, IntComparator(), tag_of(bucket_array_size)));
+
+  std::vector<int> result;
+  for (int i = 0; i < bucket_array_size; i++) {
+    result.clear();
+    EXPECT_TRUE(bucket_page->GetValue(i, IntComparator(), &result, tag_of(i)));
+    EXPECT_EQ(std::vector<int>{i}, result);
+    // a key is only found under its own tag.
+    result.clear();
+    EXPECT_FALSE(bucket_page->GetValue(i, IntComparator(), &result, tag_of(i + 1)));
+  }
+
+  // removed slots are reused, from the lowest one up.
+  EXPECT_TRUE(bucket_page->Remove(100, 100, IntComparator(), tag_of(100)));
+  EXPECT_TRUE(bucket_page->Remove(40, 40, IntComparator(), tag_of(40)));
+  EXPECT_FALSE(bucket_page->Remove(40, 40, IntComparator(), tag_of(40)));
+  EXPECT_EQ(bucket_array_size - 2, bucket_page->NumReadable());
+  EXPECT_TRUE(bucket_page->Insert(-1, -1, IntComparator(), tag_of(1)));
+  EXPECT_EQ(-1, bucket_page->KeyAt(40));
+  EXPECT_TRUE(bucket_page->Insert(-2, -2, IntComparator(), tag_of(2)));
+  EXPECT_EQ(-2, bucket_page->KeyAt(100));
+  EXPECT_TRUE(bucket_page->IsFull());
+
+  bpm->UnpinPage(bucket_page_id, true, nullptr);
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete disk_manager;
+  delete bpm;
+}
+
 // NOLINTNEXTLINE
 TEST(HashTablePageTest, BucketPageInsertTest) {
   DiskManager *disk_manager = new DiskManager("test.db");
@@ -243,7 +291,7 @@ TEST(HashTablePageTest, BucketPageInsertTest) {
   auto bucket_page = reinterpret_cast<HashTableBucketPage<int, int, IntComparator> *>(
       bpm->NewPage(&bucket_page_id, nullptr)->GetData());
 
-  int bucket_array_size = (4 * PAGE_SIZE) / (4 * sizeof(std::pair<int, int>) + 1);
+  int bucket_array_size = (4 * (PAGE_SIZE - 64)) / (4 * sizeof(std::pair<int, int>) + 5) / 8 * 8;
 
   EXPECT_TRUE(bucket_page->IsEmpty());
   EXPECT_FALSE(bucket_page->IsFull());
@@ -324,7 +372,7 @@ TEST(HashTablePageTest, BucketPageGetValueTest) {
   auto bucket_page = reinterpret_cast<HashTableBucketPage<int, int, IntComparator> *>(
       bpm->NewPage(&bucket_page_id, nullptr)->GetData());
 
-  int bucket_array_size = (4 * PAGE_SIZE) / (4 * sizeof(std::pair<int, int>) + 1);
+  int bucket_array_size = (4 * (PAGE_SIZE - 64)) / (4 * sizeof(std::pair<int, int>) + 5) / 8 * 8;
   std::vector<int> values;
 
   for (int i = 0; i < 3; i++) {
@@ -369,7 +417,7 @@ TEST(HashTablePageTest, BucketPageInsertRemoveTest) {
   auto bucket_page = reinterpret_cast<HashTableBucketPage<int, int, IntComparator> *>(
       bpm->NewPage(&bucket_page_id, nullptr)->GetData());
 
-  int bucket_array_size = (4 * PAGE_SIZE) / (4 * sizeof(std::pair<int, int>) + 1);
+  int bucket_array_size = (4 * (PAGE_SIZE - 64)) / (4 * sizeof(std::pair<int, int>) + 5) / 8 * 8;
 
   for (int i = 0; i < 5; i++) {
     bucket_page->Insert(i, i, IntComparator());
@@ -415,4 +463,36 @@ TEST(HashTablePageTest, BucketPageInsertRemoveTest) {
   delete bpm;
 }
 
+// NOLINTNEXTLINE
+TEST(HashTablePageTest, HeaderPageSampleTest) {
+  DiskManager *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManagerInstance(5, disk_manager);
+  page_id_t header_page_id = INVALID_PAGE_ID;
+  auto header_page = reinterpret_cast<HashTableHeaderPage *>(bpm->NewPage(&header_page_id, nullptr)->GetData());
+
+  EXPECT_EQ(0, header_page->GetGlobalDepth());
+  EXPECT_EQ(1, header_page->NumDirectoryPages());
+  header_page->SetDirectoryPageId(0, 7);
+
+  // the first directory page holds DIRECTORY_ARRAY_SIZE indexes, then a second one is needed.
+  for (int i = 0; i < 9; i++) {
+    header_page->IncrGlobalDepth();
+  }
+  EXPECT_EQ(DIRECTORY_ARRAY_SIZE, header_page->Size());
+  EXPECT_EQ(1, header_page->NumDirectoryPages());
+  EXPECT_EQ(7, header_page->GetDirectoryPageId(DIRECTORY_ARRAY_SIZE - 1));
+  header_page->IncrGlobalDepth();
+  EXPECT_EQ(2, header_page->NumDirectoryPages());
+  EXPECT_EQ(0x3ff, header_page->GetGlobalDepthMask());
+  header_page->SetDirectoryPageId(1, 8);
+  EXPECT_EQ(8, header_page->GetDirectoryPageId(DIRECTORY_ARRAY_SIZE));
+  EXPECT_EQ(DIRECTORY_ARRAY_SIZE * HEADER_ARRAY_SIZE, header_page->MaxSize());
+
+  bpm->UnpinPage(header_page_id, true, nullptr);
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete disk_manager;
+  delete bpm;
+}
+
 }  // namespace bustub
@@ -10,7 +10,11 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
+#include <chrono>  // NOLINT
 #include <ctime>
+#include <iostream>
+#include <memory>
 #include <random>
 #include <thread>  // NOLINT
 #include <vector>
@@ -22,18 +26,18 @@
 #include "container/hash/extendible_hash_table.h"
 #include "gtest/gtest.h"
 #include "murmur3/MurmurHash3.h"
+#include "test_util.h"  // NOLINT
 
 namespace bustub {
 
-// NOLINTNEXTLINE
-template <>
-class HashFunction<int> {
+// Hashes a key to itself, so that the tests control which bucket a key lands in
+class IdentityHashFunction : public HashFunction<int> {
  public:
-  virtual uint64_t GetHash(int key) { return static_cast<uint64_t>(key); }
+  uint64_t GetHash(int key) override { return static_cast<uint64_t>(key); }
 };
 
 void ProcessHashTable(ExtendibleHashTable<int, int, IntComparator> *ht) {
-  int bucket_array_size = (4 * PAGE_SIZE) / (4 * sizeof(std::pair<int, int>) + 1);
+  int bucket_array_size = (4 * (PAGE_SIZE - 64)) / (4 * sizeof(std::pair<int, int>) + 5) / 8 * 8;
 
   for (int i = 0; i < bucket_array_size; i++) {
     ht->Insert(nullptr, i * 2, i * 2);
@@ -85,7 +89,8 @@ void ProcessHashTable(ExtendibleHashTable<int, int, IntComparator> *ht) {
 TEST(HashTableTest, SampleTest) {
   auto *disk_manager = new DiskManager("test.db");
   auto *bpm = new BufferPoolManagerInstance(50, disk_manager);
-  ExtendibleHashTable<int, int, IntComparator> ht("blah", bpm, IntComparator(), HashFunction<int>());
+  ExtendibleHashTable<int, int, IntComparator> ht("blah", bpm, IntComparator(),
+                                                  std::make_unique<IdentityHashFunction>());
 
   // insert a few values
   for (int i = 0; i < 5; i++) {
@@ -179,7 +184,8 @@ TEST(HashTableTest, SampleTest) {
 TEST(HashTableTest, SplitTestOne) {
   auto *disk_manager = new DiskManager("test.db");
   auto *bpm = new BufferPoolManagerInstance(50, disk_manager);
-  ExtendibleHashTable<int, int, IntComparator> ht("blah", bpm, IntComparator(), HashFunction<int>());
+  ExtendibleHashTable<int, int, IntComparator> ht("blah", bpm, IntComparator(),
+                                                  std::make_unique<IdentityHashFunction>());
 
   ProcessHashTable(&ht);
 
@@ -193,9 +199,10 @@ TEST(HashTableTest, SplitTestOne) {
 TEST(HashTableTest, SplitTestTwo) {
   auto *disk_manager = new DiskManager("test.db");
   auto *bpm = new BufferPoolManagerInstance(50, disk_manager);
-  ExtendibleHashTable<int, int, IntComparator> ht("blah", bpm, IntComparator(), HashFunction<int>());
+  ExtendibleHashTable<int, int, IntComparator> ht("blah", bpm, IntComparator(),
+                                                  std::make_unique<IdentityHashFunction>());
 
-  int bucket_array_size = (4 * PAGE_SIZE) / (4 * sizeof(std::pair<int, int>) + 1);
+  int bucket_array_size = (4 * (PAGE_SIZE - 64)) / (4 * sizeof(std::pair<int, int>) + 5) / 8 * 8;
 
   for (int i = 0; i <= bucket_array_size; i++) {
     ht.Insert(nullptr, i * 4, i * 4);
@@ -220,9 +227,10 @@ TEST(HashTableTest, SplitTestTwo) {
 TEST(HashTableTest, MergeTestOne) {
   auto *disk_manager = new DiskManager("test.db");
   auto *bpm = new BufferPoolManagerInstance(50, disk_manager);
-  ExtendibleHashTable<int, int, IntComparator> ht("blah", bpm, IntComparator(), HashFunction<int>());
+  ExtendibleHashTable<int, int, IntComparator> ht("blah", bpm, IntComparator(),
+                                                  std::make_unique<IdentityHashFunction>());
 
-  int bucket_array_size = (4 * PAGE_SIZE) / (4 * sizeof(std::pair<int, int>) + 1);
+  int bucket_array_size = (4 * (PAGE_SIZE - 64)) / (4 * sizeof(std::pair<int, int>) + 5) / 8 * 8;
 
   ht.Insert(nullptr, 0, 0);
   ht.Remove(nullptr, 0, 0);
@@ -266,9 +274,10 @@ TEST(HashTableTest, MergeTestOne) {
 TEST(HashTableTest, MergeTestTwo) {
   auto *disk_manager = new DiskManager("test.db");
   auto *bpm = new BufferPoolManagerInstance(50, disk_manager);
-  ExtendibleHashTable<int, int, IntComparator> ht("blah", bpm, IntComparator(), HashFunction<int>());
+  ExtendibleHashTable<int, int, IntComparator> ht("blah", bpm, IntComparator(),
+                                                  std::make_unique<IdentityHashFunction>());
 
-  int bucket_array_size = (4 * PAGE_SIZE) / (4 * sizeof(std::pair<int, int>) + 1);
+  int bucket_array_size = (4 * (PAGE_SIZE - 64)) / (4 * sizeof(std::pair<int, int>) + 5) / 8 * 8;
 
   ProcessHashTable(&ht);
 
@@ -295,9 +304,10 @@ TEST(HashTableTest, MergeTestTwo) {
 TEST(HashTableTest, MergeTestThree) {
   auto *disk_manager = new DiskManager("test.db");
   auto *bpm = new BufferPoolManagerInstance(50, disk_manager);
-  ExtendibleHashTable<int, int, IntComparator> ht("blah", bpm, IntComparator(), HashFunction<int>());
+  ExtendibleHashTable<int, int, IntComparator> ht("blah", bpm, IntComparator(),
+                                                  std::make_unique<IdentityHashFunction>());
 
-  int bucket_array_size = (4 * PAGE_SIZE) / (4 * sizeof(std::pair<int, int>) + 1);
+  int bucket_array_size = (4 * (PAGE_SIZE - 64)) / (4 * sizeof(std::pair<int, int>) + 5) / 8 * 8;
 
   ProcessHashTable(&ht);
 
@@ -324,9 +334,10 @@ TEST(HashTableTest, MergeTestThree) {
 TEST(HashTableTest, MergeTestFour) {
   auto *disk_manager = new DiskManager("test.db");
   auto *bpm = new BufferPoolManagerInstance(50, disk_manager);
-  ExtendibleHashTable<int, int, IntComparator> ht("blah", bpm, IntComparator(), HashFunction<int>());
+  ExtendibleHashTable<int, int, IntComparator> ht("blah", bpm, IntComparator(),
+                                                  std::make_unique<IdentityHashFunction>());
 
-  int bucket_array_size = (4 * PAGE_SIZE) / (4 * sizeof(std::pair<int, int>) + 1);
+  int bucket_array_size = (4 * (PAGE_SIZE - 64)) / (4 * sizeof(std::pair<int, int>) + 5) / 8 * 8;
 
   ProcessHashTable(&ht);
 
@@ -351,4 +362,331 @@ TEST(HashTableTest, MergeTestFour) {
   delete bpm;
 }
 
+// NOLINTNEXTLINE
+TEST(HashTableTest, GetValuesTest) {
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManagerInstance(50, disk_manager);
+  ExtendibleHashTable<int, int, IntComparator> ht("blah", bpm, IntComparator(),
+                                                  std::make_unique<IdentityHashFunction>());
+
+  // enough keys to split a few times, even keys have a second value
+  const int num_keys = 5000;
+  for (int i = 0; i < num_keys; i++) {
+    ht.Insert(nullptr, i, i);
+    if (i % 2 == 0) {
+      ht.Insert(nullptr, i, -i - 1);
+    }
+  }
+  ht.VerifyIntegrity();
+
+  // every key, duplicates and missing keys, in a random order
+  std::vector<int> keys;
+  for (int i = -100; i < num_keys + 100; i++) {
+    keys.push_back(i);
+    keys.push_back(i);
+  }
+  std::shuffle(keys.begin(), keys.end(), std::mt19937(15445));
+
+  std::vector<std::vector<int>> results;
+  size_t expected_found = 0;
+  for (const auto &key : keys) {
+    expected_found += (key >= 0 && key < num_keys) ? 1 : 0;
+  }
+  EXPECT_EQ(expected_found, ht.GetValues(nullptr, keys, &results));
+  ASSERT_EQ(keys.size(), results.size());
+  for (size_t i = 0; i < keys.size(); i++) {
+    std::vector<int> expected;
+    ht.GetValue(nullptr, keys[i], &expected);
+    EXPECT_EQ(expected, results[i]);
+  }
+
+  // the empty batch leaves no pages pinned
+  EXPECT_EQ(0, ht.GetValues(nullptr, {}, &results));
+  EXPECT_TRUE(results.empty());
+  for (int i = 0; i < 50; i++) {
+    page_id_t page_id;
+    ASSERT_NE(nullptr, bpm->NewPage(&page_id));
+  }
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete disk_manager;
+  delete bpm;
+}
+
+// NOLINTNEXTLINE
+TEST(HashTableTest, ConcurrentSplitTest) {
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManagerInstance(50, disk_manager);
+  ExtendibleHashTable<int, int, IntComparator> ht("blah", bpm, IntComparator(),
+                                                  std::make_unique<IdentityHashFunction>());
+
+  // writers split buckets all the time, while readers look up keys that are already in the table.
+  const int num_writers = 4;
+  const int keys_per_writer = 5000;
+  const int num_preloaded = 1000;
+  for (int i = 0; i < num_preloaded; i++) {
+    ht.Insert(nullptr, -i - 1, i);
+  }
+  std::vector<std::thread> threads;
+  for (int t = 0; t < num_writers; t++) {
+    threads.emplace_back([&ht, t] {
+      for (int i = t; i < num_writers * keys_per_writer; i += num_writers) {
+        EXPECT_TRUE(ht.Insert(nullptr, i, i));
+      }
+    });
+  }
+  for (int t = 0; t < 2; t++) {
+    threads.emplace_back([&ht] {
+      std::vector<int> result;
+      for (int round = 0; round < 5; round++) {
+        for (int i = 0; i < num_preloaded; i++) {
+          result.clear();
+          EXPECT_TRUE(ht.GetValue(nullptr, -i - 1, &result));
+          EXPECT_EQ(std::vector<int>{i}, result);
+        }
+      }
+    });
+  }
+  threads.emplace_back([&ht] {
+    std::vector<int> keys;
+    for (int i = 0; i < num_preloaded; i++) {
+      keys.push_back(-i - 1);
+    }
+    std::vector<std::vector<int>> results;
+    for (int round = 0; round < 20; round++) {
+      EXPECT_EQ(keys.size(), ht.GetValues(nullptr, keys, &results));
+      for (int i = 0; i < num_preloaded; i++) {
+        EXPECT_EQ(std::vector<int>{i}, results[i]);
+      }
+    }
+  });
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  ht.VerifyIntegrity();
+  std::vector<int> result;
+  for (int i = 0; i < num_writers * keys_per_writer; i++) {
+    result.clear();
+    EXPECT_TRUE(ht.GetValue(nullptr, i, &result));
+    EXPECT_EQ(std::vector<int>{i}, result);
+  }
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete disk_manager;
+  delete bpm;
+}
+
+// NOLINTNEXTLINE
+TEST(HashTableTest, LargeDirectoryTest) {
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManagerInstance(50, disk_manager);
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<64> comparator(key_schema.get());
+  ExtendibleHashTable<GenericKey<64>, RID, GenericComparator<64>> ht("blah", bpm, comparator,
+                                                                    HashFunction<GenericKey<64>>());
+
+  // large keys keep the buckets small, so that the directory outgrows a single directory page.
+  const int64_t num_keys = 60000;
+  GenericKey<64> index_key;
+  for (int64_t i = 0; i < num_keys; i++) {
+    index_key.SetFromInteger(i);
+    ASSERT_TRUE(ht.Insert(nullptr, index_key, RID(static_cast<page_id_t>(i >> 16), static_cast<uint32_t>(i))));
+  }
+  EXPECT_LT(9, ht.GetGlobalDepth());
+  ht.VerifyIntegrity();
+
+  std::vector<RID> rids;
+  for (int64_t i = 0; i < num_keys; i++) {
+    rids.clear();
+    index_key.SetFromInteger(i);
+    ASSERT_TRUE(ht.GetValue(nullptr, index_key, &rids));
+    ASSERT_EQ(1, rids.size());
+    EXPECT_EQ(static_cast<uint32_t>(i), rids[0].GetSlotNum());
+  }
+
+  // removing every key merges the buckets and shrinks the directory back to a single page.
+  for (int64_t i = 0; i < num_keys; i++) {
+    index_key.SetFromInteger(i);
+    ASSERT_TRUE(ht.Remove(nullptr, index_key, RID(static_cast<page_id_t>(i >> 16), static_cast<uint32_t>(i))));
+  }
+  EXPECT_GE(9, ht.GetGlobalDepth());
+  ht.VerifyIntegrity();
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete disk_manager;
+  delete bpm;
+}
+
+// NOLINTNEXTLINE
+TEST(HashTableTest, OverflowChainTest) {
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManagerInstance(50, disk_manager);
+  ExtendibleHashTable<int, int, IntComparator> ht("blah", bpm, IntComparator(),
+                                                  std::make_unique<IdentityHashFunction>());
+
+  // a low cardinality key has several buckets worth of values, which no split can separate.
+  const int dup_key = 1024;
+  const int num_values = 2000;
+  for (int i = 0; i < num_values; i++) {
+    ASSERT_TRUE(ht.Insert(nullptr, dup_key, i));
+  }
+  EXPECT_FALSE(ht.Insert(nullptr, dup_key, num_values - 1));
+  EXPECT_GE(2, ht.GetGlobalDepth());
+
+  // keys that share low bits with it split its bucket, and the chain moves along as a whole.
+  const int num_keys = 5000;
+  for (int i = 0; i < num_keys; i++) {
+    if (i != dup_key) {
+      ASSERT_TRUE(ht.Insert(nullptr, i, i));
+    }
+  }
+  EXPECT_GE(12, ht.GetGlobalDepth());
+  ht.VerifyIntegrity();
+
+  std::vector<int> result;
+  EXPECT_TRUE(ht.GetValue(nullptr, dup_key, &result));
+  std::sort(result.begin(), result.end());
+  ASSERT_EQ(num_values, result.size());
+  for (int i = 0; i < num_values; i++) {
+    EXPECT_EQ(i, result[i]);
+  }
+  std::vector<std::vector<int>> results;
+  EXPECT_EQ(2, ht.GetValues(nullptr, {dup_key, 0}, &results));
+  EXPECT_EQ(num_values, results[0].size());
+  EXPECT_EQ(std::vector<int>{0}, results[1]);
+
+  // removing all values unlinks and deletes the overflow pages.
+  EXPECT_FALSE(ht.Remove(nullptr, dup_key, num_values));
+  for (int i = 0; i < num_values; i++) {
+    ASSERT_TRUE(ht.Remove(nullptr, dup_key, i));
+  }
+  result.clear();
+  EXPECT_FALSE(ht.GetValue(nullptr, dup_key, &result));
+  for (int i = 0; i < num_keys; i++) {
+    result.clear();
+    EXPECT_EQ(i != dup_key, ht.GetValue(nullptr, i, &result));
+  }
+  ht.VerifyIntegrity();
+
+  // no page is left pinned
+  for (int i = 0; i < 50; i++) {
+    page_id_t page_id;
+    ASSERT_NE(nullptr, bpm->NewPage(&page_id));
+  }
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete disk_manager;
+  delete bpm;
+}
+
+// NOLINTNEXTLINE
+TEST(HashTableTest, CompactTest) {
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManagerInstance(50, disk_manager);
+  ExtendibleHashTable<int, int, IntComparator> ht("blah", bpm, IntComparator(),
+                                                  std::make_unique<IdentityHashFunction>());
+
+  const int num_keys = 20000;
+  for (int i = 0; i < num_keys; i++) {
+    ht.Insert(nullptr, i, i);
+  }
+  auto global_depth = ht.GetGlobalDepth();
+
+  // a bulk delete leaves every bucket sparse but none empty, so Remove() merges nothing.
+  for (int i = 0; i < num_keys; i++) {
+    if ((i / 64) % 8 != 0) {
+      ASSERT_TRUE(ht.Remove(nullptr, i, i));
+    }
+  }
+  EXPECT_EQ(global_depth, ht.GetGlobalDepth());
+
+  EXPECT_LT(0, ht.Compact(nullptr));
+  EXPECT_GT(global_depth, ht.GetGlobalDepth());
+  ht.VerifyIntegrity();
+  EXPECT_EQ(0, ht.Compact(nullptr));
+
+  std::vector<int> result;
+  for (int i = 0; i < num_keys; i++) {
+    result.clear();
+    EXPECT_EQ((i / 64) % 8 == 0, ht.GetValue(nullptr, i, &result));
+  }
+
+  // the compacted table still splits as usual.
+  for (int i = 0; i < num_keys; i++) {
+    if ((i / 64) % 8 != 0) {
+      ASSERT_TRUE(ht.Insert(nullptr, i, i));
+    }
+  }
+  ht.VerifyIntegrity();
+  for (int i = 0; i < num_keys; i++) {
+    result.clear();
+    EXPECT_TRUE(ht.GetValue(nullptr, i, &result));
+  }
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete disk_manager;
+  delete bpm;
+}
+
+// Compares GetValues() against a loop over GetValue() on a table that is much larger than the CPU caches.
+// NOLINTNEXTLINE
+TEST(HashTableTest, DISABLED_GetValuesBenchmark) {
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManagerInstance(1024, disk_manager);
+  ExtendibleHashTable<int, int, IntComparator> ht("blah", bpm, IntComparator(),
+                                                  std::make_unique<IdentityHashFunction>());
+
+  const int num_keys = 150000;
+  std::mt19937 rng(15445);
+  std::vector<int> keys;
+  for (int i = 0; i < num_keys; i++) {
+    keys.push_back(static_cast<int>(rng()));
+    ht.Insert(nullptr, keys.back(), i);
+  }
+
+  const size_t num_probes = 500000;
+  const size_t batch_size = 1024;
+  std::uniform_int_distribution<size_t> dist(0, keys.size() - 1);
+  std::vector<int> probes;
+  for (size_t i = 0; i < num_probes; i++) {
+    probes.push_back(keys[dist(rng)]);
+  }
+
+  size_t sequential_found = 0;
+  auto start = std::chrono::steady_clock::now();
+  std::vector<int> result;
+  for (const auto &key : probes) {
+    result.clear();
+    sequential_found += ht.GetValue(nullptr, key, &result) ? 1 : 0;
+  }
+  auto sequential_time = std::chrono::steady_clock::now() - start;
+
+  size_t interleaved_found = 0;
+  start = std::chrono::steady_clock::now();
+  std::vector<int> batch;
+  std::vector<std::vector<int>> results;
+  for (size_t i = 0; i < num_probes; i += batch_size) {
+    batch.assign(probes.begin() + i, probes.begin() + std::min(num_probes, i + batch_size));
+    interleaved_found += ht.GetValues(nullptr, batch, &results);
+  }
+  auto interleaved_time = std::chrono::steady_clock::now() - start;
+
+  EXPECT_EQ(num_probes, sequential_found);
+  EXPECT_EQ(num_probes, interleaved_found);
+  auto to_ms = [](auto duration) { return std::chrono::duration_cast<std::chrono::milliseconds>(duration).count(); };
+  std::cout << "sequential GetValue: " << to_ms(sequential_time) << " ms, interleaved GetValues: "
+            << to_ms(interleaved_time) << " ms for " << num_probes << " probes" << std::endl;
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete disk_manager;
+  delete bpm;
+}
+
 }  // namespace bustub
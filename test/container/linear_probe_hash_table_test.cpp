@@ -0,0 +1,212 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// linear_probe_hash_table_test.cpp
+//
+// Identification: test/container/linear_probe_hash_table_test.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <chrono>  // NOLINT
+#include <iostream>
+#include <random>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "container/hash/extendible_hash_table.h"
+#include "container/hash/linear_probe_hash_table.h"
+#include "gtest/gtest.h"
+
+namespace bustub {
+
+// NOLINTNEXTLINE
+TEST(LinearProbeHashTableTest, SampleTest) {
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManagerInstance(50, disk_manager);
+  LinearProbeHashTable<int, int, IntComparator> ht("blah", bpm, IntComparator(), HashFunction<int>());
+
+  // insert a few values
+  for (int i = 0; i < 5; i++) {
+    EXPECT_TRUE(ht.Insert(nullptr, i, i));
+    std::vector<int> res;
+    EXPECT_TRUE(ht.GetValue(nullptr, i, &res));
+    EXPECT_EQ(std::vector<int>{i}, res);
+  }
+
+  // a second value per key, but no duplicate pair
+  for (int i = 0; i < 5; i++) {
+    EXPECT_TRUE(ht.Insert(nullptr, i, 2 * i + 1));
+    EXPECT_FALSE(ht.Insert(nullptr, i, i));
+    std::vector<int> res;
+    EXPECT_TRUE(ht.GetValue(nullptr, i, &res));
+    EXPECT_EQ(2, res.size());
+  }
+  EXPECT_EQ(10, ht.GetSize());
+
+  // removed pairs are gone, and a probe continues past their tombstones
+  for (int i = 0; i < 5; i++) {
+    EXPECT_TRUE(ht.Remove(nullptr, i, i));
+    EXPECT_FALSE(ht.Remove(nullptr, i, i));
+    std::vector<int> res;
+    EXPECT_TRUE(ht.GetValue(nullptr, i, &res));
+    EXPECT_EQ(std::vector<int>{2 * i + 1}, res);
+  }
+  std::vector<int> res;
+  EXPECT_FALSE(ht.GetValue(nullptr, 5, &res));
+  EXPECT_EQ(5, ht.GetSize());
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete disk_manager;
+  delete bpm;
+}
+
+// NOLINTNEXTLINE
+TEST(LinearProbeHashTableTest, GrowTest) {
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManagerInstance(50, disk_manager);
+  LinearProbeHashTable<int, int, IntComparator> ht("blah", bpm, IntComparator(), HashFunction<int>());
+
+  // enough keys for a few rounds of splits, and one key with more values than fit into a block
+  const int num_keys = 20000;
+  const int num_duplicates = 1000;
+  for (int i = 0; i < num_keys; i++) {
+    ASSERT_TRUE(ht.Insert(nullptr, i, i));
+  }
+  for (int i = 1; i < num_duplicates; i++) {
+    ASSERT_TRUE(ht.Insert(nullptr, 0, -i));
+  }
+  EXPECT_EQ(num_keys + num_duplicates - 1, ht.GetSize());
+  EXPECT_LT(32, ht.GetNumBlocks());
+
+  std::vector<int> result;
+  for (int i = 1; i < num_keys; i++) {
+    result.clear();
+    ASSERT_TRUE(ht.GetValue(nullptr, i, &result));
+    EXPECT_EQ(std::vector<int>{i}, result);
+  }
+  result.clear();
+  EXPECT_TRUE(ht.GetValue(nullptr, 0, &result));
+  EXPECT_EQ(num_duplicates, result.size());
+
+  // remove every other key, the rest must stay reachable past the tombstones
+  for (int i = 0; i < num_keys; i += 2) {
+    ASSERT_TRUE(ht.Remove(nullptr, i, i));
+  }
+  for (int i = 1; i < num_keys; i++) {
+    result.clear();
+    EXPECT_EQ(i % 2 == 1, ht.GetValue(nullptr, i, &result));
+  }
+  for (int i = 0; i < num_keys; i += 2) {
+    ASSERT_TRUE(ht.Insert(nullptr, i, i));
+  }
+  for (int i = 1; i < num_keys; i++) {
+    result.clear();
+    EXPECT_TRUE(ht.GetValue(nullptr, i, &result));
+  }
+
+  // no page is left pinned
+  for (int i = 0; i < 50; i++) {
+    page_id_t page_id;
+    ASSERT_NE(nullptr, bpm->NewPage(&page_id));
+  }
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete disk_manager;
+  delete bpm;
+}
+
+// NOLINTNEXTLINE
+TEST(LinearProbeHashTableTest, ConcurrentInsertTest) {
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManagerInstance(50, disk_manager);
+  LinearProbeHashTable<int, int, IntComparator> ht("blah", bpm, IntComparator(), HashFunction<int>());
+
+  const int num_threads = 4;
+  const int keys_per_thread = 5000;
+  std::vector<std::thread> threads;
+  for (int t = 0; t < num_threads; t++) {
+    threads.emplace_back([&ht, t] {
+      for (int i = t; i < num_threads * keys_per_thread; i += num_threads) {
+        EXPECT_TRUE(ht.Insert(nullptr, i, i));
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  EXPECT_EQ(num_threads * keys_per_thread, ht.GetSize());
+  std::vector<int> result;
+  for (int i = 0; i < num_threads * keys_per_thread; i++) {
+    result.clear();
+    EXPECT_TRUE(ht.GetValue(nullptr, i, &result));
+    EXPECT_EQ(std::vector<int>{i}, result);
+  }
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete disk_manager;
+  delete bpm;
+}
+
+// Compares point lookups against the extendible hash table, on tables that fit into the buffer pool.
+// NOLINTNEXTLINE
+TEST(LinearProbeHashTableTest, DISABLED_LookupBenchmark) {
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManagerInstance(2048, disk_manager);
+  LinearProbeHashTable<int, int, IntComparator> linear_ht("linear", bpm, IntComparator(), HashFunction<int>());
+  ExtendibleHashTable<int, int, IntComparator> extendible_ht("extendible", bpm, IntComparator(), HashFunction<int>());
+
+  const int num_keys = 150000;
+  std::mt19937 rng(15445);
+  std::vector<int> keys;
+  for (int i = 0; i < num_keys; i++) {
+    keys.push_back(static_cast<int>(rng()));
+    linear_ht.Insert(nullptr, keys.back(), i);
+    extendible_ht.Insert(nullptr, keys.back(), i);
+  }
+
+  const size_t num_probes = 1000000;
+  std::uniform_int_distribution<size_t> dist(0, keys.size() - 1);
+  std::vector<int> probes;
+  for (size_t i = 0; i < num_probes; i++) {
+    probes.push_back(keys[dist(rng)]);
+  }
+
+  auto to_ms = [](auto duration) { return std::chrono::duration_cast<std::chrono::milliseconds>(duration).count(); };
+  std::vector<int> result;
+  size_t linear_found = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (const auto &key : probes) {
+    result.clear();
+    linear_found += linear_ht.GetValue(nullptr, key, &result) ? 1 : 0;
+  }
+  auto linear_time = std::chrono::steady_clock::now() - start;
+
+  size_t extendible_found = 0;
+  start = std::chrono::steady_clock::now();
+  for (const auto &key : probes) {
+    result.clear();
+    extendible_found += extendible_ht.GetValue(nullptr, key, &result) ? 1 : 0;
+  }
+  auto extendible_time = std::chrono::steady_clock::now() - start;
+
+  EXPECT_EQ(num_probes, linear_found);
+  EXPECT_EQ(num_probes, extendible_found);
+  std::cout << "linear probing: " << to_ms(linear_time) << " ms in " << linear_ht.GetNumBlocks()
+            << " blocks, extendible: " << to_ms(extendible_time) << " ms with global depth "
+            << extendible_ht.GetGlobalDepth() << " for " << num_probes << " lookups" << std::endl;
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete disk_manager;
+  delete bpm;
+}
+
+}  // namespace bustub
@@ -0,0 +1,245 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// lsm_tree_test.cpp
+//
+// Identification: test/container/lsm_tree_test.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <chrono>  // NOLINT
+#include <iostream>
+#include <random>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "container/hash/extendible_hash_table.h"
+#include "container/lsm/lsm_tree.h"
+#include "gtest/gtest.h"
+#include "storage/index/b_plus_tree.h"
+#include "test_util.h"  // NOLINT
+
+namespace bustub {
+
+using LSMTree8 = LSMTree<GenericKey<8>, RID, GenericComparator<8>>;
+
+static GenericKey<8> MakeKey(int64_t key) {
+  GenericKey<8> index_key;
+  index_key.SetFromInteger(key);
+  return index_key;
+}
+
+// NOLINTNEXTLINE
+TEST(LSMTreeTest, SampleTest) {
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManagerInstance(50, disk_manager);
+  {
+    LSMTree8 tree("foo_pk", bpm, comparator, HashFunction<GenericKey<8>>());
+
+    // insert a few values, and a second value per key
+    for (int64_t i = 0; i < 5; i++) {
+      tree.Insert(MakeKey(i), RID(i));
+      tree.Insert(MakeKey(i), RID(i + 100));
+      tree.Insert(MakeKey(i), RID(i));
+      std::vector<RID> res;
+      EXPECT_TRUE(tree.GetValue(MakeKey(i), &res));
+      EXPECT_EQ(2, res.size());
+    }
+
+    // removed pairs are gone, the other value of the key stays
+    for (int64_t i = 0; i < 5; i++) {
+      tree.Remove(MakeKey(i), RID(i));
+      std::vector<RID> res;
+      EXPECT_TRUE(tree.GetValue(MakeKey(i), &res));
+      EXPECT_EQ(std::vector<RID>{RID(i + 100)}, res);
+    }
+    std::vector<RID> res;
+    EXPECT_FALSE(tree.GetValue(MakeKey(5), &res));
+
+    // a removed pair can be inserted again
+    tree.Remove(MakeKey(0), RID(100));
+    EXPECT_FALSE(tree.GetValue(MakeKey(0), &res));
+    tree.Insert(MakeKey(0), RID(0));
+    EXPECT_TRUE(tree.GetValue(MakeKey(0), &res));
+    EXPECT_EQ(std::vector<RID>{RID(0)}, res);
+  }
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete disk_manager;
+  delete bpm;
+}
+
+// NOLINTNEXTLINE
+TEST(LSMTreeTest, FlushCompactionTest) {
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManagerInstance(50, disk_manager);
+  {
+    // a small memtable, so that the pairs end up in runs of several levels
+    LSMTree8 tree("foo_pk", bpm, comparator, HashFunction<GenericKey<8>>(), 64);
+    const int64_t num_keys = 10000;
+    std::mt19937 rng(15445);
+    std::vector<int64_t> keys;
+    for (int64_t i = 0; i < num_keys; i++) {
+      keys.push_back(i);
+    }
+    std::shuffle(keys.begin(), keys.end(), rng);
+    for (auto key : keys) {
+      tree.Insert(MakeKey(key), RID(key));
+    }
+    tree.WaitForBackgroundWork();
+    // at most RUNS_PER_LEVEL - 1 runs per level are left over
+    EXPECT_LE(tree.GetNumRuns(), 3 * 4);
+    for (int64_t i = 0; i < num_keys; i++) {
+      std::vector<RID> res;
+      ASSERT_TRUE(tree.GetValue(MakeKey(i), &res));
+      EXPECT_EQ(std::vector<RID>{RID(i)}, res);
+    }
+
+    // removes hide the copies in older runs, and merges into the oldest run drop them
+    for (auto key : keys) {
+      if (key % 2 == 0) {
+        tree.Remove(MakeKey(key), RID(key));
+      }
+    }
+    for (int64_t i = 0; i < num_keys; i += 3) {
+      tree.Insert(MakeKey(i), RID(i + num_keys));
+    }
+    tree.WaitForBackgroundWork();
+    for (int64_t i = 0; i < num_keys; i++) {
+      std::vector<RID> res;
+      std::vector<RID> expected;
+      if (i % 2 == 1) {
+        expected.push_back(RID(i));
+      }
+      if (i % 3 == 0) {
+        expected.push_back(RID(i + num_keys));
+      }
+      ASSERT_EQ(!expected.empty(), tree.GetValue(MakeKey(i), &res));
+      std::sort(res.begin(), res.end(), [](const RID &lhs, const RID &rhs) { return lhs.Get() < rhs.Get(); });
+      EXPECT_EQ(expected, res);
+    }
+    std::vector<RID> res;
+    EXPECT_FALSE(tree.GetValue(MakeKey(num_keys), &res));
+    EXPECT_FALSE(tree.GetValue(MakeKey(-1), &res));
+  }
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete disk_manager;
+  delete bpm;
+}
+
+// NOLINTNEXTLINE
+TEST(LSMTreeTest, ConcurrentInsertTest) {
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManagerInstance(50, disk_manager);
+  {
+    LSMTree8 tree("foo_pk", bpm, comparator, HashFunction<GenericKey<8>>(), 256);
+    const int64_t num_threads = 4;
+    const int64_t keys_per_thread = 10000;
+
+    std::vector<std::thread> threads;
+    for (int64_t t = 0; t < num_threads; t++) {
+      threads.emplace_back([&tree, t] {
+        for (int64_t i = t; i < num_threads * keys_per_thread; i += num_threads) {
+          tree.Insert(MakeKey(i), RID(i));
+        }
+      });
+    }
+    // readers run against memtables that are switched and runs that are merged under them
+    threads.emplace_back([&tree] {
+      for (int64_t i = 0; i < num_threads * keys_per_thread; i += 7) {
+        std::vector<RID> res;
+        if (tree.GetValue(MakeKey(i), &res)) {
+          EXPECT_EQ(std::vector<RID>{RID(i)}, res);
+        }
+      }
+    });
+    for (auto &thread : threads) {
+      thread.join();
+    }
+
+    tree.WaitForBackgroundWork();
+    for (int64_t i = 0; i < num_threads * keys_per_thread; i++) {
+      std::vector<RID> res;
+      ASSERT_TRUE(tree.GetValue(MakeKey(i), &res));
+      EXPECT_EQ(std::vector<RID>{RID(i)}, res);
+    }
+  }
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete disk_manager;
+  delete bpm;
+}
+
+// Compares random inserts against the extendible hash table and the B+ tree.
+// NOLINTNEXTLINE
+TEST(LSMTreeTest, DISABLED_InsertBenchmark) {
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManagerInstance(8192, disk_manager);
+  page_id_t header_page_id;
+  bpm->NewPage(&header_page_id);
+
+  const int num_keys = 500000;
+  std::mt19937 rng(15445);
+  std::vector<GenericKey<8>> keys;
+  for (int i = 0; i < num_keys; i++) {
+    keys.push_back(MakeKey(static_cast<int64_t>(rng())));
+  }
+  auto to_ms = [](auto duration) { return std::chrono::duration_cast<std::chrono::milliseconds>(duration).count(); };
+
+  auto start = std::chrono::steady_clock::now();
+  {
+    LSMTree8 tree("lsm", bpm, comparator, HashFunction<GenericKey<8>>());
+    for (int i = 0; i < num_keys; i++) {
+      tree.Insert(keys[i], RID(i));
+    }
+    tree.WaitForBackgroundWork();
+  }
+  auto lsm_time = std::chrono::steady_clock::now() - start;
+
+  start = std::chrono::steady_clock::now();
+  {
+    ExtendibleHashTable<GenericKey<8>, RID, GenericComparator<8>> table("extendible", bpm, comparator,
+                                                                        HashFunction<GenericKey<8>>());
+    for (int i = 0; i < num_keys; i++) {
+      table.Insert(nullptr, keys[i], RID(i));
+    }
+  }
+  auto extendible_time = std::chrono::steady_clock::now() - start;
+
+  start = std::chrono::steady_clock::now();
+  {
+    BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("b_plus", bpm, comparator);
+    for (int i = 0; i < num_keys; i++) {
+      tree.Insert(keys[i], RID(i));
+    }
+  }
+  auto b_plus_time = std::chrono::steady_clock::now() - start;
+
+  std::cout << "lsm tree: " << to_ms(lsm_time) << " ms, extendible: " << to_ms(extendible_time)
+            << " ms, b+ tree: " << to_ms(b_plus_time) << " ms for " << num_keys << " inserts" << std::endl;
+
+  bpm->UnpinPage(header_page_id, true);
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete disk_manager;
+  delete bpm;
+}
+
+}  // namespace bustub
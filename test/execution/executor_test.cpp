@@ -10,6 +10,7 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
 #include <memory>
 #include <numeric>
 #include <string>
@@ -33,8 +34,12 @@
 #include "execution/plans/delete_plan.h"
 #include "execution/plans/distinct_plan.h"
 #include "execution/plans/hash_join_plan.h"
+#include "execution/plans/index_scan_plan.h"
 #include "execution/plans/limit_plan.h"
+#include "execution/plans/nested_index_join_plan.h"
+#include "execution/plans/semi_join_plan.h"
 #include "execution/plans/seq_scan_plan.h"
+#include "execution/plans/sort_merge_join_plan.h"
 #include "execution/plans/update_plan.h"
 #include "executor_test_util.h"  // NOLINT
 #include "gtest/gtest.h"
@@ -155,6 +160,171 @@ TEST_F(ExecutorTest, SeqScanTestTwo) {
   }
 }
 
+// SELECT colA, colB FROM test_1 WHERE colA >= 300, through a B+ tree index on colA
+TEST_F(ExecutorTest, IndexScanTest) {
+  TableInfo *table_info = GetExecutorContext()->GetCatalog()->GetTable("test_1");
+  const Schema &schema = table_info->schema_;
+  auto key_schema = ParseCreateStatement("colA int");
+  // The index is bulk loaded by several threads
+  auto *index_info = GetExecutorContext()->GetCatalog()->CreateIndex<KeyType, ValueType, ComparatorType>(
+      GetTxn(), "index1", "test_1", schema, *key_schema, {0}, 8, HashFunctionType{}, IndexType::BPlusTree, 0.9, 4);
+
+  auto *col_a = MakeColumnValueExpression(schema, 0, "colA");
+  auto *col_b = MakeColumnValueExpression(schema, 0, "colB");
+  auto *const300 = MakeConstantValueExpression(ValueFactory::GetIntegerValue(300));
+  auto *predicate = MakeComparisonExpression(col_a, const300, ComparisonType::GreaterThanOrEqual);
+  auto *out_schema = MakeOutputSchema({{"colA", col_a}, {"colB", col_b}});
+
+  // A small batch size makes the scan resume from the index several times
+  IndexScanPlanNode plan{out_schema, predicate, index_info->index_oid_, 64};
+  std::vector<Tuple> result_set{};
+  GetExecutionEngine()->Execute(&plan, &result_set, GetTxn(), GetExecutorContext());
+
+  ASSERT_EQ(result_set.size(), TEST1_SIZE - 300);
+  std::vector<int32_t> col_a_values;
+  for (const auto &tuple : result_set) {
+    col_a_values.push_back(tuple.GetValue(out_schema, out_schema->GetColIdx("colA")).GetAs<int32_t>());
+    ASSERT_TRUE(tuple.GetValue(out_schema, out_schema->GetColIdx("colB")).GetAs<int32_t>() < 10);
+  }
+  std::sort(col_a_values.begin(), col_a_values.end());
+  for (size_t i = 0; i < col_a_values.size(); i++) {
+    ASSERT_EQ(col_a_values[i], static_cast<int32_t>(300 + i));
+  }
+
+  // SELECT colA, colB FROM test_1 WHERE 42 = colA
+  auto *const42 = MakeConstantValueExpression(ValueFactory::GetIntegerValue(42));
+  auto *eq_predicate = MakeComparisonExpression(const42, col_a, ComparisonType::Equal);
+  IndexScanPlanNode eq_plan{out_schema, eq_predicate, index_info->index_oid_};
+  result_set.clear();
+  GetExecutionEngine()->Execute(&eq_plan, &result_set, GetTxn(), GetExecutorContext());
+  ASSERT_EQ(result_set.size(), 1);
+  ASSERT_EQ(result_set[0].GetValue(out_schema, out_schema->GetColIdx("colA")).GetAs<int32_t>(), 42);
+
+  // SELECT colA, colB FROM test_1 WHERE colA < 3000000000, the constant does not fit the key type
+  auto *const_big = MakeConstantValueExpression(ValueFactory::GetBigIntValue(3000000000));
+  auto *big_predicate = MakeComparisonExpression(col_a, const_big, ComparisonType::LessThan);
+  IndexScanPlanNode big_plan{out_schema, big_predicate, index_info->index_oid_};
+  result_set.clear();
+  ASSERT_TRUE(GetExecutionEngine()->Execute(&big_plan, &result_set, GetTxn(), GetExecutorContext()));
+  ASSERT_EQ(result_set.size(), TEST1_SIZE);
+
+  // SELECT colA, colB FROM test_1
+  IndexScanPlanNode full_plan{out_schema, nullptr, index_info->index_oid_, 100};
+  result_set.clear();
+  GetExecutionEngine()->Execute(&full_plan, &result_set, GetTxn(), GetExecutorContext());
+  ASSERT_EQ(result_set.size(), TEST1_SIZE);
+}
+
+// SELECT colA, colB FROM test_1 WHERE colA < 100, through an adaptive radix tree index on colA
+TEST_F(ExecutorTest, RadixTreeIndexScanTest) {
+  TableInfo *table_info = GetExecutorContext()->GetCatalog()->GetTable("test_1");
+  const Schema &schema = table_info->schema_;
+  auto key_schema = ParseCreateStatement("colA int");
+  auto *index_info = GetExecutorContext()->GetCatalog()->CreateIndex<KeyType, ValueType, ComparatorType>(
+      GetTxn(), "index1", "test_1", schema, *key_schema, {0}, 8, HashFunctionType{}, IndexType::AdaptiveRadixTree);
+
+  auto *col_a = MakeColumnValueExpression(schema, 0, "colA");
+  auto *col_b = MakeColumnValueExpression(schema, 0, "colB");
+  auto *const100 = MakeConstantValueExpression(ValueFactory::GetIntegerValue(100));
+  auto *predicate = MakeComparisonExpression(col_a, const100, ComparisonType::LessThan);
+  auto *out_schema = MakeOutputSchema({{"colA", col_a}, {"colB", col_b}});
+
+  // A small batch size makes the scan resume from the index several times
+  IndexScanPlanNode plan{out_schema, predicate, index_info->index_oid_, 16};
+  std::vector<Tuple> result_set{};
+  GetExecutionEngine()->Execute(&plan, &result_set, GetTxn(), GetExecutorContext());
+
+  ASSERT_EQ(result_set.size(), 100);
+  std::vector<int32_t> col_a_values;
+  for (const auto &tuple : result_set) {
+    col_a_values.push_back(tuple.GetValue(out_schema, out_schema->GetColIdx("colA")).GetAs<int32_t>());
+  }
+  std::sort(col_a_values.begin(), col_a_values.end());
+  for (size_t i = 0; i < col_a_values.size(); i++) {
+    ASSERT_EQ(col_a_values[i], static_cast<int32_t>(i));
+  }
+
+  // point lookups go through the index as well
+  Tuple key({ValueFactory::GetIntegerValue(42)}, key_schema.get());
+  std::vector<RID> rids;
+  index_info->index_->ScanKey(key, &rids, GetTxn());
+  ASSERT_EQ(rids.size(), 1);
+
+  // SELECT colA, colB FROM test_1
+  IndexScanPlanNode full_plan{out_schema, nullptr, index_info->index_oid_, 100};
+  result_set.clear();
+  GetExecutionEngine()->Execute(&full_plan, &result_set, GetTxn(), GetExecutorContext());
+  ASSERT_EQ(result_set.size(), TEST1_SIZE);
+}
+
+// Point lookups into test_1 through an LSM tree index on colA, which the catalog fills from the table
+TEST_F(ExecutorTest, LSMTreeIndexLookupTest) {
+  TableInfo *table_info = GetExecutorContext()->GetCatalog()->GetTable("test_1");
+  const Schema &schema = table_info->schema_;
+  auto key_schema = ParseCreateStatement("colA int");
+  auto *index_info = GetExecutorContext()->GetCatalog()->CreateIndex<KeyType, ValueType, ComparatorType>(
+      GetTxn(), "index1", "test_1", schema, *key_schema, {0}, 8, HashFunctionType{}, IndexType::LSMTree);
+
+  auto *col_a = MakeColumnValueExpression(schema, 0, "colA");
+  auto *out_schema = MakeOutputSchema({{"colA", col_a}});
+  for (int32_t i = 0; i < static_cast<int32_t>(TEST1_SIZE); i += 37) {
+    Tuple key({ValueFactory::GetIntegerValue(i)}, key_schema.get());
+    std::vector<RID> rids;
+    index_info->index_->ScanKey(key, &rids, GetTxn());
+    ASSERT_EQ(rids.size(), 1);
+    Tuple indexed_tuple{};
+    ASSERT_TRUE(table_info->table_->GetTuple(rids[0], &indexed_tuple, GetTxn()));
+    ASSERT_EQ(indexed_tuple.GetValue(out_schema, 0).GetAs<int32_t>(), i);
+
+    // a deleted entry is hidden from later lookups
+    index_info->index_->DeleteEntry(key, rids[0], GetTxn());
+    rids.clear();
+    index_info->index_->ScanKey(key, &rids, GetTxn());
+    ASSERT_TRUE(rids.empty());
+  }
+}
+
+TEST_F(ExecutorTest, VarlenBPlusTreeIndexLookupTest) {
+  TableInfo *table_info = GetExecutorContext()->GetCatalog()->GetTable("varchar_table");
+  const Schema &schema = table_info->schema_;
+  auto make_url = [](int i) { return "https://www.example.com/catalog/item/" + std::to_string(i); };
+  const int num_rows = 2000;
+  for (int i = 0; i < num_rows; i++) {
+    Tuple tuple({ValueFactory::GetVarcharValue(make_url(i / 2)), ValueFactory::GetTinyIntValue(i % 2 - 1),
+                 ValueFactory::GetDecimalValue(i)},
+                &schema);
+    RID rid;
+    ASSERT_TRUE(table_info->table_->InsertTuple(tuple, &rid, GetTxn()));
+  }
+  // the string column is not the last one, so it is encoded with its end
+  auto key_schema = ParseCreateStatement("colA varchar(64),colB tinyint");
+  auto *index_info = GetExecutorContext()->GetCatalog()->CreateIndex<KeyType, ValueType, ComparatorType>(
+      GetTxn(), "index1", "varchar_table", schema, *key_schema, {0, 1}, 8, HashFunctionType{},
+      IndexType::VarlenBPlusTree);
+
+  for (int i = 0; i < num_rows; i += 7) {
+    Tuple key({ValueFactory::GetVarcharValue(make_url(i / 2)), ValueFactory::GetTinyIntValue(i % 2 - 1)},
+              key_schema.get());
+    std::vector<RID> rids;
+    index_info->index_->ScanKey(key, &rids, GetTxn());
+    ASSERT_EQ(rids.size(), 1);
+    Tuple indexed_tuple{};
+    ASSERT_TRUE(table_info->table_->GetTuple(rids[0], &indexed_tuple, GetTxn()));
+    ASSERT_EQ(indexed_tuple.GetValue(&schema, 2).GetAs<double>(), i);
+
+    index_info->index_->DeleteEntry(key, rids[0], GetTxn());
+    rids.clear();
+    index_info->index_->ScanKey(key, &rids, GetTxn());
+    ASSERT_TRUE(rids.empty());
+  }
+  // a prefix of a stored string is another key
+  Tuple key({ValueFactory::GetVarcharValue("https://www.example.com/catalog/item/"), ValueFactory::GetTinyIntValue(0)},
+            key_schema.get());
+  std::vector<RID> rids;
+  index_info->index_->ScanKey(key, &rids, GetTxn());
+  ASSERT_TRUE(rids.empty());
+}
+
 // SELECT colB, colC, colD FROM test_1
 TEST_F(ExecutorTest, SeqScanTestThree) {
   // Construct query plan
@@ -1127,6 +1297,65 @@ TEST_F(ExecutorTest, SimpleNestedLoopJoinTest) {
   }
 }
 
+// SELECT test_1.colA, test_1.colB, test_2.col1, test_2.col3 FROM test_1 JOIN test_2 ON test_1.colB = test_2.col1;
+TEST_F(ExecutorTest, SimpleNestedIndexJoinTest) {
+  const Schema *out_schema1;
+  std::unique_ptr<AbstractPlanNode> scan_plan1;
+  {
+    auto table_info = GetExecutorContext()->GetCatalog()->GetTable("test_1");
+    auto &schema = table_info->schema_;
+    auto col_a = MakeColumnValueExpression(schema, 0, "colA");
+    auto col_b = MakeColumnValueExpression(schema, 0, "colB");
+    out_schema1 = MakeOutputSchema({{"colA", col_a}, {"colB", col_b}});
+    scan_plan1 = std::make_unique<SeqScanPlanNode>(out_schema1, nullptr, table_info->oid_);
+  }
+
+  // The inner table is probed through a B+ tree index on test_2.col1
+  auto inner_table_info = GetExecutorContext()->GetCatalog()->GetTable("test_2");
+  auto &inner_schema = inner_table_info->schema_;
+  auto key_schema = ParseCreateStatement("col1 smallint");
+  GetExecutorContext()->GetCatalog()->CreateIndex<KeyType, ValueType, ComparatorType>(
+      GetTxn(), "index1", "test_2", inner_schema, *key_schema, {0}, 8, HashFunctionType{}, IndexType::BPlusTree);
+
+  const Schema *out_final;
+  std::unique_ptr<NestedIndexJoinPlanNode> join_plan;
+  {
+    // col_a and col_b have a tuple index of 0 because they are the outer side of the join
+    auto col_a = MakeColumnValueExpression(*out_schema1, 0, "colA");
+    auto col_b = MakeColumnValueExpression(*out_schema1, 0, "colB");
+    // col1 and col3 have a tuple index of 1 because they are the inner side of the join
+    auto col1 = MakeColumnValueExpression(inner_schema, 1, "col1");
+    auto col3 = MakeColumnValueExpression(inner_schema, 1, "col3");
+    auto predicate = MakeComparisonExpression(col_b, col1, ComparisonType::Equal);
+    out_final = MakeOutputSchema({{"colA", col_a}, {"colB", col_b}, {"col1", col1}, {"col3", col3}});
+    // Every batch of 64 outer tuples has only 10 distinct join keys
+    join_plan = std::make_unique<NestedIndexJoinPlanNode>(
+        out_final, std::vector<const AbstractPlanNode *>{scan_plan1.get()}, predicate, inner_table_info->oid_, "index1",
+        out_schema1, &inner_schema, 64);
+  }
+
+  std::vector<Tuple> result_set{};
+  GetExecutionEngine()->Execute(join_plan.get(), &result_set, GetTxn(), GetExecutorContext());
+  ASSERT_EQ(result_set.size(), TEST1_SIZE);
+  for (uint32_t i = 0; i < TEST1_SIZE; i++) {
+    // The output follows the order of the outer table
+    ASSERT_EQ(result_set[i].GetValue(out_final, 0).GetAs<int32_t>(), i);
+    ASSERT_EQ(result_set[i].GetValue(out_final, 1).GetAs<int32_t>(),
+              result_set[i].GetValue(out_final, 2).GetAs<int16_t>());
+    ASSERT_TRUE(result_set[i].GetValue(out_final, 3).GetAs<int64_t>() < 1025);
+  }
+
+  // The index cannot answer an equality on a column of the inner table that is not its key
+  auto col_b = MakeColumnValueExpression(*out_schema1, 0, "colB");
+  auto col3 = MakeColumnValueExpression(inner_schema, 1, "col3");
+  auto non_key_plan = std::make_unique<NestedIndexJoinPlanNode>(
+      out_final, std::vector<const AbstractPlanNode *>{scan_plan1.get()},
+      MakeComparisonExpression(col_b, col3, ComparisonType::Equal), inner_table_info->oid_, "index1", out_schema1,
+      &inner_schema, 64);
+  EXPECT_THROW(GetExecutionEngine()->Execute(non_key_plan.get(), &result_set, GetTxn(), GetExecutorContext()),
+               NotImplementedException);
+}
+
 // SELECT test_8.colA, test_8.colB, test_9.colA, test_9.colB FROM test_8 JOIN test_9
 TEST_F(ExecutorTest, NestedLoopJoinTestOne) {
   const Schema *out_schema1;
@@ -1227,6 +1456,52 @@ TEST_F(ExecutorTest, NestedLoopJoinTestTwo) {
   }
 }
 
+// SELECT test_1.colA, test_2.col1 FROM test_1 JOIN test_2 ON test_1.colA = test_2.col1, with varying outer batch sizes
+TEST_F(ExecutorTest, BlockNestedLoopJoinTest) {
+  const Schema *out_schema1;
+  std::unique_ptr<AbstractPlanNode> scan_plan1;
+  {
+    auto table_info = GetExecutorContext()->GetCatalog()->GetTable("test_1");
+    auto &schema = table_info->schema_;
+    auto col_a = MakeColumnValueExpression(schema, 0, "colA");
+    out_schema1 = MakeOutputSchema({{"colA", col_a}});
+    scan_plan1 = std::make_unique<SeqScanPlanNode>(out_schema1, nullptr, table_info->oid_);
+  }
+
+  const Schema *out_schema2;
+  std::unique_ptr<AbstractPlanNode> scan_plan2;
+  {
+    auto table_info = GetExecutorContext()->GetCatalog()->GetTable("test_2");
+    auto &schema = table_info->schema_;
+    auto col1 = MakeColumnValueExpression(schema, 0, "col1");
+    out_schema2 = MakeOutputSchema({{"col1", col1}});
+    scan_plan2 = std::make_unique<SeqScanPlanNode>(out_schema2, nullptr, table_info->oid_);
+  }
+
+  auto col_a = MakeColumnValueExpression(*out_schema1, 0, "colA");
+  auto col1 = MakeColumnValueExpression(*out_schema2, 1, "col1");
+  auto predicate = MakeComparisonExpression(col_a, col1, ComparisonType::Equal);
+  const Schema *out_final = MakeOutputSchema({{"colA", col_a}, {"col1", col1}});
+
+  // Zero gives the tuple-at-a-time join, the others buffer a few, many, and all outer tuples.
+  for (uint32_t outer_buffer_size : std::vector<uint32_t>{0, 100, PAGE_SIZE, 1024 * PAGE_SIZE}) {
+    NestedLoopJoinPlanNode join_plan(
+        out_final, std::vector<const AbstractPlanNode *>{scan_plan1.get(), scan_plan2.get()}, predicate,
+        outer_buffer_size);
+    std::vector<Tuple> result_set{};
+    GetExecutionEngine()->Execute(&join_plan, &result_set, GetTxn(), GetExecutorContext());
+    ASSERT_EQ(result_set.size(), 100);
+    std::vector<bool> seen(100, false);
+    for (const auto &tuple : result_set) {
+      auto a = tuple.GetValue(out_final, 0).GetAs<int32_t>();
+      ASSERT_EQ(a, tuple.GetValue(out_final, 1).GetAs<int16_t>());
+      ASSERT_TRUE(a >= 0 && a < 100);
+      ASSERT_FALSE(seen[a]);
+      seen[a] = true;
+    }
+  }
+}
+
 // SELECT test_4.colA, test_4.colB, test_6.colA, test_6.colB FROM test_4 JOIN test_6 ON test_4.colA = test_6.colA;
 TEST_F(ExecutorTest, SimpleHashJoinTest) {
   // Construct sequential scan of table test_4
@@ -1410,6 +1685,191 @@ TEST_F(ExecutorTest, HashJoinTestTwo) {
   }
 }
 
+// SELECT test_1.colA, test_2.col1 FROM test_1 JOIN test_2 ON test_1.colA = test_2.col1 WHERE test_1.colA < 5
+TEST_F(ExecutorTest, SelectiveHashJoinTest) {
+  const Schema *out_schema1;
+  std::unique_ptr<AbstractPlanNode> scan_plan1;
+  {
+    auto table_info = GetExecutorContext()->GetCatalog()->GetTable("test_1");
+    auto &schema = table_info->schema_;
+    auto col_a = MakeColumnValueExpression(schema, 0, "colA");
+    auto const5 = MakeConstantValueExpression(ValueFactory::GetIntegerValue(5));
+    auto predicate = MakeComparisonExpression(col_a, const5, ComparisonType::LessThan);
+    out_schema1 = MakeOutputSchema({{"colA", col_a}});
+    scan_plan1 = std::make_unique<SeqScanPlanNode>(out_schema1, predicate, table_info->oid_);
+  }
+
+  const Schema *out_schema2;
+  std::unique_ptr<AbstractPlanNode> scan_plan2;
+  {
+    auto table_info = GetExecutorContext()->GetCatalog()->GetTable("test_2");
+    auto &schema = table_info->schema_;
+    auto col1 = MakeColumnValueExpression(schema, 0, "col1");
+    out_schema2 = MakeOutputSchema({{"col1", col1}});
+    scan_plan2 = std::make_unique<SeqScanPlanNode>(out_schema2, nullptr, table_info->oid_);
+  }
+
+  // The right scan only produces the tuples that pass the Bloom filter built on the five left keys.
+  auto col_a = MakeColumnValueExpression(*out_schema1, 0, "colA");
+  auto col1 = MakeColumnValueExpression(*out_schema2, 1, "col1");
+  auto out_final = MakeOutputSchema({{"colA", col_a}, {"col1", col1}});
+  HashJoinPlanNode join_plan(out_final, std::vector<const AbstractPlanNode *>{scan_plan1.get(), scan_plan2.get()},
+                             col_a, col1);
+
+  std::vector<Tuple> result_set{};
+  GetExecutionEngine()->Execute(&join_plan, &result_set, GetTxn(), GetExecutorContext());
+  ASSERT_EQ(result_set.size(), 5);
+  for (int i = 0; i < 5; i++) {
+    ASSERT_EQ(result_set[i].GetValue(out_final, 0).GetAs<int32_t>(), i);
+    ASSERT_EQ(result_set[i].GetValue(out_final, 1).GetAs<int16_t>(), i);
+  }
+}
+
+// SELECT test_1.colB, test_2.col2 FROM test_1 JOIN test_2 ON test_1.colB = test_2.col2
+TEST_F(ExecutorTest, SortMergeJoinTest) {
+  const Schema *out_schema1;
+  std::unique_ptr<AbstractPlanNode> scan_plan1;
+  {
+    auto table_info = GetExecutorContext()->GetCatalog()->GetTable("test_1");
+    auto &schema = table_info->schema_;
+    auto col_a = MakeColumnValueExpression(schema, 0, "colA");
+    auto col_b = MakeColumnValueExpression(schema, 0, "colB");
+    out_schema1 = MakeOutputSchema({{"colA", col_a}, {"colB", col_b}});
+    scan_plan1 = std::make_unique<SeqScanPlanNode>(out_schema1, nullptr, table_info->oid_);
+  }
+
+  const Schema *out_schema2;
+  std::unique_ptr<AbstractPlanNode> scan_plan2;
+  {
+    auto table_info = GetExecutorContext()->GetCatalog()->GetTable("test_2");
+    auto &schema = table_info->schema_;
+    auto col1 = MakeColumnValueExpression(schema, 0, "col1");
+    auto col2 = MakeColumnValueExpression(schema, 0, "col2");
+    out_schema2 = MakeOutputSchema({{"col1", col1}, {"col2", col2}});
+    scan_plan2 = std::make_unique<SeqScanPlanNode>(out_schema2, nullptr, table_info->oid_);
+  }
+
+  // Count the duplicates of every key on both sides.
+  std::vector<size_t> left_count(10, 0);
+  std::vector<size_t> right_count(10, 0);
+  std::vector<Tuple> result_set{};
+  GetExecutionEngine()->Execute(scan_plan1.get(), &result_set, GetTxn(), GetExecutorContext());
+  for (const auto &tuple : result_set) {
+    left_count[tuple.GetValue(out_schema1, 1).GetAs<int32_t>()]++;
+  }
+  result_set.clear();
+  GetExecutionEngine()->Execute(scan_plan2.get(), &result_set, GetTxn(), GetExecutorContext());
+  for (const auto &tuple : result_set) {
+    right_count[tuple.GetValue(out_schema2, 1).GetAs<int32_t>()]++;
+  }
+  size_t expected_size = 0;
+  for (int i = 0; i < 10; i++) {
+    expected_size += left_count[i] * right_count[i];
+  }
+
+  auto col_a = MakeColumnValueExpression(*out_schema1, 0, "colA");
+  auto col_b = MakeColumnValueExpression(*out_schema1, 0, "colB");
+  auto col1 = MakeColumnValueExpression(*out_schema2, 1, "col1");
+  auto col2 = MakeColumnValueExpression(*out_schema2, 1, "col2");
+
+  // Unsorted inputs on keys with many duplicates on both sides.
+  {
+    auto out_final = MakeOutputSchema({{"colB", col_b}, {"col2", col2}});
+    SortMergeJoinPlanNode join_plan(out_final,
+                                    std::vector<const AbstractPlanNode *>{scan_plan1.get(), scan_plan2.get()}, col_b,
+                                    col2);
+    result_set.clear();
+    GetExecutionEngine()->Execute(&join_plan, &result_set, GetTxn(), GetExecutorContext());
+    ASSERT_EQ(expected_size, result_set.size());
+    std::vector<size_t> join_count(10, 0);
+    int32_t prev = 0;
+    for (const auto &tuple : result_set) {
+      auto b = tuple.GetValue(out_final, 0).GetAs<int32_t>();
+      ASSERT_EQ(b, tuple.GetValue(out_final, 1).GetAs<int32_t>());
+      // The output is ordered on the join key.
+      ASSERT_LE(prev, b);
+      prev = b;
+      join_count[b]++;
+    }
+    for (int i = 0; i < 10; i++) {
+      ASSERT_EQ(left_count[i] * right_count[i], join_count[i]);
+    }
+  }
+
+  // Inputs that are already sorted are merged as they are produced.
+  {
+    auto out_final = MakeOutputSchema({{"colA", col_a}, {"col1", col1}});
+    SortMergeJoinPlanNode join_plan(out_final,
+                                    std::vector<const AbstractPlanNode *>{scan_plan1.get(), scan_plan2.get()}, col_a,
+                                    col1, true, true);
+    result_set.clear();
+    GetExecutionEngine()->Execute(&join_plan, &result_set, GetTxn(), GetExecutorContext());
+    ASSERT_EQ(result_set.size(), 100);
+    for (int i = 0; i < 100; i++) {
+      ASSERT_EQ(result_set[i].GetValue(out_final, 0).GetAs<int32_t>(), i);
+      ASSERT_EQ(result_set[i].GetValue(out_final, 1).GetAs<int16_t>(), i);
+    }
+  }
+}
+
+// SELECT colA FROM test_1 WHERE [NOT] EXISTS (SELECT * FROM test_2 WHERE test_1.colA = test_2.col1)
+TEST_F(ExecutorTest, SemiJoinAndAntiJoinTest) {
+  const Schema *out_schema1;
+  std::unique_ptr<AbstractPlanNode> scan_plan1;
+  {
+    auto table_info = GetExecutorContext()->GetCatalog()->GetTable("test_1");
+    auto &schema = table_info->schema_;
+    auto col_a = MakeColumnValueExpression(schema, 0, "colA");
+    out_schema1 = MakeOutputSchema({{"colA", col_a}});
+    scan_plan1 = std::make_unique<SeqScanPlanNode>(out_schema1, nullptr, table_info->oid_);
+  }
+
+  // test_2.col2 only holds 0 to 9, so the right side has many duplicate keys.
+  const Schema *out_schema2;
+  std::unique_ptr<AbstractPlanNode> scan_plan2;
+  {
+    auto table_info = GetExecutorContext()->GetCatalog()->GetTable("test_2");
+    auto &schema = table_info->schema_;
+    auto col2 = MakeColumnValueExpression(schema, 0, "col2");
+    out_schema2 = MakeOutputSchema({{"col2", col2}});
+    scan_plan2 = std::make_unique<SeqScanPlanNode>(out_schema2, nullptr, table_info->oid_);
+  }
+
+  auto col_a = MakeColumnValueExpression(*out_schema1, 0, "colA");
+  auto col2 = MakeColumnValueExpression(*out_schema2, 1, "col2");
+  auto predicate = MakeComparisonExpression(col_a, col2, ComparisonType::Equal);
+  auto out_final = MakeOutputSchema({{"colA", col_a}});
+
+  std::vector<Tuple> result_set{};
+  GetExecutionEngine()->Execute(scan_plan2.get(), &result_set, GetTxn(), GetExecutorContext());
+  std::vector<bool> in_right(10, false);
+  for (const auto &tuple : result_set) {
+    in_right[tuple.GetValue(out_schema2, 0).GetAs<int32_t>()] = true;
+  }
+  std::vector<int32_t> semi_expected;
+  std::vector<int32_t> anti_expected;
+  for (int32_t i = 0; i < static_cast<int32_t>(TEST1_SIZE); i++) {
+    (i < 10 && in_right[i] ? semi_expected : anti_expected).push_back(i);
+  }
+
+  auto children = [&]() { return std::vector<const AbstractPlanNode *>{scan_plan1.get(), scan_plan2.get()}; };
+  std::vector<std::pair<std::unique_ptr<SemiJoinPlanNode>, const std::vector<int32_t> *>> plans;
+  plans.emplace_back(std::make_unique<SemiJoinPlanNode>(out_final, children(), col_a, col2), &semi_expected);
+  plans.emplace_back(std::make_unique<SemiJoinPlanNode>(out_final, children(), predicate), &semi_expected);
+  plans.emplace_back(std::make_unique<AntiJoinPlanNode>(out_final, children(), col_a, col2), &anti_expected);
+  plans.emplace_back(std::make_unique<AntiJoinPlanNode>(out_final, children(), predicate), &anti_expected);
+
+  for (const auto &[plan, expected] : plans) {
+    result_set.clear();
+    GetExecutionEngine()->Execute(plan.get(), &result_set, GetTxn(), GetExecutorContext());
+    // Every left tuple is emitted at most once, in the order of the left child.
+    ASSERT_EQ(expected->size(), result_set.size());
+    for (size_t i = 0; i < result_set.size(); i++) {
+      ASSERT_EQ((*expected)[i], result_set[i].GetValue(out_final, 0).GetAs<int32_t>());
+    }
+  }
+}
+
 // SELECT COUNT(colA), SUM(colA), min(colA), max(colA) from test_1;
 TEST_F(ExecutorTest, SimpleAggregationTest) {
   const Schema *scan_schema;
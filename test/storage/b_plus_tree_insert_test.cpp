@@ -12,6 +12,8 @@
 
 #include <algorithm>
 #include <cstdio>
+#include <utility>
+#include <vector>
 
 #define DLL_USER
 
@@ -22,7 +24,7 @@
 
 namespace bustub {
 
-TEST(BPlusTreeTests, DISABLED_InsertTest1) {
+TEST(BPlusTreeTests, InsertTest1) {
   // create KeyComparator and index schema
   auto key_schema = ParseCreateStatement("a bigint");
   GenericComparator<8> comparator(key_schema.get());
@@ -80,7 +82,7 @@ TEST(BPlusTreeTests, DISABLED_InsertTest1) {
   remove("test.log");
 }
 
-TEST(BPlusTreeTests, DISABLED_InsertTest2) {
+TEST(BPlusTreeTests, InsertTest2) {
   // create KeyComparator and index schema
   auto key_schema = ParseCreateStatement("a bigint");
   GenericComparator<8> comparator(key_schema.get());
@@ -147,4 +149,71 @@ TEST(BPlusTreeTests, DISABLED_InsertTest2) {
   remove("test.db");
   remove("test.log");
 }
+
+TEST(BPlusTreeTests, BulkLoadTest) {
+  // create KeyComparator and index schema
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+
+  DiskManager *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManagerInstance(50, disk_manager);
+  // create and fetch header_page
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(&page_id);
+  (void)header_page;
+
+  const int64_t scale = 1000;
+  std::vector<std::pair<GenericKey<8>, RID>> items(scale);
+  for (int64_t key = 0; key < scale; key++) {
+    items[key].first.SetFromInteger(key * 2);
+    items[key].second.Set(static_cast<int32_t>(key >> 32), key * 2);
+  }
+
+  for (double fill_factor : {0.5, 0.9, 1.0}) {
+    BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", bpm, comparator, 4, 5);
+    EXPECT_TRUE(tree.BulkLoad(items, fill_factor));
+    EXPECT_FALSE(tree.IsEmpty());
+    EXPECT_FALSE(tree.BulkLoad(items, fill_factor));
+
+    int64_t current_key = 0;
+    for (auto iterator = tree.Begin(); iterator != tree.End(); ++iterator) {
+      EXPECT_EQ((*iterator).second.GetSlotNum(), current_key);
+      current_key += 2;
+    }
+    EXPECT_EQ(current_key, scale * 2);
+
+    // The loaded tree keeps working as a regular tree: fill the gaps, then remove the loaded keys.
+    GenericKey<8> index_key;
+    RID rid;
+    std::vector<RID> rids;
+    for (int64_t key = 1; key < scale * 2; key += 2) {
+      index_key.SetFromInteger(key);
+      rid.Set(0, key);
+      EXPECT_TRUE(tree.Insert(index_key, rid));
+    }
+    for (int64_t key = 0; key < scale * 2; key += 2) {
+      index_key.SetFromInteger(key);
+      tree.Remove(index_key);
+    }
+    current_key = 1;
+    for (auto iterator = tree.Begin(); iterator != tree.End(); ++iterator) {
+      EXPECT_EQ((*iterator).second.GetSlotNum(), current_key);
+      current_key += 2;
+    }
+    EXPECT_EQ(current_key, scale * 2 + 1);
+    for (int64_t key = 1; key < scale * 2; key += 2) {
+      rids.clear();
+      index_key.SetFromInteger(key);
+      tree.GetValue(index_key, &rids);
+      ASSERT_EQ(rids.size(), 1);
+      EXPECT_EQ(rids[0].GetSlotNum(), key);
+    }
+  }
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete disk_manager;
+  delete bpm;
+  remove("test.db");
+  remove("test.log");
+}
 }  // namespace bustub
@@ -126,17 +126,18 @@ TEST(BPlusTreePageTest, InternalPageSimpleTest) {
   EXPECT_EQ(1, internal_page->ValueIndex(2));
   EXPECT_EQ(1, internal_page->ValueAt(0));
   EXPECT_EQ(2, internal_page->Lookup(2, comparator));
-  EXPECT_EQ(INVALID_PAGE_ID, internal_page->Lookup(6, comparator));
+  EXPECT_EQ(5, internal_page->Lookup(6, comparator));
+  EXPECT_EQ(1, internal_page->Lookup(1, comparator));
   internal_page->Remove(2);
   internal_page->Remove(1);
   internal_page->Remove(3);
   internal_page->Remove(2);
-  internal_page->RemoveAndReturnOnlyChild();
-
-  internal_page->MoveAllTo(nullptr, 0, nullptr);
-  internal_page->MoveFirstToEndOf(nullptr, 0, nullptr);
-  internal_page->MoveHalfTo(nullptr, nullptr);
-  internal_page->MoveLastToFrontOf(nullptr, 0, nullptr);
+  EXPECT_EQ(2, internal_page->GetSize());
+  EXPECT_EQ(4, internal_page->ValueAt(1));
+  internal_page->Remove(1);
+  EXPECT_EQ(1, internal_page->GetSize());
+  EXPECT_EQ(1, internal_page->RemoveAndReturnOnlyChild());
+  EXPECT_EQ(0, internal_page->GetSize());
 
   delete internal_page;
 }
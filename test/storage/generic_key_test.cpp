@@ -0,0 +1,138 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// generic_key_test.cpp
+//
+// Identification: test/storage/generic_key_test.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <random>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "storage/index/generic_key.h"
+#include "test_util.h"  // NOLINT
+#include "type/value_factory.h"
+
+namespace bustub {
+
+// Reference ordering of two key columns, nulls first.
+static int CompareValues(const Value &lhs, const Value &rhs) {
+  if (lhs.IsNull() || rhs.IsNull()) {
+    return static_cast<int>(rhs.IsNull()) - static_cast<int>(lhs.IsNull());
+  }
+  if (lhs.CompareLessThan(rhs) == CmpBool::CmpTrue) {
+    return -1;
+  }
+  return lhs.CompareGreaterThan(rhs) == CmpBool::CmpTrue ? 1 : 0;
+}
+
+// NOLINTNEXTLINE
+TEST(GenericKeyTest, NormalizedKeyTest) {
+  auto key_schema = ParseCreateStatement("a smallint,b int,c double,d bigint");
+  ASSERT_TRUE(GenericKey<32>::IsNormalized(key_schema.get()));
+  ASSERT_FALSE(GenericKey<16>::IsNormalized(key_schema.get()));
+  GenericComparator<32> comparator(key_schema.get());
+
+  // Few distinct values per column, so that keys often share a prefix.
+  std::mt19937 rng(15445);
+  std::uniform_int_distribution<int> dist(-3, 3);
+  auto random_value = [&](TypeId type) {
+    int v = dist(rng);
+    if (v == -3) {
+      return ValueFactory::GetNullValueByType(type);
+    }
+    switch (type) {
+      case TypeId::SMALLINT:
+        return ValueFactory::GetSmallIntValue(static_cast<int16_t>(v * 1000));
+      case TypeId::INTEGER:
+        return ValueFactory::GetIntegerValue(v * 100000);
+      case TypeId::DECIMAL:
+        return ValueFactory::GetDecimalValue(v * 0.75);
+      default:
+        return ValueFactory::GetBigIntValue(static_cast<int64_t>(v) << 40);
+    }
+  };
+
+  std::vector<std::vector<Value>> values;
+  std::vector<GenericKey<32>> keys(200);
+  for (auto &key : keys) {
+    std::vector<Value> row;
+    for (const auto &col : key_schema->GetColumns()) {
+      row.push_back(random_value(col.GetType()));
+    }
+    key.SetFromKey(Tuple(row, key_schema.get()), key_schema.get());
+    values.push_back(row);
+  }
+
+  for (size_t i = 0; i < keys.size(); i++) {
+    // Every column can be read back.
+    for (uint32_t col = 0; col < key_schema->GetColumnCount(); col++) {
+      EXPECT_EQ(0, CompareValues(values[i][col], keys[i].ToValue(key_schema.get(), col)));
+    }
+    for (size_t j = 0; j < keys.size(); j++) {
+      int expected = 0;
+      for (uint32_t col = 0; col < key_schema->GetColumnCount() && expected == 0; col++) {
+        expected = CompareValues(values[i][col], values[j][col]);
+      }
+      EXPECT_EQ(expected, comparator(keys[i], keys[j]));
+    }
+  }
+
+  // -0.0 equals 0.0
+  GenericKey<32> zero;
+  GenericKey<32> negative_zero;
+  zero.SetFromKey(Tuple({ValueFactory::GetSmallIntValue(0), ValueFactory::GetIntegerValue(0),
+                         ValueFactory::GetDecimalValue(0.0), ValueFactory::GetBigIntValue(0)},
+                        key_schema.get()),
+                  key_schema.get());
+  negative_zero.SetFromKey(Tuple({ValueFactory::GetSmallIntValue(0), ValueFactory::GetIntegerValue(0),
+                                  ValueFactory::GetDecimalValue(-0.0), ValueFactory::GetBigIntValue(0)},
+                                 key_schema.get()),
+                           key_schema.get());
+  EXPECT_EQ(0, comparator(zero, negative_zero));
+}
+
+// NOLINTNEXTLINE
+TEST(GenericKeyTest, ColumnWiseFallbackTest) {
+  auto key_schema = ParseCreateStatement("a varchar(8),b int");
+  ASSERT_FALSE(GenericKey<32>::IsNormalized(key_schema.get()));
+  GenericComparator<32> comparator(key_schema.get());
+
+  GenericKey<32> lhs;
+  GenericKey<32> rhs;
+  lhs.SetFromKey(Tuple({ValueFactory::GetVarcharValue("ab"), ValueFactory::GetIntegerValue(2)}, key_schema.get()),
+                 key_schema.get());
+  rhs.SetFromKey(Tuple({ValueFactory::GetVarcharValue("b"), ValueFactory::GetIntegerValue(1)}, key_schema.get()),
+                 key_schema.get());
+  EXPECT_EQ(-1, comparator(lhs, rhs));
+  EXPECT_EQ(1, comparator(rhs, lhs));
+  EXPECT_EQ(0, comparator(lhs, lhs));
+  EXPECT_EQ("ab", lhs.ToValue(key_schema.get(), 0).ToString());
+  EXPECT_EQ(2, lhs.ToValue(key_schema.get(), 1).GetAs<int32_t>());
+}
+
+// NOLINTNEXTLINE
+TEST(GenericKeyTest, SetFromIntegerTest) {
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+  GenericKey<8> lhs;
+  GenericKey<8> rhs;
+  for (int64_t a : {-300L, -1L, 0L, 1L, 256L}) {
+    for (int64_t b : {-300L, -1L, 0L, 1L, 256L}) {
+      lhs.SetFromInteger(a);
+      rhs.SetFromInteger(b);
+      EXPECT_EQ((a > b) - (a < b), comparator(lhs, rhs));
+    }
+    lhs.SetFromInteger(a);
+    EXPECT_EQ(a, lhs.ToString());
+    EXPECT_EQ(a, lhs.ToValue(key_schema.get(), 0).GetAs<int64_t>());
+  }
+}
+
+}  // namespace bustub
@@ -0,0 +1,213 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// varlen_b_plus_tree_test.cpp
+//
+// Identification: test/storage/varlen_b_plus_tree_test.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <chrono>  // NOLINT
+#include <cstdio>
+#include <iostream>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "gtest/gtest.h"
+#include "storage/index/b_plus_tree.h"
+#include "storage/index/varlen_b_plus_tree.h"
+#include "test_util.h"  // NOLINT
+#include "type/value_factory.h"
+
+namespace bustub {
+
+namespace {
+
+/** A URL that shares a long prefix with the URLs of neighbouring numbers. */
+std::string MakeUrl(int64_t key) {
+  char buffer[64];
+  snprintf(buffer, sizeof(buffer), "https://www.example.com/catalog/item/%010ld", static_cast<long>(key));  // NOLINT
+  return buffer;
+}
+
+}  // namespace
+
+TEST(VarlenBPlusTreeTests, InsertTest) {
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManagerInstance(50, disk_manager);
+  page_id_t page_id;
+  bpm->NewPage(&page_id);
+
+  VarlenBPlusTree tree("foo_pk", bpm);
+  EXPECT_TRUE(tree.IsEmpty());
+  const int64_t scale = 5000;
+  std::vector<int64_t> order(scale);
+  for (int64_t key = 0; key < scale; key++) {
+    order[key] = key;
+  }
+  std::shuffle(order.begin(), order.end(), std::mt19937(15445));
+  for (auto key : order) {
+    EXPECT_TRUE(tree.Insert(MakeUrl(key), RID(0, key)));
+  }
+  EXPECT_FALSE(tree.Insert(MakeUrl(0), RID(0, 0)));
+  EXPECT_FALSE(tree.IsEmpty());
+
+  std::vector<RID> rids;
+  for (int64_t key = 0; key < scale; key++) {
+    rids.clear();
+    EXPECT_TRUE(tree.GetValue(MakeUrl(key), &rids));
+    ASSERT_EQ(rids.size(), 1);
+    EXPECT_EQ(rids[0].GetSlotNum(), key);
+  }
+  // prefixes and extensions of stored keys are other keys
+  EXPECT_FALSE(tree.GetValue("https://www.example.com/catalog/item/", &rids));
+  EXPECT_FALSE(tree.GetValue(MakeUrl(1) + "0", &rids));
+  EXPECT_FALSE(tree.GetValue("", &rids));
+
+  // the separators are truncated and the keys are prefix compressed, so the internal level stays a single page
+  EXPECT_EQ(tree.GetHeight(), 2);
+
+  EXPECT_THROW(tree.Insert(std::string(VarlenBPlusTree::MAX_KEY_SIZE + 1, 'a'), RID(0, 0)), Exception);
+  EXPECT_TRUE(tree.Insert(std::string(VarlenBPlusTree::MAX_KEY_SIZE, 'a'), RID(0, 0)));
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete bpm;
+  delete disk_manager;
+  remove("test.db");
+  remove("test.log");
+}
+
+TEST(VarlenBPlusTreeTests, RandomInsertRemoveTest) {
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManagerInstance(50, disk_manager);
+  page_id_t page_id;
+  bpm->NewPage(&page_id);
+
+  VarlenBPlusTree tree("foo_pk", bpm);
+  std::map<std::string, int64_t> expected;
+  std::mt19937 rng(15445);
+  // keys of random bytes, including '\0', behind shared prefixes of random length, so that the separators are
+  // long enough to split internal pages too
+  auto random_key = [&]() {
+    std::string key(rng() % 200, 'x');
+    for (size_t i = 0, length = rng() % 50; i < length; i++) {
+      key.push_back(static_cast<char>(rng() % 4 == 0 ? 0 : rng()));
+    }
+    return key;
+  };
+  std::vector<std::string> keys;
+  for (int i = 0; i < 4000; i++) {
+    keys.push_back(random_key());
+  }
+
+  std::vector<RID> rids;
+  for (int round = 0; round < 3; round++) {
+    for (int i = 0; i < 6000; i++) {
+      const std::string &key = keys[rng() % keys.size()];
+      if (rng() % 3 != 0) {
+        bool inserted = expected.emplace(key, i).second;
+        EXPECT_EQ(tree.Insert(key, RID(0, i)), inserted);
+      } else {
+        expected.erase(key);
+        tree.Remove(key);
+      }
+    }
+    EXPECT_GE(tree.GetHeight(), 3);
+    for (const auto &key : keys) {
+      rids.clear();
+      auto it = expected.find(key);
+      ASSERT_EQ(tree.GetValue(key, &rids), it != expected.end());
+      if (it != expected.end()) {
+        EXPECT_EQ(rids[0].GetSlotNum(), it->second);
+      }
+    }
+  }
+
+  // removing every key merges the tree down to nothing
+  for (const auto &key : keys) {
+    tree.Remove(key);
+  }
+  EXPECT_TRUE(tree.IsEmpty());
+  EXPECT_EQ(tree.GetHeight(), 0);
+  EXPECT_TRUE(tree.Insert(keys[0], RID(0, 1)));
+  EXPECT_TRUE(tree.GetValue(keys[0], &rids));
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete bpm;
+  delete disk_manager;
+  remove("test.db");
+  remove("test.log");
+}
+
+/** Compares the size and the lookups of the tree with a BPlusTree on GenericKey for long string keys. */
+TEST(VarlenBPlusTreeTests, DISABLED_StringKeyBenchmark) {
+  const int64_t num_keys = 300000;
+  std::vector<int64_t> order(num_keys);
+  for (int64_t i = 0; i < num_keys; i++) {
+    order[i] = i;
+  }
+  std::shuffle(order.begin(), order.end(), std::mt19937(15445));
+  auto to_ms = [](auto duration) { return std::chrono::duration_cast<std::chrono::milliseconds>(duration).count(); };
+
+  {
+    auto *disk_manager = new DiskManager("test.db");
+    auto *bpm = new BufferPoolManagerInstance(4096, disk_manager);
+    page_id_t page_id;
+    bpm->NewPage(&page_id);
+    VarlenBPlusTree tree("varlen", bpm);
+    for (auto key : order) {
+      tree.Insert(MakeUrl(key), RID(0, key));
+    }
+    auto start = std::chrono::steady_clock::now();
+    std::vector<RID> rids;
+    for (auto key : order) {
+      tree.GetValue(MakeUrl(key), &rids);
+    }
+    auto lookup_time = std::chrono::steady_clock::now() - start;
+    bpm->NewPage(&page_id);
+    std::cout << "varlen b+ tree: height " << tree.GetHeight() << ", " << page_id << " pages, lookups "
+              << to_ms(lookup_time) << " ms" << std::endl;
+    delete bpm;
+    delete disk_manager;
+  }
+
+  {
+    auto key_schema = ParseCreateStatement("a varchar(64)");
+    GenericComparator<64> comparator(key_schema.get());
+    auto *disk_manager = new DiskManager("test.db");
+    auto *bpm = new BufferPoolManagerInstance(4096, disk_manager);
+    page_id_t page_id;
+    bpm->NewPage(&page_id);
+    BPlusTree<GenericKey<64>, RID, GenericComparator<64>> tree("generic", bpm, comparator);
+    auto make_key = [&](int64_t key) {
+      GenericKey<64> index_key;
+      index_key.SetFromKey(Tuple({ValueFactory::GetVarcharValue(MakeUrl(key))}, key_schema.get()), key_schema.get());
+      return index_key;
+    };
+    for (auto key : order) {
+      tree.Insert(make_key(key), RID(0, key));
+    }
+    auto start = std::chrono::steady_clock::now();
+    std::vector<RID> rids;
+    for (auto key : order) {
+      tree.GetValue(make_key(key), &rids);
+    }
+    auto lookup_time = std::chrono::steady_clock::now() - start;
+    bpm->NewPage(&page_id);
+    std::cout << "GenericKey<64> b+ tree: " << page_id << " pages, lookups " << to_ms(lookup_time) << " ms"
+              << std::endl;
+    delete bpm;
+    delete disk_manager;
+  }
+  remove("test.db");
+  remove("test.log");
+}
+
+}  // namespace bustub